@@ -0,0 +1,723 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include "array.h"
+#include "memstats.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ARRAY_HAVE_X86_KERNELS 1
+#endif
+
+/* Comentario general:
+   - Cada operación masiva tiene hasta tres versiones: escalar, SSE2 y AVX2.
+   - La tabla de kernels se elige una sola vez según la CPU (__builtin_cpu_supports); en otras
+     arquitecturas se usa la escalar.
+   - sum sobre REAL acumula en 4 carriles (elementos i con i % 4 == carril) y los combina al final
+     en el mismo orden en las tres versiones: el resultado no depende de la CPU.
+   - Los enteros usan aritmética modular (como los registros SIMD) para no depender de desbordes.
+*/
+
+#define ARRAY_ALIGNMENT 32
+
+typedef struct {
+    void (*fill_int)(int *dst, size_t n, int value);
+    void (*fill_real)(double *dst, size_t n, double value);
+    int (*sum_int)(const int *src, size_t n);
+    double (*sum_real)(const double *src, size_t n);
+    int (*min_int)(const int *src, size_t n);
+    int (*max_int)(const int *src, size_t n);
+    double (*min_real)(const double *src, size_t n);
+    double (*max_real)(const double *src, size_t n);
+    void (*add_int)(int *dst, const int *src, size_t n);
+    void (*sub_int)(int *dst, const int *src, size_t n);
+    void (*mul_int)(int *dst, const int *src, size_t n);
+    void (*add_real)(double *dst, const double *src, size_t n);
+    void (*sub_real)(double *dst, const double *src, size_t n);
+    void (*mul_real)(double *dst, const double *src, size_t n);
+} ArrayKernels;
+
+/* --- Kernels escalares --- */
+
+static void scalar_fill_int(int *dst, size_t n, int value) {
+    for (size_t i = 0; i < n; i++) dst[i] = value;
+}
+
+static void scalar_fill_real(double *dst, size_t n, double value) {
+    for (size_t i = 0; i < n; i++) dst[i] = value;
+}
+
+static int scalar_sum_int(const int *src, size_t n) {
+    uint32_t total = 0;
+    for (size_t i = 0; i < n; i++) total += (uint32_t)src[i];
+    return (int)total;
+}
+
+static double scalar_sum_real(const double *src, size_t n) {
+    double lane[4] = { 0.0, 0.0, 0.0, 0.0 };
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        lane[0] += src[i];
+        lane[1] += src[i + 1];
+        lane[2] += src[i + 2];
+        lane[3] += src[i + 3];
+    }
+    double total = (lane[0] + lane[1]) + (lane[2] + lane[3]);
+    for (; i < n; i++) total += src[i];
+    return total;
+}
+
+static int scalar_min_int(const int *src, size_t n) {
+    int best = src[0];
+    for (size_t i = 1; i < n; i++) if (src[i] < best) best = src[i];
+    return best;
+}
+
+static int scalar_max_int(const int *src, size_t n) {
+    int best = src[0];
+    for (size_t i = 1; i < n; i++) if (src[i] > best) best = src[i];
+    return best;
+}
+
+static double scalar_min_real(const double *src, size_t n) {
+    double best = src[0];
+    for (size_t i = 1; i < n; i++) if (src[i] < best) best = src[i];
+    return best;
+}
+
+static double scalar_max_real(const double *src, size_t n) {
+    double best = src[0];
+    for (size_t i = 1; i < n; i++) if (src[i] > best) best = src[i];
+    return best;
+}
+
+static void scalar_add_int(int *dst, const int *src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = (int)((uint32_t)dst[i] + (uint32_t)src[i]);
+}
+
+static void scalar_sub_int(int *dst, const int *src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = (int)((uint32_t)dst[i] - (uint32_t)src[i]);
+}
+
+static void scalar_mul_int(int *dst, const int *src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = (int)((uint32_t)dst[i] * (uint32_t)src[i]);
+}
+
+static void scalar_add_real(double *dst, const double *src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] += src[i];
+}
+
+static void scalar_sub_real(double *dst, const double *src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] -= src[i];
+}
+
+static void scalar_mul_real(double *dst, const double *src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] *= src[i];
+}
+
+static const ArrayKernels scalar_kernels = {
+    scalar_fill_int, scalar_fill_real, scalar_sum_int, scalar_sum_real,
+    scalar_min_int, scalar_max_int, scalar_min_real, scalar_max_real,
+    scalar_add_int, scalar_sub_int, scalar_mul_int,
+    scalar_add_real, scalar_sub_real, scalar_mul_real
+};
+
+#ifdef ARRAY_HAVE_X86_KERNELS
+
+/* --- Kernels SSE2 (base de x86-64) --- */
+
+__attribute__((target("sse2")))
+static void sse2_fill_int(int *dst, size_t n, int value) {
+    __m128i v = _mm_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm_storeu_si128((__m128i*)(dst + i), v);
+    for (; i < n; i++) dst[i] = value;
+}
+
+__attribute__((target("sse2")))
+static void sse2_fill_real(double *dst, size_t n, double value) {
+    __m128d v = _mm_set1_pd(value);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) _mm_storeu_pd(dst + i, v);
+    for (; i < n; i++) dst[i] = value;
+}
+
+__attribute__((target("sse2")))
+static int sse2_sum_int(const int *src, size_t n) {
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) acc = _mm_add_epi32(acc, _mm_loadu_si128((const __m128i*)(src + i)));
+    uint32_t lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, acc);
+    uint32_t total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < n; i++) total += (uint32_t)src[i];
+    return (int)total;
+}
+
+__attribute__((target("sse2")))
+static double sse2_sum_real(const double *src, size_t n) {
+    __m128d acc01 = _mm_setzero_pd(), acc23 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc01 = _mm_add_pd(acc01, _mm_loadu_pd(src + i));
+        acc23 = _mm_add_pd(acc23, _mm_loadu_pd(src + i + 2));
+    }
+    double lane[4];
+    _mm_storeu_pd(lane, acc01);
+    _mm_storeu_pd(lane + 2, acc23);
+    double total = (lane[0] + lane[1]) + (lane[2] + lane[3]);
+    for (; i < n; i++) total += src[i];
+    return total;
+}
+
+// SSE2 no tiene min/max de enteros de 32 bits: se arma con comparación y máscaras
+__attribute__((target("sse2")))
+static int sse2_min_int(const int *src, size_t n) {
+    if (n < 4) return scalar_min_int(src, n);
+    __m128i best = _mm_loadu_si128((const __m128i*)src);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i greater = _mm_cmpgt_epi32(best, v);
+        best = _mm_or_si128(_mm_and_si128(greater, v), _mm_andnot_si128(greater, best));
+    }
+    int lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, best);
+    int result = scalar_min_int(lanes, 4);
+    for (; i < n; i++) if (src[i] < result) result = src[i];
+    return result;
+}
+
+__attribute__((target("sse2")))
+static int sse2_max_int(const int *src, size_t n) {
+    if (n < 4) return scalar_max_int(src, n);
+    __m128i best = _mm_loadu_si128((const __m128i*)src);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i less = _mm_cmplt_epi32(best, v);
+        best = _mm_or_si128(_mm_and_si128(less, v), _mm_andnot_si128(less, best));
+    }
+    int lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, best);
+    int result = scalar_max_int(lanes, 4);
+    for (; i < n; i++) if (src[i] > result) result = src[i];
+    return result;
+}
+
+__attribute__((target("sse2")))
+static double sse2_min_real(const double *src, size_t n) {
+    if (n < 2) return src[0];
+    __m128d best = _mm_loadu_pd(src);
+    size_t i = 2;
+    for (; i + 2 <= n; i += 2) best = _mm_min_pd(best, _mm_loadu_pd(src + i));
+    double lanes[2];
+    _mm_storeu_pd(lanes, best);
+    double result = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+    for (; i < n; i++) if (src[i] < result) result = src[i];
+    return result;
+}
+
+__attribute__((target("sse2")))
+static double sse2_max_real(const double *src, size_t n) {
+    if (n < 2) return src[0];
+    __m128d best = _mm_loadu_pd(src);
+    size_t i = 2;
+    for (; i + 2 <= n; i += 2) best = _mm_max_pd(best, _mm_loadu_pd(src + i));
+    double lanes[2];
+    _mm_storeu_pd(lanes, best);
+    double result = lanes[0] > lanes[1] ? lanes[0] : lanes[1];
+    for (; i < n; i++) if (src[i] > result) result = src[i];
+    return result;
+}
+
+__attribute__((target("sse2")))
+static void sse2_add_int(int *dst, const int *src, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_add_epi32(a, b));
+    }
+    scalar_add_int(dst + i, src + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static void sse2_sub_int(int *dst, const int *src, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_sub_epi32(a, b));
+    }
+    scalar_sub_int(dst + i, src + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static void sse2_add_real(double *dst, const double *src, size_t n) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) _mm_storeu_pd(dst + i, _mm_add_pd(_mm_loadu_pd(dst + i), _mm_loadu_pd(src + i)));
+    scalar_add_real(dst + i, src + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static void sse2_sub_real(double *dst, const double *src, size_t n) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) _mm_storeu_pd(dst + i, _mm_sub_pd(_mm_loadu_pd(dst + i), _mm_loadu_pd(src + i)));
+    scalar_sub_real(dst + i, src + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static void sse2_mul_real(double *dst, const double *src, size_t n) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) _mm_storeu_pd(dst + i, _mm_mul_pd(_mm_loadu_pd(dst + i), _mm_loadu_pd(src + i)));
+    scalar_mul_real(dst + i, src + i, n - i);
+}
+
+// La multiplicación de enteros de 32 bits (pmulld) recién aparece en SSE4.1: se usa la escalar
+static const ArrayKernels sse2_kernels = {
+    sse2_fill_int, sse2_fill_real, sse2_sum_int, sse2_sum_real,
+    sse2_min_int, sse2_max_int, sse2_min_real, sse2_max_real,
+    sse2_add_int, sse2_sub_int, scalar_mul_int,
+    sse2_add_real, sse2_sub_real, sse2_mul_real
+};
+
+/* --- Kernels AVX2 --- */
+
+__attribute__((target("avx2")))
+static void avx2_fill_int(int *dst, size_t n, int value) {
+    __m256i v = _mm256_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm256_storeu_si256((__m256i*)(dst + i), v);
+    for (; i < n; i++) dst[i] = value;
+}
+
+__attribute__((target("avx2")))
+static void avx2_fill_real(double *dst, size_t n, double value) {
+    __m256d v = _mm256_set1_pd(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm256_storeu_pd(dst + i, v);
+    for (; i < n; i++) dst[i] = value;
+}
+
+__attribute__((target("avx2")))
+static int avx2_sum_int(const int *src, size_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) acc = _mm256_add_epi32(acc, _mm256_loadu_si256((const __m256i*)(src + i)));
+    uint32_t lanes[8];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+    uint32_t total = 0;
+    for (int l = 0; l < 8; l++) total += lanes[l];
+    for (; i < n; i++) total += (uint32_t)src[i];
+    return (int)total;
+}
+
+__attribute__((target("avx2")))
+static double avx2_sum_real(const double *src, size_t n) {
+    __m256d acc = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) acc = _mm256_add_pd(acc, _mm256_loadu_pd(src + i));
+    double lane[4];
+    _mm256_storeu_pd(lane, acc);
+    double total = (lane[0] + lane[1]) + (lane[2] + lane[3]);
+    for (; i < n; i++) total += src[i];
+    return total;
+}
+
+__attribute__((target("avx2")))
+static int avx2_min_int(const int *src, size_t n) {
+    if (n < 8) return scalar_min_int(src, n);
+    __m256i best = _mm256_loadu_si256((const __m256i*)src);
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) best = _mm256_min_epi32(best, _mm256_loadu_si256((const __m256i*)(src + i)));
+    int lanes[8];
+    _mm256_storeu_si256((__m256i*)lanes, best);
+    int result = scalar_min_int(lanes, 8);
+    for (; i < n; i++) if (src[i] < result) result = src[i];
+    return result;
+}
+
+__attribute__((target("avx2")))
+static int avx2_max_int(const int *src, size_t n) {
+    if (n < 8) return scalar_max_int(src, n);
+    __m256i best = _mm256_loadu_si256((const __m256i*)src);
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) best = _mm256_max_epi32(best, _mm256_loadu_si256((const __m256i*)(src + i)));
+    int lanes[8];
+    _mm256_storeu_si256((__m256i*)lanes, best);
+    int result = scalar_max_int(lanes, 8);
+    for (; i < n; i++) if (src[i] > result) result = src[i];
+    return result;
+}
+
+__attribute__((target("avx2")))
+static double avx2_min_real(const double *src, size_t n) {
+    if (n < 4) return scalar_min_real(src, n);
+    __m256d best = _mm256_loadu_pd(src);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) best = _mm256_min_pd(best, _mm256_loadu_pd(src + i));
+    double lanes[4];
+    _mm256_storeu_pd(lanes, best);
+    double result = scalar_min_real(lanes, 4);
+    for (; i < n; i++) if (src[i] < result) result = src[i];
+    return result;
+}
+
+__attribute__((target("avx2")))
+static double avx2_max_real(const double *src, size_t n) {
+    if (n < 4) return scalar_max_real(src, n);
+    __m256d best = _mm256_loadu_pd(src);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) best = _mm256_max_pd(best, _mm256_loadu_pd(src + i));
+    double lanes[4];
+    _mm256_storeu_pd(lanes, best);
+    double result = scalar_max_real(lanes, 4);
+    for (; i < n; i++) if (src[i] > result) result = src[i];
+    return result;
+}
+
+__attribute__((target("avx2")))
+static void avx2_add_int(int *dst, const int *src, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_add_epi32(a, b));
+    }
+    scalar_add_int(dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void avx2_sub_int(int *dst, const int *src, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_sub_epi32(a, b));
+    }
+    scalar_sub_int(dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void avx2_mul_int(int *dst, const int *src, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_mullo_epi32(a, b));
+    }
+    scalar_mul_int(dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void avx2_add_real(double *dst, const double *src, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm256_storeu_pd(dst + i, _mm256_add_pd(_mm256_loadu_pd(dst + i), _mm256_loadu_pd(src + i)));
+    scalar_add_real(dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void avx2_sub_real(double *dst, const double *src, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm256_storeu_pd(dst + i, _mm256_sub_pd(_mm256_loadu_pd(dst + i), _mm256_loadu_pd(src + i)));
+    scalar_sub_real(dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void avx2_mul_real(double *dst, const double *src, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm256_storeu_pd(dst + i, _mm256_mul_pd(_mm256_loadu_pd(dst + i), _mm256_loadu_pd(src + i)));
+    scalar_mul_real(dst + i, src + i, n - i);
+}
+
+static const ArrayKernels avx2_kernels = {
+    avx2_fill_int, avx2_fill_real, avx2_sum_int, avx2_sum_real,
+    avx2_min_int, avx2_max_int, avx2_min_real, avx2_max_real,
+    avx2_add_int, avx2_sub_int, avx2_mul_int,
+    avx2_add_real, avx2_sub_real, avx2_mul_real
+};
+
+#endif // ARRAY_HAVE_X86_KERNELS
+
+static const ArrayKernels *kernels = NULL;
+
+static const ArrayKernels* select_kernels(void) {
+    if (kernels) return kernels;
+    kernels = &scalar_kernels;
+#ifdef ARRAY_HAVE_X86_KERNELS
+    __builtin_cpu_init();
+    if (getenv("EIFFEL_ARRAY_SCALAR")) {
+        kernels = &scalar_kernels; // Para comparar resultados contra la versión escalar
+    } else if (__builtin_cpu_supports("avx2")) {
+        kernels = &avx2_kernels;
+    } else if (__builtin_cpu_supports("sse2")) {
+        kernels = &sse2_kernels;
+    }
+#endif
+    return kernels;
+}
+
+/* --- Creación y acceso --- */
+
+int is_array_type(const char *type_name) {
+    return type_name && (strcmp(type_name, "ARRAY [INTEGER]") == 0 || strcmp(type_name, "ARRAY [REAL]") == 0
+                         || strcmp(type_name, "ARRAY [STRING]") == 0);
+}
+
+EiffelArray* create_array(const char *type_name) {
+    if (!is_array_type(type_name)) return NULL;
+    EiffelArray *array = mem_alloc(MEM_ARRAY, sizeof(EiffelArray));
+    if (strcmp(type_name, "ARRAY [INTEGER]") == 0) array->element_type = ARRAY_OF_INTEGER;
+    else if (strcmp(type_name, "ARRAY [REAL]") == 0) array->element_type = ARRAY_OF_REAL;
+    else array->element_type = ARRAY_OF_STRING;
+    array->type_name = mem_strdup(MEM_IDENTIFIER, type_name);
+    array->lower = 1;
+    array->upper = 0;
+    array->data.raw = NULL;
+    return array;
+}
+
+// resize_storage garantiza que count cabe en un int; la resta se hace en 64 bits igual
+int array_count(const EiffelArray *array) {
+    return array->upper >= array->lower ? (int)((int64_t)array->upper - array->lower + 1) : 0;
+}
+
+static size_t element_size(const EiffelArray *array) {
+    switch (array->element_type) {
+        case ARRAY_OF_INTEGER: return sizeof(int);
+        case ARRAY_OF_REAL: return sizeof(double);
+        default: return sizeof(char*);
+    }
+}
+
+static void free_strings(EiffelArray *array) {
+    if (array->element_type != ARRAY_OF_STRING || !array->data.raw) return;
+    size_t count = (size_t)array_count(array);
+    for (size_t i = 0; i < count; i++) mem_free(MEM_STRING, array->data.strings[i]);
+}
+
+// Reserva (o re-reserva) el bloque contiguo alineado y lo deja en cero (NULL para STRING)
+static void resize_storage(EiffelArray *array, int lower, int upper) {
+    // make (-2147483648, 2147483647) tiene 2^32 elementos: no cabe en count ni en memoria
+    int64_t wanted = upper >= lower ? (int64_t)upper - lower + 1 : 0;
+    if (wanted > INT_MAX || (uint64_t)wanted > (SIZE_MAX - ARRAY_ALIGNMENT) / element_size(array)) {
+        fprintf(stderr, "Error: Los límites [%d, %d] de %s piden demasiados elementos (%lld).\n",
+                lower, upper, array->type_name, (long long)wanted);
+        runtime_abort();
+    }
+    free_strings(array);
+    mem_free(MEM_ARRAY, array->data.raw);
+    array->lower = lower;
+    array->upper = upper;
+    array->data.raw = NULL;
+    size_t count = (size_t)array_count(array);
+    if (count == 0) return;
+    size_t bytes = (count * element_size(array) + ARRAY_ALIGNMENT - 1) & ~(size_t)(ARRAY_ALIGNMENT - 1);
+    if (posix_memalign(&array->data.raw, ARRAY_ALIGNMENT, bytes) != 0) {
+        fprintf(stderr, "Error: No hay memoria para un ARRAY de %zu elementos.\n", count);
+        runtime_abort();
+    }
+    memset(array->data.raw, 0, bytes);
+    mem_adopt(MEM_ARRAY, array->data.raw);
+}
+
+static void array_error_feature(EiffelArray *array, const char *feature_name) {
+    fprintf(stderr, "Error: %s no tiene la feature '%s' (o sus argumentos no son válidos).\n", array->type_name, feature_name);
+    runtime_abort();
+}
+
+static int expect_int(EiffelArray *array, const char *feature_name, RuntimeValue value) {
+    if (value.type == VAL_TYPE_INT) return value.as.int_val;
+    array_error_feature(array, feature_name);
+    return 0;
+}
+
+static const char* expect_string(EiffelArray *array, const char *feature_name, RuntimeValue value) {
+    if (value.type == VAL_TYPE_STRING && value.as.string_val) return value.as.string_val;
+    array_error_feature(array, feature_name);
+    return NULL;
+}
+
+static double expect_number(EiffelArray *array, const char *feature_name, RuntimeValue value) {
+    if (value.type == VAL_TYPE_INT) return value.as.int_val;
+    if (value.type == VAL_TYPE_REAL) return value.as.real_val;
+    array_error_feature(array, feature_name);
+    return 0.0;
+}
+
+// Valor para un elemento numérico: ARRAY [INTEGER] solo acepta INTEGER (un REAL como 1e20 no cabe en int)
+static double expect_element(EiffelArray *array, const char *feature_name, RuntimeValue value) {
+    if (array->element_type == ARRAY_OF_INTEGER) return expect_int(array, feature_name, value);
+    return expect_number(array, feature_name, value);
+}
+
+static EiffelArray* expect_same_shape(EiffelArray *array, const char *feature_name, RuntimeValue value) {
+    if (value.type != VAL_TYPE_ARRAY || !value.as.array_val
+        || value.as.array_val->element_type != array->element_type) {
+        array_error_feature(array, feature_name);
+    }
+    EiffelArray *other = value.as.array_val;
+    if (strcmp(feature_name, "copy") != 0 && array_count(other) != array_count(array)) {
+        fprintf(stderr, "Error: %s.%s requiere arrays del mismo tamaño (%d y %d).\n",
+                array->type_name, feature_name, array_count(array), array_count(other));
+        runtime_abort();
+    }
+    return other;
+}
+
+static size_t checked_index(EiffelArray *array, int index) {
+    if (index < array->lower || index > array->upper) {
+        fprintf(stderr, "Error: Índice %d fuera de los límites [%d, %d] de %s.\n",
+                index, array->lower, array->upper, array->type_name);
+        runtime_abort();
+    }
+    return (size_t)(index - array->lower);
+}
+
+static RuntimeValue element_value(EiffelArray *array, size_t offset) {
+    RuntimeValue value;
+    if (array->element_type == ARRAY_OF_INTEGER) {
+        value.type = VAL_TYPE_INT;
+        value.as.int_val = array->data.ints[offset];
+    } else if (array->element_type == ARRAY_OF_STRING) {
+        // El que llama es dueño de la copia, como al leer una variable STRING
+        const char *item = array->data.strings[offset];
+        value.type = VAL_TYPE_STRING;
+        value.as.string_val = mem_strdup(MEM_STRING, item ? item : "");
+    } else {
+        value.type = VAL_TYPE_REAL;
+        value.as.real_val = array->data.reals[offset];
+    }
+    return value;
+}
+
+static void store_element(EiffelArray *array, size_t offset, double number) {
+    if (array->element_type == ARRAY_OF_INTEGER) array->data.ints[offset] = (int)number;
+    else array->data.reals[offset] = number;
+}
+
+static void fill_strings(EiffelArray *array, const char *value) {
+    size_t count = (size_t)array_count(array);
+    for (size_t i = 0; i < count; i++) {
+        mem_free(MEM_STRING, array->data.strings[i]);
+        array->data.strings[i] = mem_strdup(MEM_STRING, value);
+    }
+}
+
+/* Comandos de ARRAY [STRING] que difieren de los numéricos (cada elemento es un string propio).
+   Devuelve 0 si la feature no es uno de ellos. */
+static int string_array_command(EiffelArray *array, const char *feature_name, RuntimeValue *args, int arg_count) {
+    if (strcmp(feature_name, "make_filled") == 0 && arg_count == 3) {
+        const char *value = expect_string(array, feature_name, args[0]);
+        resize_storage(array, expect_int(array, feature_name, args[1]), expect_int(array, feature_name, args[2]));
+        fill_strings(array, value);
+    } else if (strcmp(feature_name, "put") == 0 && arg_count == 2) {
+        const char *value = expect_string(array, feature_name, args[0]);
+        size_t offset = checked_index(array, expect_int(array, feature_name, args[1]));
+        mem_free(MEM_STRING, array->data.strings[offset]);
+        array->data.strings[offset] = mem_strdup(MEM_STRING, value);
+    } else if (strcmp(feature_name, "fill") == 0 && arg_count == 1) {
+        fill_strings(array, expect_string(array, feature_name, args[0]));
+    } else if (strcmp(feature_name, "copy") == 0 && arg_count == 1) {
+        EiffelArray *other = expect_same_shape(array, feature_name, args[0]);
+        if (other != array) {
+            resize_storage(array, other->lower, other->upper);
+            size_t count = (size_t)array_count(array);
+            for (size_t i = 0; i < count; i++) {
+                if (other->data.strings[i]) array->data.strings[i] = mem_strdup(MEM_STRING, other->data.strings[i]);
+            }
+        }
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+RuntimeValue array_call_feature(EiffelArray *array, const char *feature_name, RuntimeValue *args, int arg_count) {
+    const ArrayKernels *k = select_kernels();
+    RuntimeValue result = { .type = VAL_TYPE_VOID };
+    size_t count = (size_t)array_count(array);
+    int is_int = array->element_type == ARRAY_OF_INTEGER;
+
+    if (strcmp(feature_name, "make") == 0 && arg_count == 2) {
+        resize_storage(array, expect_int(array, feature_name, args[0]), expect_int(array, feature_name, args[1]));
+    } else if (array->element_type == ARRAY_OF_STRING && string_array_command(array, feature_name, args, arg_count)) {
+        // make_filled, put, fill o copy sobre ARRAY [STRING]
+    } else if (strcmp(feature_name, "make_filled") == 0 && arg_count == 3) {
+        double value = expect_element(array, feature_name, args[0]);
+        resize_storage(array, expect_int(array, feature_name, args[1]), expect_int(array, feature_name, args[2]));
+        count = (size_t)array_count(array);
+        if (is_int) k->fill_int(array->data.ints, count, (int)value);
+        else k->fill_real(array->data.reals, count, value);
+    } else if (strcmp(feature_name, "count") == 0 && arg_count == 0) {
+        result.type = VAL_TYPE_INT;
+        result.as.int_val = (int)count;
+    } else if (strcmp(feature_name, "lower") == 0 && arg_count == 0) {
+        result.type = VAL_TYPE_INT;
+        result.as.int_val = array->lower;
+    } else if (strcmp(feature_name, "upper") == 0 && arg_count == 0) {
+        result.type = VAL_TYPE_INT;
+        result.as.int_val = array->upper;
+    } else if (strcmp(feature_name, "valid_index") == 0 && arg_count == 1) {
+        int index = expect_int(array, feature_name, args[0]);
+        result.type = VAL_TYPE_BOOLEAN;
+        result.as.int_val = index >= array->lower && index <= array->upper;
+    } else if (strcmp(feature_name, "item") == 0 && arg_count == 1) {
+        result = element_value(array, checked_index(array, expect_int(array, feature_name, args[0])));
+    } else if (array->element_type == ARRAY_OF_STRING) {
+        array_error_feature(array, feature_name); // sum, min, max, add, ... no aplican a STRING
+    } else if (strcmp(feature_name, "put") == 0 && arg_count == 2) {
+        double value = expect_element(array, feature_name, args[0]);
+        store_element(array, checked_index(array, expect_int(array, feature_name, args[1])), value);
+    } else if (strcmp(feature_name, "fill") == 0 && arg_count == 1) {
+        double value = expect_element(array, feature_name, args[0]);
+        if (is_int) k->fill_int(array->data.ints, count, (int)value);
+        else k->fill_real(array->data.reals, count, value);
+    } else if (strcmp(feature_name, "sum") == 0 && arg_count == 0) {
+        if (is_int) {
+            result.type = VAL_TYPE_INT;
+            result.as.int_val = k->sum_int(array->data.ints, count);
+        } else {
+            result.type = VAL_TYPE_REAL;
+            result.as.real_val = k->sum_real(array->data.reals, count);
+        }
+    } else if ((strcmp(feature_name, "min") == 0 || strcmp(feature_name, "max") == 0) && arg_count == 0) {
+        if (count == 0) {
+            fprintf(stderr, "Error: %s.%s sobre un array vacío.\n", array->type_name, feature_name);
+            runtime_abort();
+        }
+        int is_min = feature_name[1] == 'i';
+        if (is_int) {
+            result.type = VAL_TYPE_INT;
+            result.as.int_val = is_min ? k->min_int(array->data.ints, count) : k->max_int(array->data.ints, count);
+        } else {
+            result.type = VAL_TYPE_REAL;
+            result.as.real_val = is_min ? k->min_real(array->data.reals, count) : k->max_real(array->data.reals, count);
+        }
+    } else if (strcmp(feature_name, "copy") == 0 && arg_count == 1) {
+        EiffelArray *other = expect_same_shape(array, feature_name, args[0]);
+        if (other != array) {
+            resize_storage(array, other->lower, other->upper);
+            if (array_count(other)) memcpy(array->data.raw, other->data.raw, array_count(other) * element_size(other));
+        }
+    } else if ((strcmp(feature_name, "add") == 0 || strcmp(feature_name, "subtract") == 0
+                || strcmp(feature_name, "multiply") == 0) && arg_count == 1) {
+        EiffelArray *other = expect_same_shape(array, feature_name, args[0]);
+        char op = feature_name[0];
+        if (is_int) {
+            if (op == 'a') k->add_int(array->data.ints, other->data.ints, count);
+            else if (op == 's') k->sub_int(array->data.ints, other->data.ints, count);
+            else k->mul_int(array->data.ints, other->data.ints, count);
+        } else {
+            if (op == 'a') k->add_real(array->data.reals, other->data.reals, count);
+            else if (op == 's') k->sub_real(array->data.reals, other->data.reals, count);
+            else k->mul_real(array->data.reals, other->data.reals, count);
+        }
+    } else {
+        array_error_feature(array, feature_name);
+    }
+    return result;
+}
@@ -0,0 +1,51 @@
+#ifndef ARRAY_H
+#define ARRAY_H
+
+#include "interpreter.h"
+
+/* Comentario general:
+   - ARRAY [INTEGER], ARRAY [REAL] y ARRAY [STRING] son clases predefinidas: no tienen AST, sus
+     features se implementan en C (array.c).
+   - Los elementos se guardan sin boxing en un bloque contiguo y alineado, indexado de lower a upper.
+     ARRAY [STRING] guarda punteros propios (copias); un elemento nunca asignado vale "".
+   - Las operaciones masivas (fill, sum, min/max, aritmética elemento a elemento) usan kernels
+     AVX2/SSE2 elegidos en tiempo de ejecución, con versión escalar como respaldo.
+*/
+
+typedef enum {
+    ARRAY_OF_INTEGER,
+    ARRAY_OF_REAL,
+    ARRAY_OF_STRING
+} ArrayElementType;
+
+typedef struct EiffelArray {
+    ArrayElementType element_type;
+    char *type_name;     // Ej. "ARRAY [INTEGER]"
+    int lower;
+    int upper;           // count = upper - lower + 1 (vacío si upper < lower)
+    union {
+        int *ints;
+        double *reals;
+        char **strings;
+        void *raw;
+    } data;
+} EiffelArray;
+
+// Devuelve 1 si type_name es un ARRAY predefinido (ARRAY [INTEGER], ARRAY [REAL] o ARRAY [STRING])
+int is_array_type(const char *type_name);
+
+// Crea un array vacío (lower = 1, upper = 0) del tipo indicado, o NULL si el tipo no es soportado
+EiffelArray* create_array(const char *type_name);
+
+int array_count(const EiffelArray *array);
+
+/* array_call_feature: ejecuta una feature de ARRAY sobre argumentos ya evaluados.
+   - Creación: make (lower, upper), make_filled (valor, lower, upper)
+   - Consultas: count, lower, upper, item (i), valid_index (i), sum, min, max
+   - Comandos: put (valor, i), fill (valor), copy (otro), add (otro), subtract (otro), multiply (otro)
+   ARRAY [STRING] solo admite creación, consultas de límites, item, put, fill y copy.
+   Los errores (índice fuera de rango, feature desconocida, tamaños distintos) llaman a runtime_abort.
+*/
+RuntimeValue array_call_feature(EiffelArray *array, const char *feature_name, RuntimeValue *args, int arg_count);
+
+#endif // ARRAY_H
@@ -2,9 +2,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include "ast.h"
+#include "memstats.h"
 
 /* Comentario general:
-   - Este archivo implementa "constructores" de nodos del AST, utilidades (append/reverse)
+   - Este archivo implementa "constructores" de nodos del AST, utilidades (append)
      y funciones para imprimir y liberar el AST.
    - Las funciones create_* devuelven punteros a nodos ya inicializados.
 */
@@ -13,7 +14,7 @@
 
 AstNode* create_int_literal_node(int value) {
     /* Crea un nodo literal entero */
-    LiteralNode* node = malloc(sizeof(LiteralNode));
+    LiteralNode* node = mem_alloc(MEM_AST, sizeof(LiteralNode));
     node->base.type = NODE_TYPE_LITERAL;
     node->literal_type = LITERAL_TYPE_INT;
     node->value.int_val = value;
@@ -22,7 +23,7 @@ AstNode* create_int_literal_node(int value) {
 
 AstNode* create_real_literal_node(double value) {
     /* Crea un nodo literal real */
-    LiteralNode* node = malloc(sizeof(LiteralNode));
+    LiteralNode* node = mem_alloc(MEM_AST, sizeof(LiteralNode));
     node->base.type = NODE_TYPE_LITERAL;
     node->literal_type = LITERAL_TYPE_REAL;
     node->value.real_val = value;
@@ -31,18 +32,39 @@ AstNode* create_real_literal_node(double value) {
 
 AstNode* create_string_literal_node(char* value) {
     /* Crea un nodo literal de cadena */
-    LiteralNode* node = malloc(sizeof(LiteralNode));
+    LiteralNode* node = mem_alloc(MEM_AST, sizeof(LiteralNode));
     node->base.type = NODE_TYPE_LITERAL;
     node->literal_type = LITERAL_TYPE_STRING;
     node->value.string_val = value;
     return (AstNode*)node;
 }
 
+AstNode* create_boolean_literal_node(int value) {
+    /* Crea un nodo literal BOOLEAN (True/False) */
+    LiteralNode* node = mem_alloc(MEM_AST, sizeof(LiteralNode));
+    node->base.type = NODE_TYPE_LITERAL;
+    node->literal_type = LITERAL_TYPE_BOOLEAN;
+    node->value.int_val = value != 0;
+    return (AstNode*)node;
+}
+
+AstNode* create_boolean_expr_node(BooleanOp op, AstNode* left, AstNode* right) {
+    /* Crea un nodo de expresión BOOLEAN (right es NULL en 'not') */
+    BooleanExprNode* node = mem_alloc(MEM_AST, sizeof(BooleanExprNode));
+    node->base.type = NODE_TYPE_BOOLEAN_EXPR;
+    node->op = op;
+    node->left = left;
+    node->right = right;
+    return (AstNode*)node;
+}
+
 AstNode* create_binary_expr_node(char op, AstNode* left, AstNode* right) {
     /* Crea un nodo de expresión binaria */
-    BinaryExprNode* node = malloc(sizeof(BinaryExprNode));
+    BinaryExprNode* node = mem_alloc(MEM_AST, sizeof(BinaryExprNode));
     node->base.type = NODE_TYPE_BINARY_EXPR;
     node->op = op;
+    atomic_init(&node->quick, QUICK_UNSEEN);
+    atomic_init(&node->deopts, 0);
     node->left = left;
     node->right = right;
     return (AstNode*)node;
@@ -50,46 +72,67 @@ AstNode* create_binary_expr_node(char op, AstNode* left, AstNode* right) {
 
 AstNode* create_procedure_call_node(char* name, ArgumentListNode* args) {
     /* Crea un nodo de llamada a procedimiento */
-    ProcedureCallNode* node = malloc(sizeof(ProcedureCallNode));
+    ProcedureCallNode* node = mem_alloc(MEM_AST, sizeof(ProcedureCallNode));
     node->base.type = NODE_TYPE_PROCEDURE_CALL;
     node->name = name;
     node->arguments = args;
+    node->bound_class = NULL;
+    node->bound_feature = NULL;
     return (AstNode*)node;
 }
 
-ArgumentListNode* create_argument_list_node(AstNode* arg, ArgumentListNode* next) {
-    /* Crea un nodo de lista de argumentos */
-    ArgumentListNode* node = malloc(sizeof(ArgumentListNode));
+/* Capacidad inicial de las listas: la mayoría de los cuerpos y llamadas son cortos */
+#define LIST_INITIAL_CAPACITY 4
+
+ArgumentListNode* create_argument_list_node(AstNode* arg) {
+    /* Crea un nodo de lista de argumentos con un primer argumento */
+    ArgumentListNode* node = mem_alloc(MEM_AST, sizeof(ArgumentListNode) + LIST_INITIAL_CAPACITY * sizeof(AstNode*));
     node->base.type = NODE_TYPE_ARGUMENT_LIST;
-    node->argument = arg;
-    node->next = next;
+    node->count = 1;
+    node->capacity = LIST_INITIAL_CAPACITY;
+    node->arguments[0] = arg;
     return node;
 }
 
-StatementListNode* append_to_statement_list(StatementListNode* list, AstNode* stmt) {
-    /* Añade una sentencia al final de la lista de sentencias */
+ArgumentListNode* append_to_argument_list(ArgumentListNode* list, AstNode* arg) {
+    /* Añade un argumento al final; duplica la capacidad cuando se llena */
     if (list == NULL) {
-        return create_statement_list_node(stmt, NULL);
+        return create_argument_list_node(arg);
     }
-    StatementListNode* current = list;
-    while (current->next != NULL) {
-        current = current->next;
+    if (list->count == list->capacity) {
+        list->capacity *= 2;
+        list = mem_realloc(MEM_AST, list, sizeof(ArgumentListNode) + list->capacity * sizeof(AstNode*));
     }
-    current->next = create_statement_list_node(stmt, NULL);
+    list->arguments[list->count++] = arg;
     return list;
 }
-StatementListNode* create_statement_list_node(AstNode* stmt, StatementListNode* next) {
-    /* Crea un nodo de lista de sentencias */
-    StatementListNode* node = malloc(sizeof(StatementListNode));
+
+StatementListNode* create_statement_list_node(AstNode* stmt) {
+    /* Crea un nodo de lista de sentencias con una primera sentencia */
+    StatementListNode* node = mem_alloc(MEM_AST, sizeof(StatementListNode) + LIST_INITIAL_CAPACITY * sizeof(AstNode*));
     node->base.type = NODE_TYPE_STATEMENT_LIST;
-    node->statement = stmt;
-    node->next = next;
+    node->count = 1;
+    node->capacity = LIST_INITIAL_CAPACITY;
+    node->statements[0] = stmt;
     return node;
 }
 
+StatementListNode* append_to_statement_list(StatementListNode* list, AstNode* stmt) {
+    /* Añade una sentencia al final de la lista; duplica la capacidad cuando se llena */
+    if (list == NULL) {
+        return create_statement_list_node(stmt);
+    }
+    if (list->count == list->capacity) {
+        list->capacity *= 2;
+        list = mem_realloc(MEM_AST, list, sizeof(StatementListNode) + list->capacity * sizeof(AstNode*));
+    }
+    list->statements[list->count++] = stmt;
+    return list;
+}
+
 AstNode* create_assign_node(AstNode* target, AstNode* expr) {
     /* Crea un nodo de asignación */
-    AssignNode* node = malloc(sizeof(AssignNode));
+    AssignNode* node = mem_alloc(MEM_AST, sizeof(AssignNode));
     node->base.type = NODE_TYPE_ASSIGN;
     node->target = target;
     node->expression = expr;
@@ -98,15 +141,32 @@ AstNode* create_assign_node(AstNode* target, AstNode* expr) {
 
 AstNode* create_variable_node(char* name) {
     /* Crea un nodo de variable */
-    VariableNode* node = malloc(sizeof(VariableNode));
+    VariableNode* node = mem_alloc(MEM_AST, sizeof(VariableNode));
     node->base.type = NODE_TYPE_VARIABLE;
     node->name = name;
     return (AstNode*)node;
 }
 
+AstNode* create_inline_slot_node(int slot) {
+    /* Crea un lugar del frame de un cuerpo empalmado (ver inline.h) */
+    InlineSlotNode* node = mem_alloc(MEM_AST, sizeof(InlineSlotNode));
+    node->base.type = NODE_TYPE_INLINE_SLOT;
+    node->slot = slot;
+    return (AstNode*)node;
+}
+
+AstNode* create_inline_field_node(char* name, int index) {
+    /* Crea un atributo del objeto que recibe un cuerpo empalmado (name NULL: Current) */
+    InlineFieldNode* node = mem_alloc(MEM_AST, sizeof(InlineFieldNode));
+    node->base.type = NODE_TYPE_INLINE_FIELD;
+    node->name = name;
+    node->index = index;
+    return (AstNode*)node;
+}
+
 AstNode* create_if_node(AstNode* condition, StatementListNode* then_branch, StatementListNode* else_branch) {
     /* Crea un nodo de estructura if-then-else */
-    IfNode* node = malloc(sizeof(IfNode));
+    IfNode* node = mem_alloc(MEM_AST, sizeof(IfNode));
     node->base.type = NODE_TYPE_IF;
     node->condition = condition;
     node->then_branch = then_branch;
@@ -116,9 +176,11 @@ AstNode* create_if_node(AstNode* condition, StatementListNode* then_branch, Stat
 
 AstNode* create_comparison_expr_node(int op, AstNode* left, AstNode* right) {
     /* Crea un nodo de expresión de comparación */
-    ComparisonExprNode* node = malloc(sizeof(ComparisonExprNode));
+    ComparisonExprNode* node = mem_alloc(MEM_AST, sizeof(ComparisonExprNode));
     node->base.type = NODE_TYPE_COMPARISON_EXPR;
     node->op = op;
+    atomic_init(&node->quick, QUICK_UNSEEN);
+    atomic_init(&node->deopts, 0);
     node->left = left;
     node->right = right;
     return (AstNode*)node;
@@ -126,7 +188,7 @@ AstNode* create_comparison_expr_node(int op, AstNode* left, AstNode* right) {
 
 AstNode* create_loop_node(StatementListNode* init, AstNode* condition, StatementListNode* body) {
     /* Crea un nodo de bucle (loop) */
-    LoopNode* node = malloc(sizeof(LoopNode));
+    LoopNode* node = mem_alloc(MEM_AST, sizeof(LoopNode));
     node->base.type = NODE_TYPE_LOOP;
     node->initialization = init;
     node->condition = condition;
@@ -134,91 +196,124 @@ AstNode* create_loop_node(StatementListNode* init, AstNode* condition, Statement
     return (AstNode*)node;
 }
 
+AstNode* create_across_node(AstNode* lower, AstNode* upper, char* cursor_name, int is_parallel, StatementListNode* body) {
+    /* Crea un nodo across sobre el intervalo lower |..| upper */
+    AcrossNode* node = mem_alloc(MEM_AST, sizeof(AcrossNode));
+    node->base.type = NODE_TYPE_ACROSS;
+    node->lower = lower;
+    node->upper = upper;
+    node->cursor_name = cursor_name;
+    node->is_parallel = is_parallel;
+    node->fallback_reported = 0;
+    node->loop_body = body;
+    return (AstNode*)node;
+}
+
 AstNode* create_attribute_access_node(AstNode* obj_node, char* attr_name) {
     /* Crea un nodo de acceso a atributo */
-    AttributeAccessNode* node = malloc(sizeof(AttributeAccessNode));
+    AttributeAccessNode* node = mem_alloc(MEM_AST, sizeof(AttributeAccessNode));
     node->base.type = NODE_TYPE_ATTRIBUTE_ACCESS;
     node->object_node = obj_node;
     node->attribute_name = attr_name;
+    node->bound_class = NULL;
+    node->bound_feature = NULL;
     return (AstNode*)node;
 }
 
 AstNode* create_method_call_node(AstNode* obj_node, char* method_name, ArgumentListNode* args) {
     /* Crea un nodo de llamada a método */
-    MethodCallNode* node = malloc(sizeof(MethodCallNode));
+    MethodCallNode* node = mem_alloc(MEM_AST, sizeof(MethodCallNode));
     node->base.type = NODE_TYPE_METHOD_CALL;
     node->object_node = obj_node;
     node->method_name = method_name;
     node->arguments = args;
+    node->bound_class = NULL;
+    node->bound_feature = NULL;
     return (AstNode*)node;
 }
 
-AstNode* create_create_node(char* obj_name) {
-    /* Crea un nodo de creación de objeto */
-    CreateNode* node = malloc(sizeof(CreateNode));
+AstNode* create_create_node(char* obj_name, char* creation_procedure, ArgumentListNode* args) {
+    /* Crea un nodo de creación de objeto (con procedimiento de creación opcional) */
+    CreateNode* node = mem_alloc(MEM_AST, sizeof(CreateNode));
     node->base.type = NODE_TYPE_CREATE;
     node->object_name = obj_name;
     node->class_name = NULL; // Se resolverá en análisis semántico (o en el intérprete por ahora)
+    node->creation_procedure = creation_procedure;
+    node->arguments = args;
+    node->frame_slot = -1;
+    node->bound_class = NULL;
+    node->bound_feature = NULL;
     return (AstNode*)node;
 }
 
-ArgumentListNode* reverse_argument_list(ArgumentListNode* list) {
-    /* Invierte una lista encadenada de argumentos (útil porque el parser construye en orden inverso) */
-    ArgumentListNode *prev = NULL, *current = list, *next = NULL;
-    while (current != NULL) {
-        next = current->next;
-        current->next = prev;
-        prev = current;
-        current = next;
-    }
-    return prev;
-}
-
 /* --- IMPLEMENTACIONES PARA DECLARACIONES --- */
 
 /* create_declaration_list_node: construye listas de declaraciones (variables) */
-DeclarationListNode* create_declaration_list_node(char* name, DeclarationListNode* next) {
-    DeclarationListNode* node = malloc(sizeof(DeclarationListNode));
+DeclarationListNode* create_declaration_list_node(char* name) {
+    DeclarationListNode* node = mem_alloc(MEM_AST, sizeof(DeclarationListNode) + LIST_INITIAL_CAPACITY * sizeof(Declaration));
     node->base.type = NODE_TYPE_DECLARATION_LIST;
-    node->variable_name = name;
-    node->type_name = NULL; // por defecto sin tipo
-    node->next = next;
+    node->count = 1;
+    node->capacity = LIST_INITIAL_CAPACITY;
+    node->items[0].variable_name = name;
+    node->items[0].type_name = NULL; // por defecto sin tipo
     return node;
 }
 
+DeclarationListNode* append_declaration(DeclarationListNode* list, char* name) {
+    /* Añade una variable (sin tipo) al final de la lista */
+    if (!list) return create_declaration_list_node(name);
+    if (list->count == list->capacity) {
+        list->capacity *= 2;
+        list = mem_realloc(MEM_AST, list, sizeof(DeclarationListNode) + list->capacity * sizeof(Declaration));
+    }
+    list->items[list->count].variable_name = name;
+    list->items[list->count].type_name = NULL;
+    list->count++;
+    return list;
+}
+
 DeclarationListNode* append_to_declaration_list(DeclarationListNode* list, DeclarationListNode* new_decls) {
-    /* Añade nuevas declaraciones al final de la lista de declaraciones */
+    /* Mueve las declaraciones de new_decls al final de list y libera el nodo new_decls */
     if (!list) return new_decls;
-    DeclarationListNode* current = list;
-    while (current->next) {
-        current = current->next;
+    if (!new_decls) return list;
+    for (int i = 0; i < new_decls->count; i++) {
+        list = append_declaration(list, new_decls->items[i].variable_name);
+        list->items[list->count - 1].type_name = new_decls->items[i].type_name;
     }
-    current->next = new_decls;
+    mem_free(MEM_AST, new_decls);
     return list;
 }
 
-/* NUEVA FUNCIÓN: asigna type_name a todos los nodos de la lista */
+/* set_declaration_type: asigna type_name a todas las declaraciones de la lista */
 void set_declaration_type(DeclarationListNode* list, char* type_name) {
-    DeclarationListNode* cur = list;
-    while (cur) {
-        if (type_name) cur->type_name = strdup(type_name);
-        cur = cur->next;
+    if (!list || !type_name) return;
+    for (int i = 0; i < list->count; i++) {
+        list->items[i].type_name = type_name; // Internado: lo comparten todas las declaraciones
     }
 }
 
 AstNode* create_feature_body_node(DeclarationListNode* decls, StatementListNode* stmts) {
     /* Crea un nodo de cuerpo de feature (con declaraciones y sentencias) */
-    FeatureBodyNode* node = malloc(sizeof(FeatureBodyNode));
+    FeatureBodyNode* node = mem_alloc(MEM_AST, sizeof(FeatureBodyNode));
     node->base.type = NODE_TYPE_FEATURE_BODY;
     node->declarations = decls;
     node->statements = stmts;
     node->feature_name = NULL;
+    node->parameters = NULL;
+    node->result_type = NULL;
+    node->routine_kind = ROUTINE_DO;
+    node->once_index = -1;
+    node->frame_slots = 0;
+    node->escape_version = -1;
+    node->inline_body = NULL;
+    node->inline_slots = 0;
+    atomic_init(&node->lazy_body, NULL);
     return (AstNode*)node;
 }
 
 AstNode* create_class_node(char* name, StatementListNode* features) {
     /* Crea un nodo de declaración de clase */
-    ClassNode* node = malloc(sizeof(ClassNode));
+    ClassNode* node = mem_alloc(MEM_AST, sizeof(ClassNode));
     node->base.type = NODE_TYPE_CLASS_DECL;
     node->name = name;
     node->features = features;
@@ -263,6 +358,7 @@ static void print_ast_internal(AstNode *node, FILE *output, int indent) {
                 case LITERAL_TYPE_INT: fprintf(output, "%d (int)\n", n->value.int_val); break;
                 case LITERAL_TYPE_REAL: fprintf(output, "%f (real)\n", n->value.real_val); break;
                 case LITERAL_TYPE_STRING: fprintf(output, "\"%s\" (string)\n", n->value.string_val); break;
+                case LITERAL_TYPE_BOOLEAN: fprintf(output, "%s (boolean)\n", n->value.int_val ? "True" : "False"); break;
             }
             break;
         }
@@ -280,6 +376,14 @@ static void print_ast_internal(AstNode *node, FILE *output, int indent) {
             print_ast_internal(n->right, output, indent + 2);
             break;
         }
+        case NODE_TYPE_BOOLEAN_EXPR: {
+            static const char *names[] = { "not", "and", "or", "and then", "or else", "implies" };
+            BooleanExprNode *n = (BooleanExprNode*)node;
+            fprintf(output, "BooleanExpr: %s\n", names[n->op]);
+            print_ast_internal(n->left, output, indent + 2);
+            if (n->right) print_ast_internal(n->right, output, indent + 2);
+            break;
+        }
         case NODE_TYPE_PROCEDURE_CALL: {
             ProcedureCallNode *n = (ProcedureCallNode*)node;
             fprintf(output, "ProcedureCall: %s\n", n->name);
@@ -300,18 +404,16 @@ static void print_ast_internal(AstNode *node, FILE *output, int indent) {
         case NODE_TYPE_ARGUMENT_LIST: {
             ArgumentListNode *list = (ArgumentListNode*)node;
             fprintf(output, "ArgumentList\n");
-            while (list) {
-                print_ast_internal(list->argument, output, indent + 2);
-                list = list->next;
+            for (int i = 0; i < list->count; i++) {
+                print_ast_internal(list->arguments[i], output, indent + 2);
             }
             break;
         }
         case NODE_TYPE_STATEMENT_LIST: {
             StatementListNode *list = (StatementListNode*)node;
             fprintf(output, "StatementList\n");
-            while (list) {
-                print_ast_internal(list->statement, output, indent + 2);
-                list = list->next;
+            for (int i = 0; i < list->count; i++) {
+                print_ast_internal(list->statements[i], output, indent + 2);
             }
             break;
         }
@@ -359,6 +461,20 @@ static void print_ast_internal(AstNode *node, FILE *output, int indent) {
             print_ast_internal((AstNode*)n->loop_body, output, indent + 4);
             break;
         }
+        case NODE_TYPE_ACROSS: {
+            AcrossNode *n = (AcrossNode*)node;
+            fprintf(output, "Across (cursor: %s%s)\n", n->cursor_name, n->is_parallel ? ", parallel" : "");
+            print_indent(output, indent + 2);
+            fprintf(output, "Lower:\n");
+            print_ast_internal(n->lower, output, indent + 4);
+            print_indent(output, indent + 2);
+            fprintf(output, "Upper:\n");
+            print_ast_internal(n->upper, output, indent + 4);
+            print_indent(output, indent + 2);
+            fprintf(output, "Body:\n");
+            print_ast_internal((AstNode*)n->loop_body, output, indent + 4);
+            break;
+        }
         case NODE_TYPE_ATTRIBUTE_ACCESS: {
             AttributeAccessNode *n = (AttributeAccessNode*)node;
             fprintf(output, "AttributeAccess: %s\n", n->attribute_name);
@@ -367,26 +483,45 @@ static void print_ast_internal(AstNode *node, FILE *output, int indent) {
         }
         case NODE_TYPE_CREATE: {
             CreateNode *n = (CreateNode*)node;
-            fprintf(output, "Create: %s\n", n->object_name);
+            if (n->creation_procedure) {
+                fprintf(output, "Create: %s.%s\n", n->object_name, n->creation_procedure);
+                print_ast_internal((AstNode*)n->arguments, output, indent + 2);
+            } else {
+                fprintf(output, "Create: %s\n", n->object_name);
+            }
             break;
         }
         case NODE_TYPE_DECLARATION_LIST: {
             DeclarationListNode *list = (DeclarationListNode*)node;
             fprintf(output, "DeclarationList\n");
-            while(list) {
+            for (int i = 0; i < list->count; i++) {
                 print_indent(output, indent + 2);
-                fprintf(output, "Var: %s, Type: %s\n", list->variable_name, list->type_name ? list->type_name : "(none)");
-                list = list->next;
+                fprintf(output, "Var: %s, Type: %s\n", list->items[i].variable_name, list->items[i].type_name ? list->items[i].type_name : "(none)");
             }
             break;
         }
         case NODE_TYPE_FEATURE_BODY: {
             FeatureBodyNode *n = (FeatureBodyNode*)node;
-            fprintf(output, "FeatureBody: %s\n", n->feature_name);
+            fprintf(output, "FeatureBody: %s%s\n", n->feature_name,
+                    n->routine_kind == ROUTINE_ONCE ? " (once)" : n->routine_kind == ROUTINE_ONCE_OBJECT ? " (once OBJECT)" : "");
+            if (n->parameters) {
+                print_indent(output, indent + 2);
+                fprintf(output, "Parameters:\n");
+                print_ast_internal((AstNode*)n->parameters, output, indent + 4);
+            }
+            if (n->result_type) {
+                print_indent(output, indent + 2);
+                fprintf(output, "Result: %s\n", n->result_type);
+            }
             print_indent(output, indent + 2);
             fprintf(output, "Declarations:\n");
             print_ast_internal((AstNode*)n->declarations, output, indent + 4);
             print_indent(output, indent + 2);
+            LazyBody *lazy = atomic_load(&n->lazy_body);
+            if (lazy) {
+                fprintf(output, "Statements: (sin parsear, %zu bytes desde la línea %d)\n", lazy->length, lazy->first_line);
+                break;
+            }
             fprintf(output, "Statements:\n");
             print_ast_internal((AstNode*)n->statements, output, indent + 4);
             break;
@@ -406,15 +541,19 @@ static void print_ast_internal(AstNode *node, FILE *output, int indent) {
 static void free_ast_internal(AstNode *node);
 
 static void free_statement_list(StatementListNode* list) {
-    StatementListNode *s = list;
-    while (s) {
-        StatementListNode *next = s->next;
-        free_ast_internal(s->statement);
-        free(s);
-        s = next;
-    }
+    if (!list) return;
+    for (int i = 0; i < list->count; i++) free_ast_internal(list->statements[i]);
+    mem_free(MEM_AST, list);
 }
 
+static void free_argument_list(ArgumentListNode* list) {
+    if (!list) return;
+    for (int i = 0; i < list->count; i++) free_ast_internal(list->arguments[i]);
+    mem_free(MEM_AST, list);
+}
+
+/* free_ast_internal: libera los nodos y los literales STRING. Los nombres (identificadores y tipos)
+   están internados (ver intern.h) y no son del AST. */
 static void free_ast_internal(AstNode *node) {
     if (!node) return;
 
@@ -423,7 +562,7 @@ static void free_ast_internal(AstNode *node) {
             /* Liberar strings si es necesario */
             LiteralNode *n = (LiteralNode*)node;
             if (n->literal_type == LITERAL_TYPE_STRING && n->value.string_val) {
-                free(n->value.string_val);
+                mem_free(MEM_STRING, n->value.string_val);
             }
             break;
         }
@@ -439,46 +578,31 @@ static void free_ast_internal(AstNode *node) {
             free_ast_internal(n->right);
             break;
         }
+        case NODE_TYPE_BOOLEAN_EXPR: {
+            BooleanExprNode *n = (BooleanExprNode*)node;
+            free_ast_internal(n->left);
+            free_ast_internal(n->right);
+            break;
+        }
         case NODE_TYPE_PROCEDURE_CALL: {
             ProcedureCallNode *n = (ProcedureCallNode*)node;
-            if (n->name) free(n->name);
-            ArgumentListNode *arg = n->arguments;
-            while (arg) {
-                ArgumentListNode *next = arg->next;
-                free_ast_internal(arg->argument);
-                free(arg);
-                arg = next;
-            }
+            free_argument_list(n->arguments);
             break;
         }
         case NODE_TYPE_METHOD_CALL: {
             MethodCallNode *n = (MethodCallNode*)node;
             free_ast_internal(n->object_node);
-            if (n->method_name) free(n->method_name);
-            ArgumentListNode *arg = n->arguments;
-            while (arg) {
-                ArgumentListNode *next = arg->next;
-                free_ast_internal(arg->argument);
-                free(arg);
-                arg = next;
-            }
+            free_argument_list(n->arguments);
             break;
         }
         case NODE_TYPE_ATTRIBUTE_ACCESS: {
             AttributeAccessNode *n = (AttributeAccessNode*)node;
             free_ast_internal(n->object_node);
-            if (n->attribute_name) free(n->attribute_name);
             break;
         }
         case NODE_TYPE_CREATE: {
             CreateNode *n = (CreateNode*)node;
-            if (n->object_name) free(n->object_name);
-            if (n->class_name) free(n->class_name);
-            break;
-        }
-        case NODE_TYPE_VARIABLE: {
-            VariableNode *n = (VariableNode*)node;
-            if (n->name) free(n->name);
+            free_argument_list(n->arguments);
             break;
         }
         case NODE_TYPE_ASSIGN: {
@@ -501,39 +625,44 @@ static void free_ast_internal(AstNode *node) {
             free_statement_list(n->loop_body);
             break;
         }
+        case NODE_TYPE_ACROSS: {
+            AcrossNode *n = (AcrossNode*)node;
+            free_ast_internal(n->lower);
+            free_ast_internal(n->upper);
+            free_statement_list(n->loop_body);
+            break;
+        }
         case NODE_TYPE_STATEMENT_LIST: {
             free_statement_list((StatementListNode*)node);
-            return; // El bucle ya libera el nodo
+            return; // free_statement_list ya libera el nodo
         }
-        case NODE_TYPE_DECLARATION_LIST: {
-            DeclarationListNode *it = (DeclarationListNode*)node;
-            while (it) {
-                DeclarationListNode *next = it->next;
-                if (it->variable_name) free(it->variable_name);
-                if (it->type_name) free(it->type_name); // LIBERAR type_name
-                free(it);
-                it = next;
-            }
-            return; // El bucle ya libera el nodo
+        case NODE_TYPE_ARGUMENT_LIST: {
+            free_argument_list((ArgumentListNode*)node);
+            return;
         }
         case NODE_TYPE_FEATURE_BODY: {
-            /* Liberar nombre de feature, declaraciones y sentencias */
+            /* Liberar argumentos, declaraciones y sentencias */
             FeatureBodyNode *n = (FeatureBodyNode*)node;
-            if (n->feature_name) free(n->feature_name);
+            if (n->parameters) free_ast_internal((AstNode*)n->parameters);
             if (n->declarations) free_ast_internal((AstNode*)n->declarations);
             if (n->statements) free_ast_internal((AstNode*)n->statements);
+            free_ast_internal(n->inline_body);
+            LazyBody *lazy = atomic_load(&n->lazy_body);
+            if (lazy) {
+                mem_free(MEM_AST, lazy->source);
+                mem_free(MEM_AST, lazy);
+            }
             break;
         }
         case NODE_TYPE_CLASS_DECL: {
             ClassNode *n = (ClassNode*)node;
-            if (n->name) free(n->name);
             if (n->features) free_ast_internal((AstNode*)n->features);
             break;
         }
         default:
             break;
     }
-    free(node);
+    mem_free(MEM_AST, node);
 }
 
 void free_ast(AstNode *node) {
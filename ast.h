@@ -2,11 +2,17 @@
 #define AST_H
 
 #include <stdio.h>
+#include <stdatomic.h>
 
 /* Comentario general:
    - Este header define los nodos del AST usados por el parser y el intérprete.
    - Cada nodo comienza con AstNode (campo 'type') para permitir dispatch por switch.
    - Hay nodos para literales, expresiones binarias, listas, llamadas, declaraciones y clases.
+   - Las listas (sentencias, argumentos, declaraciones) guardan sus elementos contiguos a
+     continuación del nodo (flexible array member): agregar al final es O(1) amortizado y
+     recorrerlas es secuencial. Una lista vacía se representa con NULL.
+   - Los nombres de los nodos (identificadores y tipos) están internados (ver intern.h): varios
+     nodos comparten el mismo string y free_ast no los libera.
 */
 
 // Tipos de nodos del AST
@@ -21,23 +27,31 @@ typedef enum {
     NODE_TYPE_IF,
     NODE_TYPE_COMPARISON_EXPR,
     NODE_TYPE_LOOP,
+    NODE_TYPE_ACROSS,
     NODE_TYPE_ATTRIBUTE_ACCESS,
     NODE_TYPE_METHOD_CALL,
     NODE_TYPE_CREATE,
     NODE_TYPE_DECLARATION_LIST,
     NODE_TYPE_FEATURE_BODY,
-    NODE_TYPE_CLASS_DECL // Nodo para una declaración de clase completa
+    NODE_TYPE_CLASS_DECL, // Nodo para una declaración de clase completa
+    NODE_TYPE_BOOLEAN_EXPR, // not, and, or, and then, or else, implies (al final: imágenes viejas)
+    NODE_TYPE_INLINE_SLOT,  // Solo en cuerpos empalmados por el enlace (ver inline.h); no van a imágenes
+    NODE_TYPE_INLINE_FIELD
 } NodeType;
 
 /* Tipos de literales:
-   - INT, REAL y STRING se manejan con union en LiteralNode.
+   - INT, REAL y STRING se manejan con union en LiteralNode; BOOLEAN (True/False) usa int_val.
 */
 typedef enum {
     LITERAL_TYPE_INT,
     LITERAL_TYPE_REAL,
-    LITERAL_TYPE_STRING
+    LITERAL_TYPE_STRING,
+    LITERAL_TYPE_BOOLEAN
 } LiteralType;
 
+struct FeatureBodyNode;
+struct ClassDefinition;
+
 /* Estructura base para nodos del AST */
 typedef struct AstNode {
     NodeType type;
@@ -54,41 +68,93 @@ typedef struct {
     } value;
 } LiteralNode;
 
-/* Nodo para expresiones binarias (ej. a + b) */
+/* Variantes especializadas ("quickening") de las expresiones binarias y comparaciones.
+   - Un nodo nuevo está en QUICK_UNSEEN; su primera ejecución pasa por el camino general y lo
+     reescribe con la variante de los tipos que vio (ej. QUICK_INT_ADD).
+   - Cada variante verifica los tipos (guarda): si no coinciden se desoptimiza al camino general y
+     se vuelve a especializar; después de QUICK_MAX_DEOPTS fallas queda en QUICK_GENERIC.
+   - Ver eval_binary y eval_comparison en interpreter.c.
+*/
+typedef enum {
+    QUICK_UNSEEN,
+    QUICK_GENERIC,
+    // Expresiones binarias
+    QUICK_INT_ADD, QUICK_INT_SUB, QUICK_INT_MUL, QUICK_INT_DIV,
+    QUICK_REAL_ADD, QUICK_REAL_SUB, QUICK_REAL_MUL, QUICK_REAL_DIV,
+    QUICK_MIXED,   // INTEGER con REAL (en cualquier orden): se opera como REAL
+    QUICK_CONCAT,  // STRING + STRING
+    // Comparaciones
+    QUICK_CMP_INT,
+    QUICK_CMP_NUMERIC, // Al menos un REAL
+    QUICK_CMP_STRING
+} QuickOp;
+
+#define QUICK_MAX_DEOPTS 4
+
+/* Nodo para expresiones binarias (ej. a + b).
+   quick y deopts son atómicos porque un across paralelo evalúa el mismo nodo en varios hilos. */
 typedef struct {
     AstNode base;
     char op;
+    atomic_uchar quick;  // QuickOp
+    atomic_uchar deopts;
     struct AstNode *left;
     struct AstNode *right;
 } BinaryExprNode;
 
-/* Nodo para expresiones de comparación (ej. a > b) */
+/* Nodo para expresiones de comparación (ej. a > b); quick y deopts como en BinaryExprNode */
 typedef struct {
     AstNode base;
     int op;
+    atomic_uchar quick;
+    atomic_uchar deopts;
     struct AstNode *left;
     struct AstNode *right;
 } ComparisonExprNode;
 
-/* Nodo para una lista de argumentos (encadenada) */
+/* Operadores BOOLEAN. AND_THEN, OR_ELSE e IMPLIES evalúan el operando derecho solo si el
+   izquierdo no decide el resultado; AND y OR evalúan los dos. */
+typedef enum {
+    BOOL_NOT,
+    BOOL_AND,
+    BOOL_OR,
+    BOOL_AND_THEN,
+    BOOL_OR_ELSE,
+    BOOL_IMPLIES
+} BooleanOp;
+
+/* Nodo para expresiones BOOLEAN (ej. a and then b); en 'not' right es NULL */
+typedef struct {
+    AstNode base;
+    BooleanOp op;
+    struct AstNode *left;
+    struct AstNode *right;
+} BooleanExprNode;
+
+/* Nodo para una lista de argumentos (en orden) */
 typedef struct ArgumentListNode {
     AstNode base;
-    AstNode *argument;
-    struct ArgumentListNode *next;
+    int count;
+    int capacity;
+    AstNode *arguments[];
 } ArgumentListNode;
 
-/* Llamada a procedimiento global (ej. print("hola")) */
+/* Llamada a procedimiento global (ej. print("hola")) o a una rutina de Current sin objeto.
+   bound_class/bound_feature: rutina enlazada por link.c (NULL si se busca al ejecutar). */
 typedef struct {
     AstNode base;
     char *name;
     ArgumentListNode *arguments;
+    struct ClassDefinition *bound_class;
+    struct FeatureBodyNode *bound_feature;
 } ProcedureCallNode;
 
 /* Lista de sentencias (cuerpo de métodos o bloques) */
 typedef struct StatementListNode {
     AstNode base;
-    AstNode *statement;
-    struct StatementListNode *next;
+    int count;
+    int capacity;
+    AstNode *statements[];
 } StatementListNode;
 
 /* Nodo para if-then-else */
@@ -114,6 +180,20 @@ typedef struct {
     char *name;
 } VariableNode;
 
+/* Nodos de un cuerpo empalmado (ver inline.h), armados por el enlace y nunca por el parser:
+   InlineSlotNode es un argumento, 'Result' o una variable del cuerpo en el frame de la llamada;
+   InlineFieldNode, un atributo del objeto que recibe la llamada por su lugar en el prototipo. */
+typedef struct {
+    AstNode base;
+    int slot;
+} InlineSlotNode;
+
+typedef struct {
+    AstNode base;
+    char *name;  // El del prototipo de la clase; NULL para Current (el objeto mismo)
+    int index;   // Lugar del atributo en el prototipo; -1 para Current
+} InlineFieldNode;
+
 /* Bucle from-until: initializations, condition, body */
 typedef struct {
     AstNode base;
@@ -122,42 +202,98 @@ typedef struct {
     StatementListNode *loop_body;
 } LoopNode;
 
-/* Acceso a atributos: objeto.atributo */
+/* Bucle across sobre un intervalo: across lower |..| upper as cursor [parallel] loop body end
+   - is_parallel: las iteraciones se reparten entre los hilos del pool (ver parallel.h)
+*/
+typedef struct {
+    AstNode base;
+    AstNode *lower;
+    AstNode *upper;
+    char *cursor_name;
+    int is_parallel;
+    int fallback_reported; // Ya se avisó que este across paralelo corre en secuencia
+    StatementListNode *loop_body;
+} AcrossNode;
+
+/* Acceso a atributos: objeto.atributo (o llamada a una rutina sin argumentos, enlazada como en
+   ProcedureCallNode si link.c conoce la clase del objeto) */
 typedef struct {
     AstNode base;
     AstNode *object_node;
     char *attribute_name;
+    struct ClassDefinition *bound_class;
+    struct FeatureBodyNode *bound_feature;
 } AttributeAccessNode;
 
-/* Llamada a método: objeto.method(args) */
+/* Llamada a método: objeto.method(args); bound_* como en AttributeAccessNode */
 typedef struct {
     AstNode base;
     AstNode *object_node;
     char *method_name;
     ArgumentListNode *arguments;
+    struct ClassDefinition *bound_class;
+    struct FeatureBodyNode *bound_feature;
 } MethodCallNode;
 
-/* 'create' crea una instancia y la asigna a un nombre */
+/* 'create' crea una instancia y la asigna a un nombre.
+   - Opcionalmente invoca un procedimiento de creación: create a.make (1, 10)
+*/
 typedef struct {
     AstNode base;
     char *object_name;
     char *class_name; // Nombre de clase asociado (si se resuelve)
+    char *creation_procedure; // NULL si es un 'create x' simple
+    ArgumentListNode *arguments;
+    int frame_slot; // Posición en el frame del método si el objeto no escapa (ver escape.h); -1: heap
+    struct ClassDefinition *bound_class;   // Clase y procedimiento de creación enlazados por link.c
+    struct FeatureBodyNode *bound_feature;
 } CreateNode;
 
-/* Lista de declaraciones de variables (nombre + tipo opcional) */
-typedef struct DeclarationListNode {
-    AstNode base;
+/* Declaración de una variable (nombre + tipo opcional) */
+typedef struct {
     char *variable_name;
     char *type_name; // Nombre del tipo (ej. "INTEGER" o nombre de clase)
-    struct DeclarationListNode *next;
+} Declaration;
+
+/* Lista de declaraciones de variables */
+typedef struct DeclarationListNode {
+    AstNode base;
+    int count;
+    int capacity;
+    Declaration items[];
 } DeclarationListNode;
 
+/* Forma de ejecutar una rutina: do (cada llamada) u once (la primera vez, después devuelve el
+   mismo resultado). once guarda el resultado en la clase; once ("OBJECT"), en cada objeto. */
+typedef enum {
+    ROUTINE_DO,
+    ROUTINE_ONCE,
+    ROUTINE_ONCE_OBJECT
+} RoutineKind;
+
+/* Cuerpo de una rutina que todavía no se parseó (cuerpos diferidos, ver frontend.h): el texto
+   entre 'do'/'once' y su 'end', y la línea donde empieza */
+typedef struct LazyBody {
+    char *source;
+    size_t length;
+    int first_line;
+} LazyBody;
+
 /* Cuerpo de feature/método: nombre, declaraciones y sentencias */
-typedef struct {
+typedef struct FeatureBodyNode {
     AstNode base;
     char *feature_name; // Nombre del método/feature
+    DeclarationListNode *parameters; // Argumentos formales (NULL si no tiene)
+    char *result_type;  // Tipo de 'Result' en una función; NULL en un procedimiento
+    RoutineKind routine_kind;
+    int once_index;     // Lugar de su resultado en los once de la clase o del objeto; -1 si es do
     DeclarationListNode *declarations;
     StatementListNode *statements;
+    int frame_slots;     // Objetos que el método aloja en su frame (resultado del análisis de escape)
+    int escape_version;  // Versión de las clases con la que se analizó; -1: sin analizar
+    AstNode *inline_body; // Cuerpo empalmado por el enlace (ver inline.h); NULL: se llama normalmente
+    int inline_slots;     // Lugares del frame del cuerpo empalmado: argumentos, 'Result' y variables
+    _Atomic(LazyBody *) lazy_body; // Cuerpo sin parsear (statements es NULL); NULL una vez parseado
 } FeatureBodyNode;
 
 /* Nodo para declaración de clase:
@@ -174,23 +310,30 @@ AstNode* create_binary_expr_node(char op, AstNode* left, AstNode* right);
 AstNode* create_int_literal_node(int value);
 AstNode* create_real_literal_node(double value);
 AstNode* create_string_literal_node(char* value);
+AstNode* create_boolean_literal_node(int value);
+AstNode* create_boolean_expr_node(BooleanOp op, AstNode* left, AstNode* right);
 AstNode* create_procedure_call_node(char* name, ArgumentListNode* args);
-ArgumentListNode* create_argument_list_node(AstNode* arg, ArgumentListNode* next);
-StatementListNode* create_statement_list_node(AstNode* stmt, StatementListNode* next);
+// Las funciones append_* pueden mover la lista (realloc): siempre usar el puntero que devuelven
+ArgumentListNode* create_argument_list_node(AstNode* arg);
+ArgumentListNode* append_to_argument_list(ArgumentListNode* list, AstNode* arg);
+StatementListNode* create_statement_list_node(AstNode* stmt);
 StatementListNode* append_to_statement_list(StatementListNode* list, AstNode* stmt);
 AstNode* create_assign_node(AstNode* target, AstNode* expr);
 AstNode* create_variable_node(char* name);
+AstNode* create_inline_slot_node(int slot);
+AstNode* create_inline_field_node(char* name, int index);
 AstNode* create_if_node(AstNode* condition, StatementListNode* then_branch, StatementListNode* else_branch);
 AstNode* create_comparison_expr_node(int op, AstNode* left, AstNode* right);
 AstNode* create_loop_node(StatementListNode* init, AstNode* condition, StatementListNode* body);
-AstNode* create_create_node(char* obj_name);
-ArgumentListNode* reverse_argument_list(ArgumentListNode* list);
+AstNode* create_across_node(AstNode* lower, AstNode* upper, char* cursor_name, int is_parallel, StatementListNode* body);
+AstNode* create_create_node(char* obj_name, char* creation_procedure, ArgumentListNode* args);
 
 AstNode* create_attribute_access_node(AstNode* obj_node, char* attr_name);
 AstNode* create_method_call_node(AstNode* obj_node, char* method_name, ArgumentListNode* args);
 
-DeclarationListNode* create_declaration_list_node(char* name, DeclarationListNode* next);
-DeclarationListNode* append_to_declaration_list(DeclarationListNode* list, DeclarationListNode* new_decls);
+DeclarationListNode* create_declaration_list_node(char* name);
+DeclarationListNode* append_declaration(DeclarationListNode* list, char* name);
+DeclarationListNode* append_to_declaration_list(DeclarationListNode* list, DeclarationListNode* new_decls); // Libera new_decls
 void set_declaration_type(DeclarationListNode* list, char* type_name); // NUEVO
 AstNode* create_feature_body_node(DeclarationListNode* decls, StatementListNode* stmts);
 AstNode* create_class_node(char* name, StatementListNode* features); // Nuevo prototipo
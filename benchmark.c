@@ -0,0 +1,330 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "ast.h"
+#include "interpreter.h"
+#include "token_utils.h"
+#include "memstats.h"
+#include "frontend.h"
+
+/* Comentario general:
+   - Generador de programas Eiffel sintéticos y benchmark de escala del front end.
+   - './frontend_bench --generate [opciones]' escribe un programa en stdout (se puede ejecutar con
+     ./interpreter): N clases con F features cada una (atributos y métodos de S sentencias), con
+     if/from anidados hasta la profundidad D. El contenido depende solo de las opciones y la semilla.
+   - './frontend_bench [opciones]' duplica la cantidad de clases desde 1 hasta --max-classes y mide
+     por separado lexer, parser, registro de clases, print_ast y free_ast (el mejor de --repeat
+     corridas). Imprime una tabla, un gráfico de ns por sentencia (plano = lineal) y el exponente de
+     crecimiento de cada fase: la pendiente log-log (mínimos cuadrados) sobre la mitad más grande
+     de los tamaños, donde el costo fijo ya no pesa.
+   - Con --check termina con código 1 si alguna fase crece en forma superlineal.
+*/
+
+typedef struct yy_buffer_state *YY_BUFFER_STATE;
+extern int yylex_init_extra(ParseContext *extra, yyscan_t *scanner);
+extern int yylex_destroy(yyscan_t scanner);
+extern YY_BUFFER_STATE yy_scan_bytes(const char *bytes, int len, yyscan_t scanner);
+extern void yy_delete_buffer(YY_BUFFER_STATE buffer, yyscan_t scanner);
+extern int yylex(YYSTYPE *yylval, yyscan_t scanner);
+
+// Exponente a partir del cual una fase se considera superlineal (el ruido de medición ronda ±0.1)
+#define SUPERLINEAR_EXPONENT 1.3
+
+typedef struct {
+    int classes;
+    int features;   // Por clase (la mitad atributos, la mitad métodos; al menos un método)
+    int statements; // Sentencias de nivel superior por método
+    int depth;      // Anidamiento máximo de if/from
+    unsigned seed;
+    const char *prefix; // Prefijo de los nombres de clase (evita choques entre corridas)
+} GenOptions;
+
+typedef struct {
+    FILE *out;
+    unsigned state;
+    long statements; // Sentencias emitidas (incluidas las anidadas)
+} Generator;
+
+static unsigned next_random(Generator *g) {
+    g->state = g->state * 1103515245u + 12345u;
+    return (g->state >> 16) & 0x7fff;
+}
+
+static void indent(Generator *g, int level) {
+    for (int i = 0; i < level; i++) fputs("   ", g->out);
+}
+
+static void emit_statement(Generator *g, const GenOptions *o, int level, int depth_left, int loop_depth);
+
+static void emit_block(Generator *g, const GenOptions *o, int level, int depth_left, int loop_depth) {
+    int count = 1 + (int)(next_random(g) % 2);
+    for (int i = 0; i < count; i++) emit_statement(g, o, level, depth_left, loop_depth);
+}
+
+static void emit_statement(Generator *g, const GenOptions *o, int level, int depth_left, int loop_depth) {
+    unsigned kind = next_random(g) % 10;
+    g->statements++;
+    indent(g, level);
+    if (depth_left > 0 && kind == 0) {
+        fprintf(g->out, "if x > %u then\n", next_random(g) % 100);
+        emit_block(g, o, level + 1, depth_left - 1, loop_depth);
+        indent(g, level);
+        fprintf(g->out, "else\n");
+        emit_block(g, o, level + 1, depth_left - 1, loop_depth);
+        indent(g, level);
+        fprintf(g->out, "end\n");
+    } else if (depth_left > 0 && kind == 1) {
+        int counter = loop_depth + 1; // Un contador por nivel de anidamiento: i1, i2, ...
+        fprintf(g->out, "from\n");
+        indent(g, level + 1);
+        fprintf(g->out, "i%d := 0\n", counter);
+        indent(g, level);
+        fprintf(g->out, "until\n");
+        indent(g, level + 1);
+        fprintf(g->out, "i%d = 2\n", counter);
+        indent(g, level);
+        fprintf(g->out, "loop\n");
+        emit_block(g, o, level + 1, depth_left - 1, counter);
+        indent(g, level + 1);
+        fprintf(g->out, "i%d := i%d + 1\n", counter, counter);
+        indent(g, level);
+        fprintf(g->out, "end\n");
+    } else if (kind < 5) {
+        fprintf(g->out, "x := x + %u * (y - %u)\n", next_random(g) % 10, next_random(g) % 10);
+    } else if (kind < 8) {
+        fprintf(g->out, "y := (y * 3 + x) / %u\n", 1 + next_random(g) % 9);
+    } else {
+        fprintf(g->out, "s := \"v%u\"\n", next_random(g) % 1000);
+    }
+}
+
+static void emit_method(Generator *g, const GenOptions *o, int class_index, int feature_index) {
+    int calls_next = feature_index == 0 && class_index + 1 < o->classes;
+    fprintf(g->out, "   f%d\n      local\n         x, y: INTEGER;\n         s: STRING", feature_index);
+    for (int d = 1; d <= o->depth; d++) fprintf(g->out, ";\n         i%d: INTEGER", d);
+    if (calls_next) fprintf(g->out, ";\n         o: %sC%d", o->prefix, class_index + 1);
+    fprintf(g->out, "\n      do\n         x := %d\n         y := %d\n", feature_index + 1, class_index + 1);
+    for (int i = 0; i < o->statements; i++) emit_statement(g, o, 3, o->depth, 0);
+    if (calls_next) fprintf(g->out, "         create o\n         o.f0\n");
+    fprintf(g->out, "      end\n\n");
+}
+
+// Escribe el programa completo en out; devuelve la cantidad de sentencias generadas
+static long generate_program(FILE *out, const GenOptions *o) {
+    Generator g = { out, o->seed, 0 };
+    for (int c = 0; c < o->classes; c++) {
+        fprintf(out, "class %sC%d\nfeature\n", o->prefix, c);
+        int attributes = o->features / 2;
+        for (int a = 0; a < attributes; a++) fprintf(out, "   a%d: INTEGER\n", a);
+        if (attributes > 0) fprintf(out, "\n");
+        int methods = o->features - attributes > 0 ? o->features - attributes : 1;
+        for (int m = 0; m < methods; m++) emit_method(&g, o, c, m);
+        fprintf(out, "end\n\n");
+    }
+    fprintf(out, "class MAIN\nfeature\n   make\n      local\n         o: %sC0\n      do\n"
+                 "         create o\n         o.f0\n         print(%ld)\n      end\nend\n", o->prefix, g.statements);
+    return g.statements;
+}
+
+/* --- Benchmark --- */
+
+enum { PHASE_LEX, PHASE_PARSE, PHASE_REGISTER, PHASE_PRINT, PHASE_FREE, PHASE_COUNT };
+static const char *phase_names[PHASE_COUNT] = { "lex", "parse", "register", "print_ast", "free_ast" };
+
+typedef struct {
+    int classes;
+    long statements;
+    size_t bytes;
+    double seconds[PHASE_COUNT];
+} Sample;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double lex_only(const char *text, size_t length) {
+    ParseContext context = { NULL, stderr };
+    yyscan_t scanner;
+    YYSTYPE value;
+    double start = now_seconds();
+    yylex_init_extra(&context, &scanner);
+    YY_BUFFER_STATE buffer = yy_scan_bytes(text, (int)length, scanner);
+    int token;
+    while ((token = yylex(&value, scanner)) != 0) {
+        // Los identificadores quedan internados (ver intern.h)
+        if (token == TOKEN_STRING) mem_free(MEM_STRING, value.string_val);
+    }
+    yy_delete_buffer(buffer, scanner);
+    yylex_destroy(scanner);
+    return now_seconds() - start;
+}
+
+static void measure(Sample *sample, const char *text, size_t length, int run, FILE *sink) {
+    double t[PHASE_COUNT];
+    t[PHASE_LEX] = lex_only(text, length);
+
+    // El parser incluye su propio lexing: la fase 'parse' es la diferencia
+    ParseContext context = { NULL, stderr };
+    AstNode *root = NULL;
+    double start = now_seconds();
+    int status = parse_text(text, length, 1, &context, &root);
+    t[PHASE_PARSE] = now_seconds() - start - t[PHASE_LEX];
+    if (status != 0 || !root) {
+        fprintf(stderr, "Error: el programa generado no parsea (%d clases).\n", sample->classes);
+        exit(1);
+    }
+    if (t[PHASE_PARSE] < 0) t[PHASE_PARSE] = 0;
+
+    start = now_seconds();
+    register_classes_from_ast(root);
+    t[PHASE_REGISTER] = now_seconds() - start;
+
+    start = now_seconds();
+    print_ast(root, sink);
+    fflush(sink);
+    t[PHASE_PRINT] = now_seconds() - start;
+
+    start = now_seconds();
+    free_ast(root);
+    t[PHASE_FREE] = now_seconds() - start;
+
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        if (run == 0 || t[p] < sample->seconds[p]) sample->seconds[p] = t[p];
+    }
+}
+
+static double ns_per_statement(const Sample *s, int phase) {
+    return s->seconds[phase] * 1e9 / (double)s->statements;
+}
+
+static void print_plot(const Sample *samples, int count) {
+    printf("\nns por sentencia (barras de igual largo = crecimiento lineal)\n");
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        double max = 0;
+        for (int i = 0; i < count; i++) {
+            if (ns_per_statement(&samples[i], p) > max) max = ns_per_statement(&samples[i], p);
+        }
+        printf("%s\n", phase_names[p]);
+        for (int i = 0; i < count; i++) {
+            double value = ns_per_statement(&samples[i], p);
+            int width = max > 0 ? (int)(40 * value / max + 0.5) : 0;
+            printf("  %8ld |", samples[i].statements);
+            for (int w = 0; w < width; w++) putchar('#');
+            printf(" %.1f\n", value);
+        }
+    }
+}
+
+static int report(const Sample *samples, int count) {
+    printf("%8s %10s %10s", "classes", "statements", "bytes");
+    for (int p = 0; p < PHASE_COUNT; p++) printf(" %12s", phase_names[p]);
+    printf("   (segundos)\n");
+    for (int i = 0; i < count; i++) {
+        printf("%8d %10ld %10zu", samples[i].classes, samples[i].statements, samples[i].bytes);
+        for (int p = 0; p < PHASE_COUNT; p++) printf(" %12.6f", samples[i].seconds[p]);
+        printf("\n");
+    }
+    print_plot(samples, count);
+
+    if (count < 2) return 0;
+    int first = count / 2 < count - 2 ? count / 2 : count - 2;
+    int superlinear = 0;
+    printf("\nexponente de crecimiento (tiempo ~ tamaño^k, desde %ld sentencias)\n", samples[first].statements);
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        double sx = 0, sy = 0, sxx = 0, sxy = 0;
+        int n = 0;
+        for (int i = first; i < count; i++) {
+            if (samples[i].seconds[p] <= 0) continue;
+            double x = log((double)samples[i].statements), y = log(samples[i].seconds[p]);
+            sx += x; sy += y; sxx += x * x; sxy += x * y;
+            n++;
+        }
+        if (n < 2 || n * sxx - sx * sx <= 0) {
+            printf("  %-10s (demasiado rápido para medir)\n", phase_names[p]);
+            continue;
+        }
+        double k = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+        int flagged = k > SUPERLINEAR_EXPONENT;
+        printf("  %-10s k = %.2f%s\n", phase_names[p], k, flagged ? "  <-- SUPERLINEAL" : "");
+        superlinear |= flagged;
+    }
+    return superlinear;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Uso: %s [--generate] [--classes N | --max-classes N] [--features F] [--statements S]\n"
+            "          [--depth D] [--seed X] [--repeat R] [--check]\n", program);
+}
+
+int main(int argc, char **argv) {
+    GenOptions options = { .classes = 1, .features = 6, .statements = 20, .depth = 3, .seed = 1, .prefix = "" };
+    int generate = 0, max_classes = 256, repeat = 3, check = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--generate") == 0) { generate = 1; continue; }
+        if (strcmp(argv[i], "--check") == 0) { check = 1; continue; }
+        if (!value) { usage(argv[0]); return 2; }
+        if (strcmp(argv[i], "--classes") == 0) options.classes = atoi(value);
+        else if (strcmp(argv[i], "--max-classes") == 0) max_classes = atoi(value);
+        else if (strcmp(argv[i], "--features") == 0) options.features = atoi(value);
+        else if (strcmp(argv[i], "--statements") == 0) options.statements = atoi(value);
+        else if (strcmp(argv[i], "--depth") == 0) options.depth = atoi(value);
+        else if (strcmp(argv[i], "--seed") == 0) options.seed = (unsigned)strtoul(value, NULL, 10);
+        else if (strcmp(argv[i], "--repeat") == 0) repeat = atoi(value);
+        else { usage(argv[0]); return 2; }
+        i++;
+    }
+    if (options.classes < 1 || max_classes < 1 || options.features < 1 || options.statements < 0
+        || options.depth < 0 || repeat < 1) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (generate) {
+        generate_program(stdout, &options);
+        return 0;
+    }
+
+    FILE *sink = fopen("/dev/null", "w");
+    if (!sink) {
+        perror("/dev/null");
+        return 1;
+    }
+    int count = 0;
+    for (int classes = 1; classes <= max_classes; classes *= 2) count++;
+    Sample *samples = calloc(count, sizeof(Sample));
+
+    int index = 0;
+    for (int classes = 1; classes <= max_classes; classes *= 2, index++) {
+        samples[index].classes = classes;
+        for (int run = 0; run < repeat; run++) {
+            // Cada corrida usa nombres de clase nuevos para que el registro no encuentre duplicados
+            char prefix[32];
+            snprintf(prefix, sizeof(prefix), "R%d_%d_", index, run);
+            GenOptions sized = options;
+            sized.classes = classes;
+            sized.prefix = prefix;
+
+            char *text = NULL;
+            size_t length = 0;
+            FILE *out = open_memstream(&text, &length);
+            samples[index].statements = generate_program(out, &sized);
+            fclose(out);
+            samples[index].bytes = length;
+
+            measure(&samples[index], text, length, run, sink);
+            free(text);
+        }
+    }
+
+    int superlinear = report(samples, count);
+    free(samples);
+    fclose(sink);
+    return check && superlinear ? 1 : 0;
+}
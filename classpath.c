@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <dirent.h>
+#include "ast.h"
+#include "interpreter.h"
+#include "classpath.h"
+#include "frontend.h"
+
+/* Comentario general:
+   - El índice es una tabla hash con direccionamiento abierto (clave: nombre de clase en mayúsculas).
+   - Cada archivo se parsea a lo sumo una vez: 'loaded' se marca antes de parsear, así una clase que
+     el archivo no define (o una carga recursiva) no vuelve a leerlo.
+   - El parseo usa su propio scanner (parse_text, ver frontend.h): puede ocurrir en medio de la
+     ejecución, con el programa principal ya parseado, sin tocar el estado de otro parseo.
+*/
+
+typedef struct {
+    char *class_name; // NULL: posición libre
+    char *path;
+    int loaded;
+} ClassFileEntry;
+
+static ClassFileEntry *slots = NULL;
+static size_t slot_count = 0;
+static size_t entry_count = 0;
+
+// ASTs de los archivos cargados: class_table apunta a sus features hasta el final
+static AstNode **loaded_roots = NULL;
+static int loaded_root_count = 0;
+
+static size_t name_hash(const char *name) {
+    size_t hash = 2166136261u; // FNV-1a
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash;
+}
+
+static ClassFileEntry *find_slot(ClassFileEntry *table, size_t count, const char *name) {
+    size_t mask = count - 1;
+    size_t i = name_hash(name) & mask;
+    while (table[i].class_name && strcmp(table[i].class_name, name) != 0) i = (i + 1) & mask;
+    return &table[i];
+}
+
+static void grow_index(void) {
+    size_t new_count = slot_count ? slot_count * 2 : 64;
+    ClassFileEntry *new_slots = calloc(new_count, sizeof(ClassFileEntry));
+    for (size_t i = 0; i < slot_count; i++) {
+        if (slots[i].class_name) *find_slot(new_slots, new_count, slots[i].class_name) = slots[i];
+    }
+    free(slots);
+    slots = new_slots;
+    slot_count = new_count;
+}
+
+static void index_file(const char *dir, const char *file_name) {
+    size_t len = strlen(file_name);
+    if (len < 3 || strcmp(file_name + len - 2, ".e") != 0) return;
+
+    char *class_name = malloc(len - 1);
+    for (size_t i = 0; i < len - 2; i++) class_name[i] = toupper((unsigned char)file_name[i]);
+    class_name[len - 2] = '\0';
+
+    if ((entry_count + 1) * 2 > slot_count) grow_index();
+    ClassFileEntry *entry = find_slot(slots, slot_count, class_name);
+    if (entry->class_name) { // Ya indexada desde un directorio anterior
+        free(class_name);
+        return;
+    }
+    entry->class_name = class_name;
+    entry->path = malloc(strlen(dir) + len + 2);
+    sprintf(entry->path, "%s/%s", dir, file_name);
+    entry->loaded = 0;
+    entry_count++;
+}
+
+void class_path_add(const char *paths) {
+    if (!paths) return;
+    char *copy = strdup(paths);
+    char *saveptr = NULL;
+    for (char *dir = strtok_r(copy, ":", &saveptr); dir; dir = strtok_r(NULL, ":", &saveptr)) {
+        DIR *handle = opendir(dir);
+        if (!handle) {
+            fprintf(stderr, "Aviso: no se pudo abrir el directorio '%s' del class path.\n", dir);
+            continue;
+        }
+        struct dirent *item;
+        while ((item = readdir(handle)) != NULL) index_file(dir, item->d_name);
+        closedir(handle);
+    }
+    free(copy);
+}
+
+static char *read_file(const char *path, long *length) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    *length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *text = malloc(*length + 1);
+    *length = (long)fread(text, 1, *length, file);
+    text[*length] = '\0';
+    fclose(file);
+    return text;
+}
+
+int class_path_load(const char *class_name) {
+    if (slot_count == 0) return 0;
+    ClassFileEntry *entry = find_slot(slots, slot_count, class_name);
+    if (!entry->class_name || entry->loaded) return 0;
+    entry->loaded = 1;
+
+    long length = 0;
+    char *text = read_file(entry->path, &length);
+    if (!text) {
+        fprintf(stderr, "Error: No se pudo leer '%s' (clase %s).\n", entry->path, class_name);
+        runtime_abort();
+    }
+
+    // El .info describe solo el programa principal: sin tokens
+    ParseContext context = { NULL, stderr, parse_lazy_bodies };
+    AstNode *root = NULL;
+    int status = parse_text(text, (size_t)length, 1, &context, &root);
+    free(text);
+
+    if (status != 0) {
+        fprintf(stderr, "Error: No se pudo parsear '%s' (clase %s).\n", entry->path, class_name);
+        runtime_abort();
+    }
+    if (!root) return 0;
+
+    loaded_roots = realloc(loaded_roots, (loaded_root_count + 1) * sizeof(AstNode*));
+    loaded_roots[loaded_root_count++] = root;
+    register_classes_from_ast(root);
+    return 1;
+}
+
+void class_path_free(void) {
+    for (int i = 0; i < loaded_root_count; i++) free_ast(loaded_roots[i]);
+    free(loaded_roots);
+    loaded_roots = NULL;
+    loaded_root_count = 0;
+    for (size_t i = 0; i < slot_count; i++) {
+        free(slots[i].class_name);
+        free(slots[i].path);
+    }
+    free(slots);
+    slots = NULL;
+    slot_count = entry_count = 0;
+}
@@ -0,0 +1,23 @@
+#ifndef CLASSPATH_H
+#define CLASSPATH_H
+
+/* Comentario general:
+   - Programas de varios archivos: el class path es una lista de directorios separados por ':'
+     (opción '--classpath' o variable de entorno EIFFEL_CLASSPATH).
+   - class_path_add solo lista los directorios (no abre ni parsea ningún archivo) y arma un índice
+     nombre de clase -> archivo: 'point.e' define la clase POINT. Si dos directorios tienen el mismo
+     archivo, gana el primero.
+   - class_path_load parsea el archivo de una clase la primera vez que find_class no la encuentra
+     (create, llamadas, tipos de atributos...) y registra todas las clases que contiene.
+*/
+
+// Agrega los directorios de 'paths' (separados por ':') al índice
+void class_path_add(const char *paths);
+
+// Carga la clase desde el class path; devuelve 1 si se parseó su archivo ahora, 0 si no hay nada que cargar
+int class_path_load(const char *class_name);
+
+// Libera el índice y los ASTs de las clases cargadas (al terminar el programa)
+void class_path_free(void);
+
+#endif // CLASSPATH_H
@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "server.h"
+
+/* Comentario general:
+   - Cliente liviano del modo servidor: './interpreter_client archivo.e' se comporta como
+     './interpreter archivo.e' (misma salida, mismo .info, mismo código de salida), pero el parseo
+     y el arranque los hace el servidor que ya tiene el programa en memoria.
+   - Envía la ruta y sus descriptores stdin/stdout/stderr; el programa escribe directamente en ellos.
+*/
+
+static int send_request(int sock, const char *request, size_t len) {
+    int fds[3] = { STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO };
+    struct iovec iov = { .iov_base = (void*)request, .iov_len = len };
+    union {
+        struct cmsghdr header;
+        char space[CMSG_SPACE(sizeof(fds))];
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    struct msghdr msg = { 0 };
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.space;
+    msg.msg_controllen = sizeof(control.space);
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    return sendmsg(sock, &msg, 0) == (ssize_t)len ? 0 : -1;
+}
+
+int main(int argc, char **argv) {
+    const char *socket_path = getenv(SOCKET_PATH_ENV);
+    int arg = 1;
+    if (argc > 2 && strcmp(argv[1], "--socket") == 0) {
+        socket_path = argv[2];
+        arg = 3;
+    }
+    char default_path[sizeof(((struct sockaddr_un*)0)->sun_path)];
+    if (!socket_path) {
+        char dir[sizeof(default_path) - sizeof(DEFAULT_SOCKET_NAME)];
+        if (default_socket_dir(dir, sizeof(dir)) != 0) {
+            fprintf(stderr, "Ruta de socket demasiado larga: %s/%s\n", dir, DEFAULT_SOCKET_NAME);
+            return 1;
+        }
+        snprintf(default_path, sizeof(default_path), "%s/%s", dir, DEFAULT_SOCKET_NAME);
+        socket_path = default_path;
+    }
+    if (arg >= argc) {
+        fprintf(stderr, "Uso: %s [--socket ruta] archivo.e\n", argv[0]);
+        return 1;
+    }
+    const char *display_path = argv[arg];
+
+    // Ruta absoluta para que el servidor encuentre el archivo sin importar su directorio de trabajo
+    char absolute_path[PATH_MAX];
+    if (display_path[0] == '/') {
+        snprintf(absolute_path, sizeof(absolute_path), "%s", display_path);
+    } else {
+        char cwd[PATH_MAX];
+        if (!getcwd(cwd, sizeof(cwd))) {
+            perror("getcwd");
+            return 1;
+        }
+        if (snprintf(absolute_path, sizeof(absolute_path), "%s/%s", cwd, display_path) >= (int)sizeof(absolute_path)) {
+            fprintf(stderr, "Ruta demasiado larga: %s\n", display_path);
+            return 1;
+        }
+    }
+
+    // Pedido: ruta absoluta (para abrir el archivo y su .info) y ruta original (para los mensajes)
+    char request[MAX_REQUEST_SIZE];
+    size_t path_len = strlen(absolute_path);
+    size_t display_len = strlen(display_path);
+    size_t request_len = path_len + 1 + display_len + 1;
+    if (request_len > sizeof(request)) {
+        fprintf(stderr, "Ruta demasiado larga: %s\n", display_path);
+        return 1;
+    }
+    memcpy(request, absolute_path, path_len + 1);
+    memcpy(request + path_len + 1, display_path, display_len + 1);
+
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un address = { .sun_family = AF_UNIX };
+    snprintf(address.sun_path, sizeof(address.sun_path), "%s", socket_path);
+    if (sock < 0 || connect(sock, (struct sockaddr*)&address, sizeof(address)) != 0) {
+        fprintf(stderr, "No se pudo conectar al servidor en %s (¿está corriendo './interpreter --serve'?)\n", socket_path);
+        return 1;
+    }
+
+    fflush(NULL);
+    if (send_request(sock, request, request_len) != 0) {
+        perror("sendmsg");
+        return 1;
+    }
+
+    int status = 1;
+    ssize_t got = 0;
+    while (got < (ssize_t)sizeof(status)) {
+        ssize_t r = read(sock, (char*)&status + got, sizeof(status) - got);
+        if (r <= 0) {
+            fprintf(stderr, "El servidor cerró la conexión sin responder.\n");
+            return 1;
+        }
+        got += r;
+    }
+    close(sock);
+    return status;
+}
@@ -0,0 +1,328 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "interpreter.h"
+#include "memstats.h"
+#include "eiffel_io.h"
+
+/* Comentario general:
+   - InputStream guarda posiciones (no punteros) dentro de data: al compactar o agrandar el buffer
+     solo cambia data.
+   - Con mmap se avisa al kernel que la lectura es secuencial (MADV_SEQUENTIAL).
+   - read_line busca el salto de línea solo en los bytes nuevos después de cada lectura, así una
+     línea larga no se recorre más de una vez. Un "\r\n" final también se quita.
+   - La entrada estándar se abre en el primer uso, con el descriptor 0 de ese momento (en el
+     servidor es el stdin del cliente).
+*/
+
+static InputStream standard_input;
+static int standard_input_ready = 0;
+static char *stdin_last_string = NULL;
+static int stdin_last_integer = 0;
+
+/* --- Streams de entrada --- */
+
+static void stream_open(InputStream *s, int fd) {
+    memset(s, 0, sizeof(*s));
+    s->fd = fd;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        off_t offset = lseek(fd, 0, SEEK_CUR);
+        if (offset < 0) offset = 0;
+        if (st.st_size <= offset) {
+            s->mapped = 1;
+            s->eof = 1;
+            return;
+        }
+        void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+            s->data = map;
+            s->map_size = (size_t)st.st_size;
+            s->pos = (size_t)offset;
+            s->limit = (size_t)st.st_size;
+            s->mapped = 1;
+            s->eof = 1;
+            return;
+        }
+    }
+    s->capacity = IO_BUFFER_SIZE;
+    s->buffer = mem_alloc(MEM_OBJECT, s->capacity);
+    s->data = s->buffer;
+}
+
+static void stream_close(InputStream *s) {
+    if (s->mapped && s->map_size) munmap((void*)s->data, s->map_size);
+    if (s->buffer) mem_free(MEM_OBJECT, s->buffer);
+    memset(s, 0, sizeof(*s));
+}
+
+// Lee más datos al final del buffer (compactando o agrandando). Devuelve los bytes leídos
+static size_t stream_fill(InputStream *s) {
+    if (s->eof) return 0;
+    if (s->pos > 0) {
+        memmove(s->buffer, s->buffer + s->pos, s->limit - s->pos);
+        s->limit -= s->pos;
+        s->pos = 0;
+    }
+    if (s->limit == s->capacity) {
+        s->capacity *= 2;
+        s->buffer = mem_realloc(MEM_OBJECT, s->buffer, s->capacity);
+    }
+    s->data = s->buffer;
+    ssize_t got;
+    do {
+        got = read(s->fd, s->buffer + s->limit, s->capacity - s->limit);
+    } while (got < 0 && errno == EINTR);
+    if (got <= 0) {
+        s->eof = 1;
+        return 0;
+    }
+    s->limit += (size_t)got;
+    return (size_t)got;
+}
+
+static int stream_at_end(InputStream *s) {
+    if (s->pos < s->limit) return 0;
+    return stream_fill(s) == 0;
+}
+
+static int stream_peek(InputStream *s) {
+    if (stream_at_end(s)) return -1;
+    return s->data[s->pos];
+}
+
+// Devuelve la próxima línea sin el salto (un STRING nuevo); "" si no queda nada
+static char* stream_read_line(InputStream *s) {
+    size_t scanned = s->pos;
+    const unsigned char *newline = NULL;
+    for (;;) {
+        newline = scanned < s->limit ? memchr(s->data + scanned, '\n', s->limit - scanned) : NULL;
+        if (newline) break;
+        size_t consumed = s->pos;
+        scanned = s->limit;
+        if (stream_fill(s) == 0) break;
+        scanned -= consumed; // stream_fill movió los datos pendientes al principio
+    }
+    size_t end = newline ? (size_t)(newline - s->data) : s->limit;
+    size_t length = end - s->pos;
+    if (length > 0 && s->data[s->pos + length - 1] == '\r') length--;
+    char *line = length ? mem_strndup(MEM_STRING, (const char*)s->data + s->pos, length) : mem_strdup(MEM_STRING, "");
+    s->pos = newline ? end + 1 : end;
+    return line;
+}
+
+static int is_space(int c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+// Lee el próximo entero (saltea blancos). Si no hay un número, consume la palabra y devuelve 0
+static int stream_read_integer(InputStream *s) {
+    int c;
+    while ((c = stream_peek(s)) >= 0 && is_space(c)) s->pos++;
+    int negative = 0;
+    if (c == '-' || c == '+') {
+        negative = c == '-';
+        s->pos++;
+    }
+    long value = 0;
+    int digits = 0;
+    while ((c = stream_peek(s)) >= '0' && c <= '9') {
+        value = value * 10 + (c - '0');
+        if (value > 2147483648L) value = 2147483648L; // Satura en vez de desbordar
+        digits++;
+        s->pos++;
+    }
+    if (!digits) {
+        while ((c = stream_peek(s)) >= 0 && !is_space(c)) s->pos++;
+        return 0;
+    }
+    value = negative ? -value : value;
+    if (value > 2147483647L) value = 2147483647L;
+    return (int)value;
+}
+
+static InputStream* standard_input_stream(void) {
+    if (!standard_input_ready) {
+        stream_open(&standard_input, STDIN_FILENO);
+        standard_input_ready = 1;
+    }
+    return &standard_input;
+}
+
+/* --- Valores --- */
+
+static RuntimeValue int_value(int number) {
+    RuntimeValue value;
+    value.type = VAL_TYPE_INT;
+    value.as.int_val = number;
+    return value;
+}
+
+static RuntimeValue bool_value(int condition) {
+    RuntimeValue value;
+    value.type = VAL_TYPE_BOOLEAN;
+    value.as.int_val = condition != 0;
+    return value;
+}
+
+// Guarda line como último string leído (en *last) y devuelve una copia para el que llama
+static RuntimeValue remember_line(char **last, char *line) {
+    if (*last) mem_free(MEM_STRING, *last);
+    *last = line;
+    RuntimeValue value;
+    value.type = VAL_TYPE_STRING;
+    value.as.string_val = mem_strdup(MEM_STRING, line);
+    return value;
+}
+
+static RuntimeValue copy_string(const char *text) {
+    RuntimeValue value;
+    value.type = VAL_TYPE_STRING;
+    value.as.string_val = mem_strdup(MEM_STRING, text ? text : "");
+    return value;
+}
+
+/* --- Consultas globales (entrada estándar) --- */
+
+int io_is_builtin(const char *name) {
+    return strcmp(name, "read_line") == 0 || strcmp(name, "read_integer") == 0
+        || strcmp(name, "last_string") == 0 || strcmp(name, "last_integer") == 0
+        || strcmp(name, "end_of_input") == 0;
+}
+
+int io_call_builtin(const char *name, RuntimeValue *args, int arg_count, RuntimeValue *result) {
+    (void)args;
+    if (!io_is_builtin(name)) return 0;
+    if (arg_count != 0) {
+        fprintf(stderr, "Error: '%s' no recibe argumentos.\n", name);
+        runtime_abort();
+    }
+    if (strcmp(name, "read_line") == 0) {
+        *result = remember_line(&stdin_last_string, stream_read_line(standard_input_stream()));
+    } else if (strcmp(name, "read_integer") == 0) {
+        stdin_last_integer = stream_read_integer(standard_input_stream());
+        *result = int_value(stdin_last_integer);
+    } else if (strcmp(name, "last_string") == 0) {
+        *result = copy_string(stdin_last_string);
+    } else if (strcmp(name, "last_integer") == 0) {
+        *result = int_value(stdin_last_integer);
+    } else {
+        *result = int_value(stream_at_end(standard_input_stream()));
+    }
+    return 1;
+}
+
+/* --- PLAIN_TEXT_FILE --- */
+
+int is_file_type(const char *type_name) {
+    return type_name && strcmp(type_name, "PLAIN_TEXT_FILE") == 0;
+}
+
+EiffelFile* create_file(void) {
+    EiffelFile *file = mem_alloc(MEM_OBJECT, sizeof(EiffelFile));
+    memset(file, 0, sizeof(*file));
+    file->mode = FILE_CLOSED;
+    return file;
+}
+
+static void file_error_feature(const char *feature_name) {
+    fprintf(stderr, "Error: PLAIN_TEXT_FILE no tiene la feature '%s' (o sus argumentos no son válidos).\n", feature_name);
+    runtime_abort();
+}
+
+static void file_close(EiffelFile *file) {
+    if (file->mode == FILE_OPEN_READ) {
+        close(file->input.fd);
+        stream_close(&file->input);
+    } else if (file->mode == FILE_OPEN_WRITE) {
+        fclose(file->output);
+        file->output = NULL;
+    }
+    file->mode = FILE_CLOSED;
+}
+
+static void file_open(EiffelFile *file, const char *feature_name, RuntimeValue *args, int arg_count) {
+    if (arg_count != 1 || args[0].type != VAL_TYPE_STRING) file_error_feature(feature_name);
+    const char *path = args[0].as.string_val;
+    file_close(file);
+    if (file->name) mem_free(MEM_IDENTIFIER, file->name);
+    file->name = mem_strdup(MEM_IDENTIFIER, path);
+
+    if (strcmp(feature_name, "make_open_read") == 0) {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            fprintf(stderr, "Error: No se pudo abrir '%s' para lectura: %s.\n", path, strerror(errno));
+            runtime_abort();
+        }
+        stream_open(&file->input, fd);
+        file->mode = FILE_OPEN_READ;
+    } else {
+        file->output = fopen(path, strcmp(feature_name, "make_open_append") == 0 ? "a" : "w");
+        if (!file->output) {
+            fprintf(stderr, "Error: No se pudo abrir '%s' para escritura: %s.\n", path, strerror(errno));
+            runtime_abort();
+        }
+        setvbuf(file->output, NULL, _IOFBF, IO_BUFFER_SIZE);
+        file->mode = FILE_OPEN_WRITE;
+    }
+}
+
+static void expect_mode(EiffelFile *file, FileMode mode, const char *feature_name) {
+    if (file->mode == mode) return;
+    fprintf(stderr, "Error: '%s' necesita el archivo '%s' abierto para %s.\n", feature_name,
+            file->name ? file->name : "(sin abrir)", mode == FILE_OPEN_READ ? "lectura" : "escritura");
+    runtime_abort();
+}
+
+RuntimeValue file_call_feature(EiffelFile *file, const char *feature_name, RuntimeValue *args, int arg_count) {
+    RuntimeValue result = { .type = VAL_TYPE_VOID };
+
+    if (strcmp(feature_name, "make_open_read") == 0 || strcmp(feature_name, "make_open_write") == 0
+        || strcmp(feature_name, "make_open_append") == 0) {
+        file_open(file, feature_name, args, arg_count);
+    } else if (strcmp(feature_name, "read_line") == 0 && arg_count == 0) {
+        expect_mode(file, FILE_OPEN_READ, feature_name);
+        result = remember_line(&file->last_string, stream_read_line(&file->input));
+    } else if (strcmp(feature_name, "read_integer") == 0 && arg_count == 0) {
+        expect_mode(file, FILE_OPEN_READ, feature_name);
+        file->last_integer = stream_read_integer(&file->input);
+        result = int_value(file->last_integer);
+    } else if (strcmp(feature_name, "last_string") == 0 && arg_count == 0) {
+        result = copy_string(file->last_string);
+    } else if (strcmp(feature_name, "last_integer") == 0 && arg_count == 0) {
+        result = int_value(file->last_integer);
+    } else if (strcmp(feature_name, "end_of_file") == 0 && arg_count == 0) {
+        expect_mode(file, FILE_OPEN_READ, feature_name);
+        result = bool_value(stream_at_end(&file->input));
+    } else if (strcmp(feature_name, "put_string") == 0 && arg_count == 1 && args[0].type == VAL_TYPE_STRING) {
+        expect_mode(file, FILE_OPEN_WRITE, feature_name);
+        fputs(args[0].as.string_val, file->output);
+    } else if (strcmp(feature_name, "put_integer") == 0 && arg_count == 1 && args[0].type == VAL_TYPE_INT) {
+        expect_mode(file, FILE_OPEN_WRITE, feature_name);
+        fprintf(file->output, "%d", args[0].as.int_val);
+    } else if (strcmp(feature_name, "put_real") == 0 && arg_count == 1
+               && (args[0].type == VAL_TYPE_REAL || args[0].type == VAL_TYPE_INT)) {
+        expect_mode(file, FILE_OPEN_WRITE, feature_name);
+        fprintf(file->output, "%f", args[0].type == VAL_TYPE_REAL ? args[0].as.real_val : (double)args[0].as.int_val);
+    } else if (strcmp(feature_name, "put_new_line") == 0 && arg_count == 0) {
+        expect_mode(file, FILE_OPEN_WRITE, feature_name);
+        fputc('\n', file->output);
+    } else if (strcmp(feature_name, "close") == 0 && arg_count == 0) {
+        file_close(file);
+    } else if (strcmp(feature_name, "is_open_read") == 0 && arg_count == 0) {
+        result = bool_value(file->mode == FILE_OPEN_READ);
+    } else if (strcmp(feature_name, "is_open_write") == 0 && arg_count == 0) {
+        result = bool_value(file->mode == FILE_OPEN_WRITE);
+    } else if (strcmp(feature_name, "name") == 0 && arg_count == 0) {
+        result = copy_string(file->name);
+    } else {
+        file_error_feature(feature_name);
+    }
+    return result;
+}
@@ -0,0 +1,67 @@
+#ifndef EIFFEL_IO_H
+#define EIFFEL_IO_H
+
+#include "interpreter.h"
+
+/* Comentario general:
+   - Entrada/salida para los scripts: consultas globales sobre la entrada estándar y la clase
+     predefinida PLAIN_TEXT_FILE (VAL_TYPE_FILE), implementadas en C como STRING y ARRAY.
+   - Lectura por streams: un archivo regular (también la entrada estándar redirigida) se mapea
+     entero con mmap y se recorre con memchr; pipes y terminales se leen con read() en un buffer
+     de IO_BUFFER_SIZE que crece si una línea no entra. La única copia de cada línea es el STRING
+     que recibe el script.
+   - La escritura usa stdio con un buffer de IO_BUFFER_SIZE; close (o el fin del proceso) la vuelca.
+*/
+
+#define IO_BUFFER_SIZE (1024 * 1024)
+
+typedef struct {
+    int fd;
+    const unsigned char *data; // Mapeo del archivo o buffer de lectura
+    size_t pos;                // Primer byte sin consumir
+    size_t limit;              // Fin de los datos disponibles
+    int mapped;
+    size_t map_size;
+    unsigned char *buffer;     // Solo sin mmap
+    size_t capacity;
+    int eof;                   // read() ya devolvió 0 (con mmap: siempre)
+} InputStream;
+
+typedef enum {
+    FILE_CLOSED,
+    FILE_OPEN_READ,
+    FILE_OPEN_WRITE
+} FileMode;
+
+typedef struct EiffelFile {
+    char *name;
+    FileMode mode;
+    InputStream input;
+    FILE *output;
+    char *last_string;
+    int last_integer;
+} EiffelFile;
+
+// Devuelve 1 si type_name es PLAIN_TEXT_FILE
+int is_file_type(const char *type_name);
+
+// Crea un PLAIN_TEXT_FILE cerrado (se abre con make_open_read / make_open_write / make_open_append)
+EiffelFile* create_file(void);
+
+/* file_call_feature: ejecuta una feature de PLAIN_TEXT_FILE sobre argumentos ya evaluados.
+   - Creación / apertura: make_open_read (ruta), make_open_write (ruta), make_open_append (ruta)
+   - Lectura: read_line (devuelve la línea y la deja en last_string), read_integer (ídem con
+     last_integer), end_of_file
+   - Escritura: put_string (s), put_integer (i), put_real (r), put_new_line
+   - Otras: close, is_open_read, is_open_write, name
+   Los STRING devueltos son del que llama. Los errores llaman a runtime_abort.
+*/
+RuntimeValue file_call_feature(EiffelFile *file, const char *feature_name, RuntimeValue *args, int arg_count);
+
+/* Consultas globales sobre la entrada estándar: read_line, read_integer, last_string,
+   last_integer y end_of_input. Solo se usan si no hay una variable con ese nombre.
+   io_call_builtin devuelve 1 (y el valor en result) si name es una de ellas. */
+int io_is_builtin(const char *name);
+int io_call_builtin(const char *name, RuntimeValue *args, int arg_count, RuntimeValue *result);
+
+#endif // EIFFEL_IO_H
@@ -0,0 +1,375 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include "eiffel_string.h"
+#include "memstats.h"
+#include "array.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define STRING_HAVE_X86_KERNELS 1
+#endif
+
+/* Comentario general:
+   - Igual que en array.c, cada kernel tiene versión escalar, SSE2 y AVX2, y la tabla se elige
+     una sola vez según la CPU.
+   - find usa el filtro de "primer y último byte": compara un bloque entero contra ambos extremos
+     del patrón y solo verifica con memcmp las posiciones donde coinciden los dos.
+   - El hash recorre el texto en bloques de 32 bytes con 8 carriles de 32 bits independientes
+     (rotación + multiplicación) y luego combina carriles y cola con FNV-1a. Todas las versiones
+     calculan exactamente lo mismo, así que hash_code no depende de la CPU.
+*/
+
+#define HASH_LANES 8
+#define HASH_BLOCK (HASH_LANES * 4)
+#define HASH_LANE_PRIME 0x9E3779B1u
+#define FNV_OFFSET 0x811C9DC5u
+#define FNV_PRIME 0x01000193u
+
+typedef struct {
+    size_t (*mismatch)(const unsigned char *a, const unsigned char *b, size_t n);   // Primer índice distinto, o n
+    long (*find)(const unsigned char *text, size_t n, const unsigned char *pattern, size_t m); // Offset o -1
+    void (*hash_blocks)(const unsigned char *s, size_t blocks, uint32_t lanes[HASH_LANES]);
+} StringKernels;
+
+/* --- Kernels escalares --- */
+
+static size_t scalar_mismatch(const unsigned char *a, const unsigned char *b, size_t n) {
+    size_t i = 0;
+    while (i < n && a[i] == b[i]) i++;
+    return i;
+}
+
+static long scalar_find(const unsigned char *text, size_t n, const unsigned char *pattern, size_t m) {
+    if (m == 0) return 0;
+    for (size_t i = 0; i + m <= n; i++) {
+        if (text[i] == pattern[0] && scalar_mismatch(text + i, pattern, m) == m) return (long)i;
+    }
+    return -1;
+}
+
+static uint32_t load_le32(const unsigned char *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t hash_lane_step(uint32_t lane, uint32_t word) {
+    uint32_t x = lane ^ word;
+    x = (x << 13) | (x >> 19);
+    return x * HASH_LANE_PRIME;
+}
+
+static void scalar_hash_blocks(const unsigned char *s, size_t blocks, uint32_t lanes[HASH_LANES]) {
+    for (size_t b = 0; b < blocks; b++, s += HASH_BLOCK) {
+        for (int j = 0; j < HASH_LANES; j++) lanes[j] = hash_lane_step(lanes[j], load_le32(s + 4 * j));
+    }
+}
+
+static const StringKernels scalar_kernels = { scalar_mismatch, scalar_find, scalar_hash_blocks };
+
+#ifdef STRING_HAVE_X86_KERNELS
+
+/* --- Kernels SSE2 --- */
+
+__attribute__((target("sse2")))
+static size_t sse2_mismatch(const unsigned char *a, const unsigned char *b, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i)));
+        unsigned mask = (unsigned)_mm_movemask_epi8(eq) ^ 0xFFFFu;
+        if (mask) return i + (size_t)__builtin_ctz(mask);
+    }
+    return i + scalar_mismatch(a + i, b + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static long sse2_find(const unsigned char *text, size_t n, const unsigned char *pattern, size_t m) {
+    if (m == 0) return 0;
+    if (m > n) return -1;
+    __m128i first = _mm_set1_epi8((char)pattern[0]);
+    __m128i last = _mm_set1_epi8((char)pattern[m - 1]);
+    size_t i = 0;
+    for (; i + m - 1 + 16 <= n; i += 16) {
+        __m128i eq_first = _mm_cmpeq_epi8(first, _mm_loadu_si128((const __m128i*)(text + i)));
+        __m128i eq_last = _mm_cmpeq_epi8(last, _mm_loadu_si128((const __m128i*)(text + i + m - 1)));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(eq_first, eq_last));
+        while (mask) {
+            size_t offset = i + (size_t)__builtin_ctz(mask);
+            if (memcmp(text + offset, pattern, m) == 0) return (long)offset;
+            mask &= mask - 1;
+        }
+    }
+    long rest = scalar_find(text + i, n - i, pattern, m);
+    return rest < 0 ? -1 : (long)i + rest;
+}
+
+// SSE2 no tiene pmulld (SSE4.1): producto bajo de 32 bits armado con dos pmuludq
+__attribute__((target("sse2")))
+static __m128i sse2_mullo_epi32(__m128i a, __m128i b) {
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+__attribute__((target("sse2")))
+static __m128i sse2_hash_step(__m128i lane, __m128i word, __m128i prime) {
+    __m128i x = _mm_xor_si128(lane, word);
+    x = _mm_or_si128(_mm_slli_epi32(x, 13), _mm_srli_epi32(x, 19));
+    return sse2_mullo_epi32(x, prime);
+}
+
+__attribute__((target("sse2")))
+static void sse2_hash_blocks(const unsigned char *s, size_t blocks, uint32_t lanes[HASH_LANES]) {
+    __m128i prime = _mm_set1_epi32((int)HASH_LANE_PRIME);
+    __m128i low = _mm_loadu_si128((const __m128i*)lanes);
+    __m128i high = _mm_loadu_si128((const __m128i*)(lanes + 4));
+    for (size_t b = 0; b < blocks; b++, s += HASH_BLOCK) {
+        low = sse2_hash_step(low, _mm_loadu_si128((const __m128i*)s), prime);
+        high = sse2_hash_step(high, _mm_loadu_si128((const __m128i*)(s + 16)), prime);
+    }
+    _mm_storeu_si128((__m128i*)lanes, low);
+    _mm_storeu_si128((__m128i*)(lanes + 4), high);
+}
+
+static const StringKernels sse2_kernels = { sse2_mismatch, sse2_find, sse2_hash_blocks };
+
+/* --- Kernels AVX2 --- */
+
+__attribute__((target("avx2")))
+static size_t avx2_mismatch(const unsigned char *a, const unsigned char *b, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)));
+        unsigned mask = ~(unsigned)_mm256_movemask_epi8(eq);
+        if (mask) return i + (size_t)__builtin_ctz(mask);
+    }
+    return i + sse2_mismatch(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static long avx2_find(const unsigned char *text, size_t n, const unsigned char *pattern, size_t m) {
+    if (m == 0) return 0;
+    if (m > n) return -1;
+    __m256i first = _mm256_set1_epi8((char)pattern[0]);
+    __m256i last = _mm256_set1_epi8((char)pattern[m - 1]);
+    size_t i = 0;
+    for (; i + m - 1 + 32 <= n; i += 32) {
+        __m256i eq_first = _mm256_cmpeq_epi8(first, _mm256_loadu_si256((const __m256i*)(text + i)));
+        __m256i eq_last = _mm256_cmpeq_epi8(last, _mm256_loadu_si256((const __m256i*)(text + i + m - 1)));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(eq_first, eq_last));
+        while (mask) {
+            size_t offset = i + (size_t)__builtin_ctz(mask);
+            if (memcmp(text + offset, pattern, m) == 0) return (long)offset;
+            mask &= mask - 1;
+        }
+    }
+    long rest = sse2_find(text + i, n - i, pattern, m);
+    return rest < 0 ? -1 : (long)i + rest;
+}
+
+__attribute__((target("avx2")))
+static void avx2_hash_blocks(const unsigned char *s, size_t blocks, uint32_t lanes[HASH_LANES]) {
+    __m256i prime = _mm256_set1_epi32((int)HASH_LANE_PRIME);
+    __m256i acc = _mm256_loadu_si256((const __m256i*)lanes);
+    for (size_t b = 0; b < blocks; b++, s += HASH_BLOCK) {
+        __m256i x = _mm256_xor_si256(acc, _mm256_loadu_si256((const __m256i*)s));
+        x = _mm256_or_si256(_mm256_slli_epi32(x, 13), _mm256_srli_epi32(x, 19));
+        acc = _mm256_mullo_epi32(x, prime);
+    }
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+}
+
+static const StringKernels avx2_kernels = { avx2_mismatch, avx2_find, avx2_hash_blocks };
+
+#endif // STRING_HAVE_X86_KERNELS
+
+static const StringKernels *kernels = NULL;
+
+static const StringKernels* select_kernels(void) {
+    if (kernels) return kernels;
+    kernels = &scalar_kernels;
+#ifdef STRING_HAVE_X86_KERNELS
+    __builtin_cpu_init();
+    if (getenv("EIFFEL_STRING_SCALAR")) {
+        kernels = &scalar_kernels; // Para comparar resultados contra la versión escalar
+    } else if (__builtin_cpu_supports("avx2")) {
+        kernels = &avx2_kernels;
+    } else if (__builtin_cpu_supports("sse2")) {
+        kernels = &sse2_kernels;
+    }
+#endif
+    return kernels;
+}
+
+/* --- Operaciones públicas --- */
+
+int string_compare(const char *a, const char *b) {
+    size_t la = strlen(a), lb = strlen(b);
+    size_t n = la < lb ? la : lb;
+    size_t i = select_kernels()->mismatch((const unsigned char*)a, (const unsigned char*)b, n);
+    if (i < n) return (int)(unsigned char)a[i] - (int)(unsigned char)b[i];
+    return la < lb ? -1 : (la > lb ? 1 : 0);
+}
+
+int string_hash(const char *s, size_t length) {
+    const unsigned char *bytes = (const unsigned char*)s;
+    uint32_t lanes[HASH_LANES];
+    for (int j = 0; j < HASH_LANES; j++) lanes[j] = 0x9E3779B9u * (uint32_t)(j + 1);
+    size_t blocks = length / HASH_BLOCK;
+    select_kernels()->hash_blocks(bytes, blocks, lanes);
+
+    uint32_t h = FNV_OFFSET ^ (uint32_t)length;
+    for (int j = 0; j < HASH_LANES; j++) h = (h ^ lanes[j]) * FNV_PRIME;
+    for (size_t i = blocks * HASH_BLOCK; i < length; i++) h = (h ^ bytes[i]) * FNV_PRIME;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return (int)(h & 0x7FFFFFFFu);
+}
+
+/* --- Features --- */
+
+static void string_error_feature(const char *feature_name) {
+    fprintf(stderr, "Error: STRING no tiene la feature '%s' (o sus argumentos no son válidos).\n", feature_name);
+    runtime_abort();
+}
+
+static int expect_int(const char *feature_name, RuntimeValue value) {
+    if (value.type == VAL_TYPE_INT) return value.as.int_val;
+    string_error_feature(feature_name);
+    return 0;
+}
+
+static const char* expect_string(const char *feature_name, RuntimeValue value) {
+    if (value.type == VAL_TYPE_STRING && value.as.string_val) return value.as.string_val;
+    string_error_feature(feature_name);
+    return NULL;
+}
+
+static RuntimeValue int_value(int number) {
+    RuntimeValue value;
+    value.type = VAL_TYPE_INT;
+    value.as.int_val = number;
+    return value;
+}
+
+static RuntimeValue bool_value(int condition) {
+    RuntimeValue value;
+    value.type = VAL_TYPE_BOOLEAN;
+    value.as.int_val = condition != 0;
+    return value;
+}
+
+static RuntimeValue string_value(const char *start, size_t length) {
+    RuntimeValue value;
+    value.type = VAL_TYPE_STRING;
+    value.as.string_val = mem_alloc(MEM_STRING, length + 1);
+    memcpy(value.as.string_val, start, length);
+    value.as.string_val[length] = '\0';
+    return value;
+}
+
+// Índice de base 0 de la primera aparición de pattern a partir de from, o -1
+static long find_from(const char *string, size_t length, size_t from, const char *pattern) {
+    if (from > length) return -1;
+    long offset = select_kernels()->find((const unsigned char*)string + from, length - from,
+                                         (const unsigned char*)pattern, strlen(pattern));
+    return offset < 0 ? -1 : (long)from + offset;
+}
+
+// Signo opcional seguido de dígitos, dentro del rango de INTEGER
+static int parse_integer(const char *string, int *out) {
+    const char *p = string;
+    int negative = 0;
+    if (*p == '+' || *p == '-') negative = *p++ == '-';
+    if (!*p) return 0;
+    long long value = 0;
+    for (; *p; p++) {
+        if (*p < '0' || *p > '9') return 0;
+        value = value * 10 + (*p - '0');
+        if (value > (long long)INT_MAX + 1) return 0;
+    }
+    if (negative) value = -value;
+    if (value < INT_MIN || value > INT_MAX) return 0;
+    *out = (int)value;
+    return 1;
+}
+
+static RuntimeValue split_string(const char *string, size_t length, const char *separator) {
+    size_t separator_length = strlen(separator);
+    if (separator_length == 0) string_error_feature("split");
+
+    int parts = 1;
+    for (long at = find_from(string, length, 0, separator); at >= 0;
+         at = find_from(string, length, (size_t)at + separator_length, separator)) {
+        parts++;
+    }
+
+    EiffelArray *array = create_array("ARRAY [STRING]");
+    RuntimeValue bounds[2] = { int_value(1), int_value(parts) };
+    array_call_feature(array, "make", bounds, 2);
+
+    size_t start = 0;
+    for (int k = 0; k < parts; k++) {
+        long at = find_from(string, length, start, separator);
+        size_t end = at < 0 ? length : (size_t)at;
+        array->data.strings[k] = string_value(string + start, end - start).as.string_val;
+        start = end + separator_length;
+    }
+
+    RuntimeValue result;
+    result.type = VAL_TYPE_ARRAY;
+    result.as.array_val = array;
+    return result;
+}
+
+RuntimeValue string_call_feature(const char *string, const char *feature_name, RuntimeValue *args, int arg_count) {
+    RuntimeValue result = { .type = VAL_TYPE_VOID };
+    size_t length = strlen(string);
+
+    if (strcmp(feature_name, "count") == 0 && arg_count == 0) {
+        result = int_value((int)length);
+    } else if (strcmp(feature_name, "is_equal") == 0 && arg_count == 1) {
+        const char *other = expect_string(feature_name, args[0]);
+        result = bool_value(strlen(other) == length
+            && select_kernels()->mismatch((const unsigned char*)string, (const unsigned char*)other, length) == length);
+    } else if (strcmp(feature_name, "has") == 0 && arg_count == 1) {
+        result = bool_value(find_from(string, length, 0, expect_string(feature_name, args[0])) >= 0);
+    } else if (strcmp(feature_name, "index_of") == 0 && (arg_count == 1 || arg_count == 2)) {
+        const char *pattern = expect_string(feature_name, args[0]);
+        int start = arg_count == 2 ? expect_int(feature_name, args[1]) : 1;
+        if (start < 1 || (size_t)start > length + 1) {
+            fprintf(stderr, "Error: index_of desde %d fuera de un STRING de largo %zu.\n", start, length);
+            runtime_abort();
+        }
+        result = int_value((int)(find_from(string, length, (size_t)start - 1, pattern) + 1));
+    } else if (strcmp(feature_name, "substring") == 0 && arg_count == 2) {
+        int start = expect_int(feature_name, args[0]);
+        int end = expect_int(feature_name, args[1]);
+        // Como en EiffelBase: 1 <= inicio <= fin + 1 <= count + 1; inicio = fin + 1 es el STRING vacío
+        if (start < 1 || (long long)start > (long long)end + 1 || (long long)end > (long long)length) {
+            fprintf(stderr, "Error: substring (%d, %d) fuera de los límites de un STRING de largo %zu.\n", start, end, length);
+            runtime_abort();
+        }
+        result = string_value(string + start - 1, (size_t)((long long)end - start + 1));
+    } else if (strcmp(feature_name, "split") == 0 && arg_count == 1) {
+        result = split_string(string, length, expect_string(feature_name, args[0]));
+    } else if (strcmp(feature_name, "hash_code") == 0 && arg_count == 0) {
+        result = int_value(string_hash(string, length));
+    } else if (strcmp(feature_name, "is_integer") == 0 && arg_count == 0) {
+        int ignored;
+        result = bool_value(parse_integer(string, &ignored));
+    } else if (strcmp(feature_name, "to_integer") == 0 && arg_count == 0) {
+        int value;
+        if (!parse_integer(string, &value)) {
+            fprintf(stderr, "Error: \"%s\" no representa un INTEGER.\n", string);
+            runtime_abort();
+        }
+        result = int_value(value);
+    } else {
+        string_error_feature(feature_name);
+    }
+    return result;
+}
@@ -0,0 +1,30 @@
+#ifndef EIFFEL_STRING_H
+#define EIFFEL_STRING_H
+
+#include <stddef.h>
+#include "interpreter.h"
+
+/* Comentario general:
+   - STRING es un tipo predefinido: los valores son char* terminados en '\0' (VAL_TYPE_STRING) y
+     sus features se implementan en C (eiffel_string.c), igual que ARRAY en array.c.
+   - Búsqueda, comparación y hash usan kernels AVX2/SSE2 elegidos en tiempo de ejecución, con
+     versión escalar como respaldo (EIFFEL_STRING_SCALAR fuerza la escalar).
+   - Los índices son de base 1, como en Eiffel; index_of devuelve 0 si no encuentra el patrón.
+*/
+
+/* string_call_feature: ejecuta una feature de STRING sobre argumentos ya evaluados.
+   - Consultas: count, is_equal (otro), has (patrón), index_of (patrón [, inicio]),
+     substring (inicio, fin), hash_code, is_integer, to_integer
+   - split (separador): devuelve un ARRAY [STRING] con las partes (lower = 1)
+   El string recibido no se modifica ni se libera; el resultado (si es STRING) es del que llama.
+   Los errores (índices inválidos, feature desconocida) llaman a runtime_abort.
+*/
+RuntimeValue string_call_feature(const char *string, const char *feature_name, RuntimeValue *args, int arg_count);
+
+// Orden lexicográfico por bytes (como strcmp): < 0, 0 o > 0
+int string_compare(const char *a, const char *b);
+
+// Hash no negativo del contenido; el mismo valor con cualquier juego de kernels
+int string_hash(const char *s, size_t length);
+
+#endif // EIFFEL_STRING_H
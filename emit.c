@@ -0,0 +1,983 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ast.h"
+#include "interpreter.h"
+#include "parser.tab.h"
+#include "array.h"
+#include "eiffel_io.h"
+#include "link.h"
+#include "emit.h"
+#include "scoop.h"
+
+/* Comentario general:
+   - El archivo se genera en dos partes: primero los cuerpos de las rutinas (en memoria, con
+     open_memstream) y después el archivo completo: runtime, structs de las clases, globales,
+     prototipos, cuerpos y ayudantes por nombre. Así solo se generan los ayudantes que los
+     cuerpos usan.
+   - Ayudantes por nombre (lo que en el intérprete hacen resolve_feature y get_symbol):
+       * find_m (cls): la rutina m de la clase cls, o NULL (para obj.m (args)).
+       * get_a (obj) / set_a (obj, v): leer obj.a (rutina, atributo o atributo agregado) y escribirlo.
+       * vN_x (self): lo que vale el nombre x en una rutina de la clase N cuando no es una variable
+         del método (o todavía no se asignó): atributo de Current, variable global (rutinas de MAIN
+         sobre el scope global), rutina de la clase, consulta de entrada o error.
+   - Las rutinas de MAIN que se llaman desde MAIN.make corren sobre el scope global, igual que en
+     el intérprete: reciben self NULL.
+   - Una variable que no se declara (asignación sin 'local', cursor de un across) existe recién
+     cuando se asigna: lleva una bandera (d_x) y antes de eso el nombre se resuelve con vN_x.
+   - Los nombres de C llevan prefijo (l_, g_, a_, rN_...) para no chocar con palabras reservadas
+     ni con el runtime. Las clases se numeran por su posición en class_table (0: desconocida).
+   - Los temporales de las expresiones (statement expressions de GCC) tienen un número único; así
+     la evaluación es de izquierda a derecha, como en eval_ast.
+*/
+
+typedef struct {
+    const char **items;
+    int count;
+    int capacity;
+} NameList;
+
+// Variable de una rutina: parámetro, Result o local declarado (declared), o asignada sin declarar
+typedef struct {
+    const char *name;
+    const char *type_name;
+    int declared;
+} ScopeVar;
+
+typedef struct {
+    ClassDefinition *class_def;
+    int class_id;
+    int is_main;  // Rutina de MAIN: Current puede ser el scope global (self NULL)
+    int is_entry; // MAIN.make sobre el scope global: sus variables son globales de C
+    ScopeVar *vars;
+    int var_count;
+    int var_capacity;
+} RoutineScope;
+
+typedef struct {
+    FILE *out;
+    int temp;              // Contador de temporales
+    NameList methods;      // find_m
+    NameList getters;      // get_a
+    NameList setters;      // set_a
+    NameList *fallbacks;   // vN_x, por class_id
+    int fallback_count;
+    ClassDefinition *main_class;
+    RoutineScope globals;  // Variables de MAIN.make
+    int routines;
+} Emitter;
+
+static Emitter emitter;
+
+static void emit_expr(RoutineScope *scope, AstNode *node);
+static void emit_statements(RoutineScope *scope, StatementListNode *list, int depth);
+
+/* --- Listas de nombres y variables --- */
+
+static int name_list_add(NameList *list, const char *name) {
+    for (int i = 0; i < list->count; i++) {
+        if (strcmp(list->items[i], name) == 0) return 0;
+    }
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 16;
+        list->items = realloc(list->items, list->capacity * sizeof(char*));
+    }
+    list->items[list->count++] = name;
+    return 1;
+}
+
+static NameList *fallback_list(int class_id) {
+    if (class_id >= emitter.fallback_count) {
+        int count = class_id + 1;
+        emitter.fallbacks = realloc(emitter.fallbacks, count * sizeof(NameList));
+        memset(emitter.fallbacks + emitter.fallback_count, 0, (count - emitter.fallback_count) * sizeof(NameList));
+        emitter.fallback_count = count;
+    }
+    return &emitter.fallbacks[class_id];
+}
+
+static ScopeVar *scope_find(RoutineScope *scope, const char *name) {
+    for (int i = 0; i < scope->var_count; i++) {
+        if (strcmp(scope->vars[i].name, name) == 0) return &scope->vars[i];
+    }
+    return NULL;
+}
+
+// Como declare_symbol: un nombre repetido no se vuelve a declarar (solo recibe el tipo si no tenía)
+static void scope_add(RoutineScope *scope, const char *name, const char *type_name, int declared) {
+    ScopeVar *existing = scope_find(scope, name);
+    if (existing) {
+        if (!existing->type_name) existing->type_name = type_name;
+        return;
+    }
+    if (scope->var_count == scope->var_capacity) {
+        scope->var_capacity = scope->var_capacity ? scope->var_capacity * 2 : 8;
+        scope->vars = realloc(scope->vars, scope->var_capacity * sizeof(ScopeVar));
+    }
+    scope->vars[scope->var_count++] = (ScopeVar){ name, type_name, declared };
+}
+
+// Nombres que el cuerpo asigna sin declarar: set_symbol los crea en el scope del método
+static void collect_assigned(RoutineScope *scope, AstNode *node) {
+    if (!node) return;
+    switch (node->type) {
+        case NODE_TYPE_STATEMENT_LIST: {
+            StatementListNode *list = (StatementListNode*)node;
+            for (int i = 0; i < list->count; i++) collect_assigned(scope, list->statements[i]);
+            break;
+        }
+        case NODE_TYPE_ASSIGN: {
+            AssignNode *n = (AssignNode*)node;
+            if (n->target->type == NODE_TYPE_VARIABLE) scope_add(scope, ((VariableNode*)n->target)->name, NULL, 0);
+            break;
+        }
+        case NODE_TYPE_IF:
+            collect_assigned(scope, (AstNode*)((IfNode*)node)->then_branch);
+            collect_assigned(scope, (AstNode*)((IfNode*)node)->else_branch);
+            break;
+        case NODE_TYPE_LOOP:
+            collect_assigned(scope, (AstNode*)((LoopNode*)node)->initialization);
+            collect_assigned(scope, (AstNode*)((LoopNode*)node)->loop_body);
+            break;
+        case NODE_TYPE_ACROSS:
+            scope_add(scope, ((AcrossNode*)node)->cursor_name, "INTEGER", 0);
+            collect_assigned(scope, (AstNode*)((AcrossNode*)node)->loop_body);
+            break;
+        default:
+            break;
+    }
+}
+
+static int class_id_of(ClassDefinition *class_def) {
+    for (int i = 0; i < class_count; i++) {
+        if (class_table[i] == class_def) return i + 1;
+    }
+    return 0;
+}
+
+/* build_scope: variables de routine en el orden de invoke_method (parámetros, Result, locales) y
+   las que el cuerpo asigna. is_entry: MAIN.make sobre el scope global (sin parámetros ni Result). */
+static void build_scope(RoutineScope *scope, ClassDefinition *class_def, FeatureBodyNode *routine, int is_entry) {
+    memset(scope, 0, sizeof(*scope));
+    scope->class_def = class_def;
+    scope->class_id = class_id_of(class_def);
+    scope->is_main = class_def == emitter.main_class;
+    scope->is_entry = is_entry;
+    DeclarationListNode *params = routine->parameters;
+    for (int i = 0; !is_entry && params && i < params->count; i++) {
+        scope_add(scope, params->items[i].variable_name, params->items[i].type_name, 1);
+    }
+    if (!is_entry && routine->result_type) scope_add(scope, "Result", routine->result_type, 1);
+    DeclarationListNode *locals = routine->declarations;
+    for (int i = 0; locals && i < locals->count; i++) {
+        scope_add(scope, locals->items[i].variable_name, locals->items[i].type_name, 1);
+    }
+    collect_assigned(scope, (AstNode*)routine->statements);
+}
+
+static SymbolTableEntry *find_attribute(ClassDefinition *class_def, const char *name) {
+    for (int i = 0; i < class_def->prototype_count; i++) {
+        if (strcmp(class_def->prototype[i].name, name) == 0) return &class_def->prototype[i];
+    }
+    return NULL;
+}
+
+// Primera rutina con ese nombre (la que encuentra find_feature): es la única que se genera
+static int is_emitted_routine(ClassDefinition *class_def, FeatureBodyNode *routine) {
+    return find_feature(class_def->feature_list, routine->feature_name) == routine;
+}
+
+/* --- Expresiones --- */
+
+static void emit_indent(int depth) {
+    for (int i = 0; i < depth; i++) fputs("    ", emitter.out);
+}
+
+static void emit_c_string(const char *text) {
+    FILE *out = emitter.out;
+    fputc('"', out);
+    for (const unsigned char *p = (const unsigned char*)text; *p; p++) {
+        if (*p == '"' || *p == '\\') fprintf(out, "\\%c", *p);
+        else if (*p == '\n') fputs("\\n", out);
+        else if (*p < 32 || *p >= 127) fprintf(out, "\\%03o", *p);
+        else fputc(*p, out);
+    }
+    fputc('"', out);
+}
+
+// Valor inicial de un atributo, de Result o de una rutina once (default_value en el intérprete)
+static void emit_default(const char *type_name) {
+    if (type_name && strcmp(type_name, "INTEGER") == 0) fputs("rt_int(0)", emitter.out);
+    else if (type_name && strcmp(type_name, "REAL") == 0) fputs("rt_real(0.0)", emitter.out);
+    else if (type_name && strcmp(type_name, "STRING") == 0) fputs("rt_str(\"\")", emitter.out);
+    else if (type_name && strcmp(type_name, "BOOLEAN") == 0) fputs("rt_bool(0)", emitter.out);
+    else fputs("RT_NULL", emitter.out);
+}
+
+static void emit_var_name(RoutineScope *scope, ScopeVar *var) {
+    fprintf(emitter.out, "%s%s", scope->is_entry ? "g_" : "l_", var->name);
+}
+
+static void emit_var_flag(RoutineScope *scope, ScopeVar *var) {
+    fprintf(emitter.out, "%s%s", scope->is_entry ? "gd_" : "d_", var->name);
+}
+
+static void emit_fallback(RoutineScope *scope, const char *name) {
+    name_list_add(fallback_list(scope->class_id), name);
+    fprintf(emitter.out, "v%d_%s(self)", scope->class_id, name);
+}
+
+// Lectura de un nombre sin objeto: variable del método o, si no existe (todavía), vN_x
+static void emit_plain_read(RoutineScope *scope, const char *name) {
+    ScopeVar *var = scope_find(scope, name);
+    if (var && var->declared) {
+        emit_var_name(scope, var);
+    } else if (var) {
+        fputc('(', emitter.out);
+        emit_var_flag(scope, var);
+        fputs(" ? ", emitter.out);
+        emit_var_name(scope, var);
+        fputs(" : ", emitter.out);
+        emit_fallback(scope, name);
+        fputc(')', emitter.out);
+    } else {
+        emit_fallback(scope, name);
+    }
+}
+
+static void emit_name_read(RoutineScope *scope, const char *name) {
+    // Current es el objeto de la rutina; en el scope global no hay objeto y es un nombre más
+    if (strcmp(name, "Current") == 0 && !scope->is_entry) {
+        if (!scope->is_main) {
+            fputs("rt_obj(self)", emitter.out);
+            return;
+        }
+        fputs("(self ? rt_obj(self) : ", emitter.out);
+        emit_plain_read(scope, name);
+        fputc(')', emitter.out);
+        return;
+    }
+    emit_plain_read(scope, name);
+}
+
+// Current en una clase que no es MAIN: la clase del objeto se conoce al generar
+static int is_static_current(RoutineScope *scope, AstNode *node) {
+    return !scope->is_entry && !scope->is_main && node->type == NODE_TYPE_VARIABLE
+        && strcmp(((VariableNode*)node)->name, "Current") == 0;
+}
+
+// Operando que se puede evaluar en cualquier orden (sin efectos): literal o variable declarada
+static int is_simple_operand(RoutineScope *scope, AstNode *node) {
+    if (node->type == NODE_TYPE_LITERAL) return 1;
+    if (node->type != NODE_TYPE_VARIABLE || strcmp(((VariableNode*)node)->name, "Current") == 0) return 0;
+    ScopeVar *var = scope_find(scope, ((VariableNode*)node)->name);
+    return var && var->declared;
+}
+
+// Declara y evalúa los argumentos en orden en el arreglo aN; devuelve cuántos son
+static int emit_arguments(RoutineScope *scope, ArgumentListNode *args, int t) {
+    int count = args ? args->count : 0;
+    if (count == 0) return 0;
+    fprintf(emitter.out, "Value a%d[%d]; ", t, count);
+    for (int i = 0; i < count; i++) {
+        fprintf(emitter.out, "a%d[%d] = ", t, i);
+        emit_expr(scope, args->arguments[i]);
+        fputs("; ", emitter.out);
+    }
+    return count;
+}
+
+static void emit_argv(int count, int t) {
+    if (count) fprintf(emitter.out, "%d, a%d", count, t);
+    else fputs("0, NULL", emitter.out);
+}
+
+static void emit_routine_call(RoutineScope *scope, int class_id, const char *name, const char *self_expr,
+                              ArgumentListNode *args) {
+    if (!args || args->count == 0) {
+        fprintf(emitter.out, "r%d_%s(%s, 0, NULL)", class_id, name, self_expr);
+        return;
+    }
+    int t = ++emitter.temp;
+    fputs("({ ", emitter.out);
+    int count = emit_arguments(scope, args, t);
+    fprintf(emitter.out, "r%d_%s(%s, ", class_id, name, self_expr);
+    emit_argv(count, t);
+    fputs("); })", emitter.out);
+}
+
+static void emit_operands(RoutineScope *scope, AstNode *left, AstNode *right, const char *function, int op) {
+    FILE *out = emitter.out;
+    if (is_simple_operand(scope, left) && is_simple_operand(scope, right)) {
+        fprintf(out, "%s('%c', ", function, op);
+        emit_expr(scope, left);
+        fputs(", ", out);
+        emit_expr(scope, right);
+        fputc(')', out);
+        return;
+    }
+    int t = ++emitter.temp;
+    fprintf(out, "({ Value l%d = ", t);
+    emit_expr(scope, left);
+    fprintf(out, "; Value r%d = ", t);
+    emit_expr(scope, right);
+    fprintf(out, "; %s('%c', l%d, r%d); })", function, op, t, t);
+}
+
+static char comparison_code(int op) {
+    switch (op) {
+        case TOKEN_LT: return '<';
+        case TOKEN_LE: return 'L';
+        case TOKEN_GT: return '>';
+        case TOKEN_GE: return 'G';
+        default: return '=';
+    }
+}
+
+// Llamada sin objeto: print, rutina de la clase de Current, consulta de entrada o nada
+static void emit_unqualified_call(RoutineScope *scope, ProcedureCallNode *n) {
+    FILE *out = emitter.out;
+    int count = n->arguments ? n->arguments->count : 0;
+    if (strcmp(n->name, "print") == 0) {
+        fputs("({ ", out);
+        for (int i = 0; i < count; i++) {
+            fputs("rt_print(", out);
+            emit_expr(scope, n->arguments->arguments[i]);
+            fputs("); ", out);
+        }
+        fputs("putchar('\\n'); RT_VOID; })", out);
+    } else if (find_feature(scope->class_def->feature_list, n->name)) {
+        emit_routine_call(scope, scope->class_id, n->name, "self", n->arguments);
+    } else if (io_is_builtin(n->name)) {
+        fprintf(out, "rt_io_builtin(\"%s\", %d)", n->name, count);
+    } else {
+        fputs("RT_VOID", out);
+    }
+}
+
+static void emit_attribute_read(RoutineScope *scope, AttributeAccessNode *n) {
+    FILE *out = emitter.out;
+    if (is_static_current(scope, n->object_node)) {
+        if (find_feature(scope->class_def->feature_list, n->attribute_name)) {
+            fprintf(out, "r%d_%s(self, 0, NULL)", scope->class_id, n->attribute_name);
+        } else if (find_attribute(scope->class_def, n->attribute_name)) {
+            fprintf(out, "((C%d *)self)->a_%s", scope->class_id, n->attribute_name);
+        } else {
+            name_list_add(&emitter.getters, n->attribute_name);
+            fprintf(out, "get_%s(self)", n->attribute_name);
+        }
+        return;
+    }
+    name_list_add(&emitter.getters, n->attribute_name);
+    int t = ++emitter.temp;
+    fprintf(out, "({ Value t%d = ", t);
+    emit_expr(scope, n->object_node);
+    fprintf(out, "; t%d.type == V_OBJECT ? get_%s(t%d.as.o) : rt_is_builtin_target(t%d) ? rt_builtin(t%d, \"%s\", 0, NULL) : RT_VOID; })",
+            t, n->attribute_name, t, t, t, n->attribute_name);
+}
+
+static void emit_method_call(RoutineScope *scope, MethodCallNode *n) {
+    FILE *out = emitter.out;
+    if (is_static_current(scope, n->object_node)) {
+        if (find_feature(scope->class_def->feature_list, n->method_name)) {
+            emit_routine_call(scope, scope->class_id, n->method_name, "self", n->arguments);
+        } else {
+            fputs("RT_VOID", out);
+        }
+        return;
+    }
+    // Los argumentos se evalúan solo si hay algo que llamar (como en eval_ast)
+    name_list_add(&emitter.methods, n->method_name);
+    int t = ++emitter.temp;
+    fprintf(out, "({ Value t%d = ", t);
+    emit_expr(scope, n->object_node);
+    fprintf(out, "; int k%d = rt_is_builtin_target(t%d); Routine f%d = !k%d && t%d.type == V_OBJECT ? find_%s(t%d.as.o->cls) : NULL; ",
+            t, t, t, t, t, n->method_name, t);
+    fprintf(out, "Value r%d = RT_VOID; if (k%d || f%d) { ", t, t, t);
+    int count = emit_arguments(scope, n->arguments, t);
+    fprintf(out, "r%d = k%d ? rt_builtin(t%d, \"%s\", ", t, t, t, n->method_name);
+    emit_argv(count, t);
+    fprintf(out, ") : f%d(t%d.as.o, ", t, t);
+    emit_argv(count, t);
+    fprintf(out, "); } r%d; })", t);
+}
+
+static void emit_statement(RoutineScope *scope, AstNode *node, int depth);
+
+/* emit_condition: una condición como int de C (eval_condition en el intérprete). Los operadores
+   BOOLEAN son && y || de C, así 'and then', 'or else' e 'implies' saltan el operando derecho;
+   'and' y 'or' evalúan los dos operandos en orden antes de combinarlos. */
+static void emit_condition(RoutineScope *scope, AstNode *node) {
+    FILE *out = emitter.out;
+    if (!node || node->type != NODE_TYPE_BOOLEAN_EXPR) {
+        fputs("(", out);
+        emit_expr(scope, node);
+        fputs(").as.i", out);
+        return;
+    }
+    BooleanExprNode *n = (BooleanExprNode*)node;
+    if (n->op == BOOL_AND || n->op == BOOL_OR) {
+        int t = ++emitter.temp;
+        fprintf(out, "({ int l%d = ", t);
+        emit_condition(scope, n->left);
+        fprintf(out, "; int r%d = ", t);
+        emit_condition(scope, n->right);
+        fprintf(out, "; l%d %s r%d; })", t, n->op == BOOL_AND ? "&&" : "||", t);
+        return;
+    }
+    fputs(n->op == BOOL_IMPLIES || n->op == BOOL_NOT ? "(!" : "(", out);
+    emit_condition(scope, n->left);
+    if (n->op != BOOL_NOT) {
+        fputs(n->op == BOOL_AND_THEN ? " && " : " || ", out);
+        emit_condition(scope, n->right);
+    }
+    fputs(")", out);
+}
+
+static void emit_expr(RoutineScope *scope, AstNode *node) {
+    FILE *out = emitter.out;
+    if (!node) {
+        fputs("RT_VOID", out);
+        return;
+    }
+    switch (node->type) {
+        case NODE_TYPE_LITERAL: {
+            LiteralNode *n = (LiteralNode*)node;
+            if (n->literal_type == LITERAL_TYPE_INT) {
+                fprintf(out, "rt_int(%d)", n->value.int_val);
+            } else if (n->literal_type == LITERAL_TYPE_BOOLEAN) {
+                fprintf(out, "rt_bool(%d)", n->value.int_val);
+            } else if (n->literal_type == LITERAL_TYPE_REAL) {
+                fprintf(out, "rt_real(%a)", n->value.real_val); // Hexadecimal: el mismo double exacto
+            } else {
+                fputs("rt_str((char *)", out);
+                emit_c_string(n->value.string_val);
+                fputc(')', out);
+            }
+            break;
+        }
+        case NODE_TYPE_BINARY_EXPR: {
+            BinaryExprNode *n = (BinaryExprNode*)node;
+            emit_operands(scope, n->left, n->right, "rt_arith", n->op);
+            break;
+        }
+        case NODE_TYPE_COMPARISON_EXPR: {
+            ComparisonExprNode *n = (ComparisonExprNode*)node;
+            emit_operands(scope, n->left, n->right, "rt_compare", comparison_code(n->op));
+            break;
+        }
+        case NODE_TYPE_BOOLEAN_EXPR:
+            fputs("rt_bool(", out);
+            emit_condition(scope, node);
+            fputc(')', out);
+            break;
+        case NODE_TYPE_VARIABLE:
+            emit_name_read(scope, ((VariableNode*)node)->name);
+            break;
+        case NODE_TYPE_PROCEDURE_CALL:
+            emit_unqualified_call(scope, (ProcedureCallNode*)node);
+            break;
+        case NODE_TYPE_ATTRIBUTE_ACCESS:
+            emit_attribute_read(scope, (AttributeAccessNode*)node);
+            break;
+        case NODE_TYPE_METHOD_CALL:
+            emit_method_call(scope, (MethodCallNode*)node);
+            break;
+        default:
+            // Una sentencia usada como expresión vale VOID (como en eval_ast)
+            fputs("({\n", out);
+            emit_statement(scope, node, 1);
+            fputs("RT_VOID; })", out);
+            break;
+    }
+}
+
+/* --- Sentencias --- */
+
+static void emit_assign(RoutineScope *scope, AssignNode *n, int depth) {
+    FILE *out = emitter.out;
+    emit_indent(depth);
+    if (n->target->type == NODE_TYPE_VARIABLE) {
+        ScopeVar *var = scope_find(scope, ((VariableNode*)n->target)->name); // collect_assigned la agregó
+        emit_var_name(scope, var);
+        fputs(" = ", out);
+        emit_expr(scope, n->expression);
+        fputs(";", out);
+        if (!var->declared) {
+            fputc(' ', out);
+            emit_var_flag(scope, var);
+            fputs(" = 1;", out);
+        }
+        fputc('\n', out);
+        return;
+    }
+    if (n->target->type != NODE_TYPE_ATTRIBUTE_ACCESS) {
+        fputs("(void)", out);
+        emit_expr(scope, n->expression);
+        fputs(";\n", out);
+        return;
+    }
+    AttributeAccessNode *target = (AttributeAccessNode*)n->target;
+    if (is_static_current(scope, target->object_node)) {
+        if (find_attribute(scope->class_def, target->attribute_name)) {
+            fprintf(out, "((C%d *)self)->a_%s = ", scope->class_id, target->attribute_name);
+            emit_expr(scope, n->expression);
+            fputs(";\n", out);
+        } else {
+            fprintf(out, "rt_extra_set(self, \"%s\", ", target->attribute_name);
+            emit_expr(scope, n->expression);
+            fputs(");\n", out);
+        }
+        return;
+    }
+    // Como en eval_ast: primero el valor, después el objeto
+    name_list_add(&emitter.setters, target->attribute_name);
+    int t = ++emitter.temp;
+    fprintf(out, "{ Value v%d = ", t);
+    emit_expr(scope, n->expression);
+    fprintf(out, "; Value t%d = ", t);
+    emit_expr(scope, target->object_node);
+    fprintf(out, "; if (t%d.type == V_OBJECT) set_%s(t%d.as.o, v%d); }\n", t, target->attribute_name, t, t);
+}
+
+static void emit_if(RoutineScope *scope, IfNode *n, int depth) {
+    FILE *out = emitter.out;
+    emit_indent(depth);
+    fputs("if (", out);
+    emit_condition(scope, n->condition);
+    fputs(") {\n", out);
+    emit_statements(scope, n->then_branch, depth + 1);
+    emit_indent(depth);
+    fputs("} else {\n", out);
+    emit_statements(scope, n->else_branch, depth + 1);
+    emit_indent(depth);
+    fputs("}\n", out);
+}
+
+static void emit_loop(RoutineScope *scope, LoopNode *n, int depth) {
+    FILE *out = emitter.out;
+    emit_statements(scope, n->initialization, depth);
+    emit_indent(depth);
+    fputs("while (!", out);
+    emit_condition(scope, n->condition);
+    fputs(") {\n", out);
+    emit_statements(scope, n->loop_body, depth + 1);
+    emit_indent(depth);
+    fputs("}\n", out);
+}
+
+// Un across paralelo da el mismo resultado que uno secuencial (ver parallel.h): se genera igual
+static void emit_across(RoutineScope *scope, AcrossNode *n, int depth) {
+    FILE *out = emitter.out;
+    ScopeVar *cursor = scope_find(scope, n->cursor_name);
+    int t = ++emitter.temp;
+    emit_indent(depth);
+    fprintf(out, "{ // across%s as %s\n", n->is_parallel ? " parallel" : "", n->cursor_name);
+    emit_indent(depth + 1);
+    fprintf(out, "Value lo%d = ", t);
+    emit_expr(scope, n->lower);
+    fprintf(out, "; Value hi%d = ", t);
+    emit_expr(scope, n->upper);
+    fputs(";\n", out);
+    emit_indent(depth + 1);
+    fprintf(out, "if (lo%d.type != V_INT || hi%d.type != V_INT) rt_fail(\"Error: Los límites de un across deben ser INTEGER.\\n\");\n", t, t);
+    if (!cursor->declared) {
+        // declare_symbol: si el cursor no existía, queda declarado (sin valor) aunque no haya vueltas
+        emit_indent(depth + 1);
+        fputs("if (!", out);
+        emit_var_flag(scope, cursor);
+        fputs(") { ", out);
+        emit_var_flag(scope, cursor);
+        fputs(" = 1; ", out);
+        emit_var_name(scope, cursor);
+        fputs(" = RT_NULL; }\n", out);
+    }
+    emit_indent(depth + 1);
+    fprintf(out, "for (int i%d = lo%d.as.i; i%d <= hi%d.as.i; i%d++) {\n", t, t, t, t, t);
+    emit_indent(depth + 2);
+    emit_var_name(scope, cursor);
+    fprintf(out, " = rt_int(i%d);\n", t);
+    emit_statements(scope, n->loop_body, depth + 2);
+    emit_indent(depth + 2);
+    fprintf(out, "if (i%d == hi%d.as.i) break;\n", t, t);
+    emit_indent(depth + 1);
+    fputs("}\n", out);
+    emit_indent(depth);
+    fputs("}\n", out);
+}
+
+/* emit_create: como NODE_TYPE_CREATE, solo actúa si la variable es del scope actual y está sin
+   valor; la clase sale del tipo declarado (COUNTER si no tiene; de 'separate X', X). find_class puede cargar una
+   clase del class path: queda al final de class_table y emit_program también la genera. */
+static void emit_create(RoutineScope *scope, CreateNode *n, int depth) {
+    FILE *out = emitter.out;
+    ScopeVar *var = scope_find(scope, n->object_name);
+    emit_indent(depth);
+    if (!var) {
+        fprintf(out, "// create %s: no es una variable de este scope\n", n->object_name);
+        return;
+    }
+    const char *type_name = var->type_name ? separate_base_type(var->type_name) : "COUNTER";
+    int t = ++emitter.temp;
+    fputs("if (", out);
+    if (!var->declared) {
+        emit_var_flag(scope, var);
+        fputs(" && ", out);
+    }
+    emit_var_name(scope, var);
+    fputs(".type == V_NULL) { ", out);
+    if (is_array_type(type_name)) {
+        int count = emit_arguments(scope, n->arguments, t);
+        fprintf(out, "Value x%d = rt_arr(rt_array_new(\"%s\")); ", t, type_name);
+        if (n->creation_procedure) {
+            fprintf(out, "rt_array_feature(x%d.as.a, \"%s\", ", t, n->creation_procedure);
+            emit_argv(count, t);
+            fputs("); ", out);
+        }
+        emit_var_name(scope, var);
+        fprintf(out, " = x%d; }\n", t);
+    } else if (is_file_type(type_name)) {
+        int count = emit_arguments(scope, n->arguments, t);
+        fprintf(out, "Value x%d = rt_file(rt_file_new()); ", t);
+        emit_var_name(scope, var);
+        fprintf(out, " = x%d; ", t);
+        if (n->creation_procedure) {
+            fprintf(out, "rt_file_feature(x%d.as.f, \"%s\", ", t, n->creation_procedure);
+            emit_argv(count, t);
+            fputs("); ", out);
+        }
+        fputs("}\n", out);
+    } else {
+        ClassDefinition *class_def = find_class(type_name);
+        if (!class_def) {
+            emit_var_name(scope, var);
+            fputs(" = rt_obj(rt_new_unknown()); }\n", out);
+            return;
+        }
+        int class_id = class_id_of(class_def);
+        fprintf(out, "Obj *o%d = new%d(); ", t, class_id);
+        emit_var_name(scope, var);
+        fprintf(out, " = rt_obj(o%d); ", t);
+        if (n->creation_procedure && find_feature(class_def->feature_list, n->creation_procedure)) {
+            char self_expr[32];
+            snprintf(self_expr, sizeof(self_expr), "o%d", t);
+            fputs("(void)", out);
+            emit_routine_call(scope, class_id, n->creation_procedure, self_expr, n->arguments);
+            fputs("; ", out);
+        }
+        fputs("}\n", out);
+    }
+}
+
+static void emit_statement(RoutineScope *scope, AstNode *node, int depth) {
+    if (!node) return;
+    switch (node->type) {
+        case NODE_TYPE_STATEMENT_LIST:
+            emit_statements(scope, (StatementListNode*)node, depth);
+            break;
+        case NODE_TYPE_ASSIGN:
+            emit_assign(scope, (AssignNode*)node, depth);
+            break;
+        case NODE_TYPE_IF:
+            emit_if(scope, (IfNode*)node, depth);
+            break;
+        case NODE_TYPE_LOOP:
+            emit_loop(scope, (LoopNode*)node, depth);
+            break;
+        case NODE_TYPE_ACROSS:
+            emit_across(scope, (AcrossNode*)node, depth);
+            break;
+        case NODE_TYPE_CREATE:
+            emit_create(scope, (CreateNode*)node, depth);
+            break;
+        case NODE_TYPE_CLASS_DECL:
+        case NODE_TYPE_FEATURE_BODY:
+        case NODE_TYPE_DECLARATION_LIST:
+        case NODE_TYPE_ARGUMENT_LIST:
+            break;
+        default:
+            emit_indent(depth);
+            fputs("(void)", emitter.out);
+            emit_expr(scope, node);
+            fputs(";\n", emitter.out);
+            break;
+    }
+}
+
+static void emit_statements(RoutineScope *scope, StatementListNode *list, int depth) {
+    for (int i = 0; list && i < list->count; i++) emit_statement(scope, list->statements[i], depth);
+}
+
+/* --- Rutinas --- */
+
+static void emit_routine(ClassDefinition *class_def, int class_id, FeatureBodyNode *routine) {
+    FILE *out = emitter.out;
+    RoutineScope scope;
+    build_scope(&scope, class_def, routine, 0);
+    fprintf(out, "// %s.%s\n", class_def->name, routine->feature_name);
+    fprintf(out, "static Value r%d_%s(Obj *self, int argc, Value *argv) {\n", class_id, routine->feature_name);
+    if (routine->routine_kind == ROUTINE_ONCE) {
+        fputs("    static int once_done = 0;\n    static Value once_value;\n", out);
+        fputs("    int *done = &once_done;\n    Value *saved = &once_value;\n", out);
+    } else if (routine->routine_kind == ROUTINE_ONCE_OBJECT && scope.is_main) {
+        int k = routine->once_index;
+        fprintf(out, "    int *done = self ? &((C%d *)self)->od_%d : &god_%d;\n", class_id, k, k);
+        fprintf(out, "    Value *saved = self ? &((C%d *)self)->ov_%d : &gov_%d;\n", class_id, k, k);
+    } else if (routine->routine_kind == ROUTINE_ONCE_OBJECT) {
+        int k = routine->once_index;
+        fprintf(out, "    int *done = &((C%d *)self)->od_%d;\n", class_id, k);
+        fprintf(out, "    Value *saved = &((C%d *)self)->ov_%d;\n", class_id, k);
+    }
+    if (routine->routine_kind != ROUTINE_DO) {
+        // Marcada antes del cuerpo: una llamada recursiva recibe el valor por defecto
+        fputs("    if (*done) return *saved;\n    *done = 1;\n    *saved = ", out);
+        emit_default(routine->result_type);
+        fputs(";\n", out);
+    }
+    DeclarationListNode *params = routine->parameters;
+    fprintf(out, "    rt_check_args(\"%s\", %d, argc);\n", routine->feature_name, params ? params->count : 0);
+    for (int i = 0; i < scope.var_count; i++) {
+        fprintf(out, "    Value l_%s = RT_NULL;", scope.vars[i].name);
+        if (!scope.vars[i].declared) fprintf(out, " int d_%s = 0;", scope.vars[i].name);
+        fputc('\n', out);
+    }
+    for (int i = 0; params && i < params->count; i++) {
+        const char *type_name = params->items[i].type_name;
+        int is_real = type_name && strcmp(type_name, "REAL") == 0;
+        fprintf(out, "    l_%s = %sargv[%d]%s;\n", params->items[i].variable_name, is_real ? "rt_real_param(" : "", i,
+                is_real ? ")" : "");
+    }
+    if (routine->result_type) {
+        fputs("    l_Result = ", out);
+        emit_default(routine->result_type);
+        fputs(";\n", out);
+    }
+    emit_statements(&scope, routine->statements, 1);
+    const char *result = routine->result_type ? "l_Result" : "RT_VOID";
+    if (routine->routine_kind != ROUTINE_DO) fprintf(out, "    *saved = %s;\n    return *saved;\n}\n\n", result);
+    else fprintf(out, "    return %s;\n}\n\n", result);
+    free(scope.vars);
+    emitter.routines++;
+}
+
+// MAIN.make tal como lo ejecuta run_program: sobre el scope global, sin objeto
+static void emit_entry(FeatureBodyNode *make) {
+    fputs("// MAIN.make sobre el scope global\n", emitter.out);
+    fputs("static void entry(void) {\n    Obj *self = NULL;\n    (void)self;\n", emitter.out);
+    emit_statements(&emitter.globals, make->statements, 1);
+    fputs("}\n\n", emitter.out);
+}
+
+/* --- Archivo completo --- */
+
+static void emit_class_structs(FILE *out) {
+    fputs("static const char *const rt_class_names[] = { NULL", out);
+    for (int i = 0; i < class_count; i++) fprintf(out, ", \"%s\"", class_table[i]->name);
+    fputs(" };\n\nstatic const char *rt_class_name(int cls) { return rt_class_names[cls]; }\n\n", out);
+    for (int i = 0; i < class_count; i++) {
+        ClassDefinition *class_def = class_table[i];
+        int id = i + 1;
+        fprintf(out, "// class %s\ntypedef struct {\n    Obj base;\n", class_def->name);
+        for (int a = 0; a < class_def->prototype_count; a++) fprintf(out, "    Value a_%s;\n", class_def->prototype[a].name);
+        StatementListNode *features = class_def->feature_list;
+        for (int f = 0; features && f < features->count; f++) {
+            if (features->statements[f]->type != NODE_TYPE_FEATURE_BODY) continue;
+            FeatureBodyNode *routine = (FeatureBodyNode*)features->statements[f];
+            if (routine->routine_kind == ROUTINE_ONCE_OBJECT) {
+                fprintf(out, "    int od_%d;\n    Value ov_%d;\n", routine->once_index, routine->once_index);
+            }
+        }
+        fprintf(out, "} C%d;\n\n", id);
+        fprintf(out, "static Obj *new%d(void) {\n    C%d *o = rt_alloc(sizeof(C%d));\n    o->base.cls = %d;\n", id, id, id, id);
+        emitter.out = out;
+        for (int a = 0; a < class_def->prototype_count; a++) {
+            fprintf(out, "    o->a_%s = ", class_def->prototype[a].name);
+            emit_default(class_def->prototype[a].type_name);
+            fputs(";\n", out);
+        }
+        fputs("    return &o->base;\n}\n\n", out);
+    }
+}
+
+static void emit_globals(FILE *out) {
+    fputs("// Variables de MAIN.make (scope global)\n", out);
+    for (int i = 0; i < emitter.globals.var_count; i++) {
+        ScopeVar *var = &emitter.globals.vars[i];
+        fprintf(out, "static Value g_%s = { .type = V_NULL };\n", var->name);
+        if (!var->declared) fprintf(out, "static int gd_%s = 0;\n", var->name);
+    }
+    // Resultados once ("OBJECT") de MAIN cuando el objeto es el scope global
+    StatementListNode *features = emitter.main_class->feature_list;
+    for (int f = 0; features && f < features->count; f++) {
+        if (features->statements[f]->type != NODE_TYPE_FEATURE_BODY) continue;
+        FeatureBodyNode *routine = (FeatureBodyNode*)features->statements[f];
+        if (routine->routine_kind == ROUTINE_ONCE_OBJECT) {
+            fprintf(out, "static int god_%d = 0;\nstatic Value gov_%d;\n", routine->once_index, routine->once_index);
+        }
+    }
+    fputc('\n', out);
+}
+
+static void emit_prototypes(FILE *out) {
+    for (int i = 0; i < class_count; i++) {
+        StatementListNode *features = class_table[i]->feature_list;
+        for (int f = 0; features && f < features->count; f++) {
+            if (features->statements[f]->type != NODE_TYPE_FEATURE_BODY) continue;
+            FeatureBodyNode *routine = (FeatureBodyNode*)features->statements[f];
+            if (!is_emitted_routine(class_table[i], routine)) continue;
+            fprintf(out, "static Value r%d_%s(Obj *self, int argc, Value *argv);\n", i + 1, routine->feature_name);
+        }
+    }
+    for (int i = 0; i < emitter.methods.count; i++) fprintf(out, "static Routine find_%s(int cls);\n", emitter.methods.items[i]);
+    for (int i = 0; i < emitter.getters.count; i++) fprintf(out, "static Value get_%s(Obj *o);\n", emitter.getters.items[i]);
+    for (int i = 0; i < emitter.setters.count; i++) fprintf(out, "static void set_%s(Obj *o, Value v);\n", emitter.setters.items[i]);
+    for (int c = 0; c < emitter.fallback_count; c++) {
+        for (int i = 0; i < emitter.fallbacks[c].count; i++) {
+            fprintf(out, "static Value v%d_%s(Obj *self);\n", c, emitter.fallbacks[c].items[i]);
+        }
+    }
+    fputc('\n', out);
+}
+
+static void emit_finders(FILE *out) {
+    for (int m = 0; m < emitter.methods.count; m++) {
+        const char *name = emitter.methods.items[m];
+        fprintf(out, "static Routine find_%s(int cls) {\n    switch (cls) {\n", name);
+        for (int i = 0; i < class_count; i++) {
+            if (find_feature(class_table[i]->feature_list, name)) fprintf(out, "        case %d: return r%d_%s;\n", i + 1, i + 1, name);
+        }
+        fputs("        default: return NULL;\n    }\n}\n\n", out);
+    }
+}
+
+// get_a: como obj.a en eval_ast (primero una rutina de la clase, después el atributo)
+static void emit_getters(FILE *out) {
+    for (int g = 0; g < emitter.getters.count; g++) {
+        const char *name = emitter.getters.items[g];
+        fprintf(out, "static Value get_%s(Obj *o) {\n    Value v;\n    switch (o->cls) {\n", name);
+        for (int i = 0; i < class_count; i++) {
+            if (find_feature(class_table[i]->feature_list, name)) {
+                fprintf(out, "        case %d: return r%d_%s(o, 0, NULL);\n", i + 1, i + 1, name);
+            } else if (find_attribute(class_table[i], name)) {
+                fprintf(out, "        case %d: return ((C%d *)o)->a_%s;\n", i + 1, i + 1, name);
+            }
+        }
+        fprintf(out, "        default: break;\n    }\n    if (rt_extra_find(o, \"%s\", &v)) return v;\n", name);
+        fprintf(out, "    return rt_undefined(\"%s\");\n}\n\n", name);
+    }
+    for (int s = 0; s < emitter.setters.count; s++) {
+        const char *name = emitter.setters.items[s];
+        fprintf(out, "static void set_%s(Obj *o, Value v) {\n    switch (o->cls) {\n", name);
+        for (int i = 0; i < class_count; i++) {
+            if (find_attribute(class_table[i], name)) fprintf(out, "        case %d: ((C%d *)o)->a_%s = v; return;\n", i + 1, i + 1, name);
+        }
+        fprintf(out, "        default: break;\n    }\n    rt_extra_set(o, \"%s\", v);\n}\n\n", name);
+    }
+}
+
+// vN_x: la cadena de búsqueda de NODE_TYPE_VARIABLE después del scope del método
+static void emit_fallbacks(FILE *out) {
+    for (int c = 1; c < emitter.fallback_count; c++) {
+        ClassDefinition *class_def = class_table[c - 1];
+        int is_main = class_def == emitter.main_class;
+        for (int i = 0; i < emitter.fallbacks[c].count; i++) {
+            const char *name = emitter.fallbacks[c].items[i];
+            fprintf(out, "static Value v%d_%s(Obj *self) {\n    Value v;\n    (void)v;\n", c, name);
+            if (is_main) {
+                fputs("    if (!self) {\n", out);
+                ScopeVar *global = scope_find(&emitter.globals, name);
+                if (global && global->declared) fprintf(out, "        return g_%s;\n", name);
+                else if (global) fprintf(out, "        if (gd_%s) return g_%s;\n", name, name);
+                fputs("    } else {\n", out);
+            }
+            if (find_attribute(class_def, name)) {
+                fprintf(out, "    return ((C%d *)self)->a_%s;\n", c, name);
+            } else {
+                fprintf(out, "    if (rt_extra_find(self, \"%s\", &v)) return v;\n", name);
+            }
+            if (is_main) fputs("    }\n", out);
+            if (find_feature(class_def->feature_list, name)) {
+                fprintf(out, "    return r%d_%s(self, 0, NULL);\n", c, name);
+            } else if (io_is_builtin(name)) {
+                fprintf(out, "    return rt_io_builtin(\"%s\", 0);\n", name);
+            } else {
+                fprintf(out, "    return rt_undefined(\"%s\");\n", name);
+            }
+            fputs("}\n\n", out);
+        }
+    }
+}
+
+static void reset_emitter(void) {
+    free(emitter.methods.items);
+    free(emitter.getters.items);
+    free(emitter.setters.items);
+    for (int i = 0; i < emitter.fallback_count; i++) free(emitter.fallbacks[i].items);
+    free(emitter.fallbacks);
+    free(emitter.globals.vars);
+    memset(&emitter, 0, sizeof(emitter));
+}
+
+int emit_program(const char *path, FILE *info_output) {
+    ClassDefinition *main_class = find_class("MAIN");
+    FeatureBodyNode *make = main_class ? find_feature(main_class->feature_list, "make") : NULL;
+    if (!make) {
+        fprintf(stderr, "Error: --emit-c necesita una clase MAIN con make.\n");
+        return 1;
+    }
+    link_program(0, info_output);
+
+    FILE *target = fopen(path, "w");
+    if (!target) {
+        fprintf(stderr, "No se pudo crear el archivo %s.\n", path);
+        return 1;
+    }
+    char *bodies = NULL;
+    size_t bodies_size = 0;
+    emitter.out = open_memstream(&bodies, &bodies_size);
+    emitter.main_class = main_class;
+    load_feature_body(make); // Con cuerpos diferidos (y EIFFEL_NO_LINK) nadie los parseó todavía
+    build_scope(&emitter.globals, main_class, make, 1);
+    emit_entry(make);
+    for (int i = 0; i < class_count; i++) { // class_count puede crecer (ver emit_create)
+        StatementListNode *features = class_table[i]->feature_list;
+        for (int f = 0; features && f < features->count; f++) {
+            if (features->statements[f]->type != NODE_TYPE_FEATURE_BODY) continue;
+            FeatureBodyNode *routine = (FeatureBodyNode*)features->statements[f];
+            if (!is_emitted_routine(class_table[i], routine)) continue;
+            load_feature_body(routine);
+            emit_routine(class_table[i], i + 1, routine);
+        }
+    }
+    fclose(emitter.out);
+
+    fputs("/* Generado por 'interpreter --emit-c': compilar con gcc -O2 archivo.c -lm */\n\n", target);
+    fputs(emit_runtime_source, target);
+    fputc('\n', target);
+    emit_class_structs(target);
+    emit_globals(target);
+    emit_prototypes(target);
+    fputs("static void entry(void);\n\n", target);
+    fwrite(bodies, 1, bodies_size, target);
+    emit_finders(target);
+    emit_getters(target);
+    emit_fallbacks(target);
+    fputs("int main(void) {\n    entry();\n    return 0;\n}\n", target);
+    int failed = ferror(target);
+    fclose(target);
+    free(bodies);
+
+    if (info_output) {
+        fprintf(info_output, "--- Emit C ---\n");
+        fprintf(info_output, "  %-12s %s\n", "file", path);
+        fprintf(info_output, "  %-12s %d\n", "classes", class_count);
+        fprintf(info_output, "  %-12s %d\n", "routines", emitter.routines);
+        fprintf(info_output, "--------------\n");
+    }
+    reset_emitter();
+    if (failed) {
+        fprintf(stderr, "Error al escribir %s.\n", path);
+        return 1;
+    }
+    return 0;
+}
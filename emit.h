@@ -0,0 +1,31 @@
+#ifndef EMIT_H
+#define EMIT_H
+
+#include <stdio.h>
+
+/* Comentario general:
+   - Compilación anticipada ('--emit-c salida.c', ver main.c): en vez de ejecutar MAIN.make se
+     escribe una unidad de traducción C independiente que hace lo mismo, para compilar con
+     'gcc -O2 salida.c -lm'.
+   - Cada clase registrada (después del enlace, ver link.h) es un struct que empieza con la
+     cabecera Obj y tiene un campo por atributo; cada rutina es una función C; los parámetros,
+     locales y Result son variables C. Las variables locales de MAIN.make son globales de C.
+   - Los valores siguen siendo etiquetados (Value, igual que RuntimeValue): el programa C tiene
+     exactamente las mismas reglas de tipos que el intérprete, incluidos los nombres que se
+     resuelven al ejecutar (una variable que todavía no se asignó cae en el atributo del objeto,
+     una llamada sobre un objeto busca la rutina según su clase).
+   - El runtime (aritmética, print, STRING, ARRAY, PLAIN_TEXT_FILE y entrada estándar) se copia
+     al principio del archivo: ver emit_runtime.c.
+   - Un across paralelo se compila como un across secuencial (mismo resultado), y un objeto
+     separate como un objeto común: sus llamadas se hacen en el momento, en orden. Imágenes,
+     límites de ejecución (meter.h) y memstats no tienen equivalente en el programa generado.
+*/
+
+/* emit_program: genera el C de las clases registradas en path (MAIN.make es el punto de entrada).
+   Escribe un resumen en info_output (si no es NULL). Devuelve 0 si pudo, 1 si hubo un error. */
+int emit_program(const char *path, FILE *info_output);
+
+// Código fuente del runtime que encabeza cada archivo generado (emit_runtime.c)
+extern const char emit_runtime_source[];
+
+#endif // EMIT_H
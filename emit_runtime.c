@@ -0,0 +1,722 @@
+/* Comentario general:
+   - Runtime de los programas que genera --emit-c (ver emit.h): emit_program lo copia tal cual al
+     principio de cada archivo, antes de las clases y rutinas del programa.
+   - Reproduce las reglas del intérprete: Value es RuntimeValue (mismo orden de tipos), rt_arith y
+     rt_compare son eval_binary y eval_comparison, rt_print es print_value, y las features de
+     STRING, ARRAY y PLAIN_TEXT_FILE son las de eiffel_string.c, array.c y eiffel_io.c (mismos
+     resultados y mensajes de error, en sus versiones escalares).
+   - Los STRING no se modifican nunca: se comparten y no se liberan (el programa generado no
+     tiene la contabilidad de memoria de memstats.h).
+*/
+
+#include "emit.h"
+
+const char emit_runtime_source[] =
+    "/* --- Runtime (copiado por --emit-c): valores, STRING, ARRAY, PLAIN_TEXT_FILE y print --- */\n"
+    "#include <stdio.h>\n"
+    "#include <stdlib.h>\n"
+    "#include <string.h>\n"
+    "#include <stdint.h>\n"
+    "#include <stdarg.h>\n"
+    "#include <limits.h>\n"
+    "#include <errno.h>\n"
+    "\n"
+    "// Cada programa usa solo una parte del runtime\n"
+    "#pragma GCC diagnostic ignored \"-Wunused-function\"\n"
+    "\n"
+    "typedef enum { V_INT, V_REAL, V_STRING, V_VOID, V_OBJECT, V_ARRAY, V_NULL, V_FILE, V_BOOL } VType;\n"
+    "\n"
+    "struct Obj;\n"
+    "struct Arr;\n"
+    "struct File;\n"
+    "\n"
+    "typedef struct {\n"
+    "    VType type;\n"
+    "    union {\n"
+    "        int i;\n"
+    "        double r;\n"
+    "        char *s;\n"
+    "        struct Obj *o;\n"
+    "        struct Arr *a;\n"
+    "        struct File *f;\n"
+    "    } as;\n"
+    "} Value;\n"
+    "\n"
+    "// Atributo que no está en la clase (obj.x := v sobre un nombre no declarado)\n"
+    "typedef struct Extra {\n"
+    "    const char *name;\n"
+    "    Value value;\n"
+    "    struct Extra *next;\n"
+    "} Extra;\n"
+    "\n"
+    "// Cabecera de todos los objetos; cada clase es un struct que empieza con Obj\n"
+    "typedef struct Obj {\n"
+    "    int cls;\n"
+    "    Extra *extra;\n"
+    "} Obj;\n"
+    "\n"
+    "typedef Value (*Routine)(Obj *self, int argc, Value *argv);\n"
+    "\n"
+    "static const char *rt_class_name(int cls); // Generada con las clases del programa\n"
+    "\n"
+    "static Value rt_int(int i) { Value v = { .type = V_INT }; v.as.i = i; return v; }\n"
+    "static Value rt_real(double r) { Value v = { .type = V_REAL }; v.as.r = r; return v; }\n"
+    "static Value rt_bool(int b) { Value v = { .type = V_BOOL }; v.as.i = b != 0; return v; }\n"
+    "static Value rt_str(char *s) { Value v = { .type = V_STRING }; v.as.s = s; return v; }\n"
+    "static Value rt_obj(Obj *o) { Value v = { .type = V_OBJECT }; v.as.o = o; return v; }\n"
+    "static const Value RT_VOID = { .type = V_VOID };\n"
+    "static const Value RT_NULL = { .type = V_NULL };\n"
+    "\n"
+    "static void rt_fail(const char *format, ...) {\n"
+    "    va_list args;\n"
+    "    fflush(stdout);\n"
+    "    va_start(args, format);\n"
+    "    vfprintf(stderr, format, args);\n"
+    "    va_end(args);\n"
+    "    exit(1);\n"
+    "}\n"
+    "\n"
+    "static void *rt_alloc(size_t size) {\n"
+    "    void *block = calloc(1, size ? size : 1);\n"
+    "    if (!block) rt_fail(\"Error: No hay memoria.\\n\");\n"
+    "    return block;\n"
+    "}\n"
+    "\n"
+    "// Los STRING no se modifican nunca: se comparten en vez de copiarse\n"
+    "static char *rt_strndup(const char *text, size_t length) {\n"
+    "    char *copy = rt_alloc(length + 1);\n"
+    "    memcpy(copy, text, length);\n"
+    "    return copy;\n"
+    "}\n"
+    "\n"
+    "// Objeto de una clase desconocida (create con un tipo que no es una clase): sin atributos\n"
+    "static Obj *rt_new_unknown(void) {\n"
+    "    return rt_alloc(sizeof(Obj));\n"
+    "}\n"
+    "\n"
+    "static Value rt_undefined(const char *name) {\n"
+    "    rt_fail(\"Error: Variable '%s' no definida.\\n\", name);\n"
+    "    return RT_VOID;\n"
+    "}\n"
+    "\n"
+    "static void rt_check_args(const char *name, int expected, int argc) {\n"
+    "    if (argc != expected) rt_fail(\"Error: '%s' espera %d argumento(s) y recibió %d.\\n\", name, expected, argc);\n"
+    "}\n"
+    "\n"
+    "// Argumento de un parámetro REAL: un INTEGER se convierte\n"
+    "static Value rt_real_param(Value v) {\n"
+    "    return v.type == V_INT ? rt_real((double)v.as.i) : v;\n"
+    "}\n"
+    "\n"
+    "static int rt_extra_find(Obj *o, const char *name, Value *out) {\n"
+    "    for (Extra *e = o ? o->extra : NULL; e; e = e->next) {\n"
+    "        if (strcmp(e->name, name) == 0) {\n"
+    "            *out = e->value;\n"
+    "            return 1;\n"
+    "        }\n"
+    "    }\n"
+    "    return 0;\n"
+    "}\n"
+    "\n"
+    "static void rt_extra_set(Obj *o, const char *name, Value v) {\n"
+    "    Extra **link = &o->extra;\n"
+    "    for (; *link; link = &(*link)->next) {\n"
+    "        if (strcmp((*link)->name, name) == 0) {\n"
+    "            (*link)->value = v;\n"
+    "            return;\n"
+    "        }\n"
+    "    }\n"
+    "    Extra *e = rt_alloc(sizeof(Extra));\n"
+    "    e->name = name;\n"
+    "    e->value = v;\n"
+    "    *link = e;\n"
+    "}\n"
+    "\n"
+    "/* --- Aritmética y comparaciones (mismas reglas que el intérprete) --- */\n"
+    "\n"
+    "static Value rt_arith(char op, Value l, Value r) {\n"
+    "    if (l.type == V_INT && r.type == V_INT) {\n"
+    "        unsigned a = (unsigned)l.as.i, b = (unsigned)r.as.i;\n"
+    "        switch (op) {\n"
+    "            case '+': return rt_int((int)(a + b));\n"
+    "            case '-': return rt_int((int)(a - b));\n"
+    "            case '*': return rt_int((int)(a * b));\n"
+    "            default:\n"
+    "                if (r.as.i == 0) rt_fail(\"Error: División por cero.\\n\");\n"
+    "                if (r.as.i == -1) return rt_int((int)(0u - a));\n"
+    "                return rt_int(l.as.i / r.as.i);\n"
+    "        }\n"
+    "    }\n"
+    "    int ln = l.type == V_INT || l.type == V_REAL, rn = r.type == V_INT || r.type == V_REAL;\n"
+    "    if (ln && rn) {\n"
+    "        double a = l.type == V_REAL ? l.as.r : l.as.i, b = r.type == V_REAL ? r.as.r : r.as.i;\n"
+    "        switch (op) {\n"
+    "            case '+': return rt_real(a + b);\n"
+    "            case '-': return rt_real(a - b);\n"
+    "            case '*': return rt_real(a * b);\n"
+    "            default: return rt_real(a / b);\n"
+    "        }\n"
+    "    }\n"
+    "    if (l.type == V_STRING && r.type == V_STRING && op == '+') {\n"
+    "        size_t la = strlen(l.as.s), lb = strlen(r.as.s);\n"
+    "        char *s = rt_alloc(la + lb + 1);\n"
+    "        memcpy(s, l.as.s, la);\n"
+    "        memcpy(s + la, r.as.s, lb + 1);\n"
+    "        return rt_str(s);\n"
+    "    }\n"
+    "    return RT_VOID;\n"
+    "}\n"
+    "\n"
+    "static int rt_string_compare(const char *a, const char *b) {\n"
+    "    size_t la = strlen(a), lb = strlen(b);\n"
+    "    size_t n = la < lb ? la : lb;\n"
+    "    for (size_t i = 0; i < n; i++) {\n"
+    "        if (a[i] != b[i]) return (int)(unsigned char)a[i] - (int)(unsigned char)b[i];\n"
+    "    }\n"
+    "    return la < lb ? -1 : (la > lb ? 1 : 0);\n"
+    "}\n"
+    "\n"
+    "// op: '<', 'L' (<=), '>', 'G' (>=), '='\n"
+    "static int rt_compare_doubles(char op, double l, double r) {\n"
+    "    switch (op) {\n"
+    "        case '<': return l < r;\n"
+    "        case 'L': return l <= r;\n"
+    "        case '>': return l > r;\n"
+    "        case 'G': return l >= r;\n"
+    "        default: return l == r;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "static int rt_compare_ints(char op, int l, int r) {\n"
+    "    switch (op) {\n"
+    "        case '<': return l < r;\n"
+    "        case 'L': return l <= r;\n"
+    "        case '>': return l > r;\n"
+    "        case 'G': return l >= r;\n"
+    "        default: return l == r;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "static Value rt_compare(char op, Value l, Value r) {\n"
+    "    if (l.type == V_STRING && r.type == V_STRING) return rt_bool(rt_compare_doubles(op, rt_string_compare(l.as.s, r.as.s), 0));\n"
+    "    if (l.type == V_REAL || r.type == V_REAL) {\n"
+    "        return rt_bool(rt_compare_doubles(op, l.type == V_REAL ? l.as.r : l.as.i, r.type == V_REAL ? r.as.r : r.as.i));\n"
+    "    }\n"
+    "    return rt_bool(rt_compare_ints(op, l.as.i, r.as.i));\n"
+    "}\n"
+    "\n"
+    "/* --- Salida --- */\n"
+    "\n"
+    "struct Arr;\n"
+    "static const char *rt_array_type_name(struct Arr *a);\n"
+    "\n"
+    "static void rt_print(Value v) {\n"
+    "    switch (v.type) {\n"
+    "        case V_INT: printf(\"%d\", v.as.i); break;\n"
+    "        case V_REAL: printf(\"%f\", v.as.r); break;\n"
+    "        case V_STRING: fputs(v.as.s, stdout); break;\n"
+    "        case V_OBJECT: {\n"
+    "            const char *name = rt_class_name(v.as.o->cls);\n"
+    "            printf(\"[Object of class %s]\", name ? name : \"Unknown\");\n"
+    "            break;\n"
+    "        }\n"
+    "        case V_ARRAY: printf(\"[Object of class %s]\", rt_array_type_name(v.as.a)); break;\n"
+    "        case V_FILE: fputs(\"[Object of class PLAIN_TEXT_FILE]\", stdout); break;\n"
+    "        case V_BOOL: fputs(v.as.i ? \"True\" : \"False\", stdout); break;\n"
+    "        default: break;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "/* --- STRING --- */\n"
+    "\n"
+    "static void rt_string_error(const char *feature) {\n"
+    "    rt_fail(\"Error: STRING no tiene la feature '%s' (o sus argumentos no son válidos).\\n\", feature);\n"
+    "}\n"
+    "\n"
+    "static long rt_find_from(const char *s, size_t length, size_t from, const char *pattern) {\n"
+    "    if (from > length) return -1;\n"
+    "    size_t m = strlen(pattern);\n"
+    "    if (m == 0) return (long)from;\n"
+    "    for (size_t i = from; i + m <= length; i++) {\n"
+    "        if (s[i] == pattern[0] && memcmp(s + i, pattern, m) == 0) return (long)i;\n"
+    "    }\n"
+    "    return -1;\n"
+    "}\n"
+    "\n"
+    "static uint32_t rt_hash_lane(uint32_t lane, uint32_t word) {\n"
+    "    uint32_t x = lane ^ word;\n"
+    "    x = (x << 13) | (x >> 19);\n"
+    "    return x * 0x9E3779B1u;\n"
+    "}\n"
+    "\n"
+    "static int rt_string_hash(const char *s, size_t length) {\n"
+    "    const unsigned char *bytes = (const unsigned char *)s;\n"
+    "    uint32_t lanes[8];\n"
+    "    for (int j = 0; j < 8; j++) lanes[j] = 0x9E3779B9u * (uint32_t)(j + 1);\n"
+    "    size_t blocks = length / 32;\n"
+    "    for (size_t b = 0; b < blocks; b++) {\n"
+    "        const unsigned char *p = bytes + b * 32;\n"
+    "        for (int j = 0; j < 8; j++) {\n"
+    "            const unsigned char *w = p + 4 * j;\n"
+    "            lanes[j] = rt_hash_lane(lanes[j], (uint32_t)w[0] | ((uint32_t)w[1] << 8) | ((uint32_t)w[2] << 16) | ((uint32_t)w[3] << 24));\n"
+    "        }\n"
+    "    }\n"
+    "    uint32_t h = 0x811C9DC5u ^ (uint32_t)length;\n"
+    "    for (int j = 0; j < 8; j++) h = (h ^ lanes[j]) * 0x01000193u;\n"
+    "    for (size_t i = blocks * 32; i < length; i++) h = (h ^ bytes[i]) * 0x01000193u;\n"
+    "    h ^= h >> 15;\n"
+    "    h *= 0x2C1B3C6Du;\n"
+    "    h ^= h >> 12;\n"
+    "    return (int)(h & 0x7FFFFFFFu);\n"
+    "}\n"
+    "\n"
+    "static int rt_parse_integer(const char *s, int *out) {\n"
+    "    const char *p = s;\n"
+    "    int negative = 0;\n"
+    "    if (*p == '+' || *p == '-') negative = *p++ == '-';\n"
+    "    if (!*p) return 0;\n"
+    "    long long value = 0;\n"
+    "    for (; *p; p++) {\n"
+    "        if (*p < '0' || *p > '9') return 0;\n"
+    "        value = value * 10 + (*p - '0');\n"
+    "        if (value > (long long)INT_MAX + 1) return 0;\n"
+    "    }\n"
+    "    if (negative) value = -value;\n"
+    "    if (value < INT_MIN || value > INT_MAX) return 0;\n"
+    "    *out = (int)value;\n"
+    "    return 1;\n"
+    "}\n"
+    "\n"
+    "static int rt_string_int_arg(const char *feature, Value v) {\n"
+    "    if (v.type != V_INT) rt_string_error(feature);\n"
+    "    return v.as.i;\n"
+    "}\n"
+    "\n"
+    "static const char *rt_string_arg(const char *feature, Value v) {\n"
+    "    if (v.type != V_STRING || !v.as.s) rt_string_error(feature);\n"
+    "    return v.as.s;\n"
+    "}\n"
+    "\n"
+    "static Value rt_string_split(const char *s, size_t length, const char *separator);\n"
+    "\n"
+    "static Value rt_string_feature(const char *s, const char *feature, int argc, Value *argv) {\n"
+    "    size_t length = strlen(s);\n"
+    "    if (strcmp(feature, \"count\") == 0 && argc == 0) return rt_int((int)length);\n"
+    "    if (strcmp(feature, \"is_equal\") == 0 && argc == 1) return rt_bool(strcmp(s, rt_string_arg(feature, argv[0])) == 0);\n"
+    "    if (strcmp(feature, \"has\") == 0 && argc == 1) return rt_bool(rt_find_from(s, length, 0, rt_string_arg(feature, argv[0])) >= 0);\n"
+    "    if (strcmp(feature, \"index_of\") == 0 && (argc == 1 || argc == 2)) {\n"
+    "        const char *pattern = rt_string_arg(feature, argv[0]);\n"
+    "        int start = argc == 2 ? rt_string_int_arg(feature, argv[1]) : 1;\n"
+    "        if (start < 1 || (size_t)start > length + 1) {\n"
+    "            rt_fail(\"Error: index_of desde %d fuera de un STRING de largo %zu.\\n\", start, length);\n"
+    "        }\n"
+    "        return rt_int((int)(rt_find_from(s, length, (size_t)start - 1, pattern) + 1));\n"
+    "    }\n"
+    "    if (strcmp(feature, \"substring\") == 0 && argc == 2) {\n"
+    "        int start = rt_string_int_arg(feature, argv[0]), end = rt_string_int_arg(feature, argv[1]);\n"
+    "        if (start < 1 || (long long)start > (long long)end + 1 || (long long)end > (long long)length) {\n"
+    "            rt_fail(\"Error: substring (%d, %d) fuera de los límites de un STRING de largo %zu.\\n\", start, end, length);\n"
+    "        }\n"
+    "        return rt_str(rt_strndup(s + start - 1, (size_t)((long long)end - start + 1)));\n"
+    "    }\n"
+    "    if (strcmp(feature, \"split\") == 0 && argc == 1) return rt_string_split(s, length, rt_string_arg(feature, argv[0]));\n"
+    "    if (strcmp(feature, \"hash_code\") == 0 && argc == 0) return rt_int(rt_string_hash(s, length));\n"
+    "    if (strcmp(feature, \"is_integer\") == 0 && argc == 0) {\n"
+    "        int ignored;\n"
+    "        return rt_bool(rt_parse_integer(s, &ignored));\n"
+    "    }\n"
+    "    if (strcmp(feature, \"to_integer\") == 0 && argc == 0) {\n"
+    "        int value;\n"
+    "        if (!rt_parse_integer(s, &value)) rt_fail(\"Error: \\\"%s\\\" no representa un INTEGER.\\n\", s);\n"
+    "        return rt_int(value);\n"
+    "    }\n"
+    "    rt_string_error(feature);\n"
+    "    return RT_VOID;\n"
+    "}\n"
+    "\n"
+    "/* --- ARRAY [INTEGER], ARRAY [REAL] y ARRAY [STRING] --- */\n"
+    "\n"
+    "typedef enum { ARR_INTEGER, ARR_REAL, ARR_STRING } ArrKind;\n"
+    "\n"
+    "typedef struct Arr {\n"
+    "    ArrKind kind;\n"
+    "    const char *type_name;\n"
+    "    int lower;\n"
+    "    int upper;\n"
+    "    union {\n"
+    "        int *ints;\n"
+    "        double *reals;\n"
+    "        char **strings;\n"
+    "        void *raw;\n"
+    "    } data;\n"
+    "} Arr;\n"
+    "\n"
+    "static const char *rt_array_type_name(Arr *a) { return a->type_name; }\n"
+    "\n"
+    "static Value rt_arr(Arr *a) { Value v = { .type = V_ARRAY }; v.as.a = a; return v; }\n"
+    "\n"
+    "static Arr *rt_array_new(const char *type_name) {\n"
+    "    Arr *a = rt_alloc(sizeof(Arr));\n"
+    "    a->kind = strcmp(type_name, \"ARRAY [INTEGER]\") == 0 ? ARR_INTEGER\n"
+    "            : strcmp(type_name, \"ARRAY [REAL]\") == 0 ? ARR_REAL : ARR_STRING;\n"
+    "    a->type_name = type_name;\n"
+    "    a->lower = 1;\n"
+    "    a->upper = 0;\n"
+    "    return a;\n"
+    "}\n"
+    "\n"
+    "static int rt_array_count(const Arr *a) {\n"
+    "    return a->upper >= a->lower ? (int)((int64_t)a->upper - a->lower + 1) : 0;\n"
+    "}\n"
+    "\n"
+    "static size_t rt_array_element_size(const Arr *a) {\n"
+    "    return a->kind == ARR_INTEGER ? sizeof(int) : a->kind == ARR_REAL ? sizeof(double) : sizeof(char *);\n"
+    "}\n"
+    "\n"
+    "static void rt_array_resize(Arr *a, int lower, int upper) {\n"
+    "    int64_t wanted = upper >= lower ? (int64_t)upper - lower + 1 : 0;\n"
+    "    if (wanted > INT_MAX || (uint64_t)wanted > SIZE_MAX / rt_array_element_size(a)) {\n"
+    "        rt_fail(\"Error: Los límites [%d, %d] de %s piden demasiados elementos (%lld).\\n\",\n"
+    "                lower, upper, a->type_name, (long long)wanted);\n"
+    "    }\n"
+    "    free(a->data.raw);\n"
+    "    a->lower = lower;\n"
+    "    a->upper = upper;\n"
+    "    a->data.raw = NULL;\n"
+    "    size_t count = (size_t)rt_array_count(a);\n"
+    "    if (count == 0) return;\n"
+    "    a->data.raw = calloc(count, rt_array_element_size(a));\n"
+    "    if (!a->data.raw) rt_fail(\"Error: No hay memoria para un ARRAY de %zu elementos.\\n\", count);\n"
+    "}\n"
+    "\n"
+    "static void rt_array_error(Arr *a, const char *feature) {\n"
+    "    rt_fail(\"Error: %s no tiene la feature '%s' (o sus argumentos no son válidos).\\n\", a->type_name, feature);\n"
+    "}\n"
+    "\n"
+    "static int rt_array_int_arg(Arr *a, const char *feature, Value v) {\n"
+    "    if (v.type != V_INT) rt_array_error(a, feature);\n"
+    "    return v.as.i;\n"
+    "}\n"
+    "\n"
+    "// ARRAY [INTEGER] solo acepta INTEGER: un REAL como 1e20 no cabe en int\n"
+    "static double rt_array_number_arg(Arr *a, const char *feature, Value v) {\n"
+    "    if (v.type == V_INT) return v.as.i;\n"
+    "    if (a->kind == ARR_INTEGER) rt_array_error(a, feature);\n"
+    "    if (v.type != V_REAL) rt_array_error(a, feature);\n"
+    "    return v.as.r;\n"
+    "}\n"
+    "\n"
+    "static char *rt_array_string_arg(Arr *a, const char *feature, Value v) {\n"
+    "    if (v.type != V_STRING || !v.as.s) rt_array_error(a, feature);\n"
+    "    return v.as.s;\n"
+    "}\n"
+    "\n"
+    "static Arr *rt_array_same_shape(Arr *a, const char *feature, Value v) {\n"
+    "    if (v.type != V_ARRAY || !v.as.a || v.as.a->kind != a->kind) rt_array_error(a, feature);\n"
+    "    Arr *other = v.as.a;\n"
+    "    if (strcmp(feature, \"copy\") != 0 && rt_array_count(other) != rt_array_count(a)) {\n"
+    "        rt_fail(\"Error: %s.%s requiere arrays del mismo tamaño (%d y %d).\\n\", a->type_name, feature,\n"
+    "                rt_array_count(a), rt_array_count(other));\n"
+    "    }\n"
+    "    return other;\n"
+    "}\n"
+    "\n"
+    "static size_t rt_array_index(Arr *a, int index) {\n"
+    "    if (index < a->lower || index > a->upper) {\n"
+    "        rt_fail(\"Error: Índice %d fuera de los límites [%d, %d] de %s.\\n\", index, a->lower, a->upper, a->type_name);\n"
+    "    }\n"
+    "    return (size_t)(index - a->lower);\n"
+    "}\n"
+    "\n"
+    "static void rt_array_fill(Arr *a, Value v, const char *feature) {\n"
+    "    size_t count = (size_t)rt_array_count(a);\n"
+    "    if (a->kind == ARR_STRING) {\n"
+    "        char *s = rt_array_string_arg(a, feature, v);\n"
+    "        for (size_t i = 0; i < count; i++) a->data.strings[i] = s;\n"
+    "    } else {\n"
+    "        double number = rt_array_number_arg(a, feature, v);\n"
+    "        for (size_t i = 0; i < count; i++) {\n"
+    "            if (a->kind == ARR_INTEGER) a->data.ints[i] = (int)number;\n"
+    "            else a->data.reals[i] = number;\n"
+    "        }\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "static Value rt_array_feature(Arr *a, const char *feature, int argc, Value *argv) {\n"
+    "    size_t count = (size_t)rt_array_count(a);\n"
+    "    if (strcmp(feature, \"make\") == 0 && argc == 2) {\n"
+    "        rt_array_resize(a, rt_array_int_arg(a, feature, argv[0]), rt_array_int_arg(a, feature, argv[1]));\n"
+    "    } else if (strcmp(feature, \"make_filled\") == 0 && argc == 3) {\n"
+    "        if (a->kind == ARR_STRING) rt_array_string_arg(a, feature, argv[0]);\n"
+    "        else rt_array_number_arg(a, feature, argv[0]);\n"
+    "        rt_array_resize(a, rt_array_int_arg(a, feature, argv[1]), rt_array_int_arg(a, feature, argv[2]));\n"
+    "        rt_array_fill(a, argv[0], feature);\n"
+    "    } else if (strcmp(feature, \"count\") == 0 && argc == 0) {\n"
+    "        return rt_int((int)count);\n"
+    "    } else if (strcmp(feature, \"lower\") == 0 && argc == 0) {\n"
+    "        return rt_int(a->lower);\n"
+    "    } else if (strcmp(feature, \"upper\") == 0 && argc == 0) {\n"
+    "        return rt_int(a->upper);\n"
+    "    } else if (strcmp(feature, \"valid_index\") == 0 && argc == 1) {\n"
+    "        int index = rt_array_int_arg(a, feature, argv[0]);\n"
+    "        return rt_bool(index >= a->lower && index <= a->upper);\n"
+    "    } else if (strcmp(feature, \"item\") == 0 && argc == 1) {\n"
+    "        size_t offset = rt_array_index(a, rt_array_int_arg(a, feature, argv[0]));\n"
+    "        if (a->kind == ARR_INTEGER) return rt_int(a->data.ints[offset]);\n"
+    "        if (a->kind == ARR_REAL) return rt_real(a->data.reals[offset]);\n"
+    "        return rt_str(a->data.strings[offset] ? a->data.strings[offset] : \"\");\n"
+    "    } else if (strcmp(feature, \"put\") == 0 && argc == 2) {\n"
+    "        if (a->kind == ARR_STRING) {\n"
+    "            char *s = rt_array_string_arg(a, feature, argv[0]);\n"
+    "            a->data.strings[rt_array_index(a, rt_array_int_arg(a, feature, argv[1]))] = s;\n"
+    "        } else {\n"
+    "            double number = rt_array_number_arg(a, feature, argv[0]);\n"
+    "            size_t offset = rt_array_index(a, rt_array_int_arg(a, feature, argv[1]));\n"
+    "            if (a->kind == ARR_INTEGER) a->data.ints[offset] = (int)number;\n"
+    "            else a->data.reals[offset] = number;\n"
+    "        }\n"
+    "    } else if (strcmp(feature, \"fill\") == 0 && argc == 1) {\n"
+    "        rt_array_fill(a, argv[0], feature);\n"
+    "    } else if (strcmp(feature, \"copy\") == 0 && argc == 1) {\n"
+    "        Arr *other = rt_array_same_shape(a, feature, argv[0]);\n"
+    "        if (other != a) {\n"
+    "            rt_array_resize(a, other->lower, other->upper);\n"
+    "            if (rt_array_count(other)) memcpy(a->data.raw, other->data.raw, rt_array_count(other) * rt_array_element_size(a));\n"
+    "        }\n"
+    "    } else if (a->kind == ARR_STRING) {\n"
+    "        rt_array_error(a, feature); // sum, min, max, add, ... no aplican a STRING\n"
+    "    } else if (strcmp(feature, \"sum\") == 0 && argc == 0) {\n"
+    "        if (a->kind == ARR_INTEGER) {\n"
+    "            uint32_t total = 0;\n"
+    "            for (size_t i = 0; i < count; i++) total += (uint32_t)a->data.ints[i];\n"
+    "            return rt_int((int)total);\n"
+    "        }\n"
+    "        double lane[4] = { 0.0, 0.0, 0.0, 0.0 };\n"
+    "        size_t i = 0;\n"
+    "        for (; i + 4 <= count; i += 4) {\n"
+    "            for (int j = 0; j < 4; j++) lane[j] += a->data.reals[i + j];\n"
+    "        }\n"
+    "        double total = (lane[0] + lane[1]) + (lane[2] + lane[3]);\n"
+    "        for (; i < count; i++) total += a->data.reals[i];\n"
+    "        return rt_real(total);\n"
+    "    } else if ((strcmp(feature, \"min\") == 0 || strcmp(feature, \"max\") == 0) && argc == 0) {\n"
+    "        if (count == 0) rt_fail(\"Error: %s.%s sobre un array vacío.\\n\", a->type_name, feature);\n"
+    "        int is_min = feature[1] == 'i';\n"
+    "        if (a->kind == ARR_INTEGER) {\n"
+    "            int best = a->data.ints[0];\n"
+    "            for (size_t i = 1; i < count; i++) {\n"
+    "                if (is_min ? a->data.ints[i] < best : a->data.ints[i] > best) best = a->data.ints[i];\n"
+    "            }\n"
+    "            return rt_int(best);\n"
+    "        }\n"
+    "        double best = a->data.reals[0];\n"
+    "        for (size_t i = 1; i < count; i++) {\n"
+    "            if (is_min ? a->data.reals[i] < best : a->data.reals[i] > best) best = a->data.reals[i];\n"
+    "        }\n"
+    "        return rt_real(best);\n"
+    "    } else if ((strcmp(feature, \"add\") == 0 || strcmp(feature, \"subtract\") == 0\n"
+    "                || strcmp(feature, \"multiply\") == 0) && argc == 1) {\n"
+    "        Arr *other = rt_array_same_shape(a, feature, argv[0]);\n"
+    "        char op = feature[0];\n"
+    "        for (size_t i = 0; i < count; i++) {\n"
+    "            if (a->kind == ARR_INTEGER) {\n"
+    "                uint32_t x = (uint32_t)a->data.ints[i], y = (uint32_t)other->data.ints[i];\n"
+    "                a->data.ints[i] = (int)(op == 'a' ? x + y : op == 's' ? x - y : x * y);\n"
+    "            } else {\n"
+    "                double y = other->data.reals[i];\n"
+    "                if (op == 'a') a->data.reals[i] += y;\n"
+    "                else if (op == 's') a->data.reals[i] -= y;\n"
+    "                else a->data.reals[i] *= y;\n"
+    "            }\n"
+    "        }\n"
+    "    } else {\n"
+    "        rt_array_error(a, feature);\n"
+    "    }\n"
+    "    return RT_VOID;\n"
+    "}\n"
+    "\n"
+    "static Value rt_string_split(const char *s, size_t length, const char *separator) {\n"
+    "    size_t separator_length = strlen(separator);\n"
+    "    if (separator_length == 0) rt_string_error(\"split\");\n"
+    "    int parts = 1;\n"
+    "    for (long at = rt_find_from(s, length, 0, separator); at >= 0;\n"
+    "         at = rt_find_from(s, length, (size_t)at + separator_length, separator)) {\n"
+    "        parts++;\n"
+    "    }\n"
+    "    Arr *a = rt_array_new(\"ARRAY [STRING]\");\n"
+    "    rt_array_resize(a, 1, parts);\n"
+    "    size_t start = 0;\n"
+    "    for (int k = 0; k < parts; k++) {\n"
+    "        long at = rt_find_from(s, length, start, separator);\n"
+    "        size_t end = at < 0 ? length : (size_t)at;\n"
+    "        a->data.strings[k] = rt_strndup(s + start, end - start);\n"
+    "        start = end + separator_length;\n"
+    "    }\n"
+    "    return rt_arr(a);\n"
+    "}\n"
+    "\n"
+    "/* --- Entrada: entrada estándar y PLAIN_TEXT_FILE --- */\n"
+    "\n"
+    "static int rt_stream_at_end(FILE *in) {\n"
+    "    int c = getc(in);\n"
+    "    if (c == EOF) return 1;\n"
+    "    ungetc(c, in);\n"
+    "    return 0;\n"
+    "}\n"
+    "\n"
+    "static char *rt_stream_read_line(FILE *in) {\n"
+    "    size_t length = 0, capacity = 64;\n"
+    "    char *line = rt_alloc(capacity);\n"
+    "    int c;\n"
+    "    while ((c = getc(in)) != EOF && c != '\\n') {\n"
+    "        if (length + 1 == capacity) {\n"
+    "            capacity *= 2;\n"
+    "            line = realloc(line, capacity);\n"
+    "            if (!line) rt_fail(\"Error: No hay memoria.\\n\");\n"
+    "        }\n"
+    "        line[length++] = (char)c;\n"
+    "    }\n"
+    "    if (length > 0 && line[length - 1] == '\\r') length--;\n"
+    "    line[length] = '\\0';\n"
+    "    return line;\n"
+    "}\n"
+    "\n"
+    "static int rt_is_space(int c) {\n"
+    "    return c == ' ' || c == '\\t' || c == '\\n' || c == '\\r' || c == '\\f' || c == '\\v';\n"
+    "}\n"
+    "\n"
+    "static int rt_stream_read_integer(FILE *in) {\n"
+    "    int c;\n"
+    "    while ((c = getc(in)) != EOF && rt_is_space(c)) {\n"
+    "    }\n"
+    "    int negative = 0;\n"
+    "    if (c == '-' || c == '+') {\n"
+    "        negative = c == '-';\n"
+    "        c = getc(in);\n"
+    "    }\n"
+    "    long value = 0;\n"
+    "    int digits = 0;\n"
+    "    while (c >= '0' && c <= '9') {\n"
+    "        value = value * 10 + (c - '0');\n"
+    "        if (value > 2147483648L) value = 2147483648L;\n"
+    "        digits++;\n"
+    "        c = getc(in);\n"
+    "    }\n"
+    "    if (!digits) {\n"
+    "        while (c != EOF && !rt_is_space(c)) c = getc(in);\n"
+    "    }\n"
+    "    if (c != EOF) ungetc(c, in);\n"
+    "    if (!digits) return 0;\n"
+    "    value = negative ? -value : value;\n"
+    "    if (value > 2147483647L) value = 2147483647L;\n"
+    "    return (int)value;\n"
+    "}\n"
+    "\n"
+    "static char *rt_stdin_last_string = NULL;\n"
+    "static int rt_stdin_last_integer = 0;\n"
+    "\n"
+    "static Value rt_io_builtin(const char *name, int argc) {\n"
+    "    if (argc != 0) rt_fail(\"Error: '%s' no recibe argumentos.\\n\", name);\n"
+    "    if (strcmp(name, \"read_line\") == 0) return rt_str(rt_stdin_last_string = rt_stream_read_line(stdin));\n"
+    "    if (strcmp(name, \"read_integer\") == 0) return rt_int(rt_stdin_last_integer = rt_stream_read_integer(stdin));\n"
+    "    if (strcmp(name, \"last_string\") == 0) return rt_str(rt_stdin_last_string ? rt_stdin_last_string : \"\");\n"
+    "    if (strcmp(name, \"last_integer\") == 0) return rt_int(rt_stdin_last_integer);\n"
+    "    return rt_int(rt_stream_at_end(stdin));\n"
+    "}\n"
+    "\n"
+    "typedef enum { FILE_CLOSED, FILE_READ, FILE_WRITE } FileMode;\n"
+    "\n"
+    "typedef struct File {\n"
+    "    FileMode mode;\n"
+    "    FILE *stream;\n"
+    "    char *name;\n"
+    "    char *last_string;\n"
+    "    int last_integer;\n"
+    "} File;\n"
+    "\n"
+    "static Value rt_file(File *f) { Value v = { .type = V_FILE }; v.as.f = f; return v; }\n"
+    "\n"
+    "static File *rt_file_new(void) {\n"
+    "    return rt_alloc(sizeof(File));\n"
+    "}\n"
+    "\n"
+    "static void rt_file_error(const char *feature) {\n"
+    "    rt_fail(\"Error: PLAIN_TEXT_FILE no tiene la feature '%s' (o sus argumentos no son válidos).\\n\", feature);\n"
+    "}\n"
+    "\n"
+    "static void rt_file_close(File *f) {\n"
+    "    if (f->mode != FILE_CLOSED) fclose(f->stream);\n"
+    "    f->stream = NULL;\n"
+    "    f->mode = FILE_CLOSED;\n"
+    "}\n"
+    "\n"
+    "static void rt_file_expect(File *f, FileMode mode, const char *feature) {\n"
+    "    if (f->mode == mode) return;\n"
+    "    rt_fail(\"Error: '%s' necesita el archivo '%s' abierto para %s.\\n\", feature, f->name ? f->name : \"(sin abrir)\",\n"
+    "            mode == FILE_READ ? \"lectura\" : \"escritura\");\n"
+    "}\n"
+    "\n"
+    "static Value rt_file_feature(File *f, const char *feature, int argc, Value *argv) {\n"
+    "    if (strcmp(feature, \"make_open_read\") == 0 || strcmp(feature, \"make_open_write\") == 0\n"
+    "        || strcmp(feature, \"make_open_append\") == 0) {\n"
+    "        if (argc != 1 || argv[0].type != V_STRING) rt_file_error(feature);\n"
+    "        const char *path = argv[0].as.s;\n"
+    "        rt_file_close(f);\n"
+    "        f->name = argv[0].as.s;\n"
+    "        int reading = strcmp(feature, \"make_open_read\") == 0;\n"
+    "        f->stream = fopen(path, reading ? \"r\" : strcmp(feature, \"make_open_append\") == 0 ? \"a\" : \"w\");\n"
+    "        if (!f->stream) {\n"
+    "            rt_fail(\"Error: No se pudo abrir '%s' para %s: %s.\\n\", path, reading ? \"lectura\" : \"escritura\", strerror(errno));\n"
+    "        }\n"
+    "        f->mode = reading ? FILE_READ : FILE_WRITE;\n"
+    "    } else if (strcmp(feature, \"read_line\") == 0 && argc == 0) {\n"
+    "        rt_file_expect(f, FILE_READ, feature);\n"
+    "        return rt_str(f->last_string = rt_stream_read_line(f->stream));\n"
+    "    } else if (strcmp(feature, \"read_integer\") == 0 && argc == 0) {\n"
+    "        rt_file_expect(f, FILE_READ, feature);\n"
+    "        return rt_int(f->last_integer = rt_stream_read_integer(f->stream));\n"
+    "    } else if (strcmp(feature, \"last_string\") == 0 && argc == 0) {\n"
+    "        return rt_str(f->last_string ? f->last_string : \"\");\n"
+    "    } else if (strcmp(feature, \"last_integer\") == 0 && argc == 0) {\n"
+    "        return rt_int(f->last_integer);\n"
+    "    } else if (strcmp(feature, \"end_of_file\") == 0 && argc == 0) {\n"
+    "        rt_file_expect(f, FILE_READ, feature);\n"
+    "        return rt_bool(rt_stream_at_end(f->stream));\n"
+    "    } else if (strcmp(feature, \"put_string\") == 0 && argc == 1 && argv[0].type == V_STRING) {\n"
+    "        rt_file_expect(f, FILE_WRITE, feature);\n"
+    "        fputs(argv[0].as.s, f->stream);\n"
+    "    } else if (strcmp(feature, \"put_integer\") == 0 && argc == 1 && argv[0].type == V_INT) {\n"
+    "        rt_file_expect(f, FILE_WRITE, feature);\n"
+    "        fprintf(f->stream, \"%d\", argv[0].as.i);\n"
+    "    } else if (strcmp(feature, \"put_real\") == 0 && argc == 1 && (argv[0].type == V_REAL || argv[0].type == V_INT)) {\n"
+    "        rt_file_expect(f, FILE_WRITE, feature);\n"
+    "        fprintf(f->stream, \"%f\", argv[0].type == V_REAL ? argv[0].as.r : (double)argv[0].as.i);\n"
+    "    } else if (strcmp(feature, \"put_new_line\") == 0 && argc == 0) {\n"
+    "        rt_file_expect(f, FILE_WRITE, feature);\n"
+    "        fputc('\\n', f->stream);\n"
+    "    } else if (strcmp(feature, \"close\") == 0 && argc == 0) {\n"
+    "        rt_file_close(f);\n"
+    "    } else if (strcmp(feature, \"is_open_read\") == 0 && argc == 0) {\n"
+    "        return rt_bool(f->mode == FILE_READ);\n"
+    "    } else if (strcmp(feature, \"is_open_write\") == 0 && argc == 0) {\n"
+    "        return rt_bool(f->mode == FILE_WRITE);\n"
+    "    } else if (strcmp(feature, \"name\") == 0 && argc == 0) {\n"
+    "        return rt_str(f->name ? f->name : \"\");\n"
+    "    } else {\n"
+    "        rt_file_error(feature);\n"
+    "    }\n"
+    "    return RT_VOID;\n"
+    "}\n"
+    "\n"
+    "// Feature predefinida sobre un STRING, ARRAY o PLAIN_TEXT_FILE (is_builtin_target)\n"
+    "static int rt_is_builtin_target(Value v) {\n"
+    "    return v.type == V_STRING || v.type == V_ARRAY || v.type == V_FILE;\n"
+    "}\n"
+    "\n"
+    "static Value rt_builtin(Value target, const char *feature, int argc, Value *argv) {\n"
+    "    if (target.type == V_STRING) return rt_string_feature(target.as.s, feature, argc, argv);\n"
+    "    if (target.type == V_ARRAY) return rt_array_feature(target.as.a, feature, argc, argv);\n"
+    "    return rt_file_feature(target.as.f, feature, argc, argv);\n"
+    "}\n"
+    "\n"
+    "/* --- Fin del runtime --- */\n";
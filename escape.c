@@ -0,0 +1,249 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "ast.h"
+#include "interpreter.h"
+#include "array.h"
+#include "eiffel_io.h"
+#include "escape.h"
+#include "scoop.h"
+#include "frontend.h"
+
+/* Comentario general:
+   - Un recorrido del cuerpo marca, para cada local candidata (tipo de una clase del usuario):
+     si se crea, si se lee como valor (escapa) y si se invocan métodos sobre ella.
+   - Las clases cuyos métodos usan 'Current' como valor se detectan una vez por análisis.
+   - Los análisis se hacen en el hilo principal: el across paralelo no acepta create ni llamadas a
+     métodos de clases del usuario (ver parallel.c). Con objetos separate los procesadores también
+     llaman métodos, y entonces cada consulta toma analysis_lock.
+   - Las locales 'separate X' nunca van al frame: su objeto lo usa otro procesador.
+*/
+
+static int analysis_version = 0;
+static pthread_mutex_t analysis_lock = PTHREAD_MUTEX_INITIALIZER;
+
+typedef struct {
+    const char *name;
+    const char *type_name;
+    int created;
+    int escapes;
+    int receives_calls; // Se le invocan métodos (o un procedimiento de creación)
+    int slot;
+} Candidate;
+
+typedef struct {
+    Candidate items[MAX_SYMBOLS];
+    int count;
+} EscapeAnalysis;
+
+void escape_invalidate(void) {
+    analysis_version++;
+}
+
+static Candidate *find_candidate(EscapeAnalysis *a, const char *name) {
+    for (int i = 0; i < a->count; i++) {
+        if (strcmp(a->items[i].name, name) == 0) return &a->items[i];
+    }
+    return NULL;
+}
+
+static int is_reference_type(const char *type_name) {
+    return type_name
+        && strcmp(type_name, "INTEGER") != 0
+        && strcmp(type_name, "REAL") != 0
+        && strcmp(type_name, "STRING") != 0
+        && strcmp(type_name, "BOOLEAN") != 0
+        && !is_array_type(type_name)
+        && !is_file_type(type_name)
+        && !is_separate_type(type_name);
+}
+
+static void scan_node(EscapeAnalysis *a, AstNode *node);
+
+static void scan_arguments(EscapeAnalysis *a, ArgumentListNode *args) {
+    for (int i = 0; args && i < args->count; i++) scan_node(a, args->arguments[i]);
+}
+
+static void scan_statements(EscapeAnalysis *a, StatementListNode *list) {
+    for (int i = 0; list && i < list->count; i++) scan_node(a, list->statements[i]);
+}
+
+// Objeto de un acceso o llamada: una local candidata ahí no escapa
+static void scan_receiver(EscapeAnalysis *a, AstNode *object, int is_call) {
+    if (object && object->type == NODE_TYPE_VARIABLE) {
+        Candidate *c = find_candidate(a, ((VariableNode*)object)->name);
+        if (c) {
+            if (is_call) c->receives_calls = 1;
+            return;
+        }
+    }
+    scan_node(a, object);
+}
+
+static void scan_node(EscapeAnalysis *a, AstNode *node) {
+    if (!node) return;
+    switch (node->type) {
+        case NODE_TYPE_VARIABLE: {
+            Candidate *c = find_candidate(a, ((VariableNode*)node)->name);
+            if (c) c->escapes = 1;
+            break;
+        }
+        case NODE_TYPE_BINARY_EXPR:
+            scan_node(a, ((BinaryExprNode*)node)->left);
+            scan_node(a, ((BinaryExprNode*)node)->right);
+            break;
+        case NODE_TYPE_COMPARISON_EXPR:
+            scan_node(a, ((ComparisonExprNode*)node)->left);
+            scan_node(a, ((ComparisonExprNode*)node)->right);
+            break;
+        case NODE_TYPE_BOOLEAN_EXPR:
+            scan_node(a, ((BooleanExprNode*)node)->left);
+            scan_node(a, ((BooleanExprNode*)node)->right);
+            break;
+        case NODE_TYPE_PROCEDURE_CALL:
+            scan_arguments(a, ((ProcedureCallNode*)node)->arguments);
+            break;
+        case NODE_TYPE_ASSIGN: {
+            AssignNode *n = (AssignNode*)node;
+            // Reasignar la local no publica el objeto anterior; solo importa el lado derecho
+            if (n->target->type == NODE_TYPE_ATTRIBUTE_ACCESS) {
+                scan_receiver(a, ((AttributeAccessNode*)n->target)->object_node, 0);
+            } else if (n->target->type != NODE_TYPE_VARIABLE) {
+                scan_node(a, n->target);
+            }
+            scan_node(a, n->expression);
+            break;
+        }
+        case NODE_TYPE_ATTRIBUTE_ACCESS:
+            // Sin argumentos puede ser un método: se cuenta como llamada
+            scan_receiver(a, ((AttributeAccessNode*)node)->object_node, 1);
+            break;
+        case NODE_TYPE_METHOD_CALL:
+            scan_receiver(a, ((MethodCallNode*)node)->object_node, 1);
+            scan_arguments(a, ((MethodCallNode*)node)->arguments);
+            break;
+        case NODE_TYPE_CREATE: {
+            CreateNode *n = (CreateNode*)node;
+            Candidate *c = find_candidate(a, n->object_name);
+            if (c) {
+                c->created = 1;
+                if (n->creation_procedure) c->receives_calls = 1;
+            }
+            scan_arguments(a, n->arguments);
+            break;
+        }
+        case NODE_TYPE_IF:
+            scan_node(a, ((IfNode*)node)->condition);
+            scan_statements(a, ((IfNode*)node)->then_branch);
+            scan_statements(a, ((IfNode*)node)->else_branch);
+            break;
+        case NODE_TYPE_LOOP:
+            scan_statements(a, ((LoopNode*)node)->initialization);
+            scan_node(a, ((LoopNode*)node)->condition);
+            scan_statements(a, ((LoopNode*)node)->loop_body);
+            break;
+        case NODE_TYPE_ACROSS:
+            scan_node(a, ((AcrossNode*)node)->lower);
+            scan_node(a, ((AcrossNode*)node)->upper);
+            scan_statements(a, ((AcrossNode*)node)->loop_body);
+            break;
+        case NODE_TYPE_STATEMENT_LIST:
+            scan_statements(a, (StatementListNode*)node);
+            break;
+        default:
+            break;
+    }
+}
+
+// assign_slots: anota cada create con el lugar del frame de su variable (o -1 si va al heap)
+static void assign_slots(EscapeAnalysis *a, AstNode *node);
+
+static void assign_slots_in(EscapeAnalysis *a, StatementListNode *list) {
+    for (int i = 0; list && i < list->count; i++) assign_slots(a, list->statements[i]);
+}
+
+static void assign_slots(EscapeAnalysis *a, AstNode *node) {
+    if (!node) return;
+    switch (node->type) {
+        case NODE_TYPE_CREATE: {
+            CreateNode *n = (CreateNode*)node;
+            Candidate *c = find_candidate(a, n->object_name);
+            n->frame_slot = c ? c->slot : -1;
+            break;
+        }
+        case NODE_TYPE_IF:
+            assign_slots_in(a, ((IfNode*)node)->then_branch);
+            assign_slots_in(a, ((IfNode*)node)->else_branch);
+            break;
+        case NODE_TYPE_LOOP:
+            assign_slots_in(a, ((LoopNode*)node)->initialization);
+            assign_slots_in(a, ((LoopNode*)node)->loop_body);
+            break;
+        case NODE_TYPE_ACROSS:
+            assign_slots_in(a, ((AcrossNode*)node)->loop_body);
+            break;
+        case NODE_TYPE_STATEMENT_LIST:
+            assign_slots_in(a, (StatementListNode*)node);
+            break;
+        default:
+            break;
+    }
+}
+
+/* class_leaks_current: 1 si algún método de la clase usa 'Current' como valor
+   (x := Current, print (Current), ...). 'Current.a' no cuenta. Un cuerpo diferido que todavía no
+   se parseó (ver frontend.h) cuenta como que lo usa.
+*/
+static int class_leaks_current(ClassDefinition *class_def) {
+    StatementListNode *features = class_def->feature_list;
+    for (int i = 0; features && i < features->count; i++) {
+        if (features->statements[i]->type != NODE_TYPE_FEATURE_BODY) continue;
+        FeatureBodyNode *f = (FeatureBodyNode*)features->statements[i];
+        if (FEATURE_BODY_PENDING(f)) return 1; // Sin parsear todavía: puede usarlo
+        EscapeAnalysis current = { .count = 1 };
+        current.items[0].name = "Current";
+        scan_statements(&current, f->statements);
+        if (current.items[0].escapes) return 1;
+    }
+    return 0;
+}
+
+static void analyze(FeatureBodyNode *feature) {
+    EscapeAnalysis a = { .count = 0 };
+    DeclarationListNode *decls = feature->declarations;
+    for (int i = 0; decls && i < decls->count && a.count < MAX_SYMBOLS; i++) {
+        if (!is_reference_type(decls->items[i].type_name)) continue;
+        Candidate *c = &a.items[a.count++];
+        memset(c, 0, sizeof(*c));
+        c->name = decls->items[i].variable_name;
+        c->type_name = decls->items[i].type_name;
+    }
+    scan_statements(&a, feature->statements);
+
+    int slots = 0;
+    for (int i = 0; i < a.count; i++) {
+        Candidate *c = &a.items[i];
+        c->slot = -1;
+        if (!c->created || c->escapes) continue;
+        if (c->receives_calls) {
+            ClassDefinition *class_def = find_class(c->type_name);
+            if (class_def && class_leaks_current(class_def)) continue;
+        }
+        c->slot = slots++;
+    }
+    assign_slots_in(&a, feature->statements);
+    feature->frame_slots = slots;
+}
+
+int escape_frame_slots(FeatureBodyNode *feature) {
+    int locked = scoop_started;
+    if (locked) pthread_mutex_lock(&analysis_lock);
+    if (feature->escape_version != analysis_version) {
+        analyze(feature);
+        feature->escape_version = analysis_version;
+    }
+    int slots = feature->frame_slots;
+    if (locked) pthread_mutex_unlock(&analysis_lock);
+    return slots;
+}
@@ -0,0 +1,24 @@
+#ifndef ESCAPE_H
+#define ESCAPE_H
+
+#include "ast.h"
+
+/* Comentario general:
+   - Análisis de escape por feature: decide qué objetos creados con 'create' en variables locales
+     nunca salen del método, para alojarlos en el frame de la llamada en lugar del heap.
+   - Una local escapa si su valor se lee como tal (x := v, print (v), argumento de una llamada...).
+     Usarla como objeto de un acceso o llamada (v.a, v.a := e, v.f (e)) no la hace escapar,
+     salvo que algún método de su clase use 'Current' como valor (podría guardarse a sí mismo).
+   - Un 'create' solo instancia si la variable todavía es Void, así que cada local tiene a lo sumo
+     un objeto por activación: hay un lugar del frame por variable.
+   - El resultado queda en el AST (CreateNode.frame_slot, FeatureBodyNode.frame_slots) y se recalcula
+     si una clase se redefine (REPL).
+*/
+
+// Analiza el feature si hace falta y devuelve cuántos objetos aloja en su frame
+int escape_frame_slots(FeatureBodyNode *feature);
+
+// Invalida los análisis hechos (una clase cambió de definición)
+void escape_invalidate(void);
+
+#endif // ESCAPE_H
@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include "ast.h"
+#include "memstats.h"
+#include "parser.tab.h"
+#include "threadpool.h"
+#include "frontend.h"
+
+/* Comentario general:
+   - Cada llamada a parse_text / parse_stream crea su scanner (yylex_init_extra) y lo destruye al
+     terminar; yyparse recibe el scanner como parámetro (%param en parser.y).
+   - En parse_files cada tarea escribe sus errores en un stream en memoria (open_memstream); los
+     tokens del .info solo se piden para el archivo principal, que escribe una sola tarea.
+   - Cuerpos diferidos: el scanner junta el texto del cuerpo en body_text (un buffer por parseo que
+     se reutiliza) y lazy_body_finish copia solo ese tramo. parse_feature_body lo parsea con su
+     propio scanner; un mutex evita que dos hilos parseen el mismo cuerpo.
+*/
+
+typedef struct yy_buffer_state *YY_BUFFER_STATE;
+extern int yylex_init_extra(ParseContext *extra, yyscan_t *scanner);
+extern int yylex_destroy(yyscan_t scanner);
+extern YY_BUFFER_STATE yy_scan_bytes(const char *bytes, int len, yyscan_t scanner);
+extern void yy_delete_buffer(YY_BUFFER_STATE buffer, yyscan_t scanner);
+extern void yyset_in(FILE *input, yyscan_t scanner);
+extern void yyset_lineno(int line, yyscan_t scanner);
+
+int parse_lazy_bodies = 0;
+
+static pthread_mutex_t body_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// El buffer de cuerpos es del parseo: se libera al terminar (también si hubo un error)
+static void release_body_buffer(ParseContext *context) {
+    free(context->body_text);
+    context->body_text = NULL;
+    context->body_length = context->body_capacity = 0;
+    context->body_depth = 0;
+}
+
+int parse_text(const char *text, size_t length, int first_line, ParseContext *context, AstNode **root) {
+    yyscan_t scanner;
+    *root = NULL;
+    if (yylex_init_extra(context, &scanner) != 0) return 1;
+    YY_BUFFER_STATE buffer = yy_scan_bytes(text, (int)length, scanner);
+    yyset_lineno(first_line, scanner);
+    int status = yyparse(scanner, root);
+    yy_delete_buffer(buffer, scanner);
+    yylex_destroy(scanner);
+    release_body_buffer(context);
+    return status;
+}
+
+int parse_stream(FILE *input, ParseContext *context, AstNode **root) {
+    yyscan_t scanner;
+    *root = NULL;
+    if (yylex_init_extra(context, &scanner) != 0) return 1;
+    yyset_in(input, scanner);
+    int status = yyparse(scanner, root);
+    yylex_destroy(scanner);
+    release_body_buffer(context);
+    return status;
+}
+
+void lazy_body_begin(ParseContext *context, int line) {
+    context->body_depth = 1; // El 'do' (u 'once') que abrió el cuerpo
+    context->body_line = line;
+    context->body_length = 0;
+}
+
+void lazy_body_append(ParseContext *context, const char *text, size_t length) {
+    if (context->body_length + length > context->body_capacity) {
+        size_t capacity = context->body_capacity ? context->body_capacity : 256;
+        while (capacity < context->body_length + length) capacity *= 2;
+        context->body_text = realloc(context->body_text, capacity);
+        context->body_capacity = capacity;
+    }
+    memcpy(context->body_text + context->body_length, text, length);
+    context->body_length += length;
+}
+
+LazyBody *lazy_body_finish(ParseContext *context) {
+    LazyBody *body = mem_alloc(MEM_AST, sizeof(LazyBody));
+    body->source = mem_strndup(MEM_AST, context->body_text ? context->body_text : "", context->body_length);
+    body->length = context->body_length;
+    body->first_line = context->body_line;
+    return body;
+}
+
+int parse_feature_body(FeatureBodyNode *feature) {
+    if (!FEATURE_BODY_PENDING(feature)) return 0;
+    pthread_mutex_lock(&body_lock);
+    LazyBody *body = atomic_load_explicit(&feature->lazy_body, memory_order_acquire);
+    int status = 0;
+    if (body) { // Otro hilo pudo haberlo parseado mientras esperábamos
+        ParseContext context = { NULL, stderr, 0, 1 };
+        AstNode *statements = NULL;
+        status = parse_text(body->source, body->length, body->first_line, &context, &statements);
+        if (status == 0) {
+            feature->statements = (StatementListNode*)statements;
+            atomic_store_explicit(&feature->lazy_body, NULL, memory_order_release);
+            mem_free(MEM_AST, body->source);
+            mem_free(MEM_AST, body);
+        } else {
+            free_ast(statements);
+        }
+    }
+    pthread_mutex_unlock(&body_lock);
+    return status;
+}
+
+// Parsea un archivo con los errores en diagnostics (stderr o un stream en memoria)
+static void parse_file(SourceFile *file, FILE *diagnostics) {
+    FILE *input = file->input;
+    if (!input) input = fopen(file->path, "r");
+    if (!input) {
+        fprintf(diagnostics, "%s: %s\n", file->path, strerror(errno));
+        file->status = -1;
+        file->root = NULL;
+        return;
+    }
+    ParseContext context = { file->token_output, diagnostics, parse_lazy_bodies };
+    file->status = parse_stream(input, &context, &file->root) == 0 ? 0 : 1;
+    if (file->status != 0) file->root = NULL;
+    if (!file->input) fclose(input);
+}
+
+static void parse_file_task(void *context, int index) {
+    SourceFile *file = &((SourceFile*)context)[index];
+    FILE *diagnostics = open_memstream(&file->diagnostics, &file->diagnostics_length);
+    parse_file(file, diagnostics);
+    fclose(diagnostics); // Deja diagnostics y diagnostics_length definitivos
+}
+
+void parse_files(SourceFile *files, int count) {
+    for (int i = 0; i < count; i++) {
+        files[i].root = NULL;
+        files[i].diagnostics = NULL;
+        files[i].diagnostics_length = 0;
+    }
+    if (count == 1) {
+        parse_file(&files[0], stderr);
+        return;
+    }
+    pool_run(count, parse_file_task, files);
+}
+
+int report_parse_errors(SourceFile *files, int count) {
+    for (int i = 0; i < count; i++) {
+        if (files[i].diagnostics_length > 0) fwrite(files[i].diagnostics, 1, files[i].diagnostics_length, stderr);
+        free(files[i].diagnostics);
+        files[i].diagnostics = NULL;
+        files[i].diagnostics_length = 0;
+        if (files[i].status != 0) {
+            if (files[i].status > 0 && count > 1) fprintf(stderr, "Error: No se pudo parsear '%s'.\n", files[i].path);
+            for (int j = i + 1; j < count; j++) {
+                free(files[j].diagnostics);
+                files[j].diagnostics = NULL;
+            }
+            return i;
+        }
+    }
+    return -1;
+}
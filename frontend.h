@@ -0,0 +1,78 @@
+#ifndef FRONTEND_H
+#define FRONTEND_H
+
+#include <stdio.h>
+#include "ast.h"
+
+/* Comentario general:
+   - Entrada única al front end (Flex + Bison). El scanner es reentrante y el parser es puro: cada
+     parseo tiene su propio estado (buffer, número de línea, pila del parser), así que varios
+     archivos se pueden parsear a la vez en distintos hilos.
+   - ParseContext viaja con el scanner (yyextra): adónde van los tokens (.info) y los errores.
+   - Los identificadores se internan en una tabla compartida por todos los hilos (ver intern.h).
+   - parse_files parsea varios archivos en paralelo sobre el pool (threadpool.h). Los mensajes de
+     error de cada archivo se juntan en memoria y report_parse_errors los emite en el orden de los
+     archivos, igual que un parseo secuencial.
+   - Cuerpos diferidos (opción '--lazy-bodies'): de cada rutina se parsea la firma (nombre,
+     argumentos, resultado, locales) y el scanner saltea su cuerpo contando los bloques que cierran
+     con 'end' (if, from, across), sin tokens ni AST: guarda el texto y la línea (LazyBody). El cuerpo
+     se parsea la primera vez que una llamada, un acceso o un create resuelve a la rutina
+     (parse_feature_body), así el arranque depende de las rutinas que se usan y no del tamaño de
+     los archivos. Un error de sintaxis dentro de un cuerpo aparece recién entonces.
+*/
+
+typedef struct ParseContext {
+    FILE *token_output; // Tokens para el .info (NULL: no se escriben)
+    FILE *diagnostics;  // Errores léxicos y de sintaxis
+    int lazy_bodies;    // 1: saltear los cuerpos de las rutinas (ver parse_feature_body)
+    int body_only;      // 1: el texto es un cuerpo diferido (el scanner empieza con TOKEN_BODY_START)
+    // Estado del scanner mientras saltea un cuerpo
+    int body_depth;
+    int body_line;
+    char *body_text;
+    size_t body_length, body_capacity;
+} ParseContext;
+
+// Valor de lazy_bodies para los programas y las clases del class path ('--lazy-bodies' en main.c)
+extern int parse_lazy_bodies;
+
+// 1 si el cuerpo de la rutina todavía no se parseó
+#define FEATURE_BODY_PENDING(feature) (atomic_load_explicit(&(feature)->lazy_body, memory_order_acquire) != NULL)
+
+// Usadas por el scanner al saltear un cuerpo: empieza en line, junta su texto y arma el LazyBody
+void lazy_body_begin(ParseContext *context, int line);
+void lazy_body_append(ParseContext *context, const char *text, size_t length);
+LazyBody *lazy_body_finish(ParseContext *context);
+
+/* parse_feature_body: parsea el cuerpo diferido de feature (si lo tiene) y lo deja en statements.
+   Se puede llamar desde varios hilos: el primero parsea y los demás esperan. Devuelve 0 si salió
+   bien; si no, los errores quedan escritos en stderr y el cuerpo sigue sin parsear. */
+int parse_feature_body(FeatureBodyNode *feature);
+
+// Parsea length bytes de text (líneas numeradas desde first_line). Devuelve 0 si salió bien; el AST queda en *root
+int parse_text(const char *text, size_t length, int first_line, ParseContext *context, AstNode **root);
+
+// Igual que parse_text, leyendo input hasta el final
+int parse_stream(FILE *input, ParseContext *context, AstNode **root);
+
+typedef struct {
+    const char *path;
+    FILE *input;          // Ya abierto por el que llama (o NULL: se abre path)
+    FILE *token_output;   // Tokens de este archivo (NULL: no se escriben)
+    AstNode *root;
+    int status;           // 0: ok; 1: error de parseo; -1: no se pudo abrir
+    char *diagnostics;    // Mensajes de error (malloc; NULL si se escribieron directo en stderr)
+    size_t diagnostics_length;
+} SourceFile;
+
+/* parse_files: parsea files[0..count) y completa root, status y diagnostics de cada uno. Con más
+   de un archivo cada uno es una tarea del pool; con uno solo se parsea en el hilo actual y los
+   errores van directo a stderr. Cierra los input que abrió. */
+void parse_files(SourceFile *files, int count);
+
+/* report_parse_errors: escribe en stderr los mensajes de files en orden, hasta el primer archivo
+   con error inclusive (donde se habría detenido un parseo secuencial); con varios archivos nombra
+   el que no parseó. Devuelve su índice o -1. */
+int report_parse_errors(SourceFile *files, int count);
+
+#endif // FRONTEND_H
@@ -0,0 +1,443 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/* Comentario general:
+   - Herramienta fuera de línea para los snapshots de '--heap-dump' (formato en heapdump.h):
+       ./heap_report snapshot.jsonl        instancias, tamaño propio y retenido por clase,
+                                           y las celdas que más retienen
+       ./heap_report snapshot.jsonl ID     camino más corto desde una raíz hasta la celda ID
+   - De cada línea solo se leen kind, id, class, size y refs (que van antes que los valores del
+     programa); el resto de la línea se ignora.
+   - Tamaño retenido: lo que se liberaría si la celda desapareciera, o sea la suma de los tamaños
+     propios de las celdas que domina. Los dominadores se calculan con el algoritmo iterativo de
+     Cooper, Harvey y Kennedy sobre el grafo con un nodo 0 virtual que apunta a todas las raíces.
+   - El retenido de una clase suma el de sus instancias que no están dominadas por otra instancia
+     de la misma clase (así una lista de NODE no se cuenta una vez por cada nodo).
+*/
+
+typedef struct {
+    int target;
+    char *name;
+} Edge;
+
+typedef struct {
+    char *class_name;       // NULL: id sin línea en el snapshot (o el nodo 0)
+    int class_index;
+    size_t size;
+    Edge *edges;
+    int edge_count;
+    int edge_capacity;
+    int idom;               // -1: inalcanzable
+    int order;              // Posición en el postorden desde el nodo 0
+    size_t retained;
+} HeapNode;
+
+typedef struct {
+    char *name;
+    int count;
+    size_t shallow;
+    size_t retained;
+    int active;             // Instancias en el camino actual del árbol de dominadores
+} ClassStats;
+
+static HeapNode *nodes = NULL;
+static int node_count = 1; // El nodo 0 es la raíz virtual
+static int node_capacity = 0;
+static ClassStats *classes = NULL;
+static int class_total = 0;
+
+static void ensure_node(int id) {
+    if (id < node_capacity) {
+        if (id >= node_count) node_count = id + 1;
+        return;
+    }
+    int capacity = node_capacity ? node_capacity : 64;
+    while (capacity <= id) capacity *= 2;
+    nodes = realloc(nodes, (size_t)capacity * sizeof(HeapNode));
+    memset(nodes + node_capacity, 0, (size_t)(capacity - node_capacity) * sizeof(HeapNode));
+    node_capacity = capacity;
+    if (id >= node_count) node_count = id + 1;
+}
+
+static void add_edge(int from, int target, const char *name) {
+    HeapNode *node = &nodes[from];
+    if (node->edge_count == node->edge_capacity) {
+        node->edge_capacity = node->edge_capacity ? node->edge_capacity * 2 : 4;
+        node->edges = realloc(node->edges, (size_t)node->edge_capacity * sizeof(Edge));
+    }
+    node->edges[node->edge_count].target = target;
+    node->edges[node->edge_count].name = strdup(name);
+    node->edge_count++;
+}
+
+static int class_index(const char *name) {
+    for (int i = 0; i < class_total; i++) {
+        if (strcmp(classes[i].name, name) == 0) return i;
+    }
+    classes = realloc(classes, (size_t)(class_total + 1) * sizeof(ClassStats));
+    memset(&classes[class_total], 0, sizeof(ClassStats));
+    classes[class_total].name = strdup(name);
+    return class_total++;
+}
+
+/* --- Lectura de una línea --- */
+
+static void skip_spaces(const char **p) {
+    while (isspace((unsigned char)**p)) (*p)++;
+}
+
+// Lee un string JSON en buffer (truncado a size - 1). Devuelve 0 si no había un string
+static int read_string(const char **p, char *buffer, size_t size) {
+    skip_spaces(p);
+    if (**p != '"') return 0;
+    (*p)++;
+    size_t len = 0;
+    while (**p && **p != '"') {
+        char c = **p;
+        if (c == '\\' && (*p)[1]) {
+            (*p)++;
+            c = **p;
+            if (c == 'n') c = '\n';
+            else if (c == 't') c = '\t';
+            else if (c == 'r') c = '\r';
+            else if (c == 'u') {
+                // Solo aparecen para caracteres de control: se muestran como '?'
+                for (int i = 0; i < 4 && (*p)[1]; i++) (*p)++;
+                c = '?';
+            }
+        }
+        if (len + 1 < size) buffer[len++] = c;
+        (*p)++;
+    }
+    if (**p == '"') (*p)++;
+    buffer[len] = '\0';
+    return 1;
+}
+
+static int expect(const char **p, char c) {
+    skip_spaces(p);
+    if (**p != c) return 0;
+    (*p)++;
+    return 1;
+}
+
+// Lee "refs":{...} y agrega una arista desde from por cada entrada
+static int read_refs(const char **p, int from) {
+    char name[256];
+    if (!expect(p, '{')) return 0;
+    if (expect(p, '}')) return 1;
+    do {
+        if (!read_string(p, name, sizeof(name)) || !expect(p, ':')) return 0;
+        char *end;
+        long target = strtol(*p, &end, 10);
+        if (end == *p || target <= 0) return 0;
+        *p = end;
+        ensure_node((int)target);
+        add_edge(from, (int)target, name);
+    } while (expect(p, ','));
+    return expect(p, '}');
+}
+
+static int read_line(const char *line) {
+    char key[32], kind[16], text[256];
+    long id = 0;
+    size_t size = 0;
+    char *class_name = NULL;
+    const char *p = line;
+
+    if (!expect(&p, '{') || !read_string(&p, key, sizeof(key)) || strcmp(key, "kind") != 0
+        || !expect(&p, ':') || !read_string(&p, kind, sizeof(kind))) return 0;
+    if (strcmp(kind, "snapshot") == 0 || strcmp(kind, "end") == 0) return 1;
+    int is_root = strcmp(kind, "root") == 0;
+
+    while (expect(&p, ',') && read_string(&p, key, sizeof(key)) && expect(&p, ':')) {
+        if (strcmp(key, "refs") == 0) {
+            int from = is_root ? 0 : (int)id;
+            if (!is_root) {
+                if (id <= 0) return 0;
+                ensure_node(from);
+                nodes[from].class_name = class_name ? class_name : strdup("Unknown");
+                nodes[from].size = size;
+            }
+            return read_refs(&p, from);
+        } else if (strcmp(key, "id") == 0) {
+            char *end;
+            id = strtol(p, &end, 10);
+            p = end;
+        } else if (strcmp(key, "size") == 0) {
+            char *end;
+            size = (size_t)strtoull(p, &end, 10);
+            p = end;
+        } else if (read_string(&p, text, sizeof(text))) {
+            if (strcmp(key, "class") == 0) {
+                free(class_name);
+                class_name = strdup(text);
+            }
+        } else {
+            break;
+        }
+    }
+    free(class_name);
+    return 0;
+}
+
+/* --- Dominadores y tamaño retenido --- */
+
+// Postorden iterativo desde el nodo 0; devuelve los nodos alcanzables en ese orden
+static int *postorder(int *count) {
+    int *result = malloc((size_t)node_count * sizeof(int));
+    int *stack = malloc((size_t)node_count * sizeof(int));
+    int *next_edge = calloc((size_t)node_count, sizeof(int));
+    char *seen = calloc((size_t)node_count, 1);
+    int top = 0, n = 0;
+    stack[top++] = 0;
+    seen[0] = 1;
+    while (top > 0) {
+        HeapNode *node = &nodes[stack[top - 1]];
+        if (next_edge[stack[top - 1]] < node->edge_count) {
+            int target = node->edges[next_edge[stack[top - 1]]++].target;
+            if (!seen[target]) {
+                seen[target] = 1;
+                stack[top++] = target;
+            }
+        } else {
+            result[n++] = stack[--top];
+        }
+    }
+    free(stack);
+    free(next_edge);
+    free(seen);
+    *count = n;
+    return result;
+}
+
+static int intersect(int a, int b) {
+    while (a != b) {
+        while (nodes[a].order < nodes[b].order) a = nodes[a].idom;
+        while (nodes[b].order < nodes[a].order) b = nodes[b].idom;
+    }
+    return a;
+}
+
+static void compute_dominators(void) {
+    int count;
+    int *order = postorder(&count);
+    for (int i = 0; i < node_count; i++) {
+        nodes[i].idom = -1;
+        nodes[i].order = -1;
+    }
+    for (int i = 0; i < count; i++) nodes[order[i]].order = i;
+
+    // Predecesores de cada nodo alcanzable
+    int *pred_start = calloc((size_t)node_count + 1, sizeof(int));
+    for (int i = 0; i < node_count; i++) {
+        for (int e = 0; e < nodes[i].edge_count; e++) pred_start[nodes[i].edges[e].target + 1]++;
+    }
+    for (int i = 0; i < node_count; i++) pred_start[i + 1] += pred_start[i];
+    int *preds = malloc((size_t)(pred_start[node_count] ? pred_start[node_count] : 1) * sizeof(int));
+    int *fill = calloc((size_t)node_count, sizeof(int));
+    for (int i = 0; i < node_count; i++) {
+        for (int e = 0; e < nodes[i].edge_count; e++) {
+            int target = nodes[i].edges[e].target;
+            preds[pred_start[target] + fill[target]++] = i;
+        }
+    }
+
+    nodes[0].idom = 0;
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        // Orden postorden inverso, sin el nodo 0 (el último del postorden)
+        for (int i = count - 2; i >= 0; i--) {
+            int b = order[i];
+            int new_idom = -1;
+            for (int k = pred_start[b]; k < pred_start[b + 1]; k++) {
+                int p = preds[k];
+                if (nodes[p].idom < 0) continue;
+                new_idom = new_idom < 0 ? p : intersect(p, new_idom);
+            }
+            if (new_idom >= 0 && nodes[b].idom != new_idom) {
+                nodes[b].idom = new_idom;
+                changed = 1;
+            }
+        }
+    }
+
+    // Retenido: en postorden cada nodo ya sumó a sus dominados y se suma a su dominador
+    for (int i = 0; i < count; i++) nodes[order[i]].retained = nodes[order[i]].size;
+    for (int i = 0; i < count - 1; i++) nodes[nodes[order[i]].idom].retained += nodes[order[i]].retained;
+
+    free(order);
+    free(pred_start);
+    free(preds);
+    free(fill);
+}
+
+// Recorre el árbol de dominadores: una instancia suma al retenido de su clase si no tiene encima otra igual
+static void compute_class_stats(void) {
+    int *child_start = calloc((size_t)node_count + 1, sizeof(int));
+    for (int i = 1; i < node_count; i++) {
+        if (nodes[i].idom >= 0) child_start[nodes[i].idom + 1]++;
+    }
+    for (int i = 0; i < node_count; i++) child_start[i + 1] += child_start[i];
+    int *children = malloc((size_t)(node_count ? node_count : 1) * sizeof(int));
+    int *fill = calloc((size_t)node_count, sizeof(int));
+    for (int i = 1; i < node_count; i++) {
+        if (nodes[i].idom >= 0) children[child_start[nodes[i].idom] + fill[nodes[i].idom]++] = i;
+    }
+
+    for (int i = 1; i < node_count; i++) {
+        if (!nodes[i].class_name) continue;
+        int c = nodes[i].class_index = class_index(nodes[i].class_name);
+        classes[c].count++;
+        classes[c].shallow += nodes[i].size;
+    }
+
+    // Pila de (nodo, próximo hijo); al entrar se activa la clase del nodo y al salir se desactiva
+    int *stack = malloc((size_t)node_count * sizeof(int));
+    int *next_child = calloc((size_t)node_count, sizeof(int));
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        int n = stack[top - 1];
+        if (next_child[n] < child_start[n + 1] - child_start[n]) {
+            int child = children[child_start[n] + next_child[n]++];
+            if (nodes[child].class_name) {
+                ClassStats *stats = &classes[nodes[child].class_index];
+                if (stats->active == 0) stats->retained += nodes[child].retained;
+                stats->active++;
+            }
+            stack[top++] = child;
+        } else {
+            top--;
+            if (n != 0 && nodes[n].class_name) classes[nodes[n].class_index].active--;
+        }
+    }
+
+    free(stack);
+    free(next_child);
+    free(child_start);
+    free(children);
+    free(fill);
+}
+
+static int compare_classes(const void *a, const void *b) {
+    const ClassStats *x = a, *y = b;
+    if (x->retained != y->retained) return x->retained < y->retained ? 1 : -1;
+    return strcmp(x->name, y->name);
+}
+
+static int compare_nodes(const void *a, const void *b) {
+    const HeapNode *x = &nodes[*(const int*)a], *y = &nodes[*(const int*)b];
+    if (x->retained != y->retained) return x->retained < y->retained ? 1 : -1;
+    return *(const int*)a - *(const int*)b;
+}
+
+static void print_report(const char *path) {
+    compute_dominators();
+    compute_class_stats();
+
+    int cells = 0, roots = nodes[0].edge_count;
+    for (int i = 1; i < node_count; i++) cells += nodes[i].class_name != NULL;
+    printf("--- Heap report: %s ---\n", path);
+    printf("%d celdas, %zu bytes alcanzables, %d raíces\n\n", cells, nodes[0].retained, roots);
+
+    qsort(classes, (size_t)class_total, sizeof(ClassStats), compare_classes);
+    printf("%-28s %10s %14s %14s\n", "Clase", "Instancias", "Propio", "Retenido");
+    for (int i = 0; i < class_total; i++) {
+        printf("%-28s %10d %14zu %14zu\n", classes[i].name, classes[i].count, classes[i].shallow, classes[i].retained);
+    }
+
+    int *ids = malloc((size_t)(node_count ? node_count : 1) * sizeof(int));
+    int n = 0;
+    for (int i = 1; i < node_count; i++) {
+        if (nodes[i].class_name && nodes[i].idom >= 0) ids[n++] = i;
+    }
+    qsort(ids, (size_t)n, sizeof(int), compare_nodes);
+    printf("\nCeldas que más retienen:\n");
+    for (int i = 0; i < n && i < 10; i++) {
+        HeapNode *node = &nodes[ids[i]];
+        printf("  #%-8d %-28s retenido %zu (propio %zu)\n", ids[i], node->class_name, node->retained, node->size);
+    }
+    free(ids);
+}
+
+/* --- Camino desde una raíz --- */
+
+static int print_path(int target) {
+    if (target <= 0 || target >= node_count || !nodes[target].class_name) {
+        fprintf(stderr, "Error: la celda #%d no está en el snapshot.\n", target);
+        return 1;
+    }
+    int *parent = malloc((size_t)node_count * sizeof(int));
+    const char **via = malloc((size_t)node_count * sizeof(char*));
+    int *queue = malloc((size_t)node_count * sizeof(int));
+    for (int i = 0; i < node_count; i++) parent[i] = -1;
+    int head = 0, tail = 0;
+    queue[tail++] = 0;
+    parent[0] = 0;
+    while (head < tail && parent[target] < 0) {
+        int n = queue[head++];
+        for (int e = 0; e < nodes[n].edge_count; e++) {
+            int next = nodes[n].edges[e].target;
+            if (parent[next] >= 0) continue;
+            parent[next] = n;
+            via[next] = nodes[n].edges[e].name;
+            queue[tail++] = next;
+        }
+    }
+
+    int status = 0;
+    if (parent[target] < 0) {
+        fprintf(stderr, "Error: la celda #%d no es alcanzable desde ninguna raíz.\n", target);
+        status = 1;
+    } else {
+        // El camino se arma al revés (de la celda a la raíz) y se imprime desde la raíz
+        int depth = 0;
+        for (int n = target; n != 0; n = parent[n]) queue[depth++] = n;
+        for (int i = depth - 1; i >= 0; i--) {
+            int n = queue[i];
+            if (i == depth - 1) printf("%s", via[n]);
+            else printf(" .%s", via[n]);
+            printf(" -> #%d %s", n, nodes[n].class_name);
+        }
+        printf("\n");
+    }
+    free(parent);
+    free(via);
+    free(queue);
+    return status;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "Uso: %s snapshot.jsonl [id]\n", argv[0]);
+        return 1;
+    }
+    FILE *file = fopen(argv[1], "r");
+    if (!file) {
+        perror(argv[1]);
+        return 1;
+    }
+    ensure_node(0);
+    char *line = NULL;
+    size_t capacity = 0;
+    int line_number = 0;
+    while (getline(&line, &capacity, file) != -1) {
+        line_number++;
+        if (!read_line(line)) {
+            fprintf(stderr, "Error: %s:%d: línea inválida.\n", argv[1], line_number);
+            free(line);
+            fclose(file);
+            return 1;
+        }
+    }
+    free(line);
+    fclose(file);
+
+    if (argc == 3) return print_path(atoi(argv[2]));
+    print_report(argv[1]);
+    return 0;
+}
@@ -0,0 +1,310 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "interpreter.h"
+#include "array.h"
+#include "eiffel_io.h"
+#include "heapdump.h"
+
+/* Comentario general:
+   - El índice y la cola del recorrido son estructuras internas: usan malloc directo (no cuentan
+     en memstats, igual que en image.c).
+   - El snapshot se escribe sin buffer propio: cada celda se imprime apenas sale de la cola, y sus
+     referencias se numeran en ese momento (el id de una celda es su orden de llegada).
+   - Los strings del programa se escriben con los escapes de JSON; un REAL no finito va como string
+     porque JSON no tiene NaN ni infinito.
+*/
+
+static char *requested_path = NULL;
+
+void heap_dump_request(const char *path) {
+    free(requested_path);
+    requested_path = path ? strdup(path) : NULL;
+}
+
+/* --- Índice puntero -> id --- */
+
+static size_t pointer_hash(const void *pointer, size_t mask) {
+    uintptr_t h = (uintptr_t)pointer;
+    h ^= h >> 17;
+    h *= (uintptr_t)0x9E3779B97F4A7C15ull;
+    return (size_t)(h ^ (h >> 29)) & mask;
+}
+
+static void index_slot(HeapIndex *index, void *cell, unsigned id) {
+    size_t i = pointer_hash(cell, index->slot_count - 1);
+    while (index->slot_keys[i]) i = (i + 1) & (index->slot_count - 1);
+    index->slot_keys[i] = cell;
+    index->slot_ids[i] = id;
+}
+
+static void grow_slots(HeapIndex *index) {
+    void **old_keys = index->slot_keys;
+    unsigned *old_ids = index->slot_ids;
+    size_t old_count = index->slot_count;
+    index->slot_count = old_count ? old_count * 2 : 64;
+    index->slot_keys = calloc(index->slot_count, sizeof(void*));
+    index->slot_ids = calloc(index->slot_count, sizeof(unsigned));
+    for (size_t i = 0; i < old_count; i++) {
+        if (old_keys[i]) index_slot(index, old_keys[i], old_ids[i]);
+    }
+    free(old_keys);
+    free(old_ids);
+}
+
+unsigned heap_index_id(HeapIndex *index, void *cell, HeapCellKind kind, int *added) {
+    if (added) *added = 0;
+    if (!cell) return 0;
+    if (index->slot_count) {
+        size_t i = pointer_hash(cell, index->slot_count - 1);
+        while (index->slot_keys[i]) {
+            if (index->slot_keys[i] == cell) return index->slot_ids[i];
+            i = (i + 1) & (index->slot_count - 1);
+        }
+    }
+    if ((index->count + 1) * 2 > index->slot_count) grow_slots(index);
+    if (index->count == index->capacity) {
+        index->capacity = index->capacity ? index->capacity * 2 : 64;
+        index->cells = realloc(index->cells, index->capacity * sizeof(void*));
+        index->kinds = realloc(index->kinds, index->capacity * sizeof(HeapCellKind));
+    }
+    index->cells[index->count] = cell;
+    index->kinds[index->count] = kind;
+    unsigned id = ++index->count;
+    index_slot(index, cell, id);
+    if (added) *added = 1;
+    return id;
+}
+
+void heap_index_free(HeapIndex *index) {
+    free(index->cells);
+    free(index->kinds);
+    free(index->slot_keys);
+    free(index->slot_ids);
+    memset(index, 0, sizeof(*index));
+}
+
+/* --- Escritura --- */
+
+static void put_json_string(FILE *out, const char *text) {
+    fputc('"', out);
+    for (const unsigned char *p = (const unsigned char*)(text ? text : ""); *p; p++) {
+        switch (*p) {
+            case '"': fputs("\\\"", out); break;
+            case '\\': fputs("\\\\", out); break;
+            case '\n': fputs("\\n", out); break;
+            case '\r': fputs("\\r", out); break;
+            case '\t': fputs("\\t", out); break;
+            default:
+                if (*p < 0x20) fprintf(out, "\\u%04x", *p);
+                else fputc(*p, out);
+        }
+    }
+    fputc('"', out);
+}
+
+static void put_real(FILE *out, double value) {
+    if (isfinite(value)) fprintf(out, "%.17g", value);
+    else fprintf(out, "\"%s\"", isnan(value) ? "nan" : value > 0 ? "inf" : "-inf");
+}
+
+// Id de la celda a la que apunta value (la numera si es nueva); 0 si no es una referencia
+static unsigned ref_id(HeapIndex *index, RuntimeValue value) {
+    switch (value.type) {
+        case VAL_TYPE_OBJECT: return heap_index_id(index, value.as.object_val, HEAP_CELL_OBJECT, NULL);
+        case VAL_TYPE_ARRAY: return heap_index_id(index, value.as.array_val, HEAP_CELL_ARRAY, NULL);
+        case VAL_TYPE_FILE: return heap_index_id(index, value.as.file_val, HEAP_CELL_FILE, NULL);
+        default: return 0;
+    }
+}
+
+static void put_value(FILE *out, HeapIndex *index, RuntimeValue value) {
+    switch (value.type) {
+        case VAL_TYPE_INT: fprintf(out, "%d", value.as.int_val); break;
+        case VAL_TYPE_BOOLEAN: fputs(value.as.int_val ? "true" : "false", out); break;
+        case VAL_TYPE_REAL: put_real(out, value.as.real_val); break;
+        case VAL_TYPE_STRING: put_json_string(out, value.as.string_val); break;
+        case VAL_TYPE_OBJECT:
+        case VAL_TYPE_ARRAY:
+        case VAL_TYPE_FILE: {
+            unsigned id = ref_id(index, value);
+            if (id) fprintf(out, "{\"ref\":%u}", id);
+            else fputs("null", out);
+            break;
+        }
+        case VAL_TYPE_NULL:
+        case VAL_TYPE_VOID: fputs("null", out); break;
+    }
+}
+
+// Escribe "nombre":id por cada referencia; first indica si todavía no se escribió ninguna
+static void put_ref(FILE *out, HeapIndex *index, const char *name, RuntimeValue value, int *first) {
+    unsigned id = ref_id(index, value);
+    if (!id) return;
+    if (!*first) fputc(',', out);
+    *first = 0;
+    put_json_string(out, name);
+    fprintf(out, ":%u", id);
+}
+
+// Nombre "once nombre" de un resultado once (sin la rutina que lo guardó, "once #i")
+static const char *once_label(OnceResult *result, int i, char *buffer, size_t size) {
+    if (result->feature && result->feature->feature_name) snprintf(buffer, size, "once %s", result->feature->feature_name);
+    else snprintf(buffer, size, "once #%d", i);
+    return buffer;
+}
+
+static void put_table_refs(FILE *out, HeapIndex *index, SymbolTable *table) {
+    int first = 1;
+    char label[128];
+    fputs("\"refs\":{", out);
+    for (int i = 0; i < table->count; i++) {
+        put_ref(out, index, table->entries[i].name, table->entries[i].value, &first);
+    }
+    for (int i = 0; i < table->once_count; i++) {
+        put_ref(out, index, once_label(&table->once_results[i], i, label, sizeof(label)), table->once_results[i].value, &first);
+    }
+    fputc('}', out);
+}
+
+static size_t object_size(SymbolTable *table) {
+    size_t size = sizeof(SymbolTable) + (size_t)table->once_count * sizeof(OnceResult);
+    for (int i = 0; i < table->count; i++) {
+        SymbolTableEntry *entry = &table->entries[i];
+        if (i >= table->shared_entries && entry->name) size += strlen(entry->name) + 1;
+        if (entry->value.type == VAL_TYPE_STRING && entry->value.as.string_val) size += strlen(entry->value.as.string_val) + 1;
+    }
+    return size;
+}
+
+static size_t array_size(EiffelArray *array) {
+    int count = array_count(array);
+    size_t size = sizeof(EiffelArray);
+    if (array->element_type == ARRAY_OF_INTEGER) return size + (size_t)count * sizeof(int);
+    if (array->element_type == ARRAY_OF_REAL) return size + (size_t)count * sizeof(double);
+    size += (size_t)count * sizeof(char*);
+    for (int i = 0; i < count; i++) {
+        if (array->data.strings[i]) size += strlen(array->data.strings[i]) + 1;
+    }
+    return size;
+}
+
+static size_t file_size(EiffelFile *file) {
+    size_t size = sizeof(EiffelFile);
+    if (file->name) size += strlen(file->name) + 1;
+    if (file->last_string) size += strlen(file->last_string) + 1;
+    return size;
+}
+
+static const char *file_mode_name(FileMode mode) {
+    return mode == FILE_OPEN_READ ? "lectura" : mode == FILE_OPEN_WRITE ? "escritura" : "cerrado";
+}
+
+static size_t put_object(FILE *out, HeapIndex *index, unsigned id, SymbolTable *table) {
+    size_t size = object_size(table);
+    fprintf(out, "{\"kind\":\"object\",\"id\":%u,\"class\":", id);
+    put_json_string(out, table->owner_class_name ? table->owner_class_name : "Unknown");
+    fprintf(out, ",\"size\":%zu,", size);
+    put_table_refs(out, index, table);
+    fputs(",\"fields\":{", out);
+    for (int i = 0; i < table->count; i++) {
+        if (i) fputc(',', out);
+        put_json_string(out, table->entries[i].name);
+        fputc(':', out);
+        put_value(out, index, table->entries[i].value);
+    }
+    fputs("}}\n", out);
+    return size;
+}
+
+static size_t put_array(FILE *out, unsigned id, EiffelArray *array) {
+    size_t size = array_size(array);
+    int count = array_count(array);
+    fprintf(out, "{\"kind\":\"array\",\"id\":%u,\"class\":", id);
+    put_json_string(out, array->type_name);
+    fprintf(out, ",\"size\":%zu,\"refs\":{},\"lower\":%d,\"items\":[", size, array->lower);
+    for (int i = 0; i < count; i++) {
+        if (i) fputc(',', out);
+        if (array->element_type == ARRAY_OF_INTEGER) fprintf(out, "%d", array->data.ints[i]);
+        else if (array->element_type == ARRAY_OF_REAL) put_real(out, array->data.reals[i]);
+        else put_json_string(out, array->data.strings[i]);
+    }
+    fputs("]}\n", out);
+    return size;
+}
+
+static size_t put_file(FILE *out, unsigned id, EiffelFile *file) {
+    size_t size = file_size(file);
+    fprintf(out, "{\"kind\":\"file\",\"id\":%u,\"class\":\"PLAIN_TEXT_FILE\",\"size\":%zu,\"refs\":{},\"name\":", id, size);
+    put_json_string(out, file->name);
+    fprintf(out, ",\"mode\":\"%s\"}\n", file_mode_name(file->mode));
+    return size;
+}
+
+// Una línea "root" con nombre y una sola referencia (si value es una referencia)
+static void put_root(FILE *out, HeapIndex *index, const char *name, RuntimeValue value) {
+    if (!ref_id(index, value)) return;
+    int first = 1;
+    fputs("{\"kind\":\"root\",\"name\":", out);
+    put_json_string(out, name);
+    fputs(",\"refs\":{", out);
+    put_ref(out, index, name, value, &first);
+    fputs("}}\n", out);
+}
+
+unsigned heap_dump_write(SymbolTable *global_scope, FILE *output) {
+    HeapIndex index = { 0 };
+    char label[256];
+    size_t bytes = 0;
+
+    fputs("{\"kind\":\"snapshot\",\"version\":1}\n", output);
+
+    // Raíces: el scope global (variables de MAIN.make y sus once "OBJECT") y los once de las clases
+    for (int i = 0; i < global_scope->count; i++) {
+        put_root(output, &index, global_scope->entries[i].name, global_scope->entries[i].value);
+    }
+    for (int i = 0; i < global_scope->once_count; i++) {
+        put_root(output, &index, once_label(&global_scope->once_results[i], i, label, sizeof(label)), global_scope->once_results[i].value);
+    }
+    for (int c = 0; c < class_count; c++) {
+        ClassDefinition *def = class_table[c];
+        for (int i = 0; i < def->once_count; i++) {
+            if (!def->once_results[i].feature) continue;
+            snprintf(label, sizeof(label), "%s.%s", def->name, def->once_results[i].feature->feature_name);
+            put_root(output, &index, label, def->once_results[i].value);
+        }
+    }
+
+    // Cola en anchura: index.cells[next] es la próxima celda a escribir
+    for (unsigned next = 0; next < index.count; next++) {
+        unsigned id = next + 1;
+        void *cell = index.cells[next];
+        switch (index.kinds[next]) {
+            case HEAP_CELL_OBJECT: bytes += put_object(output, &index, id, cell); break;
+            case HEAP_CELL_ARRAY: bytes += put_array(output, id, cell); break;
+            case HEAP_CELL_FILE: bytes += put_file(output, id, cell); break;
+        }
+    }
+
+    unsigned cells = index.count;
+    fprintf(output, "{\"kind\":\"end\",\"cells\":%u,\"bytes\":%zu}\n", cells, bytes);
+    heap_index_free(&index);
+    return cells;
+}
+
+int heap_dump_requested(SymbolTable *global_scope) {
+    if (!requested_path) return 0;
+    FILE *file = fopen(requested_path, "w");
+    if (!file) {
+        perror(requested_path);
+        return 1;
+    }
+    heap_dump_write(global_scope, file);
+    if (fclose(file) != 0) {
+        perror(requested_path);
+        return 1;
+    }
+    return 0;
+}
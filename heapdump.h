@@ -0,0 +1,59 @@
+#ifndef HEAPDUMP_H
+#define HEAPDUMP_H
+
+#include <stdio.h>
+#include "interpreter.h"
+
+/* Comentario general:
+   - Snapshot del heap para analizar fuera del intérprete ('--heap-dump archivo' en main.c,
+     ':dump archivo' en el REPL). Cada objeto, ARRAY o PLAIN_TEXT_FILE alcanzable recibe un número
+     (id) la primera vez que se lo encuentra y se escribe una sola vez: los objetos compartidos y
+     los ciclos no repiten nada.
+   - El recorrido es en anchura desde las raíces (el scope global y los resultados once guardados
+     en las clases) y se escribe a medida que avanza: la memoria extra es el índice puntero -> id.
+   - Formato JSON-lines, una línea por registro; cada línea empieza con "kind":
+       {"kind":"snapshot","version":1}
+       {"kind":"root","name":"lista","refs":{"lista":1}}            (una por raíz con referencias)
+       {"kind":"object","id":1,"class":"NODE","size":3264,"refs":{"next":2},"fields":{...}}
+       {"kind":"array","id":3,"class":"ARRAY [INTEGER]","size":80,"refs":{},"lower":1,"items":[...]}
+       {"kind":"file","id":4,"class":"PLAIN_TEXT_FILE","size":120,"refs":{},"name":"x","mode":"lectura"}
+       {"kind":"end","cells":4,"bytes":3464}
+     id, class, size y refs van siempre antes que los valores (fields, items...), así que un lector
+     puede quedarse con el grafo sin interpretar los strings del programa. size es el tamaño propio
+     aproximado en bytes (la celda más sus strings).
+   - heap_report.c lee este formato: instancias y tamaño retenido por clase, y el camino desde una
+     raíz hasta una celda.
+   - HeapIndex es el índice puntero -> id (en orden de llegada); también lo usa print_symbol_table
+     para imprimir cada objeto una sola vez.
+*/
+
+typedef enum {
+    HEAP_CELL_OBJECT,
+    HEAP_CELL_ARRAY,
+    HEAP_CELL_FILE
+} HeapCellKind;
+
+typedef struct {
+    void **cells;          // Celdas en orden de llegada: el id de cells[i] es i + 1
+    HeapCellKind *kinds;
+    unsigned count;
+    unsigned capacity;
+    void **slot_keys;      // Direccionamiento abierto, a lo sumo medio lleno
+    unsigned *slot_ids;
+    size_t slot_count;
+} HeapIndex;
+
+// Id de cell (lo agrega al final si es nuevo); *added queda en 1 si era nuevo (added puede ser NULL)
+unsigned heap_index_id(HeapIndex *index, void *cell, HeapCellKind kind, int *added);
+void heap_index_free(HeapIndex *index);
+
+// Escribe el snapshot del heap alcanzable desde global_scope. Devuelve la cantidad de celdas
+unsigned heap_dump_write(SymbolTable *global_scope, FILE *output);
+
+// Pide que run_in_scope escriba el snapshot en path al terminar (también si hubo un error)
+void heap_dump_request(const char *path);
+
+// Si se pidió, escribe el snapshot. Devuelve 0 si salió bien (o no se pidió)
+int heap_dump_requested(SymbolTable *global_scope);
+
+#endif // HEAPDUMP_H
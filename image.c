@@ -0,0 +1,741 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ast.h"
+#include "interpreter.h"
+#include "array.h"
+#include "memstats.h"
+#include "image.h"
+#include "intern.h"
+
+/* Comentario general:
+   - Escritura: primero se numeran las celdas (recorrido en anchura desde las globales, con un
+     índice puntero -> celda), después se escriben clases, celdas y globales en un buffer que se
+     vuelca a un archivo temporal y se renombra (nunca queda una imagen a medio escribir).
+   - Lectura: todo acceso al mapeo pasa por un lector con control de límites; una imagen truncada
+     o ajena termina con un error, nunca con una lectura fuera del archivo.
+   - Las celdas se restauran en dos pasadas: primero se crean todas vacías (así una referencia
+     puede apuntar a una celda posterior) y después se completan.
+   - El buffer, el índice y las tablas de celdas son estructuras internas: usan malloc directo.
+*/
+
+#define IMAGE_MAGIC "EIFIMAGE"
+#define IMAGE_VERSION 2
+#define IMAGE_BYTE_ORDER_MARK 0x01020304u
+#define IMAGE_NO_REF UINT32_MAX
+#define IMAGE_NULL_TAG 0xFF
+
+enum { CELL_OBJECT = 1, CELL_ARRAY = 2 };
+
+static char *requested_path = NULL;
+
+void image_request_save(const char *path) {
+    free(requested_path);
+    requested_path = path ? strdup(path) : NULL;
+}
+
+int image_save_pending(void) {
+    return requested_path != NULL;
+}
+
+/* --- Escritura --- */
+
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+} ImageBuffer;
+
+typedef struct {
+    void *pointer;
+    int kind;
+} Cell;
+
+typedef struct {
+    ImageBuffer out;
+    Cell *cells;
+    uint32_t cell_count;
+    uint32_t cell_capacity;
+    // Índice puntero -> celda + 1 (0: libre); direccionamiento abierto, a lo sumo medio lleno
+    void **slot_keys;
+    uint32_t *slot_ids;
+    size_t slot_count;
+} ImageWriter;
+
+static void put_bytes(ImageBuffer *b, const void *data, size_t len) {
+    if (len == 0) return;
+    if (b->size + len > b->capacity) {
+        size_t capacity = b->capacity ? b->capacity : 4096;
+        while (b->size + len > capacity) capacity *= 2;
+        b->data = realloc(b->data, capacity);
+        b->capacity = capacity;
+    }
+    memcpy(b->data + b->size, data, len);
+    b->size += len;
+}
+
+static void put_u8(ImageBuffer *b, uint8_t value) { put_bytes(b, &value, sizeof(value)); }
+static void put_u32(ImageBuffer *b, uint32_t value) { put_bytes(b, &value, sizeof(value)); }
+static void put_i32(ImageBuffer *b, int32_t value) { put_bytes(b, &value, sizeof(value)); }
+static void put_f64(ImageBuffer *b, double value) { put_bytes(b, &value, sizeof(value)); }
+
+static void put_string(ImageBuffer *b, const char *text) {
+    if (!text) {
+        put_u32(b, IMAGE_NO_REF);
+        return;
+    }
+    uint32_t len = (uint32_t)strlen(text);
+    put_u32(b, len);
+    put_bytes(b, text, len);
+}
+
+static size_t pointer_hash(const void *pointer, size_t mask) {
+    uintptr_t h = (uintptr_t)pointer;
+    h ^= h >> 17;
+    h *= (uintptr_t)0x9E3779B97F4A7C15ull;
+    return (size_t)(h ^ (h >> 29)) & mask;
+}
+
+static void index_cell(ImageWriter *w, void *pointer, uint32_t id) {
+    size_t i = pointer_hash(pointer, w->slot_count - 1);
+    while (w->slot_keys[i]) i = (i + 1) & (w->slot_count - 1);
+    w->slot_keys[i] = pointer;
+    w->slot_ids[i] = id + 1;
+}
+
+static void grow_index(ImageWriter *w) {
+    void **old_keys = w->slot_keys;
+    uint32_t *old_ids = w->slot_ids;
+    size_t old_count = w->slot_count;
+    w->slot_count = old_count ? old_count * 2 : 64;
+    w->slot_keys = calloc(w->slot_count, sizeof(void*));
+    w->slot_ids = calloc(w->slot_count, sizeof(uint32_t));
+    for (size_t i = 0; i < old_count; i++) {
+        if (old_keys[i]) index_cell(w, old_keys[i], old_ids[i] - 1);
+    }
+    free(old_keys);
+    free(old_ids);
+}
+
+static uint32_t find_cell(ImageWriter *w, void *pointer) {
+    if (!w->slot_count) return IMAGE_NO_REF;
+    size_t i = pointer_hash(pointer, w->slot_count - 1);
+    while (w->slot_keys[i]) {
+        if (w->slot_keys[i] == pointer) return w->slot_ids[i] - 1;
+        i = (i + 1) & (w->slot_count - 1);
+    }
+    return IMAGE_NO_REF;
+}
+
+// Devuelve la celda de pointer, numerándola si es la primera vez que aparece
+static uint32_t cell_for(ImageWriter *w, void *pointer, int kind) {
+    if (!pointer) return IMAGE_NO_REF;
+    uint32_t id = find_cell(w, pointer);
+    if (id != IMAGE_NO_REF) return id;
+    if ((w->cell_count + 1) * 2 > w->slot_count) grow_index(w);
+    if (w->cell_count == w->cell_capacity) {
+        w->cell_capacity = w->cell_capacity ? w->cell_capacity * 2 : 64;
+        w->cells = realloc(w->cells, w->cell_capacity * sizeof(Cell));
+    }
+    id = w->cell_count++;
+    w->cells[id].pointer = pointer;
+    w->cells[id].kind = kind;
+    index_cell(w, pointer, id);
+    return id;
+}
+
+static void discover_value(ImageWriter *w, RuntimeValue value) {
+    if (value.type == VAL_TYPE_OBJECT) cell_for(w, value.as.object_val, CELL_OBJECT);
+    else if (value.type == VAL_TYPE_ARRAY) cell_for(w, value.as.array_val, CELL_ARRAY);
+}
+
+static void discover_table(ImageWriter *w, SymbolTable *table) {
+    for (int i = 0; i < table->count; i++) discover_value(w, table->entries[i].value);
+}
+
+static void put_value(ImageWriter *w, RuntimeValue value) {
+    ImageBuffer *b = &w->out;
+    // Un PLAIN_TEXT_FILE no se guarda (su descriptor no sirve en otro proceso): queda sin inicializar
+    if (value.type == VAL_TYPE_FILE) value.type = VAL_TYPE_NULL;
+    put_u8(b, (uint8_t)value.type);
+    switch (value.type) {
+        case VAL_TYPE_INT: put_i32(b, value.as.int_val); break;
+        case VAL_TYPE_BOOLEAN: put_u8(b, (uint8_t)value.as.int_val); break;
+        case VAL_TYPE_REAL: put_f64(b, value.as.real_val); break;
+        case VAL_TYPE_STRING: put_string(b, value.as.string_val); break;
+        case VAL_TYPE_OBJECT: put_u32(b, find_cell(w, value.as.object_val)); break;
+        case VAL_TYPE_ARRAY: put_u32(b, find_cell(w, value.as.array_val)); break;
+        default: break;
+    }
+}
+
+static void put_entries(ImageWriter *w, SymbolTable *table) {
+    put_u32(&w->out, (uint32_t)table->count);
+    for (int i = 0; i < table->count; i++) {
+        put_string(&w->out, table->entries[i].name);
+        put_string(&w->out, table->entries[i].type_name);
+        put_value(w, table->entries[i].value);
+    }
+}
+
+static void put_array_elements(ImageBuffer *b, EiffelArray *array) {
+    put_i32(b, array->lower);
+    put_i32(b, array->upper);
+    int count = array_count(array);
+    switch (array->element_type) {
+        case ARRAY_OF_INTEGER: put_bytes(b, array->data.ints, (size_t)count * sizeof(int)); break;
+        case ARRAY_OF_REAL: put_bytes(b, array->data.reals, (size_t)count * sizeof(double)); break;
+        case ARRAY_OF_STRING:
+            for (int i = 0; i < count; i++) put_string(b, array->data.strings[i] ? array->data.strings[i] : "");
+            break;
+    }
+}
+
+static void put_node(ImageBuffer *b, AstNode *node) {
+    if (!node) {
+        put_u8(b, IMAGE_NULL_TAG);
+        return;
+    }
+    put_u8(b, (uint8_t)node->type);
+    switch (node->type) {
+        case NODE_TYPE_LITERAL: {
+            LiteralNode *n = (LiteralNode*)node;
+            put_u8(b, (uint8_t)n->literal_type);
+            if (n->literal_type == LITERAL_TYPE_INT) put_i32(b, n->value.int_val);
+            else if (n->literal_type == LITERAL_TYPE_BOOLEAN) put_u8(b, (uint8_t)n->value.int_val);
+            else if (n->literal_type == LITERAL_TYPE_REAL) put_f64(b, n->value.real_val);
+            else put_string(b, n->value.string_val);
+            break;
+        }
+        case NODE_TYPE_BINARY_EXPR: {
+            BinaryExprNode *n = (BinaryExprNode*)node;
+            put_u8(b, (uint8_t)n->op);
+            put_node(b, n->left);
+            put_node(b, n->right);
+            break;
+        }
+        case NODE_TYPE_COMPARISON_EXPR: {
+            ComparisonExprNode *n = (ComparisonExprNode*)node;
+            put_i32(b, n->op);
+            put_node(b, n->left);
+            put_node(b, n->right);
+            break;
+        }
+        case NODE_TYPE_BOOLEAN_EXPR: {
+            BooleanExprNode *n = (BooleanExprNode*)node;
+            put_u8(b, (uint8_t)n->op);
+            put_node(b, n->left);
+            put_node(b, n->right);
+            break;
+        }
+        case NODE_TYPE_PROCEDURE_CALL: {
+            ProcedureCallNode *n = (ProcedureCallNode*)node;
+            put_string(b, n->name);
+            put_node(b, (AstNode*)n->arguments);
+            break;
+        }
+        case NODE_TYPE_ARGUMENT_LIST: {
+            ArgumentListNode *n = (ArgumentListNode*)node;
+            put_u32(b, (uint32_t)n->count);
+            for (int i = 0; i < n->count; i++) put_node(b, n->arguments[i]);
+            break;
+        }
+        case NODE_TYPE_STATEMENT_LIST: {
+            StatementListNode *n = (StatementListNode*)node;
+            put_u32(b, (uint32_t)n->count);
+            for (int i = 0; i < n->count; i++) put_node(b, n->statements[i]);
+            break;
+        }
+        case NODE_TYPE_ASSIGN: {
+            AssignNode *n = (AssignNode*)node;
+            put_node(b, n->target);
+            put_node(b, n->expression);
+            break;
+        }
+        case NODE_TYPE_VARIABLE:
+            put_string(b, ((VariableNode*)node)->name);
+            break;
+        case NODE_TYPE_IF: {
+            IfNode *n = (IfNode*)node;
+            put_node(b, n->condition);
+            put_node(b, (AstNode*)n->then_branch);
+            put_node(b, (AstNode*)n->else_branch);
+            break;
+        }
+        case NODE_TYPE_LOOP: {
+            LoopNode *n = (LoopNode*)node;
+            put_node(b, (AstNode*)n->initialization);
+            put_node(b, n->condition);
+            put_node(b, (AstNode*)n->loop_body);
+            break;
+        }
+        case NODE_TYPE_ACROSS: {
+            AcrossNode *n = (AcrossNode*)node;
+            put_node(b, n->lower);
+            put_node(b, n->upper);
+            put_string(b, n->cursor_name);
+            put_u8(b, (uint8_t)n->is_parallel);
+            put_node(b, (AstNode*)n->loop_body);
+            break;
+        }
+        case NODE_TYPE_ATTRIBUTE_ACCESS: {
+            AttributeAccessNode *n = (AttributeAccessNode*)node;
+            put_node(b, n->object_node);
+            put_string(b, n->attribute_name);
+            break;
+        }
+        case NODE_TYPE_METHOD_CALL: {
+            MethodCallNode *n = (MethodCallNode*)node;
+            put_node(b, n->object_node);
+            put_string(b, n->method_name);
+            put_node(b, (AstNode*)n->arguments);
+            break;
+        }
+        case NODE_TYPE_CREATE: {
+            CreateNode *n = (CreateNode*)node;
+            put_string(b, n->object_name);
+            put_string(b, n->class_name);
+            put_string(b, n->creation_procedure);
+            put_node(b, (AstNode*)n->arguments);
+            break;
+        }
+        case NODE_TYPE_DECLARATION_LIST: {
+            DeclarationListNode *n = (DeclarationListNode*)node;
+            put_u32(b, (uint32_t)n->count);
+            for (int i = 0; i < n->count; i++) {
+                put_string(b, n->items[i].variable_name);
+                put_string(b, n->items[i].type_name);
+            }
+            break;
+        }
+        case NODE_TYPE_FEATURE_BODY: {
+            FeatureBodyNode *n = (FeatureBodyNode*)node;
+            load_feature_body(n); // La imagen guarda los cuerpos parseados
+            put_string(b, n->feature_name);
+            put_node(b, (AstNode*)n->parameters);
+            put_string(b, n->result_type);
+            put_u8(b, (uint8_t)n->routine_kind);
+            put_node(b, (AstNode*)n->declarations);
+            put_node(b, (AstNode*)n->statements);
+            break;
+        }
+        case NODE_TYPE_CLASS_DECL: {
+            ClassNode *n = (ClassNode*)node;
+            put_string(b, n->name);
+            put_node(b, (AstNode*)n->features);
+            break;
+        }
+        case NODE_TYPE_INLINE_SLOT:
+        case NODE_TYPE_INLINE_FIELD:
+            break; // Solo están en los cuerpos empalmados, que no se guardan (el enlace los arma)
+    }
+}
+
+static int write_file(const char *path, ImageBuffer *b) {
+    size_t len = strlen(path) + 5;
+    char *temporary = malloc(len);
+    snprintf(temporary, len, "%s.tmp", path);
+    FILE *file = fopen(temporary, "wb");
+    int ok = file && fwrite(b->data, 1, b->size, file) == b->size;
+    if (file && fclose(file) != 0) ok = 0;
+    if (ok && rename(temporary, path) != 0) ok = 0;
+    if (!ok) {
+        perror(path);
+        remove(temporary);
+    }
+    free(temporary);
+    return ok ? 0 : 1;
+}
+
+int image_save_requested(SymbolTable *global_scope) {
+    if (!requested_path) return 0;
+
+    ImageWriter w = { 0 };
+    discover_table(&w, global_scope);
+    for (uint32_t i = 0; i < w.cell_count; i++) {
+        if (w.cells[i].kind == CELL_OBJECT) discover_table(&w, w.cells[i].pointer);
+    }
+
+    ImageBuffer *b = &w.out;
+    put_bytes(b, IMAGE_MAGIC, 8);
+    put_u32(b, IMAGE_VERSION);
+    put_u32(b, IMAGE_BYTE_ORDER_MARK);
+    put_u32(b, (uint32_t)class_count);
+    put_u32(b, w.cell_count);
+
+    for (int i = 0; i < class_count; i++) {
+        put_string(b, class_table[i]->name);
+        put_node(b, (AstNode*)class_table[i]->feature_list);
+    }
+
+    for (uint32_t i = 0; i < w.cell_count; i++) {
+        Cell *cell = &w.cells[i];
+        put_u8(b, (uint8_t)cell->kind);
+        put_string(b, cell->kind == CELL_OBJECT ? ((SymbolTable*)cell->pointer)->owner_class_name
+                                                : ((EiffelArray*)cell->pointer)->type_name);
+        size_t length_at = b->size;
+        put_u32(b, 0); // Largo del cuerpo: se completa al final
+        if (cell->kind == CELL_OBJECT) put_entries(&w, cell->pointer);
+        else put_array_elements(b, cell->pointer);
+        uint32_t body_length = (uint32_t)(b->size - length_at - sizeof(uint32_t));
+        memcpy(b->data + length_at, &body_length, sizeof(body_length));
+    }
+
+    put_entries(&w, global_scope);
+
+    int status = write_file(requested_path, b);
+    free(b->data);
+    free(w.cells);
+    free(w.slot_keys);
+    free(w.slot_ids);
+    return status;
+}
+
+/* --- Lectura --- */
+
+typedef struct {
+    const unsigned char *data;
+    size_t size;
+    size_t pos;
+    const char *path;
+} ImageReader;
+
+typedef struct {
+    int kind;
+    void *pointer;
+    size_t body;
+} RestoredCell;
+
+static void corrupt(ImageReader *r) {
+    fprintf(stderr, "Error: La imagen '%s' está truncada o dañada (byte %zu).\n", r->path, r->pos);
+    runtime_abort();
+}
+
+static const unsigned char* take(ImageReader *r, size_t len) {
+    if (len > r->size - r->pos) corrupt(r);
+    const unsigned char *p = r->data + r->pos;
+    r->pos += len;
+    return p;
+}
+
+static uint8_t get_u8(ImageReader *r) { return *take(r, 1); }
+static uint32_t get_u32(ImageReader *r) { uint32_t v; memcpy(&v, take(r, sizeof(v)), sizeof(v)); return v; }
+static int32_t get_i32(ImageReader *r) { int32_t v; memcpy(&v, take(r, sizeof(v)), sizeof(v)); return v; }
+static double get_f64(ImageReader *r) { double v; memcpy(&v, take(r, sizeof(v)), sizeof(v)); return v; }
+
+static char* get_string(ImageReader *r, MemCategory category) {
+    uint32_t len = get_u32(r);
+    if (len == IMAGE_NO_REF) return NULL;
+    return mem_strndup(category, (const char*)take(r, len), len);
+}
+
+// Nombre de un nodo del AST: internado, como los que produce el parser (ver intern.h)
+static char* get_name(ImageReader *r) {
+    uint32_t len = get_u32(r);
+    if (len == IMAGE_NO_REF) return NULL;
+    return intern((const char*)take(r, len), len);
+}
+
+static AstNode* get_node(ImageReader *r);
+
+// Lee un nodo que debe ser del tipo indicado (o NULL)
+static AstNode* get_typed_node(ImageReader *r, NodeType type) {
+    AstNode *node = get_node(r);
+    if (node && node->type != type) corrupt(r);
+    return node;
+}
+
+static StatementListNode* get_statement_list(ImageReader *r) {
+    return (StatementListNode*)get_typed_node(r, NODE_TYPE_STATEMENT_LIST);
+}
+
+static ArgumentListNode* get_argument_list(ImageReader *r) {
+    return (ArgumentListNode*)get_typed_node(r, NODE_TYPE_ARGUMENT_LIST);
+}
+
+static AstNode* get_node(ImageReader *r) {
+    uint8_t tag = get_u8(r);
+    if (tag == IMAGE_NULL_TAG) return NULL;
+    switch ((NodeType)tag) {
+        case NODE_TYPE_LITERAL: {
+            uint8_t literal_type = get_u8(r);
+            if (literal_type == LITERAL_TYPE_INT) return create_int_literal_node(get_i32(r));
+            if (literal_type == LITERAL_TYPE_REAL) return create_real_literal_node(get_f64(r));
+            if (literal_type == LITERAL_TYPE_STRING) return create_string_literal_node(get_string(r, MEM_STRING));
+            if (literal_type == LITERAL_TYPE_BOOLEAN) return create_boolean_literal_node(get_u8(r));
+            break;
+        }
+        case NODE_TYPE_BINARY_EXPR: {
+            char op = (char)get_u8(r);
+            AstNode *left = get_node(r);
+            return create_binary_expr_node(op, left, get_node(r));
+        }
+        case NODE_TYPE_COMPARISON_EXPR: {
+            int op = get_i32(r);
+            AstNode *left = get_node(r);
+            return create_comparison_expr_node(op, left, get_node(r));
+        }
+        case NODE_TYPE_BOOLEAN_EXPR: {
+            uint8_t op = get_u8(r);
+            if (op > BOOL_IMPLIES) break;
+            AstNode *left = get_node(r);
+            return create_boolean_expr_node((BooleanOp)op, left, get_node(r));
+        }
+        case NODE_TYPE_PROCEDURE_CALL: {
+            char *name = get_name(r);
+            return create_procedure_call_node(name, get_argument_list(r));
+        }
+        case NODE_TYPE_ARGUMENT_LIST: {
+            uint32_t count = get_u32(r);
+            ArgumentListNode *list = NULL;
+            for (uint32_t i = 0; i < count; i++) list = append_to_argument_list(list, get_node(r));
+            return (AstNode*)list;
+        }
+        case NODE_TYPE_STATEMENT_LIST: {
+            uint32_t count = get_u32(r);
+            StatementListNode *list = NULL;
+            for (uint32_t i = 0; i < count; i++) list = append_to_statement_list(list, get_node(r));
+            return (AstNode*)list;
+        }
+        case NODE_TYPE_ASSIGN: {
+            AstNode *target = get_node(r);
+            return create_assign_node(target, get_node(r));
+        }
+        case NODE_TYPE_VARIABLE:
+            return create_variable_node(get_name(r));
+        case NODE_TYPE_IF: {
+            AstNode *condition = get_node(r);
+            StatementListNode *then_branch = get_statement_list(r);
+            return create_if_node(condition, then_branch, get_statement_list(r));
+        }
+        case NODE_TYPE_LOOP: {
+            StatementListNode *init = get_statement_list(r);
+            AstNode *condition = get_node(r);
+            return create_loop_node(init, condition, get_statement_list(r));
+        }
+        case NODE_TYPE_ACROSS: {
+            AstNode *lower = get_node(r);
+            AstNode *upper = get_node(r);
+            char *cursor = get_name(r);
+            int is_parallel = get_u8(r);
+            return create_across_node(lower, upper, cursor, is_parallel, get_statement_list(r));
+        }
+        case NODE_TYPE_ATTRIBUTE_ACCESS: {
+            AstNode *object = get_node(r);
+            return create_attribute_access_node(object, get_name(r));
+        }
+        case NODE_TYPE_METHOD_CALL: {
+            AstNode *object = get_node(r);
+            char *name = get_name(r);
+            return create_method_call_node(object, name, get_argument_list(r));
+        }
+        case NODE_TYPE_CREATE: {
+            char *object_name = get_name(r);
+            char *class_name = get_name(r);
+            char *procedure = get_name(r);
+            CreateNode *node = (CreateNode*)create_create_node(object_name, procedure, get_argument_list(r));
+            node->class_name = class_name;
+            return (AstNode*)node;
+        }
+        case NODE_TYPE_DECLARATION_LIST: {
+            uint32_t count = get_u32(r);
+            DeclarationListNode *list = NULL;
+            for (uint32_t i = 0; i < count; i++) {
+                list = append_declaration(list, get_name(r));
+                list->items[list->count - 1].type_name = get_name(r);
+            }
+            return (AstNode*)list;
+        }
+        case NODE_TYPE_FEATURE_BODY: {
+            char *name = get_name(r);
+            DeclarationListNode *params = (DeclarationListNode*)get_typed_node(r, NODE_TYPE_DECLARATION_LIST);
+            char *result_type = get_name(r);
+            int routine_kind = get_u8(r);
+            if (routine_kind > ROUTINE_ONCE_OBJECT) corrupt(r);
+            DeclarationListNode *decls = (DeclarationListNode*)get_typed_node(r, NODE_TYPE_DECLARATION_LIST);
+            FeatureBodyNode *node = (FeatureBodyNode*)create_feature_body_node(decls, get_statement_list(r));
+            node->feature_name = name;
+            node->parameters = params;
+            node->result_type = result_type;
+            node->routine_kind = (RoutineKind)routine_kind;
+            return (AstNode*)node;
+        }
+        case NODE_TYPE_CLASS_DECL: {
+            char *name = get_name(r);
+            return create_class_node(name, get_statement_list(r));
+        }
+        case NODE_TYPE_INLINE_SLOT:
+        case NODE_TYPE_INLINE_FIELD:
+            break; // Una imagen nunca los tiene (ver put_node)
+    }
+    r->pos--;
+    corrupt(r);
+    return NULL;
+}
+
+static RuntimeValue get_value(ImageReader *r, RestoredCell *cells, uint32_t cell_count) {
+    RuntimeValue value = { .type = (ValueType)get_u8(r) };
+    switch (value.type) {
+        case VAL_TYPE_INT: value.as.int_val = get_i32(r); break;
+        case VAL_TYPE_BOOLEAN: value.as.int_val = get_u8(r) != 0; break;
+        case VAL_TYPE_REAL: value.as.real_val = get_f64(r); break;
+        case VAL_TYPE_STRING: value.as.string_val = get_string(r, MEM_STRING); break;
+        case VAL_TYPE_OBJECT:
+        case VAL_TYPE_ARRAY: {
+            uint32_t id = get_u32(r);
+            int kind = value.type == VAL_TYPE_OBJECT ? CELL_OBJECT : CELL_ARRAY;
+            if (id == IMAGE_NO_REF) {
+                value.as.object_val = NULL;
+            } else if (id >= cell_count || cells[id].kind != kind) {
+                corrupt(r);
+            } else if (kind == CELL_OBJECT) {
+                value.as.object_val = cells[id].pointer;
+            } else {
+                value.as.array_val = cells[id].pointer;
+            }
+            break;
+        }
+        case VAL_TYPE_VOID:
+        case VAL_TYPE_NULL:
+            break;
+        default:
+            corrupt(r);
+    }
+    return value;
+}
+
+static void get_entries(ImageReader *r, SymbolTable *table, RestoredCell *cells, uint32_t cell_count) {
+    uint32_t count = get_u32(r);
+    if (count > MAX_SYMBOLS) corrupt(r);
+    for (uint32_t i = 0; i < count; i++) {
+        SymbolTableEntry *entry = &table->entries[table->count];
+        entry->name = get_string(r, MEM_IDENTIFIER);
+        entry->type_name = get_string(r, MEM_IDENTIFIER);
+        if (!entry->name) corrupt(r);
+        entry->value = get_value(r, cells, cell_count);
+        table->count++;
+    }
+}
+
+static void get_array_elements(ImageReader *r, EiffelArray *array) {
+    RuntimeValue bounds[2] = { { .type = VAL_TYPE_INT }, { .type = VAL_TYPE_INT } };
+    bounds[0].as.int_val = get_i32(r);
+    bounds[1].as.int_val = get_i32(r);
+    array_call_feature(array, "make", bounds, 2);
+    int count = array_count(array);
+    if (count <= 0) return;
+    switch (array->element_type) {
+        case ARRAY_OF_INTEGER: memcpy(array->data.ints, take(r, (size_t)count * sizeof(int)), (size_t)count * sizeof(int)); break;
+        case ARRAY_OF_REAL: memcpy(array->data.reals, take(r, (size_t)count * sizeof(double)), (size_t)count * sizeof(double)); break;
+        case ARRAY_OF_STRING:
+            for (int i = 0; i < count; i++) {
+                RuntimeValue args[2] = { { .type = VAL_TYPE_STRING }, { .type = VAL_TYPE_INT } };
+                args[0].as.string_val = get_string(r, MEM_STRING);
+                args[1].as.int_val = array->lower + i;
+                array_call_feature(array, "put", args, 2);
+                mem_free(MEM_STRING, args[0].as.string_val);
+            }
+            break;
+    }
+}
+
+// Crea la celda vacía (primera pasada) y saltea su cuerpo
+static void restore_cell_shell(ImageReader *r, RestoredCell *cell) {
+    cell->kind = get_u8(r);
+    char *name = get_string(r, MEM_IDENTIFIER);
+    if (cell->kind == CELL_OBJECT) {
+        // Del pool de su clase (ya restaurada); las entradas se leen después, con nombres propios
+        SymbolTable *object = new_object(name ? find_class(name) : NULL);
+        init_symbol_table(object);
+        object->owner_class_name = name ? intern_string(name) : NULL;
+        if (name) mem_count_instance(name, 1);
+        mem_free(MEM_IDENTIFIER, name);
+        cell->pointer = object;
+    } else if (cell->kind == CELL_ARRAY && name && is_array_type(name)) {
+        cell->pointer = create_array(name);
+        mem_count_instance(name, 1);
+        mem_free(MEM_IDENTIFIER, name);
+    } else {
+        corrupt(r);
+    }
+    uint32_t body_length = get_u32(r);
+    cell->body = r->pos;
+    take(r, body_length);
+}
+
+static void restore_cell_body(ImageReader *r, RestoredCell *cell, RestoredCell *cells, uint32_t cell_count) {
+    r->pos = cell->body;
+    if (cell->kind == CELL_OBJECT) get_entries(r, cell->pointer, cells, cell_count);
+    else get_array_elements(r, cell->pointer);
+}
+
+int image_run(const char *path, const char *entry, FILE *info_output) {
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        perror(path);
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+    void *mapped = st.st_size > 0 ? mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        fprintf(stderr, "Error: No se pudo mapear la imagen '%s'.\n", path);
+        return 1;
+    }
+
+    ImageReader r = { .data = mapped, .size = (size_t)st.st_size, .pos = 0, .path = path };
+    if (r.size < 8 || memcmp(take(&r, 8), IMAGE_MAGIC, 8) != 0) {
+        fprintf(stderr, "Error: '%s' no es una imagen del intérprete.\n", path);
+        munmap(mapped, r.size);
+        return 1;
+    }
+    uint32_t version = get_u32(&r);
+    uint32_t byte_order = get_u32(&r);
+    if (version != IMAGE_VERSION || byte_order != IMAGE_BYTE_ORDER_MARK) {
+        fprintf(stderr, "Error: La imagen '%s' es de otra versión o de otra arquitectura.\n", path);
+        munmap(mapped, r.size);
+        return 1;
+    }
+    uint32_t classes = get_u32(&r);
+    uint32_t cell_count = get_u32(&r);
+
+    // Las clases quedan en una lista de ClassNode: la misma forma que un programa parseado
+    StatementListNode *root = NULL;
+    for (uint32_t i = 0; i < classes; i++) {
+        char *name = get_name(&r);
+        if (!name) corrupt(&r);
+        root = append_to_statement_list(root, create_class_node(name, get_statement_list(&r)));
+    }
+    register_classes_from_ast((AstNode*)root);
+
+    if (cell_count > r.size) corrupt(&r); // Cada celda ocupa al menos un byte
+    RestoredCell *cells = calloc(cell_count ? cell_count : 1, sizeof(RestoredCell));
+    for (uint32_t i = 0; i < cell_count; i++) restore_cell_shell(&r, &cells[i]);
+    size_t globals = r.pos;
+    for (uint32_t i = 0; i < cell_count; i++) restore_cell_body(&r, &cells[i], cells, cell_count);
+
+    SymbolTable global_scope;
+    init_symbol_table(&global_scope);
+    r.pos = globals;
+    get_entries(&r, &global_scope, cells, cell_count);
+    free(cells);
+    munmap(mapped, r.size);
+
+    const char *feature_name = entry ? entry : IMAGE_DEFAULT_ENTRY;
+    ClassDefinition *main_class = find_class("MAIN");
+    FeatureBodyNode *feature = main_class ? find_feature(main_class->feature_list, feature_name) : NULL;
+    int status = 1;
+    if (feature) {
+        status = run_in_scope((AstNode*)feature, &global_scope, info_output);
+    } else {
+        fprintf(stderr, "Error: La imagen no tiene la feature MAIN.%s.\n", feature_name);
+    }
+    free_ast((AstNode*)root);
+    return status;
+}
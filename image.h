@@ -0,0 +1,39 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include <stdio.h>
+#include "interpreter.h"
+
+/* Comentario general:
+   - Imagen del heap: guarda en un archivo las clases registradas (su AST) y los objetos, ARRAY y
+     valores alcanzables desde el scope global, tal como quedan después de MAIN.make.
+   - Una ejecución posterior mapea la imagen (mmap), reconstruye clases y heap y ejecuta otra
+     feature de MAIN sobre ese estado: no se parsea el programa ni se repite la inicialización.
+   - La imagen es relocalizable: no guarda punteros. Las referencias son índices de celda (objeto
+     o ARRAY) y los strings van con su largo, así que los objetos compartidos y los ciclos se
+     conservan.
+   - Formato (enteros en el orden de bytes de la máquina, verificado al cargar):
+       cabecera: magia, versión, marca de orden de bytes, cantidad de clases y de celdas
+       clases:   nombre y AST de las features
+       celdas:   tipo, clase o tipo de ARRAY, largo del cuerpo y cuerpo (entradas o elementos)
+       globales: entradas del scope global (nombre, tipo declarado y valor)
+   - Los nodos del AST se escriben en preorden; un nodo nuevo en ast.h necesita su caso acá.
+   - Los resultados de las rutinas once no se guardan: después de restaurar, cada once corre de
+     nuevo la primera vez que se llama.
+*/
+
+#define IMAGE_DEFAULT_ENTRY "resume"
+
+// Pide que run_program guarde la imagen en path al terminar MAIN.make sin errores
+void image_request_save(const char *path);
+
+// Devuelve 1 si se pidió guardar una imagen (el enlace conserva entonces todas las rutinas de MAIN)
+int image_save_pending(void);
+
+// Si se pidió, guarda las clases y el heap alcanzable desde global_scope. Devuelve 0 si salió bien
+int image_save_requested(SymbolTable *global_scope);
+
+// Restaura la imagen y ejecuta MAIN.<entry> (IMAGE_DEFAULT_ENTRY si es NULL); el estado final va a info_output
+int image_run(const char *path, const char *entry, FILE *info_output);
+
+#endif // IMAGE_H
@@ -0,0 +1,243 @@
+#include <string.h>
+#include "ast.h"
+#include "interpreter.h"
+#include "inline.h"
+#include "frontend.h"
+#include "memstats.h"
+
+/* Comentario general:
+   - Decide qué rutinas se ejecutan en línea y arma su cuerpo empalmado (ver inline.h). La
+     ejecución está en interpreter.c (run_inline y las llamadas enlazadas): el mismo eval_ast sobre
+     los nodos empalmados, con los lugares del frame en vez de un scope.
+   - Lo llama el enlace con las clases que quedan, después de podarlas.
+   - Los nombres se resuelven en el orden en que corren las sentencias, como los resolvería el
+     scope de método: en "x := x + 1" con x atributo, la x de la derecha es el atributo y la de la
+     izquierda una variable nueva del cuerpo. Una variable asignada en una sola rama de un if y
+     leída después puede ser cualquiera de las dos cosas: esa rutina no se empalma.
+*/
+
+typedef enum {
+    LOCAL_UNSET, // Todavía no se asignó: el nombre es el atributo (si existe)
+    LOCAL_SET,
+    LOCAL_MAYBE  // Asignada en una sola rama de un if
+} LocalState;
+
+typedef struct {
+    ClassDefinition *class_def;
+    FeatureBodyNode *routine;
+    int nodes;
+    int failed;
+    int slot_count;                       // Argumentos y 'Result' primero; después, las variables
+    const char *locals[INLINE_MAX_NODES]; // Variables del cuerpo (cada una nace en una asignación)
+    int local_slots[INLINE_MAX_NODES];
+    LocalState states[INLINE_MAX_NODES];
+    int local_count;
+} Splicer;
+
+static AstNode* fail(Splicer *s) {
+    s->failed = 1;
+    return NULL;
+}
+
+static int declared_index(DeclarationListNode *decls, const char *name) {
+    for (int i = 0; decls && i < decls->count; i++) {
+        if (strcmp(decls->items[i].variable_name, name) == 0) return i;
+    }
+    return -1;
+}
+
+static int local_index(Splicer *s, const char *name) {
+    for (int i = 0; i < s->local_count; i++) {
+        if (strcmp(s->locals[i], name) == 0) return i;
+    }
+    return -1;
+}
+
+static int param_count(Splicer *s) {
+    return s->routine->parameters ? s->routine->parameters->count : 0;
+}
+
+// Lugar de un argumento o de 'Result'; -1 si name no es ninguno de los dos
+static int fixed_slot(Splicer *s, const char *name) {
+    int slot = declared_index(s->routine->parameters, name);
+    if (slot >= 0) return slot;
+    if (s->routine->result_type && strcmp(name, "Result") == 0) return param_count(s);
+    return -1;
+}
+
+// Atributo de Current por su lugar en el prototipo; una rutina sería una llamada
+static AstNode* splice_field(Splicer *s, const char *name) {
+    ClassDefinition *class_def = s->class_def;
+    if (find_feature(class_def->feature_list, name)) return fail(s);
+    for (int i = 0; i < class_def->prototype_count; i++) {
+        if (strcmp(class_def->prototype[i].name, name) == 0) {
+            return create_inline_field_node(class_def->prototype[i].name, i);
+        }
+    }
+    return fail(s);
+}
+
+// Un nombre leído: Current, argumento, 'Result', variable ya asignada o atributo
+static AstNode* splice_name(Splicer *s, const char *name) {
+    if (strcmp(name, "Current") == 0) return create_inline_field_node(NULL, -1);
+    int slot = fixed_slot(s, name);
+    if (slot >= 0) return create_inline_slot_node(slot);
+    int local = local_index(s, name);
+    if (local >= 0 && s->states[local] == LOCAL_SET) return create_inline_slot_node(s->local_slots[local]);
+    if (local >= 0 && s->states[local] == LOCAL_MAYBE) return fail(s);
+    return splice_field(s, name);
+}
+
+// Destino de name := e: el argumento o 'Result', o una variable del cuerpo (set_symbol la crea)
+static AstNode* splice_target(Splicer *s, const char *name) {
+    if (strcmp(name, "Current") == 0) return fail(s);
+    int slot = fixed_slot(s, name);
+    if (slot >= 0) return create_inline_slot_node(slot);
+    int local = local_index(s, name);
+    if (local < 0) {
+        local = s->local_count++;
+        s->locals[local] = name;
+        s->local_slots[local] = s->slot_count++;
+    }
+    s->states[local] = LOCAL_SET;
+    return create_inline_slot_node(s->local_slots[local]);
+}
+
+static AstNode* splice_node(Splicer *s, AstNode *node);
+
+static StatementListNode* splice_statements(Splicer *s, StatementListNode *list) {
+    StatementListNode *spliced = NULL;
+    if (list && ++s->nodes > INLINE_MAX_NODES) fail(s);
+    for (int i = 0; list && i < list->count && !s->failed; i++) {
+        spliced = append_to_statement_list(spliced, splice_node(s, list->statements[i]));
+    }
+    return spliced;
+}
+
+static AstNode* splice_assign(Splicer *s, AssignNode *n) {
+    AstNode *expression = splice_node(s, n->expression); // Se evalúa antes de asignar
+    AstNode *target = NULL;
+    if (n->target->type == NODE_TYPE_VARIABLE) {
+        target = splice_target(s, ((VariableNode *)n->target)->name);
+    } else if (n->target->type == NODE_TYPE_ATTRIBUTE_ACCESS) {
+        // obj.a := e escribe el atributo sin llamar a nada; obj tiene que ser una variable
+        AttributeAccessNode *access = (AttributeAccessNode *)n->target;
+        if (access->object_node->type != NODE_TYPE_VARIABLE) {
+            fail(s);
+        } else if (strcmp(((VariableNode *)access->object_node)->name, "Current") == 0) {
+            target = splice_field(s, access->attribute_name);
+        } else {
+            AstNode *object = splice_name(s, ((VariableNode *)access->object_node)->name);
+            target = create_attribute_access_node(object, access->attribute_name);
+        }
+    } else {
+        fail(s);
+    }
+    return create_assign_node(target, expression);
+}
+
+static AstNode* splice_if(Splicer *s, IfNode *n) {
+    AstNode *condition = splice_node(s, n->condition);
+    LocalState before[INLINE_MAX_NODES], after_then[INLINE_MAX_NODES];
+    memcpy(before, s->states, sizeof(before));
+    StatementListNode *then_branch = splice_statements(s, n->then_branch);
+    int then_count = s->local_count;
+    memcpy(after_then, s->states, sizeof(after_then));
+    // El else parte de lo que había antes del if: las variables que nacieron en el then, sin asignar
+    memcpy(s->states, before, sizeof(before));
+    StatementListNode *else_branch = splice_statements(s, n->else_branch);
+    for (int i = 0; i < s->local_count; i++) {
+        LocalState then_state = i < then_count ? after_then[i] : LOCAL_UNSET; // Nació en el else
+        if (then_state != s->states[i]) s->states[i] = LOCAL_MAYBE;
+    }
+    return create_if_node(condition, then_branch, else_branch);
+}
+
+static AstNode* splice_node(Splicer *s, AstNode *node) {
+    if (!node || s->failed) return NULL;
+    if (++s->nodes > INLINE_MAX_NODES) return fail(s);
+    switch (node->type) {
+        case NODE_TYPE_LITERAL: {
+            LiteralNode *n = (LiteralNode *)node;
+            switch (n->literal_type) {
+                case LITERAL_TYPE_INT: return create_int_literal_node(n->value.int_val);
+                case LITERAL_TYPE_REAL: return create_real_literal_node(n->value.real_val);
+                case LITERAL_TYPE_BOOLEAN: return create_boolean_literal_node(n->value.int_val);
+                default: return create_string_literal_node(mem_strdup(MEM_STRING, n->value.string_val));
+            }
+        }
+        case NODE_TYPE_BINARY_EXPR: {
+            BinaryExprNode *n = (BinaryExprNode *)node;
+            AstNode *left = splice_node(s, n->left);
+            return create_binary_expr_node(n->op, left, splice_node(s, n->right));
+        }
+        case NODE_TYPE_COMPARISON_EXPR: {
+            ComparisonExprNode *n = (ComparisonExprNode *)node;
+            AstNode *left = splice_node(s, n->left);
+            return create_comparison_expr_node(n->op, left, splice_node(s, n->right));
+        }
+        case NODE_TYPE_BOOLEAN_EXPR: {
+            BooleanExprNode *n = (BooleanExprNode *)node;
+            AstNode *left = splice_node(s, n->left);
+            return create_boolean_expr_node(n->op, left, splice_node(s, n->right));
+        }
+        case NODE_TYPE_STATEMENT_LIST:
+            return (AstNode *)splice_statements(s, (StatementListNode *)node);
+        case NODE_TYPE_IF:
+            return splice_if(s, (IfNode *)node);
+        case NODE_TYPE_VARIABLE:
+            return splice_name(s, ((VariableNode *)node)->name);
+        case NODE_TYPE_ATTRIBUTE_ACCESS: {
+            // Solo Current.a con a atributo de la clase: otro objeto podría tener una rutina 'a'
+            AttributeAccessNode *n = (AttributeAccessNode *)node;
+            if (n->object_node->type != NODE_TYPE_VARIABLE
+                || strcmp(((VariableNode *)n->object_node)->name, "Current") != 0) return fail(s);
+            return splice_field(s, n->attribute_name);
+        }
+        case NODE_TYPE_ASSIGN:
+            return splice_assign(s, (AssignNode *)node);
+        default:
+            return fail(s); // Llamadas, create, loops, across...
+    }
+}
+
+// Cuerpo empalmado de la rutina, o NULL si no se puede ejecutar en línea
+static AstNode* splice_routine(ClassDefinition *class_def, FeatureBodyNode *routine, int *slot_count) {
+    if (routine->routine_kind != ROUTINE_DO || FEATURE_BODY_PENDING(routine)) return NULL;
+    if (routine->declarations && routine->declarations->count > 0) return NULL;
+    DeclarationListNode *params = routine->parameters;
+    for (int i = 0; params && i < params->count; i++) {
+        // Con un nombre repetido, el scope de método usaría solo el primero
+        const char *name = params->items[i].variable_name;
+        if (strcmp(name, "Result") == 0 || strcmp(name, "Current") == 0) return NULL;
+        if (declared_index(params, name) != i) return NULL;
+    }
+    Splicer s = { .class_def = class_def, .routine = routine };
+    s.slot_count = (params ? params->count : 0) + (routine->result_type ? 1 : 0);
+    StatementListNode *body = splice_statements(&s, routine->statements);
+    if (s.failed) {
+        free_ast((AstNode *)body);
+        return NULL;
+    }
+    if (!body) {
+        // Cuerpo vacío: una lista sin sentencias (NULL quiere decir "no se empalma")
+        body = create_statement_list_node(NULL);
+        body->count = 0;
+    }
+    *slot_count = s.slot_count;
+    return (AstNode *)body;
+}
+
+int inline_mark_class(ClassDefinition *class_def) {
+    int marked = 0;
+    StatementListNode *features = class_def->feature_list;
+    for (int i = 0; features && i < features->count; i++) {
+        if (features->statements[i]->type != NODE_TYPE_FEATURE_BODY) continue;
+        FeatureBodyNode *routine = (FeatureBodyNode *)features->statements[i];
+        free_ast(routine->inline_body);
+        routine->inline_slots = 0;
+        routine->inline_body = splice_routine(class_def, routine, &routine->inline_slots);
+        marked += routine->inline_body != NULL;
+    }
+    return marked;
+}
@@ -0,0 +1,29 @@
+#ifndef INLINE_H
+#define INLINE_H
+
+#include "interpreter.h"
+
+/* Comentario general:
+   - Inlining de rutinas chicas: el enlace (link.h) arma para cada rutina 'do' chica un cuerpo
+     empalmado (FeatureBodyNode.inline_body), una copia del cuerpo con los nombres ya resueltos:
+     argumentos, 'Result' y variables del cuerpo son lugares de un frame en la pila del que llama
+     (NODE_TYPE_INLINE_SLOT) y los atributos se leen por su lugar en el objeto (NODE_TYPE_INLINE_FIELD).
+   - Una llamada enlazada (bound_class/bound_feature) corre el cuerpo empalmado ahí mismo si el objeto
+     es de bound_class (la guarda, una comparación): sin resolve_feature, sin invoke_method y sin
+     scope de método; tampoco pasa por el meter, el chequeo de pila ni el análisis de escape. Si la
+     guarda falla, o la llamada no está enlazada, se resuelve como siempre y run_inline usa el mismo
+     cuerpo empalmado.
+   - Una rutina es chica si no tiene locales, su cuerpo tiene a lo sumo INLINE_MAX_NODES nodos y
+     solo usa literales, operaciones, comparaciones, if y asignaciones. Cada nombre que lee tiene
+     que ser un argumento, 'Result', 'Current', un atributo de la clase o una variable que el cuerpo
+     ya asignó, y nunca una rutina: así el cuerpo no llama a nada y no puede ser recursivo.
+   - El cuerpo hace lo mismo que en una llamada normal (x := e crea una variable del cuerpo,
+     Current.x := e escribe el atributo), así que los resultados no cambian.
+*/
+
+#define INLINE_MAX_NODES 24
+
+// Arma el cuerpo empalmado de las rutinas en línea de la clase; devuelve cuántas son
+int inline_mark_class(ClassDefinition *class_def);
+
+#endif // INLINE_H
@@ -0,0 +1,97 @@
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "memstats.h"
+#include "intern.h"
+
+/* Comentario general:
+   - Cada parte es una tabla hash con direccionamiento abierto que guarda el hash junto al nombre:
+     al buscar solo se compara el texto si el hash coincide.
+   - La parte se elige con los bits altos del hash y la posición dentro de ella con los bajos, así
+     que las dos elecciones no se correlacionan.
+   - Los locks se toman solo para buscar/agregar: un nombre ya devuelto no se mueve al crecer la
+     tabla (se mueven las entradas, no los strings).
+*/
+
+typedef struct {
+    size_t hash;
+    char *text;
+} InternEntry;
+
+typedef struct {
+    pthread_mutex_t lock;
+    InternEntry *slots;
+    size_t slot_count;
+    size_t count;
+} InternShard;
+
+static InternShard shards[INTERN_SHARDS];
+static pthread_once_t shards_once = PTHREAD_ONCE_INIT;
+
+static void init_shards(void) {
+    for (int i = 0; i < INTERN_SHARDS; i++) pthread_mutex_init(&shards[i].lock, NULL);
+}
+
+static size_t name_hash(const char *text, size_t length) {
+    size_t hash = 2166136261u; // FNV-1a
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)text[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void put_entry(InternEntry *slots, size_t slot_count, InternEntry entry) {
+    size_t mask = slot_count - 1;
+    size_t i = entry.hash & mask;
+    while (slots[i].text) i = (i + 1) & mask;
+    slots[i] = entry;
+}
+
+static void grow_shard(InternShard *shard) {
+    size_t new_count = shard->slot_count ? shard->slot_count * 2 : 256;
+    InternEntry *new_slots = calloc(new_count, sizeof(InternEntry));
+    for (size_t i = 0; i < shard->slot_count; i++) {
+        if (shard->slots[i].text) put_entry(new_slots, new_count, shard->slots[i]);
+    }
+    free(shard->slots);
+    shard->slots = new_slots;
+    shard->slot_count = new_count;
+}
+
+char* intern(const char *text, size_t length) {
+    pthread_once(&shards_once, init_shards);
+    size_t hash = name_hash(text, length);
+    InternShard *shard = &shards[(hash >> 24) % INTERN_SHARDS];
+
+    pthread_mutex_lock(&shard->lock);
+    if ((shard->count + 1) * 2 > shard->slot_count) grow_shard(shard);
+    size_t mask = shard->slot_count - 1;
+    size_t i = hash & mask;
+    for (; shard->slots[i].text; i = (i + 1) & mask) {
+        InternEntry *entry = &shard->slots[i];
+        if (entry->hash == hash && strncmp(entry->text, text, length) == 0 && entry->text[length] == '\0') {
+            pthread_mutex_unlock(&shard->lock);
+            return entry->text;
+        }
+    }
+    char *copy = mem_strndup(MEM_IDENTIFIER, text, length);
+    shard->slots[i].hash = hash;
+    shard->slots[i].text = copy;
+    shard->count++;
+    pthread_mutex_unlock(&shard->lock);
+    return copy;
+}
+
+char* intern_string(const char *text) {
+    return intern(text, strlen(text));
+}
+
+void intern_free(void) {
+    for (int s = 0; s < INTERN_SHARDS; s++) {
+        InternShard *shard = &shards[s];
+        for (size_t i = 0; i < shard->slot_count; i++) mem_free(MEM_IDENTIFIER, shard->slots[i].text);
+        free(shard->slots);
+        shard->slots = NULL;
+        shard->slot_count = shard->count = 0;
+    }
+}
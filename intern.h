@@ -0,0 +1,26 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+
+/* Comentario general:
+   - Tabla de identificadores internados: cada nombre (identificador o tipo) se guarda una sola vez
+     y todos los nodos del AST que lo usan apuntan a la misma copia.
+   - Los nombres internados viven hasta intern_free: el AST no es dueño de ellos (free_ast no los
+     libera) y nunca se modifican.
+   - La comparten los hilos que parsean en paralelo (ver frontend.h): está partida en
+     INTERN_SHARDS tablas hash, cada una con su mutex, elegidas por el hash del nombre.
+*/
+
+#define INTERN_SHARDS 16
+
+// Devuelve la copia internada de los length bytes de text (se agrega si no estaba)
+char* intern(const char *text, size_t length);
+
+// Igual que intern, con un string terminado en '\0'
+char* intern_string(const char *text);
+
+// Libera todos los nombres internados (al terminar el programa)
+void intern_free(void);
+
+#endif // INTERN_H
@@ -1,9 +1,26 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 #include "interpreter.h"
 #include "ast.h"
 #include "parser.tab.h"
+#include "output.h"
+#include "array.h"
+#include "eiffel_string.h"
+#include "parallel.h"
+#include "threadpool.h"
+#include "classpath.h"
+#include "escape.h"
+#include "memstats.h"
+#include "meter.h"
+#include "image.h"
+#include "eiffel_io.h"
+#include "link.h"
+#include "intern.h"
+#include "heapdump.h"
+#include "scoop.h"
+#include "frontend.h"
 
 /* Comentario general:
    - Este archivo implementa la ejecución del AST.
@@ -12,8 +29,24 @@
 */
 
 // --- Tabla Global de Clases ---
-ClassDefinition class_table[MAX_CLASSES];
+ClassDefinition **class_table = NULL; // En orden de registro; cada definición tiene dirección fija
 int class_count = 0;
+static int class_capacity = 0;
+
+// Índice por nombre: direccionamiento abierto, potencia de 2, a lo sumo medio lleno
+static ClassDefinition **class_slots = NULL;
+static size_t class_slot_count = 0;
+
+// --- Recuperación de errores en tiempo de ejecución ---
+_Thread_local jmp_buf *runtime_error_handler = NULL;
+
+void runtime_abort(void) {
+    output_flush();
+    if (runtime_error_handler) {
+        longjmp(*runtime_error_handler, 1);
+    }
+    exit(1);
+}
 
 /* --- Funciones para la Tabla de Símbolos ---
    - init_symbol_table: inicializa una tabla (uso para scopes y objetos).
@@ -23,8 +56,13 @@ int class_count = 0;
 
 void init_symbol_table(SymbolTable *table) {
     table->count = 0;
+    table->shared_entries = 0;
     table->parent = NULL;
     table->owner_class_name = NULL;
+    table->frame_objects = NULL;
+    table->once_results = NULL;
+    table->once_count = 0;
+    table->processor = NULL;
 }
 
 SymbolTableEntry* find_symbol_entry(SymbolTable *table, const char *name) {
@@ -36,39 +74,46 @@ SymbolTableEntry* find_symbol_entry(SymbolTable *table, const char *name) {
     return NULL;
 }
 
-void set_symbol(SymbolTable *table, const char *name, RuntimeValue value) {
-    SymbolTableEntry* entry = find_symbol_entry(table, name);
-    if (entry) {
-        char* old_string_ptr = NULL;
-        // Guardar el puntero del string antiguo si existe
-        if (entry->value.type == VAL_TYPE_STRING && entry->value.as.string_val) {
-            old_string_ptr = entry->value.as.string_val;
-        }
+// Guarda value en *slot (una variable o un lugar de un cuerpo empalmado) y libera el string que tenía
+static void replace_value(RuntimeValue *slot, RuntimeValue value) {
+    char* old_string_ptr = NULL;
+    // Guardar el puntero del string antiguo si existe
+    if (slot->type == VAL_TYPE_STRING && slot->as.string_val) {
+        old_string_ptr = slot->as.string_val;
+    }
 
-        // Actualizar el valor en la tabla de símbolos
-        entry->value = value;
+    // Actualizar el valor
+    *slot = value;
 
-        // Si había un string antiguo, y es diferente del nuevo, liberarlo.
-        if (old_string_ptr) {
-            char* new_string_ptr = (value.type == VAL_TYPE_STRING) ? value.as.string_val : NULL;
-            if (old_string_ptr != new_string_ptr) {
-                free(old_string_ptr);
-            }
+    // Si había un string antiguo, y es diferente del nuevo, liberarlo.
+    if (old_string_ptr) {
+        char* new_string_ptr = (value.type == VAL_TYPE_STRING) ? value.as.string_val : NULL;
+        if (old_string_ptr != new_string_ptr) {
+            mem_free(MEM_STRING, old_string_ptr);
         }
+    }
+}
+
+void set_symbol(SymbolTable *table, const char *name, RuntimeValue value) {
+    SymbolTableEntry* entry = find_symbol_entry(table, name);
+    if (entry) {
+        if (scoop_pending_count) scoop_forget_entry(entry); // Pisa un resultado separate que nadie leyó
+        replace_value(&entry->value, value);
     } else {
         if (table->count < MAX_SYMBOLS) {
-            table->entries[table->count].name = strdup(name);
+            table->entries[table->count].name = mem_strdup(MEM_IDENTIFIER, name);
             table->entries[table->count].value = value;
             table->entries[table->count].type_name = NULL;
             table->count++;
         } else {
             fprintf(stderr, "Error: Tabla de símbolos llena.\n");
-            exit(1);
+            runtime_abort();
         }
     }
 }
 
-RuntimeValue get_symbol(SymbolTable *table, const char *name) {
+// Como get_symbol, pero sin error: devuelve 0 si el nombre no está definido en ningún scope
+static int lookup_symbol(SymbolTable *table, const char *name, RuntimeValue *value) {
     // Caso especial para 'Current'
     if (strcmp(name, "Current") == 0) {
         SymbolTable* current_table = table;
@@ -76,81 +121,479 @@ RuntimeValue get_symbol(SymbolTable *table, const char *name) {
             current_table = current_table->parent;
         }
         if (current_table) {
-            RuntimeValue obj_val;
-            obj_val.type = VAL_TYPE_OBJECT;
-            obj_val.as.object_val = current_table;
-            return obj_val;
+            value->type = VAL_TYPE_OBJECT;
+            value->as.object_val = current_table;
+            return 1;
         }
     }
 
-    SymbolTableEntry* entry = find_symbol_entry(table, name);
-    if (entry) {
-        return entry->value;
+    for (SymbolTable* scope = table; scope; scope = scope->parent) {
+        SymbolTableEntry* entry = find_symbol_entry(scope, name);
+        if (entry) {
+            if (scoop_pending_count) scoop_resolve_entry(entry); // Espera por necesidad (ver scoop.h)
+            *value = entry->value;
+            return 1;
+        }
     }
-    if (table->parent) {
-        return get_symbol(table->parent, name);
+    return 0;
+}
+
+RuntimeValue get_symbol(SymbolTable *table, const char *name) {
+    RuntimeValue value;
+    if (lookup_symbol(table, name, &value)) {
+        return value;
     }
 
     fprintf(stderr, "Error: Variable '%s' no definida.\n", name);
-    exit(1);
+    runtime_abort();
+    return (RuntimeValue){ .type = VAL_TYPE_VOID };
 }
 
 void declare_symbol(SymbolTable *table, const char *name, const char *type_name) {
     SymbolTableEntry* existing = find_symbol_entry(table, name);
     if (existing) {
         // Si ya existe, no re-declarar; pero si no tiene type_name y se provee, asignarlo.
-        if (!existing->type_name && type_name) existing->type_name = strdup(type_name);
+        if (!existing->type_name && type_name) existing->type_name = mem_strdup(MEM_IDENTIFIER, type_name);
         return;
     }
     if (table->count < MAX_SYMBOLS) {
         RuntimeValue null_val = { .type = VAL_TYPE_NULL };
-        table->entries[table->count].name = strdup(name);
+        table->entries[table->count].name = mem_strdup(MEM_IDENTIFIER, name);
         table->entries[table->count].value = null_val;
-        table->entries[table->count].type_name = type_name ? strdup(type_name) : NULL;
+        table->entries[table->count].type_name = type_name ? mem_strdup(MEM_IDENTIFIER, type_name) : NULL;
         table->count++;
     }
 }
 
 // --- Funciones de Gestión de Clases ---
+static size_t class_name_hash(const char* name) {
+    size_t hash = 2166136261u; // FNV-1a
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash;
+}
+
+static void index_class(ClassDefinition* def) {
+    size_t mask = class_slot_count - 1;
+    size_t i = class_name_hash(def->name) & mask;
+    while (class_slots[i]) i = (i + 1) & mask;
+    class_slots[i] = def;
+}
+
+// Busca solo entre las clases ya registradas (sin cargar nada del class path)
+static ClassDefinition* lookup_class(const char* name) {
+    if (class_slot_count == 0) return NULL;
+    size_t mask = class_slot_count - 1;
+    for (size_t i = class_name_hash(name) & mask; class_slots[i]; i = (i + 1) & mask) {
+        if (strcmp(class_slots[i]->name, name) == 0) return class_slots[i];
+    }
+    return NULL;
+}
+
+/* default_value: valor inicial de un atributo o de 'Result' según su tipo declarado
+   (INTEGER -> 0, REAL -> 0.0, STRING -> "" nuevo, BOOLEAN -> False; el resto, referencias, VAL_TYPE_NULL). */
+static RuntimeValue default_value(const char* type_name) {
+    RuntimeValue value = { .type = VAL_TYPE_NULL };
+    if (!type_name) return value;
+    if (strcmp(type_name, "INTEGER") == 0) {
+        value.type = VAL_TYPE_INT;
+        value.as.int_val = 0;
+    } else if (strcmp(type_name, "REAL") == 0) {
+        value.type = VAL_TYPE_REAL;
+        value.as.real_val = 0.0;
+    } else if (strcmp(type_name, "STRING") == 0) {
+        value.type = VAL_TYPE_STRING;
+        value.as.string_val = mem_strdup(MEM_STRING, "");
+    } else if (strcmp(type_name, "BOOLEAN") == 0) {
+        value.type = VAL_TYPE_BOOLEAN;
+        value.as.int_val = 0;
+    }
+    return value;
+}
+
+/* number_once_features: numera las rutinas once de la clase (once_index) y deja sus resultados
+   vacíos. Se repite al redefinir la clase: los resultados anteriores se descartan. */
+static void number_once_features(ClassDefinition* def) {
+    int count = 0;
+    StatementListNode* features = def->feature_list;
+    for (int i = 0; features && i < features->count; i++) {
+        if (features->statements[i]->type != NODE_TYPE_FEATURE_BODY) continue;
+        FeatureBodyNode* f = (FeatureBodyNode*)features->statements[i];
+        f->once_index = f->routine_kind == ROUTINE_DO ? -1 : count++;
+    }
+    free(def->once_results);
+    def->once_results = count ? calloc(count, sizeof(OnceResult)) : NULL;
+    def->once_count = count;
+}
+
+/* build_prototype: arma los atributos de la clase con su valor por defecto (ver default_value),
+   en el orden de declaración y sin repetidos. Se repite al redefinir la clase.
+   - Nombres y tipos son los del AST (internados): los objetos los comparten sin copiarlos.
+   - Un STRING queda con string_val NULL: instantiate_prototype le da a cada objeto su "" propio.
+*/
+static void build_prototype(ClassDefinition* def) {
+    free(def->prototype);
+    def->prototype = NULL;
+    def->prototype_count = 0;
+    StatementListNode* features = def->feature_list;
+    int capacity = 0;
+    for (int f = 0; features && f < features->count; f++) {
+        if (features->statements[f]->type == NODE_TYPE_DECLARATION_LIST) {
+            capacity += ((DeclarationListNode*)features->statements[f])->count;
+        }
+    }
+    if (capacity > MAX_SYMBOLS) capacity = MAX_SYMBOLS; // Como declare_symbol: el resto no entra en la tabla
+    if (capacity == 0) return;
+    def->prototype = malloc(capacity * sizeof(SymbolTableEntry));
+    for (int f = 0; f < features->count; f++) {
+        if (features->statements[f]->type != NODE_TYPE_DECLARATION_LIST) continue;
+        DeclarationListNode* decls = (DeclarationListNode*)features->statements[f];
+        for (int d = 0; d < decls->count && def->prototype_count < capacity; d++) {
+            Declaration* decl = &decls->items[d];
+            int repeated = 0;
+            for (int i = 0; i < def->prototype_count && !repeated; i++) {
+                repeated = strcmp(def->prototype[i].name, decl->variable_name) == 0;
+            }
+            if (repeated) continue;
+            SymbolTableEntry* entry = &def->prototype[def->prototype_count++];
+            entry->name = decl->variable_name;
+            entry->type_name = decl->type_name;
+            entry->value = (RuntimeValue){ .type = VAL_TYPE_NULL };
+            if (decl->type_name && strcmp(decl->type_name, "STRING") == 0) {
+                entry->value.type = VAL_TYPE_STRING;
+                entry->value.as.string_val = NULL;
+            } else if (decl->type_name) {
+                entry->value = default_value(decl->type_name);
+            }
+        }
+    }
+}
+
 void register_class(const char* name, StatementListNode* features) {
-    if (find_class(name) != NULL) return;
-    if (class_count < MAX_CLASSES) {
-        class_table[class_count].name = strdup(name);
-        class_table[class_count].feature_list = features;
-        class_count++;
+    if (lookup_class(name) != NULL) return;
+    if (class_count == class_capacity) {
+        class_capacity = class_capacity ? class_capacity * 2 : 16;
+        class_table = realloc(class_table, class_capacity * sizeof(ClassDefinition*));
+    }
+    ClassDefinition* def = malloc(sizeof(ClassDefinition));
+    def->name = intern_string(name);
+    def->feature_list = features;
+    def->once_results = NULL;
+    def->prototype = NULL;
+    def->slabs = NULL;
+    number_once_features(def);
+    build_prototype(def);
+    class_table[class_count++] = def;
+
+    if ((size_t)class_count * 2 > class_slot_count) {
+        free(class_slots);
+        class_slot_count = class_slot_count ? class_slot_count * 2 : 32;
+        class_slots = calloc(class_slot_count, sizeof(ClassDefinition*));
+        for (int i = 0; i < class_count; i++) index_class(class_table[i]);
     } else {
-        fprintf(stderr, "Error: Demasiadas clases definidas.\n");
-        exit(1);
+        index_class(def);
     }
 }
 
-ClassDefinition* find_class(const char* name) {
+/* retain_classes: deja registradas solo las clases con keep[i] != 0 (i: índice en class_table) y
+   libera las demás definiciones. Lo usa el enlace (link.h) antes de ejecutar. */
+void retain_classes(const unsigned char* keep) {
+    int kept = 0;
     for (int i = 0; i < class_count; i++) {
-        if (strcmp(class_table[i].name, name) == 0) {
-            return &class_table[i];
+        if (keep[i]) {
+            class_table[kept++] = class_table[i];
+        } else {
+            // Todavía no hay objetos: el pool de la clase está vacío
+            free(class_table[i]->once_results);
+            free(class_table[i]->prototype);
+            free(class_table[i]);
+        }
+    }
+    class_count = kept;
+    memset(class_slots, 0, class_slot_count * sizeof(ClassDefinition*));
+    for (int i = 0; i < class_count; i++) index_class(class_table[i]);
+}
+
+/* redefine_class: como register_class, pero si la clase ya existe reemplaza su lista de features.
+   - Los objetos vivos solo guardan el nombre de su clase, así que pasan a usar la nueva definición.
+*/
+void redefine_class(const char* name, StatementListNode* features) {
+    ClassDefinition* existing = lookup_class(name);
+    if (existing) {
+        existing->feature_list = features;
+        number_once_features(existing);
+        build_prototype(existing);
+        escape_invalidate(); // Los métodos que usan esta clase pueden cambiar de veredicto
+        return;
+    }
+    register_class(name, features);
+}
+
+/* find_class: busca una clase registrada; si no está, la carga del class path (ver classpath.h).
+   - Así solo se parsean los archivos de las clases que el programa realmente usa.
+*/
+// Con objetos separate varios procesadores pueden buscar (y cargar) clases a la vez
+static pthread_mutex_t class_lock = PTHREAD_MUTEX_INITIALIZER;
+
+ClassDefinition* find_class(const char* name) {
+    if (!name) return NULL; // Objeto de una clase desconocida
+    int locked = scoop_started;
+    if (locked) pthread_mutex_lock(&class_lock);
+    ClassDefinition* def = lookup_class(name);
+    if (!def && class_path_load(name)) {
+        def = lookup_class(name);
+    }
+    if (locked) pthread_mutex_unlock(&class_lock);
+    return def;
+}
+
+/* init_object_attributes: declara en la tabla del objeto los atributos de su clase que todavía no tenga,
+   con valor por defecto según el tipo declarado (INTEGER -> 0, REAL -> 0.0, STRING -> "").
+   - Lo usa el REPL al redefinir una clase con objetos vivos ('create' copia el prototipo).
+*/
+void init_object_attributes(SymbolTable* object_table, ClassDefinition* class_def) {
+    StatementListNode* features = class_def->feature_list;
+    for (int f = 0; features && f < features->count; f++) {
+        if (features->statements[f]->type == NODE_TYPE_DECLARATION_LIST) {
+            DeclarationListNode* decls = (DeclarationListNode*)features->statements[f];
+            for (int d = 0; d < decls->count; d++) {
+                Declaration* decl = &decls->items[d];
+                if (find_symbol_entry(object_table, decl->variable_name)) {
+                    // El atributo ya existe (objeto vivo): conservar su valor actual
+                    continue;
+                }
+                // Registrar atributo en la tabla del objeto con su tipo y su valor por defecto
+                // (las referencias a objetos quedan en VAL_TYPE_NULL, como las dejó declare_symbol)
+                declare_symbol(object_table, decl->variable_name, decl->type_name);
+                RuntimeValue init_val = default_value(decl->type_name);
+                if (init_val.type != VAL_TYPE_NULL) set_symbol(object_table, decl->variable_name, init_val);
+            }
+        }
+    }
+}
+
+/* --- Pool de objetos por clase ---
+   - Los objetos del heap viven hasta el final del programa (no hay recolector), así que cada clase
+     los reparte de bloques (slabs) cada vez más grandes: un malloc por bloque y no por objeto.
+   - El across paralelo no acepta create; los procesadores separate sí crean objetos, así que
+     desde el primer objeto separate los slabs se toman con slab_lock.
+   - Los objetos que no escapan de su método no pasan por acá: viven en el frame (ver escape.h).
+*/
+#define OBJECT_SLAB_FIRST 4
+#define OBJECT_SLAB_MAX 128
+
+typedef struct ObjectSlab {
+    struct ObjectSlab* next; // Bloque anterior (lleno)
+    int used;
+    int capacity;
+    SymbolTable objects[];
+} ObjectSlab;
+
+static pthread_mutex_t slab_lock = PTHREAD_MUTEX_INITIALIZER;
+
+SymbolTable* new_object(ClassDefinition* class_def) {
+    if (!class_def) return mem_alloc(MEM_OBJECT, sizeof(SymbolTable));
+    int locked = scoop_started;
+    if (locked) pthread_mutex_lock(&slab_lock);
+    ObjectSlab* slab = class_def->slabs;
+    if (!slab || slab->used == slab->capacity) {
+        int capacity = slab ? slab->capacity * 2 : OBJECT_SLAB_FIRST;
+        if (capacity > OBJECT_SLAB_MAX) capacity = OBJECT_SLAB_MAX;
+        ObjectSlab* fresh = mem_alloc(MEM_OBJECT, sizeof(ObjectSlab) + (size_t)capacity * sizeof(SymbolTable));
+        fresh->next = slab;
+        fresh->used = 0;
+        fresh->capacity = capacity;
+        class_def->slabs = slab = fresh;
+    }
+    SymbolTable* object = &slab->objects[slab->used++];
+    if (locked) pthread_mutex_unlock(&slab_lock);
+    return object;
+}
+
+/* instantiate_prototype: copia de una vez los atributos del prototipo de la clase en un objeto
+   recién inicializado (memcpy de las entradas y un "" nuevo por cada STRING). */
+void instantiate_prototype(SymbolTable* object_table, ClassDefinition* class_def) {
+    int count = class_def->prototype_count;
+    if (count > 0) memcpy(object_table->entries, class_def->prototype, count * sizeof(SymbolTableEntry));
+    for (int i = 0; i < count; i++) {
+        if (object_table->entries[i].value.type == VAL_TYPE_STRING) {
+            object_table->entries[i].value.as.string_val = mem_strdup(MEM_STRING, "");
+        }
+    }
+    object_table->count = object_table->shared_entries = count;
+    object_table->owner_class_name = class_def->name;
+}
+
+/* register_classes_from_ast:
+   - Recorre la lista de sentencias en la raíz y registra las clases encontradas en class_table.
+   - Esto separa la fase de parseo de la de ejecución.
+*/
+void register_classes_from_ast(AstNode* node) {
+    if (!node || node->type != NODE_TYPE_STATEMENT_LIST) {
+        return;
+    }
+    StatementListNode* list = (StatementListNode*)node;
+    for (int i = 0; i < list->count; i++) {
+        if (list->statements[i] && list->statements[i]->type == NODE_TYPE_CLASS_DECL) {
+            ClassNode* class_node = (ClassNode*)list->statements[i];
+            register_class(class_node->name, class_node->features);
+        }
+    }
+}
+
+/* run_in_scope: ejecuta entry (un método de MAIN o un programa sin clases) sobre un scope global ya armado.
+   - Al final escribe el estado de la tabla de símbolos en info_output (el archivo .info).
+   - Si un error corta la ejecución (incluido un límite de meter.h) y nadie más instaló un handler,
+     el .info igual recibe el estado parcial y se devuelve 1.
+   - Si se pidió un snapshot del heap (ver heapdump.h), se escribe en los dos casos.
+*/
+int run_in_scope(AstNode* entry, SymbolTable* global_scope, FILE* info_output) {
+    jmp_buf recover;
+    int own_handler = runtime_error_handler == NULL;
+    if (own_handler) {
+        runtime_error_handler = &recover;
+        if (setjmp(recover) != 0) {
+            runtime_error_handler = NULL;
+            if (info_output) {
+                fprintf(info_output, "--- Ejecución interrumpida: estado parcial ---\n");
+                print_symbol_table(global_scope, info_output);
+                mem_print_summary(info_output);
+                meter_print_summary(info_output);
+            }
+            if (scoop_started) scoop_after_abort();
+            heap_dump_requested(global_scope);
+            return 1;
+        }
+    }
+    meter_start();
+    eval_ast(entry, global_scope);
+    if (scoop_started && scoop_wait_all()) runtime_abort(); // El programa termina cuando terminan los procesadores
+
+    if (own_handler) runtime_error_handler = NULL;
+    if (info_output) {
+        print_symbol_table(global_scope, info_output);
+        mem_print_summary(info_output);
+    }
+    return heap_dump_requested(global_scope);
+}
+
+/* run_program: ejecuta un programa ya parseado sobre un scope global nuevo.
+   - Fase 1: registra todas las clases del AST y las enlaza desde MAIN.make (ver link.h), salvo con
+     cuerpos diferidos (ver frontend.h).
+   - Fase 2: ejecuta MAIN.make si existe; si no, evalúa la raíz (para tests antiguos).
+   - Si se pidió una imagen (ver image.h), la guarda con el estado que dejó MAIN.make.
+*/
+int run_program(AstNode* root, FILE* info_output) {
+    register_classes_from_ast(root);
+
+    SymbolTable global_scope;
+    init_symbol_table(&global_scope);
+
+    ClassDefinition* main_class = find_class("MAIN");
+    FeatureBodyNode* make_method = NULL;
+    if (main_class) {
+        make_method = find_feature(main_class->feature_list, "make");
+    }
+
+    // Con cuerpos diferidos no se enlaza: el enlace recorre (y parsearía) todo lo alcanzable
+    if (main_class && make_method && !parse_lazy_bodies) link_program(image_save_pending(), info_output);
+
+    // Si existe MAIN y make, lo ejecutamos; si no, ejecutamos el AST desde la raíz
+    AstNode* entry = (main_class && make_method) ? (AstNode*)make_method : root;
+    int status = run_in_scope(entry, &global_scope, info_output);
+    if (status == 0) status = image_save_requested(&global_scope);
+    return status;
+}
+
+/* find_feature: busca un método por nombre dentro de la lista de features de una clase */
+FeatureBodyNode* find_feature(StatementListNode* feature_list, const char* feature_name) {
+    if (!feature_list) return NULL;
+    for (int i = 0; i < feature_list->count; i++) {
+        AstNode* stmt = feature_list->statements[i];
+        if (stmt && stmt->type == NODE_TYPE_FEATURE_BODY) {
+            FeatureBodyNode* f_node = (FeatureBodyNode*)stmt;
+            if (f_node->feature_name && strcmp(f_node->feature_name, feature_name) == 0) {
+                return f_node;
+            }
         }
     }
     return NULL;
 }
 
+/* current_object: el objeto sobre el que corre el código de table (el primer scope con clase).
+   MAIN.make corre directamente en el scope global: ahí el objeto es el scope raíz y la clase, MAIN.
+*/
+static SymbolTable* current_object(SymbolTable* table, const char** class_name) {
+    SymbolTable* scope = table;
+    while (scope->parent && !scope->owner_class_name) scope = scope->parent;
+    *class_name = scope->owner_class_name ? scope->owner_class_name : "MAIN";
+    return scope;
+}
+
+FeatureBodyNode* find_current_feature(SymbolTable* table, const char* name) {
+    const char* class_name;
+    current_object(table, &class_name);
+    ClassDefinition* class_def = find_class(class_name);
+    return class_def ? find_feature(class_def->feature_list, name) : NULL;
+}
+
+void load_feature_body(FeatureBodyNode* feature) {
+    if (!FEATURE_BODY_PENDING(feature)) return;
+    if (parse_feature_body(feature) != 0) {
+        fprintf(stderr, "Error: No se pudo parsear el cuerpo de '%s'.\n", feature->feature_name);
+        runtime_abort();
+    }
+}
+
+/* resolve_feature: clase y rutina name (puede ser NULL) de un objeto de la clase class_name. Si
+   link.c enlazó la llamada a esa misma clase se usa el enlace (una comparación); si no, se buscan.
+   Una rutina con el cuerpo diferido se parsea acá, la primera vez que alguien la resuelve. */
+static FeatureBodyNode* resolve_feature(const char* class_name, const char* name, ClassDefinition* bound_class,
+                                        FeatureBodyNode* bound_feature, ClassDefinition** class_def) {
+    if (bound_class && class_name && strcmp(class_name, bound_class->name) == 0) {
+        *class_def = bound_class;
+        if (bound_feature) load_feature_body(bound_feature);
+        return bound_feature;
+    }
+    *class_def = find_class(class_name);
+    FeatureBodyNode* feature = *class_def && name ? find_feature((*class_def)->feature_list, name) : NULL;
+    if (feature) load_feature_body(feature);
+    return feature;
+}
+
 
 /* print_value y fprint_value: utilidades para mostrar valores durante ejecución/debug.
-   - print_symbol_table imprime recursivamente tablas de objetos (útil para el .info final).
+   - print_value escribe en la capa de salida con buffer (output.c), no directamente con printf.
+   - print_symbol_table imprime la tabla y los objetos alcanzables, cada uno una vez (útil para el .info final).
 */
 
 void print_value(RuntimeValue value) {
     switch (value.type) {
         case VAL_TYPE_INT:
-            printf("%d", value.as.int_val);
+            output_int(value.as.int_val);
             break;
         case VAL_TYPE_REAL:
-            printf("%f", value.as.real_val);
+            output_real(value.as.real_val);
             break;
         case VAL_TYPE_STRING:
-            printf("%s", value.as.string_val);
+            output_string(value.as.string_val);
             break;
         case VAL_TYPE_OBJECT:
-            printf("[Object of class %s]", value.as.object_val->owner_class_name ? value.as.object_val->owner_class_name : "Unknown");
+            output_string("[Object of class ");
+            output_string(value.as.object_val->owner_class_name ? value.as.object_val->owner_class_name : "Unknown");
+            output_char(']');
+            break;
+        case VAL_TYPE_ARRAY:
+            output_string("[Object of class ");
+            output_string(value.as.array_val->type_name);
+            output_char(']');
+            break;
+        case VAL_TYPE_FILE:
+            output_string("[Object of class PLAIN_TEXT_FILE]");
+            break;
+        case VAL_TYPE_BOOLEAN:
+            output_string(value.as.int_val ? "True" : "False");
             break;
         case VAL_TYPE_VOID:
         case VAL_TYPE_NULL:
@@ -177,6 +620,18 @@ static void fprint_value(FILE* stream, RuntimeValue value) {
                 fprintf(stream, "[Object NULL]");
             }
             break;
+        case VAL_TYPE_ARRAY:
+            fprintf(stream, "[%s count=%d at %p]", value.as.array_val->type_name, array_count(value.as.array_val), (void*)value.as.array_val);
+            break;
+        case VAL_TYPE_FILE:
+            fprintf(stream, "[PLAIN_TEXT_FILE '%s' %s at %p]", value.as.file_val->name ? value.as.file_val->name : "",
+                    value.as.file_val->mode == FILE_OPEN_READ ? "lectura"
+                        : value.as.file_val->mode == FILE_OPEN_WRITE ? "escritura" : "cerrado",
+                    (void*)value.as.file_val);
+            break;
+        case VAL_TYPE_BOOLEAN:
+            fprintf(stream, "%s", value.as.int_val ? "True" : "False");
+            break;
         case VAL_TYPE_NULL:
             fprintf(stream, "NULL");
             break;
@@ -186,42 +641,669 @@ static void fprint_value(FILE* stream, RuntimeValue value) {
     }
 }
 
-static void print_symbol_table_internal(SymbolTable *table, FILE *output, int indent) {
-    if (!table) return;
-
-    char indent_str[indent + 1];
-    for(int i=0; i<indent; ++i) indent_str[i] = ' ';
-    indent_str[indent] = '\0';
+// Imprime las entradas de table; cada objeto al que apuntan recibe su número en index (#n)
+static void print_table_entries(SymbolTable *table, FILE *output, HeapIndex *index) {
+    for (int i = 0; i < table->count; i++) {
+        SymbolTableEntry *entry = &table->entries[i];
+        fprintf(output, "  - %s (type: %s) = ", entry->name, entry->type_name ? entry->type_name : "any");
+        fprint_value(output, entry->value);
+        if (entry->value.type == VAL_TYPE_OBJECT && entry->value.as.object_val) {
+            fprintf(output, " #%u", heap_index_id(index, entry->value.as.object_val, HEAP_CELL_OBJECT, NULL));
+        }
+        fprintf(output, "\n");
+    }
+}
 
-    fprintf(output, "%sSymbolTable at %p ", indent_str, (void*)table);
+static void print_table_header(SymbolTable *table, FILE *output) {
+    fprintf(output, "SymbolTable at %p ", (void*)table);
     if (table->owner_class_name) {
         fprintf(output, "(Class: %s)\n", table->owner_class_name);
     } else {
         fprintf(output, "(Scope)\n");
     }
+}
 
-    for (int i = 0; i < table->count; i++) {
-        SymbolTableEntry *entry = &table->entries[i];
-        fprintf(output, "%s  - %s (type: %s) = ", indent_str, entry->name, entry->type_name ? entry->type_name : "any");
-        fprint_value(output, entry->value);
-        fprintf(output, "\n");
+/* print_symbol_table: la tabla y después, una sola vez cada uno, los objetos alcanzables desde
+   ella, en el orden en que aparecen (#n). Sin recursión: ciclos y objetos compartidos no se repiten. */
+void print_symbol_table(SymbolTable *table, FILE *output) {
+    fprintf(output, "--- Symbol Table State ---\n");
+    if (table) {
+        HeapIndex index = { 0 };
+        print_table_header(table, output);
+        print_table_entries(table, output, &index);
+        for (unsigned next = 0; next < index.count; next++) {
+            SymbolTable *object = index.cells[next];
+            fprintf(output, "#%u ", next + 1);
+            print_table_header(object, output);
+            print_table_entries(object, output, &index);
+        }
+        heap_index_free(&index);
+    }
+    fprintf(output, "--------------------------\n");
+}
 
-        // Si el valor es un objeto, imprimir su tabla de símbolos de forma recursiva
-        if (entry->value.type == VAL_TYPE_OBJECT && entry->value.as.object_val) {
-            print_symbol_table_internal(entry->value.as.object_val, output, indent + 4);
+
+/* eval_arguments / release_arguments: evalúan los argumentos de una llamada a un arreglo de valores
+   (usado por las features predefinidas como las de ARRAY) y liberan los strings temporales.
+*/
+#define MAX_CALL_ARGUMENTS 16
+
+static int eval_arguments(ArgumentListNode *args, SymbolTable *table, RuntimeValue *values) {
+    if (!args) return 0;
+    if (args->count > MAX_CALL_ARGUMENTS) {
+        fprintf(stderr, "Error: Demasiados argumentos en una llamada (máximo %d).\n", MAX_CALL_ARGUMENTS);
+        runtime_abort();
+    }
+    for (int i = 0; i < args->count; i++) {
+        values[i] = eval_ast(args->arguments[i], table);
+    }
+    return args->count;
+}
+
+static void release_arguments(RuntimeValue *values, int count) {
+    for (int i = 0; i < count; i++) {
+        if (values[i].type == VAL_TYPE_STRING) mem_free(MEM_STRING, values[i].as.string_val);
+    }
+}
+
+/* invoke_method: ejecuta un método sobre el objeto obj_table en un scope nuevo y devuelve su 'Result'
+   (VAL_TYPE_VOID en un procedimiento; un STRING devuelto es del que llama).
+   - Los argumentos ya evaluados (del que llama) se copian a los parámetros del scope.
+   - Los objetos que el análisis de escape ubica en el frame (ver escape.h) viven en un arreglo
+     local de esta llamada: create no hace malloc y al volver solo se liberan sus atributos.
+   - Una rutina once busca primero su resultado en class_def o en el objeto: si ya corrió, la
+     llamada es una sola lectura. Se marca antes de ejecutar el cuerpo, así una llamada recursiva
+     devuelve el valor por defecto en vez de volver a entrar.
+*/
+static void release_scope_entries(SymbolTable *scope) {
+    for (int i = 0; i < scope->count; i++) {
+        if (i >= scope->shared_entries) {
+            mem_free(MEM_IDENTIFIER, scope->entries[i].name);
+            mem_free(MEM_IDENTIFIER, scope->entries[i].type_name);
         }
+        if (scope->entries[i].value.type == VAL_TYPE_STRING) mem_free(MEM_STRING, scope->entries[i].value.as.string_val);
     }
+    scope->count = 0;
+    scope->shared_entries = 0;
 }
 
-void print_symbol_table(SymbolTable *table, FILE *output) {
-    fprintf(output, "--- Symbol Table State ---\n");
-    print_symbol_table_internal(table, output, 0);
-    fprintf(output, "--------------------------\n");
+static void release_frame_object(SymbolTable *object) {
+    release_scope_entries(object);
+    for (int i = 0; i < object->once_count; i++) {
+        if (object->once_results[i].value.type == VAL_TYPE_STRING) mem_free(MEM_STRING, object->once_results[i].value.as.string_val);
+    }
+    mem_free(MEM_OBJECT, object->once_results);
+    mem_count_instance(object->owner_class_name, -1);
+}
+
+static RuntimeValue copy_value(RuntimeValue value) {
+    if (value.type == VAL_TYPE_STRING) value.as.string_val = mem_strdup(MEM_STRING, value.as.string_val);
+    return value;
 }
 
+// Lugar del resultado de una rutina once: en la clase, o en el objeto para once ("OBJECT")
+static OnceResult *once_slot(ClassDefinition *class_def, FeatureBodyNode *method, SymbolTable *obj_table) {
+    if (method->routine_kind == ROUTINE_ONCE) return &class_def->once_results[method->once_index];
+    if (obj_table->once_count < class_def->once_count) {
+        // Primer once del objeto (o la clase se redefinió con más rutinas once)
+        size_t old_size = (size_t)obj_table->once_count * sizeof(OnceResult);
+        size_t new_size = (size_t)class_def->once_count * sizeof(OnceResult);
+        obj_table->once_results = obj_table->once_results
+            ? mem_realloc(MEM_OBJECT, obj_table->once_results, new_size) : mem_alloc(MEM_OBJECT, new_size);
+        memset((char*)obj_table->once_results + old_size, 0, new_size - old_size);
+        obj_table->once_count = class_def->once_count;
+    }
+    return &obj_table->once_results[method->once_index];
+}
+
+static void bind_parameters(FeatureBodyNode *method, SymbolTable *scope, RuntimeValue *args, int arg_count) {
+    DeclarationListNode *params = method->parameters;
+    int expected = params ? params->count : 0;
+    if (arg_count != expected) {
+        fprintf(stderr, "Error: '%s' espera %d argumento(s) y recibió %d.\n", method->feature_name, expected, arg_count);
+        runtime_abort();
+    }
+    for (int i = 0; i < expected; i++) {
+        RuntimeValue value = copy_value(args[i]);
+        const char *type_name = params->items[i].type_name;
+        if (value.type == VAL_TYPE_INT && type_name && strcmp(type_name, "REAL") == 0) {
+            value.type = VAL_TYPE_REAL;
+            value.as.real_val = (double)args[i].as.int_val;
+        }
+        declare_symbol(scope, params->items[i].variable_name, type_name);
+        set_symbol(scope, params->items[i].variable_name, value);
+    }
+}
+
+/* Frame del cuerpo empalmado que está corriendo en este hilo (ver inline.h): los lugares de sus
+   argumentos, 'Result' y variables, y el objeto que recibió la llamada. Un cuerpo empalmado no
+   llama a nada, así que no hay dos anidados; los argumentos se evalúan antes de armarlo. */
+typedef struct {
+    RuntimeValue *slots;
+    SymbolTable *receiver;
+} InlineFrame;
+
+static _Thread_local InlineFrame *inline_frame = NULL;
+
+/* Atributo de un cuerpo empalmado en el objeto que lo recibe: por su lugar en el prototipo, o por
+   nombre si el objeto no tiene esa forma (ej. se creó antes de redefinir la clase en el REPL).
+   NULL si el objeto no lo tiene. */
+static SymbolTableEntry* inline_field(InlineFieldNode *n) {
+    SymbolTable *object = inline_frame->receiver;
+    if (n->index < object->count && object->entries[n->index].name == n->name) return &object->entries[n->index];
+    return find_symbol_entry(object, n->name);
+}
+
+/* run_inline: ejecuta el cuerpo empalmado de una rutina (ver inline.h) sobre obj_table, sin scope
+   de método: los argumentos (copiados, como en bind_parameters) y 'Result' van en un frame en la
+   pila. Lo usan las llamadas enlazadas cuya guarda pasa y, por run_method, las demás. */
+static RuntimeValue run_inline(FeatureBodyNode *method, SymbolTable *obj_table, RuntimeValue *args, int arg_count) {
+    DeclarationListNode *params = method->parameters;
+    int expected = params ? params->count : 0;
+    if (arg_count != expected) {
+        fprintf(stderr, "Error: '%s' espera %d argumento(s) y recibió %d.\n", method->feature_name, expected, arg_count);
+        runtime_abort();
+    }
+    RuntimeValue slots[method->inline_slots > 0 ? method->inline_slots : 1];
+    for (int i = 0; i < expected; i++) {
+        slots[i] = copy_value(args[i]);
+        const char *type_name = params->items[i].type_name;
+        if (args[i].type == VAL_TYPE_INT && type_name && strcmp(type_name, "REAL") == 0) {
+            slots[i].type = VAL_TYPE_REAL;
+            slots[i].as.real_val = (double)args[i].as.int_val;
+        }
+    }
+    for (int i = expected; i < method->inline_slots; i++) slots[i].type = VAL_TYPE_VOID;
+    if (method->result_type) slots[expected] = default_value(method->result_type);
+
+    InlineFrame frame = { .slots = slots, .receiver = obj_table };
+    InlineFrame *outer = inline_frame;
+    inline_frame = &frame;
+    eval_ast(method->inline_body, obj_table);
+    inline_frame = outer;
+
+    RuntimeValue result = { .type = VAL_TYPE_VOID };
+    if (method->result_type) {
+        result = slots[expected]; // El valor pasa al que llama
+        slots[expected].type = VAL_TYPE_VOID;
+    }
+    release_arguments(slots, method->inline_slots);
+    return result;
+}
+
+/* spliced: guarda de una llamada enlazada a una rutina con cuerpo empalmado (ver inline.h). Si el
+   objeto es de bound_class y no es separate, la llamada corre el cuerpo con run_inline ahí mismo,
+   sin resolve_feature ni invoke_method. */
+static inline int spliced(SymbolTable *object, ClassDefinition *bound_class, FeatureBodyNode *bound_feature) {
+    return bound_feature && bound_feature->inline_body && object->owner_class_name == bound_class->name
+        && !SCOOP_IS_SEPARATE(object);
+}
+
+static RuntimeValue run_method(ClassDefinition *class_def, FeatureBodyNode *method, SymbolTable *obj_table,
+                               RuntimeValue *args, int arg_count) {
+    if (method->inline_body) return run_inline(method, obj_table, args, arg_count); // Llamada sin enlazar
+    OnceResult *once = NULL;
+    if (method->routine_kind != ROUTINE_DO) {
+        once = once_slot(class_def, method, obj_table);
+        if (once->feature == method) return copy_value(once->value);
+        if (once->value.type == VAL_TYPE_STRING) mem_free(MEM_STRING, once->value.as.string_val);
+        once->feature = method;
+        once->value = default_value(method->result_type);
+    }
+
+    METER_STEP(); // La recursión sin loops también consume pasos
+    meter_check_stack();
+    int slots = escape_frame_slots(method);
+    SymbolTable frame_objects[slots > 0 ? slots : 1];
+    for (int i = 0; i < slots; i++) init_symbol_table(&frame_objects[i]);
+    if (slots > 0) mem_track(MEM_FRAME, (long)sizeof(frame_objects));
+
+    SymbolTable method_scope;
+    init_symbol_table(&method_scope);
+    method_scope.parent = obj_table;
+    method_scope.frame_objects = slots > 0 ? frame_objects : NULL;
+    mem_track(MEM_SCOPE, (long)sizeof(method_scope));
+    bind_parameters(method, &method_scope, args, arg_count);
+    if (method->result_type) {
+        declare_symbol(&method_scope, "Result", method->result_type);
+        set_symbol(&method_scope, "Result", default_value(method->result_type));
+    }
+    eval_ast((AstNode*)method, &method_scope);
+    if (scoop_pending_count) scoop_resolve_scope(&method_scope); // Consultas separate que nadie leyó
+
+    RuntimeValue result = { .type = VAL_TYPE_VOID };
+    SymbolTableEntry *result_entry = method->result_type ? find_symbol_entry(&method_scope, "Result") : NULL;
+    if (result_entry) {
+        result = result_entry->value; // El valor pasa al que llama: el scope ya no lo libera
+        result_entry->value.type = VAL_TYPE_VOID;
+    }
+    release_scope_entries(&method_scope);
+    mem_track(MEM_SCOPE, -(long)sizeof(method_scope));
+
+    for (int i = 0; i < slots; i++) release_frame_object(&frame_objects[i]);
+    if (slots > 0) mem_track(MEM_FRAME, -(long)sizeof(frame_objects));
+
+    if (once) {
+        if (once->value.type == VAL_TYPE_STRING) mem_free(MEM_STRING, once->value.as.string_val);
+        once->value = result; // El resultado guardado es del once; cada llamada recibe una copia
+        return copy_value(result);
+    }
+    return result;
+}
+
+/* invoke_method: con objetos separate, una rutina once de clase la ejecuta un procesador a la vez
+   (el resultado guardado es uno solo para todos). */
+RuntimeValue invoke_method(ClassDefinition *class_def, FeatureBodyNode *method, SymbolTable *obj_table,
+                           RuntimeValue *args, int arg_count) {
+    if (method->routine_kind != ROUTINE_ONCE || !scoop_started) {
+        return run_method(class_def, method, obj_table, args, arg_count);
+    }
+    scoop_once_enter();
+    RuntimeValue result = run_method(class_def, method, obj_table, args, arg_count);
+    scoop_once_leave();
+    return result;
+}
+
+/* call_current_feature: llamada sin objeto a una rutina de la clase de Current (ver current_object).
+   Devuelve 0 si la clase no tiene una rutina con ese nombre. */
+static int call_current_feature(const char *name, ArgumentListNode *arguments, SymbolTable *table, RuntimeValue *result,
+                                ClassDefinition *bound_class, FeatureBodyNode *bound_feature) {
+    const char *class_name;
+    SymbolTable *object = current_object(table, &class_name);
+    int inline_call = spliced(object, bound_class, bound_feature);
+    ClassDefinition *class_def = bound_class;
+    FeatureBodyNode *method = inline_call ? bound_feature
+        : resolve_feature(class_name, name, bound_class, bound_feature, &class_def);
+    if (!method) return 0;
+    RuntimeValue args[MAX_CALL_ARGUMENTS];
+    int arg_count = eval_arguments(arguments, table, args);
+    *result = inline_call ? run_inline(method, object, args, arg_count)
+        : invoke_method(class_def, method, object, args, arg_count);
+    release_arguments(args, arg_count);
+    return 1;
+}
+
+/* --- Quickening de expresiones binarias y comparaciones (ver QuickOp en ast.h) ---
+   - El camino general decide por los tipos de los operandos y devuelve la variante que le
+     corresponde; quicken la escribe en el nodo. La próxima evaluación solo verifica esos tipos.
+   - INTEGER con INTEGER da INTEGER (con desborde en complemento a 2); si hay un REAL, se opera
+     como REAL. Dos STRING se comparan por contenido y '+' los concatena.
+   - EIFFEL_NO_QUICKENING=1 deja todos los nodos en el camino general (mismos resultados).
+*/
+static atomic_int quickening_state = -1; // -1: sin leer la variable de entorno
+
+static int quickening_enabled(void) {
+    int state = atomic_load_explicit(&quickening_state, memory_order_relaxed);
+    if (state < 0) {
+        const char *env = getenv("EIFFEL_NO_QUICKENING");
+        state = !(env && *env && strcmp(env, "0") != 0);
+        atomic_store_explicit(&quickening_state, state, memory_order_relaxed);
+    }
+    return state;
+}
+
+static void quicken(atomic_uchar *quick, atomic_uchar *deopts, QuickOp observed) {
+    int current = atomic_load_explicit(quick, memory_order_relaxed);
+    // Tipos sin variante (ej. un operando VOID): el nodo sigue como estaba
+    if (observed == QUICK_GENERIC || current == (int)observed || current == QUICK_GENERIC) return;
+    if (!quickening_enabled()) {
+        observed = QUICK_GENERIC;
+    } else if (current != QUICK_UNSEEN) {
+        // Falló la guarda de la variante: se desoptimiza y, si pasa seguido, queda general
+        if (atomic_fetch_add_explicit(deopts, 1, memory_order_relaxed) + 1 >= QUICK_MAX_DEOPTS) observed = QUICK_GENERIC;
+    }
+    atomic_store_explicit(quick, (unsigned char)observed, memory_order_relaxed);
+}
+
+static int int_divide(int left, int right) {
+    if (right == 0) {
+        fprintf(stderr, "Error: División por cero.\n");
+        runtime_abort();
+    }
+    if (right == -1) return (int)(0u - (unsigned)left); // INT_MIN / -1 desborda
+    return left / right;
+}
+
+static int int_arith(char op, int left, int right) {
+    switch (op) {
+        case '+': return (int)((unsigned)left + (unsigned)right);
+        case '-': return (int)((unsigned)left - (unsigned)right);
+        case '*': return (int)((unsigned)left * (unsigned)right);
+        default: return int_divide(left, right);
+    }
+}
+
+static double real_arith(char op, double left, double right) {
+    switch (op) {
+        case '+': return left + right;
+        case '-': return left - right;
+        case '*': return left * right;
+        default: return left / right;
+    }
+}
+
+static int is_numeric(RuntimeValue value) {
+    return value.type == VAL_TYPE_INT || value.type == VAL_TYPE_REAL;
+}
+
+static double as_real(RuntimeValue value) {
+    return value.type == VAL_TYPE_REAL ? value.as.real_val : (double)value.as.int_val;
+}
+
+static char *concat_strings(const char *left, const char *right) {
+    size_t len1 = strlen(left);
+    size_t len2 = strlen(right);
+    char *new_str = mem_alloc(MEM_STRING, len1 + len2 + 1);
+    memcpy(new_str, left, len1);
+    memcpy(new_str + len1, right, len2 + 1); // Copia el terminador nulo también
+    return new_str;
+}
+
+// Posición del operador dentro de cada grupo de variantes (ADD, SUB, MUL, DIV)
+static int op_offset(char op) {
+    return op == '+' ? 0 : op == '-' ? 1 : op == '*' ? 2 : 3;
+}
+
+// Camino general: calcula left op right y devuelve la variante para esos tipos
+static QuickOp binary_generic(char op, RuntimeValue left, RuntimeValue right, RuntimeValue *result) {
+    if (left.type == VAL_TYPE_INT && right.type == VAL_TYPE_INT) {
+        result->type = VAL_TYPE_INT;
+        result->as.int_val = int_arith(op, left.as.int_val, right.as.int_val);
+        return (QuickOp)(QUICK_INT_ADD + op_offset(op));
+    }
+    if (is_numeric(left) && is_numeric(right)) {
+        result->type = VAL_TYPE_REAL;
+        result->as.real_val = real_arith(op, as_real(left), as_real(right));
+        if (left.type == VAL_TYPE_REAL && right.type == VAL_TYPE_REAL) return (QuickOp)(QUICK_REAL_ADD + op_offset(op));
+        return QUICK_MIXED;
+    }
+    if (left.type == VAL_TYPE_STRING && right.type == VAL_TYPE_STRING && op == '+') {
+        result->type = VAL_TYPE_STRING;
+        result->as.string_val = concat_strings(left.as.string_val, right.as.string_val);
+        return QUICK_CONCAT;
+    }
+    return QUICK_GENERIC;
+}
+
+// Operando de una expresión: los literales numéricos se leen sin pasar por eval_ast
+static inline RuntimeValue eval_operand(AstNode *node, SymbolTable *table) {
+    if (node->type == NODE_TYPE_LITERAL) {
+        LiteralNode *literal = (LiteralNode*)node;
+        if (literal->literal_type == LITERAL_TYPE_INT) return (RuntimeValue){ .type = VAL_TYPE_INT, .as.int_val = literal->value.int_val };
+        if (literal->literal_type == LITERAL_TYPE_REAL) return (RuntimeValue){ .type = VAL_TYPE_REAL, .as.real_val = literal->value.real_val };
+    }
+    return eval_ast(node, table);
+}
+
+static RuntimeValue eval_binary(BinaryExprNode *n, SymbolTable *table) {
+    RuntimeValue left = eval_operand(n->left, table);
+    RuntimeValue right = eval_operand(n->right, table);
+    RuntimeValue result = { .type = VAL_TYPE_VOID };
+#define BOTH(value_type) (left.type == (value_type) && right.type == (value_type))
+
+    switch ((QuickOp)atomic_load_explicit(&n->quick, memory_order_relaxed)) {
+        case QUICK_INT_ADD:
+            if (!BOTH(VAL_TYPE_INT)) break;
+            result.type = VAL_TYPE_INT;
+            result.as.int_val = (int)((unsigned)left.as.int_val + (unsigned)right.as.int_val);
+            return result;
+        case QUICK_INT_SUB:
+            if (!BOTH(VAL_TYPE_INT)) break;
+            result.type = VAL_TYPE_INT;
+            result.as.int_val = (int)((unsigned)left.as.int_val - (unsigned)right.as.int_val);
+            return result;
+        case QUICK_INT_MUL:
+            if (!BOTH(VAL_TYPE_INT)) break;
+            result.type = VAL_TYPE_INT;
+            result.as.int_val = (int)((unsigned)left.as.int_val * (unsigned)right.as.int_val);
+            return result;
+        case QUICK_INT_DIV:
+            if (!BOTH(VAL_TYPE_INT)) break;
+            result.type = VAL_TYPE_INT;
+            result.as.int_val = int_divide(left.as.int_val, right.as.int_val);
+            return result;
+        case QUICK_REAL_ADD:
+            if (!BOTH(VAL_TYPE_REAL)) break;
+            result.type = VAL_TYPE_REAL;
+            result.as.real_val = left.as.real_val + right.as.real_val;
+            return result;
+        case QUICK_REAL_SUB:
+            if (!BOTH(VAL_TYPE_REAL)) break;
+            result.type = VAL_TYPE_REAL;
+            result.as.real_val = left.as.real_val - right.as.real_val;
+            return result;
+        case QUICK_REAL_MUL:
+            if (!BOTH(VAL_TYPE_REAL)) break;
+            result.type = VAL_TYPE_REAL;
+            result.as.real_val = left.as.real_val * right.as.real_val;
+            return result;
+        case QUICK_REAL_DIV:
+            if (!BOTH(VAL_TYPE_REAL)) break;
+            result.type = VAL_TYPE_REAL;
+            result.as.real_val = left.as.real_val / right.as.real_val;
+            return result;
+        case QUICK_MIXED:
+            if (!is_numeric(left) || !is_numeric(right) || left.type == right.type) break;
+            result.type = VAL_TYPE_REAL;
+            result.as.real_val = real_arith(n->op, as_real(left), as_real(right));
+            return result;
+        case QUICK_CONCAT:
+            if (left.type != VAL_TYPE_STRING || right.type != VAL_TYPE_STRING) break;
+            result.type = VAL_TYPE_STRING;
+            result.as.string_val = concat_strings(left.as.string_val, right.as.string_val);
+            mem_free(MEM_STRING, left.as.string_val);
+            mem_free(MEM_STRING, right.as.string_val);
+            return result;
+        default:
+            break;
+    }
+#undef BOTH
+
+    quicken(&n->quick, &n->deopts, binary_generic(n->op, left, right, &result));
+    // Liberar memoria de operandos si eran strings temporales
+    if (left.type == VAL_TYPE_STRING) mem_free(MEM_STRING, left.as.string_val);
+    if (right.type == VAL_TYPE_STRING) mem_free(MEM_STRING, right.as.string_val);
+    return result;
+}
+
+static int compare(int op, double l, double r) {
+    switch (op) {
+        case TOKEN_LT: return l < r;
+        case TOKEN_LE: return l <= r;
+        case TOKEN_GT: return l > r;
+        case TOKEN_GE: return l >= r;
+        default: return l == r;
+    }
+}
+
+static int compare_ints(int op, int l, int r) {
+    switch (op) {
+        case TOKEN_LT: return l < r;
+        case TOKEN_LE: return l <= r;
+        case TOKEN_GT: return l > r;
+        case TOKEN_GE: return l >= r;
+        default: return l == r;
+    }
+}
+
+/* eval_comparison: dos STRING se comparan por contenido (orden lexicográfico); si hay un REAL se
+   compara como REAL; cualquier otro par (también dos BOOLEAN), por su valor entero. El resultado
+   es un BOOLEAN. */
+static RuntimeValue eval_comparison(ComparisonExprNode *n, SymbolTable *table) {
+    RuntimeValue left = eval_operand(n->left, table);
+    RuntimeValue right = eval_operand(n->right, table);
+    RuntimeValue result = { .type = VAL_TYPE_BOOLEAN };
+
+    switch ((QuickOp)atomic_load_explicit(&n->quick, memory_order_relaxed)) {
+        case QUICK_CMP_INT:
+            if (left.type != VAL_TYPE_INT || right.type != VAL_TYPE_INT) break;
+            result.as.int_val = compare_ints(n->op, left.as.int_val, right.as.int_val);
+            return result;
+        case QUICK_CMP_NUMERIC:
+            if (!is_numeric(left) || !is_numeric(right) || (left.type == VAL_TYPE_INT && right.type == VAL_TYPE_INT)) break;
+            result.as.int_val = compare(n->op, as_real(left), as_real(right));
+            return result;
+        case QUICK_CMP_STRING:
+            if (left.type != VAL_TYPE_STRING || right.type != VAL_TYPE_STRING) break;
+            result.as.int_val = compare(n->op, string_compare(left.as.string_val, right.as.string_val), 0);
+            mem_free(MEM_STRING, left.as.string_val);
+            mem_free(MEM_STRING, right.as.string_val);
+            return result;
+        default:
+            break;
+    }
+
+    QuickOp observed = QUICK_GENERIC;
+    if (left.type == VAL_TYPE_STRING && right.type == VAL_TYPE_STRING) {
+        result.as.int_val = compare(n->op, string_compare(left.as.string_val, right.as.string_val), 0);
+        observed = QUICK_CMP_STRING;
+    } else if (left.type == VAL_TYPE_REAL || right.type == VAL_TYPE_REAL) {
+        result.as.int_val = compare(n->op, left.type == VAL_TYPE_REAL ? left.as.real_val : left.as.int_val,
+                                    right.type == VAL_TYPE_REAL ? right.as.real_val : right.as.int_val);
+        if (is_numeric(left) && is_numeric(right)) observed = QUICK_CMP_NUMERIC;
+    } else {
+        result.as.int_val = compare_ints(n->op, left.as.int_val, right.as.int_val);
+        if (left.type == VAL_TYPE_INT && right.type == VAL_TYPE_INT) observed = QUICK_CMP_INT;
+    }
+    quicken(&n->quick, &n->deopts, observed);
+    if (left.type == VAL_TYPE_STRING) mem_free(MEM_STRING, left.as.string_val);
+    if (right.type == VAL_TYPE_STRING) mem_free(MEM_STRING, right.as.string_val);
+    return result;
+}
+
+/* eval_condition: condición de un if, un loop o un operando BOOLEAN, como 0/1.
+   - Una expresión BOOLEAN no arma valores intermedios: cada operador es un salto en C, y en
+     'and then', 'or else' e 'implies' el operando derecho solo se evalúa si el izquierdo no
+     decidió el resultado.
+   - Cualquier otra expresión vale por su valor entero, como siempre en las condiciones (un
+     INTEGER distinto de 0 es verdadero, una variable sin valor es falsa).
+*/
+static int eval_condition(AstNode *node, SymbolTable *table) {
+    if (node && node->type == NODE_TYPE_BOOLEAN_EXPR) {
+        BooleanExprNode *n = (BooleanExprNode*)node;
+        int left = eval_condition(n->left, table);
+        switch (n->op) {
+            case BOOL_NOT: return !left;
+            case BOOL_AND_THEN: return left ? eval_condition(n->right, table) : 0;
+            case BOOL_OR_ELSE: return left ? 1 : eval_condition(n->right, table);
+            case BOOL_IMPLIES: return left ? eval_condition(n->right, table) : 1;
+            case BOOL_AND: {
+                int right = eval_condition(n->right, table);
+                return left && right;
+            }
+            case BOOL_OR: {
+                int right = eval_condition(n->right, table);
+                return left || right;
+            }
+        }
+    }
+    RuntimeValue value = eval_ast(node, table);
+    return value.as.int_val != 0;
+}
+
+/* eval_attribute_access: 'x.nombre' sin argumentos.
+   - Si el nombre corresponde a un método, lo ejecuta; si es atributo, devuelve una copia de su valor
+     desde la tabla del objeto (el método se busca en la definición de la clase).
+   - Sobre un objeto separate es una consulta a su procesador: defer_into/deferred como en scoop_call
+     (los usa la asignación a una variable; en cualquier otro lugar son NULL y se espera el valor).
+*/
+static RuntimeValue eval_attribute_access(AttributeAccessNode *n, SymbolTable *table, SymbolTableEntry *defer_into, int *deferred) {
+    RuntimeValue result = { .type = VAL_TYPE_VOID };
+    RuntimeValue object_val = eval_ast(n->object_node, table);
+    if (object_val.type == VAL_TYPE_ARRAY) {
+        // Feature predefinida de ARRAY sin argumentos (count, sum, ...)
+        result = array_call_feature(object_val.as.array_val, n->attribute_name, NULL, 0);
+    } else if (object_val.type == VAL_TYPE_FILE) {
+        // Feature predefinida de PLAIN_TEXT_FILE sin argumentos (read_line, close, ...)
+        result = file_call_feature(object_val.as.file_val, n->attribute_name, NULL, 0);
+    } else if (object_val.type == VAL_TYPE_STRING) {
+        // Feature predefinida de STRING sin argumentos (count, hash_code, ...)
+        result = string_call_feature(object_val.as.string_val, n->attribute_name, NULL, 0);
+        mem_free(MEM_STRING, object_val.as.string_val);
+    } else if (object_val.type == VAL_TYPE_OBJECT) {
+        SymbolTable* obj_table = object_val.as.object_val;
+        if (spliced(obj_table, n->bound_class, n->bound_feature)) return run_inline(n->bound_feature, obj_table, NULL, 0);
+        // Buscar si es un método
+        ClassDefinition* class_def;
+        FeatureBodyNode* method_node = resolve_feature(obj_table->owner_class_name, n->attribute_name,
+                                                       n->bound_class, n->bound_feature, &class_def);
+
+        if (method_node) { // Es una llamada a método sin argumentos (los procedimientos devuelven void)
+            if (SCOOP_IS_SEPARATE(obj_table)) {
+                result = scoop_call(class_def, method_node, obj_table, NULL, 0, defer_into, deferred);
+            } else {
+                result = invoke_method(class_def, method_node, obj_table, NULL, 0);
+            }
+        } else if (SCOOP_IS_SEPARATE(obj_table)) {
+            result = scoop_read_attribute(obj_table, n->attribute_name, defer_into, deferred);
+        } else { // Es un acceso a atributo
+            result = get_symbol(obj_table, n->attribute_name);
+            // Igual que al leer una variable: el que llama es dueño de su copia del string
+            if (result.type == VAL_TYPE_STRING) {
+                result.as.string_val = mem_strdup(MEM_STRING, result.as.string_val);
+            }
+        }
+    }
+    return result;
+}
+
+/* eval_method_call: buscar el FeatureBodyNode en la definición de la clase, crear un método_scope
+   cuyo parent es la tabla del objeto (permite acceso a atributos vía get_symbol) y ejecutar el cuerpo.
+   Sobre un objeto separate la llamada se encola en su procesador (ver eval_attribute_access).
+*/
+static RuntimeValue eval_method_call(MethodCallNode *n, SymbolTable *table, SymbolTableEntry *defer_into, int *deferred) {
+    RuntimeValue result = { .type = VAL_TYPE_VOID };
+    RuntimeValue object_val = eval_ast(n->object_node, table);
+    if (object_val.type == VAL_TYPE_ARRAY) {
+        // Feature predefinida de ARRAY (item, put, fill, ...)
+        RuntimeValue args[MAX_CALL_ARGUMENTS];
+        int arg_count = eval_arguments(n->arguments, table, args);
+        result = array_call_feature(object_val.as.array_val, n->method_name, args, arg_count);
+        release_arguments(args, arg_count);
+        return result;
+    }
+    if (object_val.type == VAL_TYPE_FILE) {
+        // Feature predefinida de PLAIN_TEXT_FILE (put_string, make_open_read, ...)
+        RuntimeValue args[MAX_CALL_ARGUMENTS];
+        int arg_count = eval_arguments(n->arguments, table, args);
+        result = file_call_feature(object_val.as.file_val, n->method_name, args, arg_count);
+        release_arguments(args, arg_count);
+        return result;
+    }
+    if (object_val.type == VAL_TYPE_STRING) {
+        // Feature predefinida de STRING (substring, index_of, split, ...)
+        RuntimeValue args[MAX_CALL_ARGUMENTS];
+        int arg_count = eval_arguments(n->arguments, table, args);
+        result = string_call_feature(object_val.as.string_val, n->method_name, args, arg_count);
+        release_arguments(args, arg_count);
+        mem_free(MEM_STRING, object_val.as.string_val);
+        return result;
+    }
+    if (object_val.type != VAL_TYPE_OBJECT) return result;
+
+    SymbolTable* obj_table = object_val.as.object_val;
+    int inline_call = spliced(obj_table, n->bound_class, n->bound_feature);
+    ClassDefinition* class_def = n->bound_class;
+    FeatureBodyNode* method_node = inline_call ? n->bound_feature
+        : resolve_feature(obj_table->owner_class_name, n->method_name, n->bound_class, n->bound_feature, &class_def);
+
+    if (method_node) {
+        RuntimeValue args[MAX_CALL_ARGUMENTS];
+        int arg_count = eval_arguments(n->arguments, table, args);
+        if (inline_call) {
+            result = run_inline(method_node, obj_table, args, arg_count);
+        } else if (SCOOP_IS_SEPARATE(obj_table)) {
+            result = scoop_call(class_def, method_node, obj_table, args, arg_count, defer_into, deferred);
+        } else {
+            result = invoke_method(class_def, method_node, obj_table, args, arg_count);
+        }
+        release_arguments(args, arg_count);
+    }
+    return result;
+}
 
 /* eval_ast: función central de ejecución. Recorre el AST y evalúa cada tipo de nodo.
-   - Important cases: NODE_TYPE_CREATE inicializa un SymbolTable para el objeto y define atributos con valores por defecto.
+   - Important cases: NODE_TYPE_CREATE toma un SymbolTable del pool de la clase (o del frame) y copia el prototipo de la clase.
    - NODE_TYPE_METHOD_CALL y NODE_TYPE_FEATURE_BODY: crean scopes anidados para ejecutar métodos con acceso a 'Current' (obj_table).
    - NODE_TYPE_PROCEDURE_CALL: llamadas globales como print.
 */
@@ -236,57 +1318,41 @@ RuntimeValue eval_ast(AstNode *node, SymbolTable *table) {
             switch (n->literal_type) {
                 case LITERAL_TYPE_INT:    result.type = VAL_TYPE_INT; result.as.int_val = n->value.int_val; break;
                 case LITERAL_TYPE_REAL:   result.type = VAL_TYPE_REAL; result.as.real_val = n->value.real_val; break;
-                case LITERAL_TYPE_STRING: result.type = VAL_TYPE_STRING; result.as.string_val = strdup(n->value.string_val); break;
+                case LITERAL_TYPE_STRING: result.type = VAL_TYPE_STRING; result.as.string_val = mem_strdup(MEM_STRING, n->value.string_val); break;
+                case LITERAL_TYPE_BOOLEAN: result.type = VAL_TYPE_BOOLEAN; result.as.int_val = n->value.int_val; break;
             }
             break;
         }
 
-        case NODE_TYPE_BINARY_EXPR: {
-            /* Evaluar ambos lados y operar (suma, resta, mult, div).
-               También maneja concatenación de strings con '+'. */
-            BinaryExprNode *n = (BinaryExprNode*)node;
-            RuntimeValue left = eval_ast(n->left, table);
-            RuntimeValue right = eval_ast(n->right, table);
-
-            // Lógica para enteros
-            if (left.type == VAL_TYPE_INT && right.type == VAL_TYPE_INT) {
-                result.type = VAL_TYPE_INT;
-                switch (n->op) {
-                    case '+': result.as.int_val = left.as.int_val + right.as.int_val; break;
-                    case '-': result.as.int_val = left.as.int_val - right.as.int_val; break;
-                    case '*': result.as.int_val = left.as.int_val * right.as.int_val; break;
-                    case '/': result.as.int_val = left.as.int_val / right.as.int_val; break;
-                }
-            }
-            // SOLUCIÓN: Añadir lógica para concatenación de strings
-            else if (left.type == VAL_TYPE_STRING && right.type == VAL_TYPE_STRING && n->op == '+') {
-                result.type = VAL_TYPE_STRING;
-                size_t len1 = strlen(left.as.string_val);
-                size_t len2 = strlen(right.as.string_val);
-                char* new_str = malloc(len1 + len2 + 1);
-                memcpy(new_str, left.as.string_val, len1);
-                memcpy(new_str + len1, right.as.string_val, len2 + 1); // Copia el terminador nulo también
-                result.as.string_val = new_str;
-            }
-
-            // Liberar memoria de operandos si eran strings temporales
-            if (left.type == VAL_TYPE_STRING) free(left.as.string_val);
-            if (right.type == VAL_TYPE_STRING) free(right.as.string_val);
-
+        case NODE_TYPE_BINARY_EXPR:
+            /* Operaciones +, -, *, / (y concatenación de STRING con '+'), especializadas por tipo */
+            result = eval_binary((BinaryExprNode*)node, table);
             break;
-        }
 
         case NODE_TYPE_PROCEDURE_CALL: {
-            /* Procedimientos globales: por ahora 'print' imprime los argumentos evaluados */
+            /* Llamadas sin objeto: 'print' imprime los argumentos evaluados; si no, una rutina de la
+               clase de Current (f (x) equivale a Current.f (x)); las consultas de entrada
+               (read_line, read_integer...) también se pueden llamar con paréntesis vacíos */
             ProcedureCallNode *n = (ProcedureCallNode*)node;
-            if (strcmp(n->name, "print") == 0) {
-                ArgumentListNode *arg = n->arguments;
-                while (arg) {
-                    RuntimeValue val = eval_ast(arg->argument, table);
+            if (strcmp(n->name, "print") == 0 && scoop_started) {
+                // Los argumentos pueden esperar a procesadores separate: su salida va antes que esta línea
+                RuntimeValue values[MAX_CALL_ARGUMENTS];
+                int count = eval_arguments(n->arguments, table, values);
+                scoop_emit_output();
+                for (int i = 0; i < count; i++) print_value(values[i]);
+                output_newline();
+                release_arguments(values, count);
+            } else if (strcmp(n->name, "print") == 0) {
+                ArgumentListNode *args = n->arguments;
+                for (int i = 0; args && i < args->count; i++) {
+                    RuntimeValue val = eval_ast(args->arguments[i], table);
                     print_value(val);
-                    arg = arg->next;
                 }
-                printf("\n");
+                output_newline();
+            } else if (call_current_feature(n->name, n->arguments, table, &result, n->bound_class, n->bound_feature)) {
+                break;
+            } else if (io_is_builtin(n->name)) {
+                io_call_builtin(n->name, NULL, n->arguments ? n->arguments->count : 0, &result);
             }
             break;
         }
@@ -294,9 +1360,11 @@ RuntimeValue eval_ast(AstNode *node, SymbolTable *table) {
         case NODE_TYPE_STATEMENT_LIST: {
             /* Ejecuta cada sentencia en secuencia */
             StatementListNode *list = (StatementListNode*)node;
-            while (list) {
-                eval_ast(list->statement, table);
-                list = list->next;
+            for (int i = 0; i < list->count; i++) {
+                METER_STEP();
+                RuntimeValue discarded = eval_ast(list->statements[i], table);
+                // Una consulta usada como instrucción (ej. read_line) deja un STRING que nadie usa
+                if (discarded.type == VAL_TYPE_STRING) mem_free(MEM_STRING, discarded.as.string_val);
             }
             break;
         }
@@ -304,14 +1372,44 @@ RuntimeValue eval_ast(AstNode *node, SymbolTable *table) {
         case NODE_TYPE_ASSIGN: {
             /* Asignación: resolver target (variable o atributo) y usar set_symbol en el scope apropiado */
             AssignNode *n = (AssignNode*)node;
-            RuntimeValue value_to_assign = eval_ast(n->expression, table);
+            RuntimeValue value_to_assign;
+            int deferred = 0;
+            if (scoop_started && n->target->type == NODE_TYPE_VARIABLE
+                && (n->expression->type == NODE_TYPE_METHOD_CALL || n->expression->type == NODE_TYPE_ATTRIBUTE_ACCESS)) {
+                // Consulta a un objeto separate hacia una variable del scope: la variable queda pendiente
+                SymbolTableEntry *target = find_symbol_entry(table, ((VariableNode*)n->target)->name);
+                value_to_assign = n->expression->type == NODE_TYPE_METHOD_CALL
+                    ? eval_method_call((MethodCallNode*)n->expression, table, target, &deferred)
+                    : eval_attribute_access((AttributeAccessNode*)n->expression, table, target, &deferred);
+            } else {
+                value_to_assign = eval_ast(n->expression, table);
+            }
 
-            if (n->target->type == NODE_TYPE_VARIABLE) {
+            if (deferred) {
+                break;
+            } else if (n->target->type == NODE_TYPE_VARIABLE) {
                 VariableNode *var_node = (VariableNode*)n->target;
                 set_symbol(table, var_node->name, value_to_assign);
+            } else if (n->target->type == NODE_TYPE_INLINE_SLOT) {
+                replace_value(&inline_frame->slots[((InlineSlotNode*)n->target)->slot], value_to_assign);
+            } else if (n->target->type == NODE_TYPE_INLINE_FIELD) {
+                // Current.a := e en un cuerpo empalmado: como set_symbol sobre el objeto
+                InlineFieldNode *field = (InlineFieldNode*)n->target;
+                SymbolTableEntry *entry = inline_field(field);
+                if (!entry) {
+                    set_symbol(inline_frame->receiver, field->name, value_to_assign);
+                    break;
+                }
+                if (scoop_pending_count) scoop_forget_entry(entry);
+                replace_value(&entry->value, value_to_assign);
             } else if (n->target->type == NODE_TYPE_ATTRIBUTE_ACCESS) {
                 AttributeAccessNode *attr_node = (AttributeAccessNode*)n->target;
                 RuntimeValue object_val = eval_ast(attr_node->object_node, table);
+                if (object_val.type == VAL_TYPE_OBJECT && SCOOP_IS_SEPARATE(object_val.as.object_val)) {
+                    fprintf(stderr, "Error: No se puede asignar '%s' de un objeto separate desde otro procesador.\n",
+                            attr_node->attribute_name);
+                    runtime_abort();
+                }
                 if (object_val.type == VAL_TYPE_OBJECT) {
                     set_symbol(object_val.as.object_val, attr_node->attribute_name, value_to_assign);
                 }
@@ -328,36 +1426,62 @@ RuntimeValue eval_ast(AstNode *node, SymbolTable *table) {
         case NODE_TYPE_VARIABLE: {
             /* Lectura de variable: get_symbol busca en scope actual y padres */
             VariableNode *n = (VariableNode*)node;
-            result = get_symbol(table, n->name);
+            if (!lookup_symbol(table, n->name, &result)) {
+                // Sin variable con ese nombre: una rutina de Current sin argumentos o una consulta de
+                // entrada (read_line...); las dos ya devuelven una copia
+                if (!call_current_feature(n->name, NULL, table, &result, NULL, NULL) && !io_call_builtin(n->name, NULL, 0, &result)) {
+                    fprintf(stderr, "Error: Variable '%s' no definida.\n", n->name);
+                    runtime_abort();
+                }
+                break;
+            }
             // Si el valor es un string, duplicarlo para que el que llama sea dueño de la memoria.
             if (result.type == VAL_TYPE_STRING) {
-                result.as.string_val = strdup(result.as.string_val);
+                result.as.string_val = mem_strdup(MEM_STRING, result.as.string_val);
             }
             break;
         }
 
-        case NODE_TYPE_COMPARISON_EXPR: {
-            /* Comparaciones <, <=, >, >=, == devolviendo entero 0/1 */
-            ComparisonExprNode *n = (ComparisonExprNode*)node;
-            RuntimeValue left = eval_ast(n->left, table);
-            RuntimeValue right = eval_ast(n->right, table);
-            result.type = VAL_TYPE_INT;
-            int l = left.as.int_val, r = right.as.int_val;
-            switch(n->op) {
-                case TOKEN_LT: result.as.int_val = l < r; break;
-                case TOKEN_LE: result.as.int_val = l <= r; break;
-                case TOKEN_GT: result.as.int_val = l > r; break;
-                case TOKEN_GE: result.as.int_val = l >= r; break;
-                case TOKEN_EQ: result.as.int_val = l == r; break;
+        case NODE_TYPE_INLINE_SLOT:
+            /* Argumento, 'Result' o variable de un cuerpo empalmado (ver run_inline) */
+            result = inline_frame->slots[((InlineSlotNode*)node)->slot];
+            if (result.type == VAL_TYPE_STRING) result.as.string_val = mem_strdup(MEM_STRING, result.as.string_val);
+            break;
+
+        case NODE_TYPE_INLINE_FIELD: {
+            /* Current o un atributo del objeto que recibió un cuerpo empalmado */
+            InlineFieldNode *n = (InlineFieldNode*)node;
+            if (!n->name) {
+                result.type = VAL_TYPE_OBJECT;
+                result.as.object_val = inline_frame->receiver;
+                break;
             }
+            SymbolTableEntry *entry = inline_field(n);
+            if (!entry) {
+                result = get_symbol(inline_frame->receiver, n->name); // No definido: el error de siempre
+            } else {
+                if (scoop_pending_count) scoop_resolve_entry(entry);
+                result = entry->value;
+            }
+            if (result.type == VAL_TYPE_STRING) result.as.string_val = mem_strdup(MEM_STRING, result.as.string_val);
             break;
         }
 
+        case NODE_TYPE_COMPARISON_EXPR:
+            /* Comparaciones <, <=, >, >=, = devolviendo entero 0/1, especializadas por tipo */
+            result = eval_comparison((ComparisonExprNode*)node, table);
+            break;
+
+        case NODE_TYPE_BOOLEAN_EXPR:
+            /* not, and, or, and then, or else, implies: ver eval_condition */
+            result.type = VAL_TYPE_BOOLEAN;
+            result.as.int_val = eval_condition(node, table);
+            break;
+
         case NODE_TYPE_IF: {
             /* If: evaluar condición y ejecutar rama correspondiente */
             IfNode *n = (IfNode*)node;
-            RuntimeValue cond = eval_ast(n->condition, table);
-            if (cond.as.int_val != 0) {
+            if (eval_condition(n->condition, table)) {
                 eval_ast((AstNode*)n->then_branch, table);
             } else {
                 eval_ast((AstNode*)n->else_branch, table);
@@ -369,8 +1493,39 @@ RuntimeValue eval_ast(AstNode *node, SymbolTable *table) {
             /* Loop: ejecutar inicializaciones y luego el cuerpo mientras la condición sea falsa (según semántica original) */
             LoopNode *n = (LoopNode*)node;
             eval_ast((AstNode*)n->initialization, table);
-            while(eval_ast(n->condition, table).as.int_val == 0) {
+            while (!eval_condition(n->condition, table)) {
+                METER_STEP(); // Vuelta del loop: cuenta aunque el cuerpo esté vacío
+                eval_ast((AstNode*)n->loop_body, table);
+            }
+            break;
+        }
+
+        case NODE_TYPE_ACROSS: {
+            /* Across sobre un intervalo: el cursor es un INTEGER que toma cada valor de lower a upper.
+               Con 'parallel' (y fuera de otro across paralelo) las iteraciones se reparten en el pool;
+               si el cuerpo no es paralelizable se sigue en secuencia. */
+            AcrossNode *n = (AcrossNode*)node;
+            RuntimeValue lower = eval_ast(n->lower, table);
+            RuntimeValue upper = eval_ast(n->upper, table);
+            if (lower.type != VAL_TYPE_INT || upper.type != VAL_TYPE_INT) {
+                fprintf(stderr, "Error: Los límites de un across deben ser INTEGER.\n");
+                runtime_abort();
+            }
+            if (n->is_parallel && !pool_in_task() && scoop_pending_count) {
+                scoop_resolve_all(); // Los workers del pool no pueden esperar las variables de este hilo
+            }
+            if (n->is_parallel && !pool_in_task()
+                && eval_parallel_across(n, table, lower.as.int_val, upper.as.int_val)) {
+                break;
+            }
+            declare_symbol(table, n->cursor_name, "INTEGER");
+            for (int i = lower.as.int_val; i <= upper.as.int_val; i++) {
+                RuntimeValue cursor = { .type = VAL_TYPE_INT };
+                cursor.as.int_val = i;
+                set_symbol(table, n->cursor_name, cursor);
+                METER_STEP();
                 eval_ast((AstNode*)n->loop_body, table);
+                if (i == upper.as.int_val) break; // Evita desbordar i cuando upper es el máximo INTEGER
             }
             break;
         }
@@ -382,149 +1537,103 @@ RuntimeValue eval_ast(AstNode *node, SymbolTable *table) {
             */
             CreateNode *n = (CreateNode*)node;
             SymbolTableEntry* var_entry = find_symbol_entry(table, n->object_name);
-            if (var_entry && var_entry->value.type == VAL_TYPE_NULL) {
-                SymbolTable* new_object_table = malloc(sizeof(SymbolTable));
-                init_symbol_table(new_object_table);
-
+            if (var_entry && scoop_pending_count) scoop_resolve_entry(var_entry);
+            if (var_entry && var_entry->value.type == VAL_TYPE_NULL && is_array_type(var_entry->type_name)) {
+                // ARRAY predefinido: almacenamiento contiguo, el procedimiento de creación fija los límites
+                RuntimeValue args[MAX_CALL_ARGUMENTS];
+                int arg_count = eval_arguments(n->arguments, table, args);
+                RuntimeValue array_val;
+                array_val.type = VAL_TYPE_ARRAY;
+                array_val.as.array_val = create_array(var_entry->type_name);
+                mem_count_instance(var_entry->type_name, 1);
+                if (n->creation_procedure) {
+                    array_call_feature(array_val.as.array_val, n->creation_procedure, args, arg_count);
+                }
+                release_arguments(args, arg_count);
+                set_symbol(table, n->object_name, array_val);
+            } else if (var_entry && var_entry->value.type == VAL_TYPE_NULL && is_file_type(var_entry->type_name)) {
+                // PLAIN_TEXT_FILE predefinido: el procedimiento de creación abre el archivo
+                RuntimeValue args[MAX_CALL_ARGUMENTS];
+                int arg_count = eval_arguments(n->arguments, table, args);
+                RuntimeValue file_val;
+                file_val.type = VAL_TYPE_FILE;
+                file_val.as.file_val = create_file();
+                mem_count_instance(var_entry->type_name, 1);
+                set_symbol(table, n->object_name, file_val);
+                if (n->creation_procedure) {
+                    file_call_feature(file_val.as.file_val, n->creation_procedure, args, arg_count);
+                }
+                release_arguments(args, arg_count);
+            } else if (var_entry && var_entry->value.type == VAL_TYPE_NULL) {
                 // Determinar la clase a instanciar: si la variable tiene type_name en la tabla de símbolos la usamos
                 const char* class_name_to_find = NULL;
+                int separate = is_separate_type(var_entry->type_name);
                 if (var_entry->type_name) {
-                    class_name_to_find = var_entry->type_name;
+                    class_name_to_find = separate_base_type(var_entry->type_name);
                 } else {
                     // Por compatibilidad, intentar COUNTER por defecto (antiguo comportamiento)
                     class_name_to_find = "COUNTER";
                 }
 
-                ClassDefinition* class_def = find_class(class_name_to_find);
+                ClassDefinition* class_def;
+                FeatureBodyNode* creation_method = resolve_feature(class_name_to_find, n->creation_procedure,
+                                                                   n->bound_class, n->bound_feature, &class_def);
+                SymbolTable* new_object_table;
+                if (n->frame_slot >= 0 && table->frame_objects && !separate) {
+                    // No escapa del método: vive en el frame de la llamada (ver invoke_method)
+                    new_object_table = &table->frame_objects[n->frame_slot];
+                } else {
+                    new_object_table = new_object(class_def);
+                }
+                init_symbol_table(new_object_table);
                 if (class_def) {
-                    new_object_table->owner_class_name = strdup(class_def->name);
-                    StatementListNode* feature = class_def->feature_list;
-                    while(feature) {
-                        if (feature->statement->type == NODE_TYPE_DECLARATION_LIST) {
-                            DeclarationListNode* decl = (DeclarationListNode*)feature->statement;
-                            while(decl) {
-                                // Registrar atributo en la tabla del objeto con su tipo
-                                declare_symbol(new_object_table, decl->variable_name, decl->type_name);
-                                // Inicialización por defecto según tipo conocido
-                                RuntimeValue init_val;
-                                if (decl->type_name && strcmp(decl->type_name, "INTEGER") == 0) {
-                                    init_val.type = VAL_TYPE_INT;
-                                    init_val.as.int_val = 0;
-                                    set_symbol(new_object_table, decl->variable_name, init_val);
-                                } else if (decl->type_name && strcmp(decl->type_name, "REAL") == 0) {
-                                    init_val.type = VAL_TYPE_REAL;
-                                    init_val.as.real_val = 0.0;
-                                    set_symbol(new_object_table, decl->variable_name, init_val);
-                                } else if (decl->type_name && strcmp(decl->type_name, "STRING") == 0) {
-                                    init_val.type = VAL_TYPE_STRING;
-                                    init_val.as.string_val = strdup("");
-                                    set_symbol(new_object_table, decl->variable_name, init_val);
-                                } else {
-                                    // Por defecto: dejar VAL_TYPE_NULL (referencias a objetos)
-                                    // ya fue declarado como NULL por declare_symbol
-                                }
-                                decl = decl->next;
-                            }
-                        }
-                        feature = feature->next;
-                    }
+                    mem_count_instance(class_def->name, 1);
+                    instantiate_prototype(new_object_table, class_def);
                 }
+                if (separate) scoop_attach(new_object_table);
 
                 RuntimeValue obj_val;
                 obj_val.type = VAL_TYPE_OBJECT;
                 obj_val.as.object_val = new_object_table;
                 set_symbol(table, n->object_name, obj_val);
-            }
-            break;
-        }
 
-        case NODE_TYPE_ATTRIBUTE_ACCESS: {
-            /* Attribute access: si el nombre corresponde a un método, devolvemos un método sin ejecutar;
-               si es atributo, obtenemos su valor desde la tabla del objeto.
-               Nota: aquí también se busca el método en la definición de la clase.
-            */
-            AttributeAccessNode *n = (AttributeAccessNode*)node;
-            RuntimeValue object_val = eval_ast(n->object_node, table);
-            if (object_val.type == VAL_TYPE_OBJECT) {
-                SymbolTable* obj_table = object_val.as.object_val;
-                ClassDefinition* class_def = find_class(obj_table->owner_class_name);
-
-                // Buscar si es un método
-                FeatureBodyNode* method_node = NULL;
-                if (class_def) {
-                    StatementListNode* feature = class_def->feature_list;
-                    while(feature) {
-                        if (feature->statement->type == NODE_TYPE_FEATURE_BODY) {
-                            FeatureBodyNode* f_node = (FeatureBodyNode*)feature->statement;
-                            if (f_node->feature_name && strcmp(f_node->feature_name, n->attribute_name) == 0) {
-                                method_node = f_node;
-                                break;
-                            }
-                        }
-                        feature = feature->next;
+                // Procedimiento de creación (create c.make): se ejecuta como un método del objeto nuevo
+                if (creation_method) {
+                    RuntimeValue args[MAX_CALL_ARGUMENTS];
+                    int arg_count = eval_arguments(n->arguments, table, args);
+                    if (separate) {
+                        // Primer pedido del procesador nuevo: el que crea sigue sin esperar
+                        scoop_call(class_def, creation_method, new_object_table, args, arg_count, NULL, NULL);
+                    } else {
+                        RuntimeValue discarded = invoke_method(class_def, creation_method, new_object_table, args, arg_count);
+                        if (discarded.type == VAL_TYPE_STRING) mem_free(MEM_STRING, discarded.as.string_val);
                     }
-                }
-
-                if (method_node) { // Es una llamada a método sin argumentos
-                    SymbolTable method_scope;
-                    init_symbol_table(&method_scope);
-                    method_scope.parent = obj_table;
-                    eval_ast((AstNode*)method_node, &method_scope);
-                    // Los métodos sin 'Result' devuelven void.
-                    result.type = VAL_TYPE_VOID;
-                } else { // Es un acceso a atributo
-                    result = get_symbol(obj_table, n->attribute_name);
+                    release_arguments(args, arg_count);
                 }
             }
             break;
         }
 
-        case NODE_TYPE_METHOD_CALL: {
-            /* Method call: buscar el FeatureBodyNode en la definición de la clase, crear un método_scope
-               cuyo parent es la tabla del objeto (permite acceso a atributos vía get_symbol) y ejecutar el cuerpo.
-            */
-            MethodCallNode *n = (MethodCallNode*)node;
-            RuntimeValue object_val = eval_ast(n->object_node, table);
-            if (object_val.type != VAL_TYPE_OBJECT) break;
-
-            SymbolTable* obj_table = object_val.as.object_val;
-            ClassDefinition* class_def = find_class(obj_table->owner_class_name);
-            if (!class_def) break;
-
-            StatementListNode* feature = class_def->feature_list;
-            FeatureBodyNode* method_node = NULL;
-            while(feature) {
-                if (feature->statement->type == NODE_TYPE_FEATURE_BODY) {
-                    FeatureBodyNode* f_node = (FeatureBodyNode*)feature->statement;
-                    if (f_node->feature_name && strcmp(f_node->feature_name, n->method_name) == 0) {
-                        method_node = f_node;
-                        break;
-                    }
-                }
-                feature = feature->next;
-            }
+        case NODE_TYPE_ATTRIBUTE_ACCESS:
+            result = eval_attribute_access((AttributeAccessNode*)node, table, NULL, NULL);
+            break;
 
-            if (method_node) {
-                SymbolTable method_scope;
-                init_symbol_table(&method_scope);
-                method_scope.parent = obj_table;
-                eval_ast((AstNode*)method_node, &method_scope);
-            }
+        case NODE_TYPE_METHOD_CALL:
+            result = eval_method_call((MethodCallNode*)node, table, NULL, NULL);
             break;
-        }
 
         case NODE_TYPE_FEATURE_BODY: {
             /* Ejecutar un feature/método:
-               - declarar variables locales y parámetros en la tabla pasada (tabla puede ser método_scope).
+               - declarar variables locales en la tabla pasada (tabla puede ser método_scope).
                - ejecutar las sentencias del cuerpo.
-               - Si se soportara 'Result', aquí se leería/retornaría.
+               - Parámetros y 'Result' los declara y lee invoke_method.
             */
             FeatureBodyNode *body_node = (FeatureBodyNode*) node;
+            load_feature_body(body_node); // MAIN.make no pasa por resolve_feature
             DeclarationListNode *decls = body_node->declarations;
-            while (decls) {
+            for (int i = 0; decls && i < decls->count; i++) {
                 // Ahora pasamos el type_name al declarar variables locales / parámetros
-                declare_symbol(table, decls->variable_name, decls->type_name);
-                decls = decls->next;
+                declare_symbol(table, decls->items[i].variable_name, decls->items[i].type_name);
             }
             eval_ast((AstNode*)body_node->statements, table);
             break;
@@ -1,17 +1,19 @@
 #ifndef INTERPRETER_H
 #define INTERPRETER_H
 
+#include <setjmp.h>
 #include "ast.h"
 
 #define MAX_SYMBOLS 100
-#define MAX_CLASSES 10
 
 struct SymbolTable;
+struct EiffelArray;
+struct EiffelFile;
 
 /* Comentario general:
    - Define los tipos de valores en tiempo de ejecución y la estructura de la tabla de símbolos.
    - La tabla de símbolos puede tener un padre para modelar scope en métodos (encadenamiento).
-   - También se mantiene una tabla global de definiciones de clase.
+   - También se mantiene una tabla global de definiciones de clase (sin límite, indexada por nombre).
 */
 
 // Tipos de valores en tiempo de ejecución
@@ -21,7 +23,10 @@ typedef enum {
     VAL_TYPE_STRING,
     VAL_TYPE_VOID,
     VAL_TYPE_OBJECT,
-    VAL_TYPE_NULL // Para variables declaradas pero no inicializadas
+    VAL_TYPE_ARRAY, // Instancia de ARRAY [INTEGER] / ARRAY [REAL] (ver array.h)
+    VAL_TYPE_NULL, // Para variables declaradas pero no inicializadas
+    VAL_TYPE_FILE, // Instancia de PLAIN_TEXT_FILE (ver eiffel_io.h)
+    VAL_TYPE_BOOLEAN // True/False en int_val (1/0): comparaciones y operadores BOOLEAN
 } ValueType;
 
 /* RuntimeValue: representa un valor en ejecución (primitivo o referencia a objeto) */
@@ -32,6 +37,8 @@ typedef struct {
         double real_val;
         char *string_val;
         struct SymbolTable* object_val; // Puntero a la tabla de símbolos del objeto
+        struct EiffelArray* array_val;  // Puntero al ARRAY predefinido
+        struct EiffelFile* file_val;    // Puntero al PLAIN_TEXT_FILE predefinido
     } as;
 } RuntimeValue;
 
@@ -46,25 +53,55 @@ typedef struct {
     char *type_name; // tipo declarado
 } SymbolTableEntry;
 
+/* Resultado guardado de una rutina once: vale solo si feature es la rutina que se llama
+   (así un lugar que quedó de una definición anterior de la clase cuenta como vacío). */
+typedef struct {
+    FeatureBodyNode* feature;
+    RuntimeValue value;
+} OnceResult;
+
 /* Tabla de símbolos:
    - entries almacena variables/atributos locales o de objeto
    - parent apunta al scope externo (por ejemplo, el objeto al ejecutar un método)
    - owner_class_name señala si esta tabla representa un objeto de clase X
+   - frame_objects: en el scope de un método, los objetos que no escapan de él (ver escape.h)
+   - once_results: en un objeto, los resultados de sus rutinas once ("OBJECT"), por once_index
+   - shared_entries: en un objeto, las primeras entradas copiadas del prototipo de su clase; sus
+     nombres y tipos son del AST (internados) y no se liberan con el objeto
+   - owner_class_name está internado (ver intern.h): nadie lo libera
+   - processor: en un objeto separate, el procesador que ejecuta todo lo que se le pide (ver scoop.h)
 */
+struct Processor;
+
 typedef struct SymbolTable {
     SymbolTableEntry entries[MAX_SYMBOLS];
     int count;
+    int shared_entries;
     struct SymbolTable* parent;
     char* owner_class_name;
+    struct SymbolTable* frame_objects;
+    OnceResult* once_results;
+    int once_count;
+    struct Processor* processor;
 } SymbolTable;
 
-/* Definición de clase: nombre y AST con features (atributos/métodos) */
-typedef struct {
+struct ObjectSlab;
+
+/* Definición de clase: nombre (internado) y AST con features (atributos/métodos).
+   once_results guarda el resultado de cada rutina once de la clase (índice: once_index).
+   prototype: los atributos con su valor por defecto, armados al registrar la clase; 'create' los
+   copia de una vez. slabs: bloques de los que salen los objetos de la clase (ver new_object). */
+typedef struct ClassDefinition {
     char* name;
     StatementListNode* feature_list;
+    OnceResult* once_results;
+    int once_count;
+    SymbolTableEntry* prototype;
+    int prototype_count;
+    struct ObjectSlab* slabs;
 } ClassDefinition;
 
-extern ClassDefinition class_table[MAX_CLASSES];
+extern ClassDefinition **class_table;
 extern int class_count;
 
 // --- Prototipos de funciones del intérprete ---
@@ -78,7 +115,34 @@ SymbolTableEntry* find_symbol_entry(SymbolTable *table, const char *name);
 
 // Funciones de gestión de clases
 void register_class(const char* name, StatementListNode* features);
+void redefine_class(const char* name, StatementListNode* features); // Reemplaza las features si la clase ya existe (REPL)
+void retain_classes(const unsigned char* keep); // Deja solo las clases con keep[i] (índice en class_table)
 ClassDefinition* find_class(const char* name);
+void init_object_attributes(SymbolTable* object_table, ClassDefinition* class_def);
+
+/* new_object: tabla para un objeto nuevo de class_def (NULL: clase desconocida), sin inicializar.
+   Sale del pool de la clase; instantiate_prototype le pone los atributos por defecto. */
+SymbolTable* new_object(ClassDefinition* class_def);
+void instantiate_prototype(SymbolTable* object_table, ClassDefinition* class_def);
+void register_classes_from_ast(AstNode* node);
+FeatureBodyNode* find_feature(StatementListNode* feature_list, const char* feature_name);
+
+/* find_current_feature: rutina de la clase del objeto actual (Current; en MAIN.make, la clase MAIN)
+   que resolvería una llamada sin objeto a name, o NULL. */
+FeatureBodyNode* find_current_feature(SymbolTable* table, const char* name);
+
+/* load_feature_body: parsea el cuerpo diferido de feature si todavía no se parseó (ver frontend.h);
+   un error de sintaxis en el cuerpo es un error de ejecución. */
+void load_feature_body(FeatureBodyNode* feature);
+
+/* Manejo de errores en tiempo de ejecución:
+   - Por defecto un error termina el proceso con exit(1).
+   - Si runtime_error_handler apunta a un jmp_buf (p. ej. el REPL), se vuelve allí con longjmp
+     para que la sesión siga viva.
+   - El handler es por hilo: cada worker de un across paralelo instala el suyo.
+*/
+extern _Thread_local jmp_buf *runtime_error_handler;
+void runtime_abort(void);
 
 // Función para imprimir valores
 void print_value(RuntimeValue value);
@@ -89,4 +153,14 @@ void print_symbol_table(SymbolTable *table, FILE *output);
 // Función principal de evaluación del AST
 RuntimeValue eval_ast(AstNode *node, SymbolTable *table);
 
+// Ejecuta method sobre el objeto obj_table con args (ya evaluados) y devuelve su 'Result'
+RuntimeValue invoke_method(ClassDefinition *class_def, FeatureBodyNode *method, SymbolTable *obj_table,
+                           RuntimeValue *args, int arg_count);
+
+// Ejecuta entry sobre un scope global ya armado (p. ej. restaurado de una imagen); vuelca el estado final en info_output
+int run_in_scope(AstNode* entry, SymbolTable* global_scope, FILE* info_output);
+
+// Registra las clases de un programa parseado y ejecuta MAIN.make (o la raíz); vuelca el estado final en info_output
+int run_program(AstNode* root, FILE* info_output);
+
 #endif // INTERPRETER_H
@@ -0,0 +1,438 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ast.h"
+#include "interpreter.h"
+#include "array.h"
+#include "eiffel_io.h"
+#include "link.h"
+#include "inline.h"
+#include "scoop.h"
+
+/* Comentario general:
+   - Los nombres llamados y las clases alcanzables se guardan en conjuntos de strings (tabla hash
+     con direccionamiento abierto; los strings son del AST y no se copian).
+   - Punto fijo: en cada vuelta se recorren las clases alcanzables y se analiza cada rutina cuyo
+     nombre ya se llamó y que todavía no se analizó. Analizar una rutina agrega nombres y clases;
+     se repite hasta que una vuelta no agrega nada. Cada rutina se analiza (y enlaza) una sola vez.
+   - find_class puede cargar archivos del class path durante el enlace: class_table crece y las
+     clases nuevas se recorren en la misma vuelta.
+*/
+
+#define LINK_MAX_CURSORS 32
+
+typedef struct {
+    const char **slots;
+    size_t slot_count;
+    size_t count;
+} NameSet;
+
+typedef struct {
+    NameSet called;          // Nombres de rutinas llamadas (con o sin objeto, o como creación)
+    NameSet classes;         // Clases alcanzables
+    unsigned char **scanned; // Por clase (índice en class_table) y posición en su feature_list
+    int scanned_count;
+    int bound_calls;
+} Linker;
+
+// Lo que se sabe del código que se analiza: para los tipos estáticos de las variables
+typedef struct {
+    ClassDefinition *class_def;
+    FeatureBodyNode *routine;
+    DeclarationListNode *globals; // Locales de MAIN.make: el scope global de la ejecución
+    const char *cursors[LINK_MAX_CURSORS];
+    int cursor_count;
+} LinkContext;
+
+static size_t name_hash(const char *name) {
+    size_t hash = 2166136261u; // FNV-1a
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash;
+}
+
+static int name_set_has(const NameSet *set, const char *name) {
+    if (set->slot_count == 0) return 0;
+    size_t mask = set->slot_count - 1;
+    for (size_t i = name_hash(name) & mask; set->slots[i]; i = (i + 1) & mask) {
+        if (strcmp(set->slots[i], name) == 0) return 1;
+    }
+    return 0;
+}
+
+static void name_set_put(NameSet *set, const char *name) {
+    size_t mask = set->slot_count - 1;
+    size_t i = name_hash(name) & mask;
+    while (set->slots[i]) i = (i + 1) & mask;
+    set->slots[i] = name;
+}
+
+// Agrega name; devuelve 1 si no estaba
+static int name_set_add(NameSet *set, const char *name) {
+    if (name_set_has(set, name)) return 0;
+    if ((set->count + 1) * 2 > set->slot_count) {
+        NameSet grown = { NULL, set->slot_count ? set->slot_count * 2 : 64, 0 };
+        grown.slots = calloc(grown.slot_count, sizeof(const char *));
+        for (size_t i = 0; i < set->slot_count; i++) {
+            if (set->slots[i]) name_set_put(&grown, set->slots[i]);
+        }
+        free(set->slots);
+        set->slots = grown.slots;
+        set->slot_count = grown.slot_count;
+    }
+    name_set_put(set, name);
+    set->count++;
+    return 1;
+}
+
+static int is_user_type(const char *type_name) {
+    return type_name
+        && strcmp(type_name, "INTEGER") != 0
+        && strcmp(type_name, "REAL") != 0
+        && strcmp(type_name, "STRING") != 0
+        && strcmp(type_name, "BOOLEAN") != 0
+        && !is_array_type(type_name)
+        && !is_file_type(type_name);
+}
+
+// Clase del programa con ese tipo declarado (NULL si es un tipo predefinido o desconocido)
+static ClassDefinition *user_class(const char *type_name) {
+    type_name = separate_base_type(type_name);
+    return is_user_type(type_name) ? find_class(type_name) : NULL;
+}
+
+static Declaration *find_declaration(DeclarationListNode *decls, const char *name) {
+    for (int i = 0; decls && i < decls->count; i++) {
+        if (strcmp(decls->items[i].variable_name, name) == 0) return &decls->items[i];
+    }
+    return NULL;
+}
+
+static Declaration *find_attribute(ClassDefinition *class_def, const char *name) {
+    StatementListNode *features = class_def->feature_list;
+    for (int i = 0; features && i < features->count; i++) {
+        if (features->statements[i]->type != NODE_TYPE_DECLARATION_LIST) continue;
+        Declaration *decl = find_declaration((DeclarationListNode *)features->statements[i], name);
+        if (decl) return decl;
+    }
+    return NULL;
+}
+
+/* variable_type: tipo declarado de una variable visible desde el código de ctx, en el orden en que
+   la busca el intérprete (cursores, Result, argumentos, locales, atributos, globales). Devuelve 0
+   si el nombre no es una variable conocida; *type queda en NULL si se declaró sin tipo. */
+static int variable_type(LinkContext *ctx, const char *name, const char **type) {
+    *type = NULL;
+    for (int i = ctx->cursor_count - 1; i >= 0; i--) {
+        if (strcmp(ctx->cursors[i], name) == 0) {
+            *type = "INTEGER";
+            return 1;
+        }
+    }
+    if (strcmp(name, "Current") == 0) {
+        *type = ctx->class_def->name;
+        return 1;
+    }
+    if (ctx->routine->result_type && strcmp(name, "Result") == 0) {
+        *type = ctx->routine->result_type;
+        return 1;
+    }
+    Declaration *decl = find_declaration(ctx->routine->parameters, name);
+    if (!decl) decl = find_declaration(ctx->routine->declarations, name);
+    if (!decl) decl = find_attribute(ctx->class_def, name);
+    if (!decl) decl = find_declaration(ctx->globals, name);
+    if (!decl) return 0;
+    *type = decl->type_name;
+    return 1;
+}
+
+// Tipo del valor de feature_name en un objeto de class_def: atributo o resultado de una función
+static const char *feature_type(ClassDefinition *class_def, const char *feature_name) {
+    Declaration *decl = find_attribute(class_def, feature_name);
+    if (decl) return decl->type_name;
+    FeatureBodyNode *routine = find_feature(class_def->feature_list, feature_name);
+    return routine ? routine->result_type : NULL;
+}
+
+// Tipo estático de una expresión, si el texto lo dice (NULL si no se sabe)
+static const char *expression_type(LinkContext *ctx, AstNode *node) {
+    if (!node) return NULL;
+    switch (node->type) {
+        case NODE_TYPE_VARIABLE: {
+            const char *type;
+            if (variable_type(ctx, ((VariableNode *)node)->name, &type)) return type;
+            return feature_type(ctx->class_def, ((VariableNode *)node)->name);
+        }
+        case NODE_TYPE_PROCEDURE_CALL:
+            return feature_type(ctx->class_def, ((ProcedureCallNode *)node)->name);
+        case NODE_TYPE_ATTRIBUTE_ACCESS: {
+            AttributeAccessNode *n = (AttributeAccessNode *)node;
+            ClassDefinition *receiver = user_class(expression_type(ctx, n->object_node));
+            return receiver ? feature_type(receiver, n->attribute_name) : NULL;
+        }
+        case NODE_TYPE_METHOD_CALL: {
+            MethodCallNode *n = (MethodCallNode *)node;
+            ClassDefinition *receiver = user_class(expression_type(ctx, n->object_node));
+            return receiver ? feature_type(receiver, n->method_name) : NULL;
+        }
+        default:
+            return NULL;
+    }
+}
+
+/* bind_call: llamada a feature_name sobre un objeto cuya clase dice el texto. La clase queda
+   alcanzable y, si feature_name es una rutina, la llamada se enlaza. */
+static void bind_call(Linker *linker, ClassDefinition *receiver, const char *feature_name,
+                      ClassDefinition **bound_class, FeatureBodyNode **bound_feature) {
+    if (!receiver) return;
+    name_set_add(&linker->classes, receiver->name);
+    FeatureBodyNode *routine = find_feature(receiver->feature_list, feature_name);
+    if (!routine) return;
+    *bound_class = receiver;
+    *bound_feature = routine;
+    linker->bound_calls++;
+}
+
+static void scan_node(Linker *linker, LinkContext *ctx, AstNode *node);
+
+static void scan_arguments(Linker *linker, LinkContext *ctx, ArgumentListNode *args) {
+    for (int i = 0; args && i < args->count; i++) scan_node(linker, ctx, args->arguments[i]);
+}
+
+static void scan_statements(Linker *linker, LinkContext *ctx, StatementListNode *list) {
+    for (int i = 0; list && i < list->count; i++) scan_node(linker, ctx, list->statements[i]);
+}
+
+static void scan_node(Linker *linker, LinkContext *ctx, AstNode *node) {
+    if (!node) return;
+    switch (node->type) {
+        case NODE_TYPE_BINARY_EXPR:
+            scan_node(linker, ctx, ((BinaryExprNode *)node)->left);
+            scan_node(linker, ctx, ((BinaryExprNode *)node)->right);
+            break;
+        case NODE_TYPE_COMPARISON_EXPR:
+            scan_node(linker, ctx, ((ComparisonExprNode *)node)->left);
+            scan_node(linker, ctx, ((ComparisonExprNode *)node)->right);
+            break;
+        case NODE_TYPE_BOOLEAN_EXPR:
+            scan_node(linker, ctx, ((BooleanExprNode *)node)->left);
+            scan_node(linker, ctx, ((BooleanExprNode *)node)->right);
+            break;
+        case NODE_TYPE_STATEMENT_LIST:
+            scan_statements(linker, ctx, (StatementListNode *)node);
+            break;
+        case NODE_TYPE_PROCEDURE_CALL: {
+            // Sin objeto: una rutina de la clase de Current (o print...)
+            ProcedureCallNode *n = (ProcedureCallNode *)node;
+            name_set_add(&linker->called, n->name);
+            bind_call(linker, ctx->class_def, n->name, &n->bound_class, &n->bound_feature);
+            scan_arguments(linker, ctx, n->arguments);
+            break;
+        }
+        case NODE_TYPE_ASSIGN: {
+            AssignNode *n = (AssignNode *)node;
+            if (n->target->type == NODE_TYPE_ATTRIBUTE_ACCESS) {
+                // obj.a := e escribe el atributo: no llama a nada
+                scan_node(linker, ctx, ((AttributeAccessNode *)n->target)->object_node);
+            }
+            scan_node(linker, ctx, n->expression);
+            break;
+        }
+        case NODE_TYPE_VARIABLE: {
+            // Un nombre que no es variable puede ser una rutina de Current sin argumentos
+            const char *type;
+            VariableNode *n = (VariableNode *)node;
+            if (!variable_type(ctx, n->name, &type)) name_set_add(&linker->called, n->name);
+            break;
+        }
+        case NODE_TYPE_IF: {
+            IfNode *n = (IfNode *)node;
+            scan_node(linker, ctx, n->condition);
+            scan_statements(linker, ctx, n->then_branch);
+            scan_statements(linker, ctx, n->else_branch);
+            break;
+        }
+        case NODE_TYPE_LOOP: {
+            LoopNode *n = (LoopNode *)node;
+            scan_statements(linker, ctx, n->initialization);
+            scan_node(linker, ctx, n->condition);
+            scan_statements(linker, ctx, n->loop_body);
+            break;
+        }
+        case NODE_TYPE_ACROSS: {
+            AcrossNode *n = (AcrossNode *)node;
+            scan_node(linker, ctx, n->lower);
+            scan_node(linker, ctx, n->upper);
+            // Más cursores anidados que LINK_MAX_CURSORS: el cursor queda con tipo desconocido
+            int pushed = ctx->cursor_count < LINK_MAX_CURSORS;
+            if (pushed) ctx->cursors[ctx->cursor_count++] = n->cursor_name;
+            scan_statements(linker, ctx, n->loop_body);
+            if (pushed) ctx->cursor_count--;
+            break;
+        }
+        case NODE_TYPE_ATTRIBUTE_ACCESS: {
+            AttributeAccessNode *n = (AttributeAccessNode *)node;
+            scan_node(linker, ctx, n->object_node);
+            name_set_add(&linker->called, n->attribute_name);
+            bind_call(linker, user_class(expression_type(ctx, n->object_node)), n->attribute_name,
+                      &n->bound_class, &n->bound_feature);
+            break;
+        }
+        case NODE_TYPE_METHOD_CALL: {
+            MethodCallNode *n = (MethodCallNode *)node;
+            scan_node(linker, ctx, n->object_node);
+            name_set_add(&linker->called, n->method_name);
+            bind_call(linker, user_class(expression_type(ctx, n->object_node)), n->method_name,
+                      &n->bound_class, &n->bound_feature);
+            scan_arguments(linker, ctx, n->arguments);
+            break;
+        }
+        case NODE_TYPE_CREATE: {
+            CreateNode *n = (CreateNode *)node;
+            const char *type;
+            // Una variable sin tipo crea un COUNTER (ver NODE_TYPE_CREATE en interpreter.c)
+            if (!variable_type(ctx, n->object_name, &type) || !type) type = "COUNTER";
+            ClassDefinition *class_def = user_class(type);
+            if (class_def) {
+                name_set_add(&linker->classes, class_def->name);
+                FeatureBodyNode *creation = n->creation_procedure
+                    ? find_feature(class_def->feature_list, n->creation_procedure) : NULL;
+                if (!n->creation_procedure || creation) {
+                    n->bound_class = class_def;
+                    n->bound_feature = creation;
+                    linker->bound_calls++;
+                }
+            }
+            if (n->creation_procedure) name_set_add(&linker->called, n->creation_procedure);
+            scan_arguments(linker, ctx, n->arguments);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// Lugar de "ya analizada" de cada feature de la clase index (class_table crece durante el enlace)
+static unsigned char *scanned_flags(Linker *linker, int index) {
+    if (index >= linker->scanned_count) {
+        linker->scanned = realloc(linker->scanned, class_count * sizeof(unsigned char *));
+        for (int i = linker->scanned_count; i < class_count; i++) {
+            StatementListNode *features = class_table[i]->feature_list;
+            linker->scanned[i] = calloc(features && features->count ? features->count : 1, 1);
+        }
+        linker->scanned_count = class_count;
+    }
+    return linker->scanned[index];
+}
+
+static void scan_routine(Linker *linker, ClassDefinition *class_def, FeatureBodyNode *routine,
+                         DeclarationListNode *globals) {
+    LinkContext ctx = { .class_def = class_def, .routine = routine, .globals = globals, .cursor_count = 0 };
+    load_feature_body(routine); // Un cuerpo diferido se parsea al alcanzarlo (--emit-c enlaza igual)
+    scan_statements(linker, &ctx, routine->statements);
+}
+
+static int class_index(ClassDefinition *class_def) {
+    for (int i = 0; i < class_count; i++) {
+        if (class_table[i] == class_def) return i;
+    }
+    return -1;
+}
+
+// Una vuelta del punto fijo; devuelve 1 si analizó alguna rutina nueva
+static int link_round(Linker *linker, DeclarationListNode *globals) {
+    int progress = 0;
+    for (int c = 0; c < class_count; c++) { // class_count puede crecer dentro del recorrido
+        ClassDefinition *class_def = class_table[c];
+        if (!name_set_has(&linker->classes, class_def->name)) continue;
+        StatementListNode *features = class_def->feature_list;
+        for (int i = 0; features && i < features->count; i++) {
+            if (features->statements[i]->type != NODE_TYPE_FEATURE_BODY) continue;
+            FeatureBodyNode *routine = (FeatureBodyNode *)features->statements[i];
+            unsigned char *scanned = scanned_flags(linker, c);
+            if (scanned[i] || !name_set_has(&linker->called, routine->feature_name)) continue;
+            scanned[i] = 1;
+            scan_routine(linker, class_def, routine, globals);
+            progress = 1;
+        }
+    }
+    return progress;
+}
+
+/* prune_class: deja en la clase los atributos y las rutinas analizadas (todas las features si la
+   clase no es alcanzable salen). Devuelve cuántas rutinas quedan y suma las que había en *total. */
+static int prune_class(ClassDefinition *class_def, unsigned char *scanned, int reachable, int *total) {
+    StatementListNode *features = class_def->feature_list;
+    int kept = 0, routines = 0;
+    for (int i = 0; features && i < features->count; i++) {
+        AstNode *feature = features->statements[i];
+        int is_routine = feature->type == NODE_TYPE_FEATURE_BODY;
+        if (is_routine) (*total)++;
+        if (reachable && (!is_routine || scanned[i])) {
+            features->statements[kept++] = feature;
+            routines += is_routine;
+        } else {
+            free_ast(feature);
+        }
+    }
+    if (features && kept != features->count) {
+        features->count = kept;
+        // Renumera los once que quedan e invalida el análisis de escape
+        if (reachable) redefine_class(class_def->name, features);
+    }
+    return routines;
+}
+
+void link_program(int keep_main_routines, FILE *info_output) {
+    const char *env = getenv("EIFFEL_NO_LINK");
+    if (env && *env && strcmp(env, "0") != 0) return;
+
+    ClassDefinition *main_class = find_class("MAIN");
+    FeatureBodyNode *make = main_class ? find_feature(main_class->feature_list, "make") : NULL;
+    if (!make) return;
+
+    Linker linker = { 0 };
+    name_set_add(&linker.classes, main_class->name);
+    int main_index = class_index(main_class);
+    StatementListNode *main_features = main_class->feature_list;
+    for (int i = 0; i < main_features->count; i++) {
+        AstNode *feature = main_features->statements[i];
+        if (feature->type != NODE_TYPE_FEATURE_BODY) continue;
+        if ((FeatureBodyNode *)feature != make && !keep_main_routines) continue;
+        scanned_flags(&linker, main_index)[i] = 1;
+        scan_routine(&linker, main_class, (FeatureBodyNode *)feature, make->declarations);
+    }
+    while (link_round(&linker, make->declarations)) {
+    }
+
+    int total_classes = class_count, total_routines = 0, kept_routines = 0;
+    unsigned char *keep = malloc(class_count ? class_count : 1);
+    for (int c = 0; c < class_count; c++) {
+        keep[c] = (unsigned char)name_set_has(&linker.classes, class_table[c]->name);
+        kept_routines += prune_class(class_table[c], scanned_flags(&linker, c), keep[c], &total_routines);
+    }
+    retain_classes(keep);
+
+    // Rutinas chicas en línea (ver inline.h); EIFFEL_NO_INLINE=1 las deja como llamadas normales
+    int inlined = 0;
+    const char *no_inline = getenv("EIFFEL_NO_INLINE");
+    if (!(no_inline && *no_inline && strcmp(no_inline, "0") != 0)) {
+        for (int c = 0; c < class_count; c++) inlined += inline_mark_class(class_table[c]);
+    }
+
+    if (info_output) {
+        fprintf(info_output, "--- Link ---\n");
+        fprintf(info_output, "  %-12s %d / %d\n", "classes", class_count, total_classes);
+        fprintf(info_output, "  %-12s %d / %d\n", "routines", kept_routines, total_routines);
+        fprintf(info_output, "  %-12s %d\n", "bound calls", linker.bound_calls);
+        fprintf(info_output, "  %-12s %d\n", "inlined", inlined);
+        fprintf(info_output, "------------\n");
+    }
+
+    free(keep);
+    for (int c = 0; c < linker.scanned_count; c++) free(linker.scanned[c]);
+    free(linker.scanned);
+    free(linker.called.slots);
+    free(linker.classes.slots);
+}
@@ -0,0 +1,33 @@
+#ifndef LINK_H
+#define LINK_H
+
+#include <stdio.h>
+#include "interpreter.h"
+
+/* Comentario general:
+   - Enlace del programa completo, entre el registro de clases y la ejecución de MAIN.make.
+   - Calcula las clases y rutinas alcanzables desde MAIN.make (o desde todas las rutinas de MAIN si
+     se va a guardar una imagen, porque la imagen puede ejecutar cualquiera de ellas):
+       * una clase es alcanzable si algún 'create' alcanzable la instancia (tipo declarado de la
+         variable) o si una llamada alcanzable tiene un objeto de esa clase (tipo estático).
+       * una rutina es alcanzable si su nombre se llama desde código alcanzable (con o sin objeto)
+         y su clase es alcanzable. Se marca por nombre y no por clase: sin herencia ni verificación
+         de tipos, un objeto puede terminar en una variable de otro tipo declarado.
+   - Las rutinas no alcanzables se liberan y las clases no alcanzables salen del registro. Los
+     atributos se conservan siempre (definen la forma de los objetos).
+   - Cada llamada cuyo objeto tiene una clase conocida en el texto (variable, atributo o resultado
+     declarado, Current, llamada sin objeto) queda enlazada a su ClassDefinition y FeatureBodyNode
+     (campos bound_* del AST). Al ejecutar, resolve_feature usa el enlace si el objeto es de esa
+     clase y, si no, busca como siempre.
+   - Al final marca las rutinas chicas que se ejecutan en línea (ver inline.h).
+   - El REPL no enlaza: sus clases cambian entre entradas. EIFFEL_NO_LINK=1 lo desactiva también
+     en los programas (mismos resultados), y con '--lazy-bodies' run_program tampoco enlaza: el
+     recorrido parsearía al arrancar todos los cuerpos alcanzables (ver frontend.h). --emit-c sí
+     enlaza; cada rutina alcanzada se parsea antes de recorrerla.
+*/
+
+/* link_program: enlaza las clases registradas. keep_main_routines: raíces = todas las rutinas de
+   MAIN. Escribe un resumen en info_output (si no es NULL). */
+void link_program(int keep_main_routines, FILE *info_output);
+
+#endif // LINK_H
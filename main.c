@@ -4,25 +4,125 @@
 #include "ast.h"
 #include "interpreter.h"
 #include "token_utils.h"
-
-extern FILE *yyin;
-extern int yyparse(AstNode **root);
-
-FeatureBodyNode* find_feature(StatementListNode* feature_list, const char* feature_name);
-void register_classes_from_ast(AstNode* node);
+#include "repl.h"
+#include "server.h"
+#include "output.h"
+#include "classpath.h"
+#include "memstats.h"
+#include "meter.h"
+#include "image.h"
+#include "heapdump.h"
+#include "frontend.h"
+#include "intern.h"
+#include "emit.h"
 
 FILE *info_file_ptr = NULL;
 
 /* Comentario:
    - main.c orquesta el proceso: abre el archivo, crea un .info para tokens/AST,
      parsea con Bison, registra clases, y ejecuta MAIN.make si existe.
+   - 'programa.e otro.e ...': los archivos siguientes aportan clases. Se parsean todos en paralelo
+     (ver frontend.h); las clases se registran en el orden de la línea de comandos (si dos archivos
+     definen la misma clase, gana el primero) y el .info describe solo el primer archivo.
    - Al final escribe el estado de la tabla de símbolos en el archivo .info para depuración.
+   - Con '--repl [archivo.e]' entra en modo interactivo (ver repl.c).
+   - Con '--serve [socket]' queda como servidor de ejecuciones (ver server.c e interpreter_client).
+   - Con '--load-image imagen [feature]' restaura una imagen y ejecuta MAIN.feature (ver image.h);
+     la opción '--save-image imagen' la guarda después de ejecutar MAIN.make.
+   - Con '--emit-c salida.c' (antes del archivo) no se ejecuta nada: se genera un programa C
+     equivalente a MAIN.make (ver emit.h).
+   - Opciones previas al archivo: '--line-buffered' vuelca la salida de print en cada línea;
+     '--classpath dir1:dir2' agrega directorios de clases (además de EIFFEL_CLASSPATH, ver classpath.h);
+     '--memstats' escribe el resumen de memoria (ver memstats.h) en stderr al terminar;
+     '--lazy-bodies' parsea el cuerpo de cada rutina recién cuando se usa (ver frontend.h);
+     '--heap-dump snapshot.jsonl' escribe el heap alcanzable al terminar (ver heapdump.h y heap_report);
+     '--max-steps N', '--max-time ms' y '--max-memory bytes[K|M|G]' limitan la ejecución (ver meter.h).
+   - El resumen de memoria también queda al final del archivo .info.
 */
 
+static void print_memstats_at_exit(void) {
+    mem_print_summary(stderr);
+}
+
+static int is_limit_option(const char *option) {
+    return strcmp(option, "--max-steps") == 0 || strcmp(option, "--max-time") == 0
+        || strcmp(option, "--max-memory") == 0;
+}
+
 int main(int argc, char **argv) {
+    int line_buffered = -1; // Automático: por línea si stdout es una terminal
+    long max_steps = 0, max_millis = 0, max_bytes = 0;
+    const char *emit_c_path = NULL;
+    int arg = 1;
+    while (arg < argc) {
+        if (strcmp(argv[arg], "--line-buffered") == 0) {
+            line_buffered = 1;
+            arg++;
+        } else if (strcmp(argv[arg], "--lazy-bodies") == 0) {
+            parse_lazy_bodies = 1;
+            arg++;
+        } else if (strcmp(argv[arg], "--memstats") == 0) {
+            atexit(print_memstats_at_exit); // También si un error termina el programa con exit(1)
+            arg++;
+        } else if (is_limit_option(argv[arg]) && arg + 1 < argc) {
+            long value = meter_parse_limit(argv[arg + 1]);
+            if (value < 0) {
+                fprintf(stderr, "%s: límite inválido '%s'.\n", argv[arg], argv[arg + 1]);
+                return 1;
+            }
+            if (strcmp(argv[arg], "--max-steps") == 0) max_steps = value;
+            else if (strcmp(argv[arg], "--max-time") == 0) max_millis = value;
+            else max_bytes = value;
+            arg += 2;
+        } else if (strcmp(argv[arg], "--save-image") == 0 && arg + 1 < argc) {
+            image_request_save(argv[arg + 1]);
+            arg += 2;
+        } else if (strcmp(argv[arg], "--heap-dump") == 0 && arg + 1 < argc) {
+            heap_dump_request(argv[arg + 1]);
+            arg += 2;
+        } else if (strcmp(argv[arg], "--emit-c") == 0 && arg + 1 < argc) {
+            emit_c_path = argv[arg + 1];
+            arg += 2;
+        } else if (strcmp(argv[arg], "--classpath") == 0 && arg + 1 < argc) {
+            class_path_add(argv[arg + 1]);
+            arg += 2;
+        } else {
+            break;
+        }
+    }
+    class_path_add(getenv("EIFFEL_CLASSPATH"));
+    meter_set_limits(max_steps, max_millis, max_bytes);
+    meter_limits_from_env();
+    // Las opciones ya consumidas no cuentan como argumentos del modo/archivo
+    argv += arg - 1;
+    argc -= arg - 1;
+    output_init(line_buffered);
+
+    if (argc > 1 && strcmp(argv[1], "--repl") == 0) {
+        return run_repl(argc > 2 ? argv[2] : NULL);
+    }
+    if (argc > 1 && strcmp(argv[1], "--serve") == 0) {
+        return run_server(argc > 2 ? argv[2] : NULL);
+    }
+    if (argc > 2 && strcmp(argv[1], "--load-image") == 0) {
+        char info_filename[256];
+        snprintf(info_filename, sizeof(info_filename), "%s.info", argv[2]);
+        info_file_ptr = fopen(info_filename, "w");
+        if (!info_file_ptr) {
+            fprintf(stderr, "No se pudo crear el archivo de información %s.\n", info_filename);
+            info_file_ptr = stderr;
+        }
+        int status = image_run(argv[2], argc > 3 ? argv[3] : NULL, info_file_ptr);
+        class_path_free();
+        intern_free();
+        if (info_file_ptr != stderr) fclose(info_file_ptr);
+        return status;
+    }
+
+    FILE *source = stdin;
     if (argc > 1) {
-        yyin = fopen(argv[1], "r");
-        if (!yyin) {
+        source = fopen(argv[1], "r");
+        if (!source) {
             perror(argv[1]);
             return 1;
         }
@@ -42,88 +142,47 @@ int main(int argc, char **argv) {
     // Escribir la cabecera de tokens
     fprintf(info_file_ptr, "--- TOKENS ---\n");
 
-    AstNode *root = NULL;
-    if (yyparse(&root) != 0) {
+    // El programa y los archivos de clases que lo acompañan (ver parse_files)
+    int file_count = argc > 1 ? argc - 1 : 1;
+    SourceFile *files = calloc(file_count, sizeof(SourceFile));
+    files[0].path = argc > 1 ? argv[1] : "stdin";
+    files[0].input = source;
+    files[0].token_output = info_file_ptr;
+    for (int i = 1; i < file_count; i++) files[i].path = argv[i + 1];
+    parse_files(files, file_count);
+    if (source != stdin) fclose(source);
+
+    if (report_parse_errors(files, file_count) >= 0) {
         fprintf(info_file_ptr, "Error de parseo.\n");
+        for (int i = 0; i < file_count; i++) free_ast(files[i].root);
+        free(files);
         if (info_file_ptr != stdout && info_file_ptr != stderr) fclose(info_file_ptr);
         return 1;
     }
+    AstNode *root = files[0].root;
 
     // Escribir el AST en el archivo .info
     fprintf(info_file_ptr, "\n--- AST Tree ---\n");
     print_ast(root, info_file_ptr);
     fprintf(info_file_ptr, "----------------\n\n");
 
-    if (root == NULL) {
-        if (info_file_ptr != stdout && info_file_ptr != stderr) fclose(info_file_ptr);
-        return 0; // Archivo vacío, no es un error.
-    }
+    int status = 0;
+    if (root != NULL) { // Un archivo vacío no es un error
+        // Las clases de los otros archivos, después de las del programa
+        register_classes_from_ast(root);
+        for (int i = 1; i < file_count; i++) register_classes_from_ast(files[i].root);
 
-    // Fase 1: Registrar todas las clases del AST
-    register_classes_from_ast(root);
-
-    SymbolTable global_scope;
-    init_symbol_table(&global_scope);
-
-    // Fase 2: Intentar ejecutar MAIN.make
-    ClassDefinition* main_class = find_class("MAIN");
-    FeatureBodyNode* make_method = NULL;
-    if (main_class) {
-        make_method = find_feature(main_class->feature_list, "make");
-    }
-
-    if (main_class && make_method) {
-        // Si existe MAIN y make, lo ejecutamos
-        eval_ast((AstNode*)make_method, &global_scope);
-    } else {
-        // Si no, ejecutamos el AST desde la raíz (para tests antiguos)
-        eval_ast(root, &global_scope);
+        // Fase 1 y 2: registrar clases y ejecutar MAIN.make (o la raíz), o generar el C equivalente
+        status = emit_c_path ? emit_program(emit_c_path, info_file_ptr) : run_program(root, info_file_ptr);
     }
 
-    // Escribir el estado final de la tabla de símbolos en el archivo .info
-    print_symbol_table(&global_scope, info_file_ptr);
-
-    free_ast(root);
-    if (argc > 1) {
-        fclose(yyin);
-    }
+    for (int i = 0; i < file_count; i++) free_ast(files[i].root);
+    free(files);
+    class_path_free();
+    intern_free();
     if (info_file_ptr != stdout && info_file_ptr != stderr) {
         fclose(info_file_ptr);
     }
 
-    return 0;
-}
-
-/* register_classes_from_ast:
-   - Recorre la lista de sentencias en la raíz y registra las clases encontradas en class_table.
-   - Esto separa la fase de parseo de la de ejecución.
-*/
-void register_classes_from_ast(AstNode* node) {
-    if (!node || node->type != NODE_TYPE_STATEMENT_LIST) {
-        return;
-    }
-    StatementListNode* list = (StatementListNode*)node;
-    while (list) {
-        if (list->statement && list->statement->type == NODE_TYPE_CLASS_DECL) {
-            ClassNode* class_node = (ClassNode*)list->statement;
-            register_class(class_node->name, class_node->features);
-        }
-        list = list->next;
-    }
-}
-
-/* find_feature: busca un método por nombre dentro de la lista de features de una clase */
-FeatureBodyNode* find_feature(StatementListNode* feature_list, const char* feature_name) {
-    StatementListNode* current = feature_list;
-    while (current) {
-        AstNode* stmt = current->statement;
-        if (stmt && stmt->type == NODE_TYPE_FEATURE_BODY) {
-            FeatureBodyNode* f_node = (FeatureBodyNode*)stmt;
-            if (f_node->feature_name && strcmp(f_node->feature_name, feature_name) == 0) {
-                return f_node;
-            }
-        }
-        current = current->next;
-    }
-    return NULL;
+    return status;
 }
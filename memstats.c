@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#ifdef __APPLE__
+#include <malloc/malloc.h>
+#define block_size(block) malloc_size(block)
+#else
+#include <malloc.h>
+#define block_size(block) malloc_usable_size(block)
+#endif
+#include "memstats.h"
+#include "meter.h"
+
+/* Comentario general:
+   - Cada categoría tiene contadores atómicos; el pico se actualiza con compare-and-swap.
+   - Además se lleva el total de todas las categorías (con su propio pico).
+   - Las instancias por clase van en una tabla chica protegida por un mutex: crear objetos no
+     ocurre dentro del across paralelo.
+*/
+
+typedef struct {
+    atomic_long live_bytes;
+    atomic_long peak_bytes;
+    atomic_long live_blocks;
+    atomic_long allocations;
+} MemCounters;
+
+static MemCounters counters[MEM_CATEGORY_COUNT];
+static MemCounters total;
+
+static const char *category_names[MEM_CATEGORY_COUNT] = {
+    "ast", "identifiers", "strings", "objects", "arrays", "scopes", "frames"
+};
+
+typedef struct {
+    char *class_name;
+    long created;
+    long live;
+} ClassInstances;
+
+static ClassInstances *instances = NULL;
+static int instance_count = 0;
+static int instance_capacity = 0;
+static pthread_mutex_t instances_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static long limit_bytes = 0;
+
+static void raise_peak(MemCounters *c, long live) {
+    long peak = atomic_load_explicit(&c->peak_bytes, memory_order_relaxed);
+    while (live > peak && !atomic_compare_exchange_weak_explicit(&c->peak_bytes, &peak, live,
+                                                                 memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static long account(MemCounters *c, long bytes, int blocks) {
+    long live = atomic_fetch_add_explicit(&c->live_bytes, bytes, memory_order_relaxed) + bytes;
+    atomic_fetch_add_explicit(&c->live_blocks, blocks, memory_order_relaxed);
+    if (blocks > 0) {
+        atomic_fetch_add_explicit(&c->allocations, 1, memory_order_relaxed);
+        raise_peak(c, live);
+    }
+    return live;
+}
+
+// Con límite de memoria (ver meter.h), el paso siguiente del hilo que lo superó revisa los límites
+static void check_limit(long live) {
+    if (limit_bytes > 0 && live > limit_bytes) meter_interrupt();
+}
+
+void mem_set_limit(long bytes) {
+    limit_bytes = bytes;
+}
+
+static void count_block(MemCategory category, long bytes, int blocks) {
+    account(&counters[category], bytes, blocks);
+    long live = account(&total, bytes, blocks);
+    if (bytes > 0) check_limit(live);
+}
+
+static void* out_of_memory(size_t size) {
+    fprintf(stderr, "Error: No hay memoria para reservar %zu bytes.\n", size);
+    exit(1);
+}
+
+void* mem_alloc(MemCategory category, size_t size) {
+    void *block = malloc(size ? size : 1);
+    if (!block) return out_of_memory(size);
+    count_block(category, (long)block_size(block), 1);
+    return block;
+}
+
+void* mem_realloc(MemCategory category, void *block, size_t size) {
+    if (!block) return mem_alloc(category, size);
+    long old_bytes = (long)block_size(block);
+    void *resized = realloc(block, size ? size : 1);
+    if (!resized) return out_of_memory(size);
+    long new_bytes = (long)block_size(resized);
+    account(&counters[category], new_bytes - old_bytes, 0);
+    check_limit(account(&total, new_bytes - old_bytes, 0));
+    raise_peak(&counters[category], atomic_load_explicit(&counters[category].live_bytes, memory_order_relaxed));
+    raise_peak(&total, atomic_load_explicit(&total.live_bytes, memory_order_relaxed));
+    return resized;
+}
+
+char* mem_strdup(MemCategory category, const char *text) {
+    return mem_strndup(category, text, strlen(text));
+}
+
+char* mem_strndup(MemCategory category, const char *text, size_t length) {
+    char *copy = mem_alloc(category, length + 1);
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+void mem_free(MemCategory category, void *block) {
+    if (!block) return;
+    count_block(category, -(long)block_size(block), -1);
+    free(block);
+}
+
+void mem_adopt(MemCategory category, void *block) {
+    if (block) count_block(category, (long)block_size(block), 1);
+}
+
+void mem_track(MemCategory category, long bytes) {
+    count_block(category, bytes, bytes > 0 ? 1 : -1);
+}
+
+void mem_count_instance(const char *class_name, int delta) {
+    if (!class_name) return;
+    pthread_mutex_lock(&instances_lock);
+    int i = 0;
+    while (i < instance_count && strcmp(instances[i].class_name, class_name) != 0) i++;
+    if (i == instance_count) {
+        if (instance_count == instance_capacity) {
+            instance_capacity = instance_capacity ? instance_capacity * 2 : 16;
+            instances = realloc(instances, instance_capacity * sizeof(ClassInstances));
+        }
+        instances[i].class_name = strdup(class_name);
+        instances[i].created = 0;
+        instances[i].live = 0;
+        instance_count++;
+    }
+    if (delta > 0) instances[i].created += delta;
+    instances[i].live += delta;
+    pthread_mutex_unlock(&instances_lock);
+}
+
+long mem_live_bytes(void) {
+    return atomic_load_explicit(&total.live_bytes, memory_order_relaxed);
+}
+
+static void print_counters(FILE *output, const char *name, MemCounters *c) {
+    fprintf(output, "  %-12s %12ld %12ld %12ld %12ld\n", name,
+            atomic_load(&c->live_bytes), atomic_load(&c->peak_bytes),
+            atomic_load(&c->allocations), atomic_load(&c->live_blocks));
+}
+
+void mem_print_summary(FILE *output) {
+    if (!output) return;
+    fprintf(output, "--- Memory ---\n");
+    fprintf(output, "  %-12s %12s %12s %12s %12s\n", "category", "live bytes", "peak bytes", "allocations", "live blocks");
+    for (int i = 0; i < MEM_CATEGORY_COUNT; i++) print_counters(output, category_names[i], &counters[i]);
+    print_counters(output, "total", &total);
+
+    pthread_mutex_lock(&instances_lock);
+    if (instance_count > 0) {
+        fprintf(output, "  %-20s %12s %12s\n", "class", "created", "live");
+        for (int i = 0; i < instance_count; i++) {
+            fprintf(output, "  %-20s %12ld %12ld\n", instances[i].class_name, instances[i].created, instances[i].live);
+        }
+    }
+    pthread_mutex_unlock(&instances_lock);
+    fprintf(output, "--------------\n");
+}
@@ -0,0 +1,55 @@
+#ifndef MEMSTATS_H
+#define MEMSTATS_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/* Comentario general:
+   - Capa central de memoria del intérprete: mem_alloc / mem_strdup / mem_free reciben una categoría
+     y llevan, por categoría, bytes vivos, pico de bytes vivos, cantidad de reservas y bloques vivos.
+   - El tamaño de cada bloque se consulta al allocator (malloc_usable_size), así que no hay cabecera:
+     un free() directo sobre un bloque contado solo desajusta las cifras, nunca corrompe memoria.
+   - Los frames de métodos (scope y objetos que no escapan, ver escape.h) están en la pila:
+     mem_track los cuenta mientras dura la llamada.
+   - También se cuentan las instancias creadas por clase (y las vivas: los objetos del frame se
+     liberan al volver del método).
+   - Contadores atómicos: el across paralelo reserva strings y scopes desde varios hilos.
+   - Las estructuras internas (índices, buffers del REPL/servidor) usan malloc directo y no se cuentan.
+*/
+
+typedef enum {
+    MEM_AST,        // Nodos del AST
+    MEM_IDENTIFIER, // Nombres: identificadores, tipos, entradas de tablas de símbolos
+    MEM_STRING,     // Valores STRING (literales y resultados en ejecución)
+    MEM_OBJECT,     // Tablas de objetos creadas con 'create'
+    MEM_ARRAY,      // ARRAY predefinidos y su almacenamiento
+    MEM_SCOPE,      // Scopes de métodos y de bloques del across paralelo
+    MEM_FRAME,      // Objetos alojados en el frame de un método
+    MEM_CATEGORY_COUNT
+} MemCategory;
+
+void* mem_alloc(MemCategory category, size_t size);
+void* mem_realloc(MemCategory category, void *block, size_t size);
+char* mem_strdup(MemCategory category, const char *text);
+char* mem_strndup(MemCategory category, const char *text, size_t length);
+void mem_free(MemCategory category, void *block);
+
+// Cuenta un bloque reservado por otro medio (p. ej. posix_memalign); se libera con mem_free
+void mem_adopt(MemCategory category, void *block);
+
+// Memoria que no viene del heap (frames en la pila): bytes > 0 al entrar, < 0 al salir
+void mem_track(MemCategory category, long bytes);
+
+// Instancias por clase: delta = +1 al crear, -1 al liberar
+void mem_count_instance(const char *class_name, int delta);
+
+// Bytes vivos de todas las categorías (lo consulta el límite de memoria, ver meter.h)
+long mem_live_bytes(void);
+
+// Límite de bytes vivos (0 = sin límite): al superarlo se llama a meter_interrupt()
+void mem_set_limit(long bytes);
+
+// Escribe el resumen (por categoría y por clase) en output
+void mem_print_summary(FILE *output);
+
+#endif // MEMSTATS_H
@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "interpreter.h"
+#include "memstats.h"
+#include "meter.h"
+
+/* Comentario general:
+   - meter_granted es el lote entregado al hilo; lo consumido es meter_granted - meter_countdown.
+   - El total de pasos es atómico porque los workers del across paralelo rinden sus lotes solos.
+   - Con límite de pasos el último lote es exacto: se ejecutan exactamente max_steps pasos.
+   - La pila: cada llamada a método usa varios KB de pila de C. El piso de cada hilo se fija en su
+     primera llamada: tres cuartos de RLIMIT_STACK por debajo (2 MB si no hay límite, lo que usa
+     un hilo nuevo en ese caso). Se supone que la pila crece hacia abajo.
+*/
+
+#define METER_UNLIMITED (LONG_MAX / 4)
+
+_Thread_local long meter_countdown = 0;
+static _Thread_local long meter_granted = 0;
+
+static struct {
+    long max_steps;
+    long max_millis;
+    long max_bytes;
+} limits;
+
+static atomic_long total_steps;
+static atomic_int tripped;
+static struct timespec started;
+static _Thread_local char *stack_floor = NULL;
+
+static long elapsed_millis(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - started.tv_sec) * 1000L + (now.tv_nsec - started.tv_nsec) / 1000000L;
+}
+
+static int has_limits(void) {
+    return limits.max_steps > 0 || limits.max_millis > 0 || limits.max_bytes > 0;
+}
+
+void meter_set_limits(long max_steps, long max_millis, long max_bytes) {
+    limits.max_steps = max_steps;
+    limits.max_millis = max_millis;
+    limits.max_bytes = max_bytes;
+    mem_set_limit(max_bytes);
+}
+
+// Acepta un número con sufijo opcional K, M o G (potencias de 1024). Devuelve -1 si no es válido
+static long parse_limit(const char *text) {
+    char *end;
+    long value = strtol(text, &end, 10);
+    if (end == text || value < 0) return -1;
+    switch (*end) {
+        case 'K': case 'k': value *= 1024L; end++; break;
+        case 'M': case 'm': value *= 1024L * 1024L; end++; break;
+        case 'G': case 'g': value *= 1024L * 1024L * 1024L; end++; break;
+        default: break;
+    }
+    return *end == '\0' ? value : -1;
+}
+
+static void limit_from_env(long *limit, const char *variable) {
+    const char *text = getenv(variable);
+    if (*limit > 0 || !text || !*text) return;
+    long value = parse_limit(text);
+    if (value < 0) {
+        fprintf(stderr, "Aviso: %s='%s' no es un límite válido; se ignora.\n", variable, text);
+        return;
+    }
+    *limit = value;
+}
+
+void meter_limits_from_env(void) {
+    limit_from_env(&limits.max_steps, "EIFFEL_MAX_STEPS");
+    limit_from_env(&limits.max_millis, "EIFFEL_MAX_TIME_MS");
+    limit_from_env(&limits.max_bytes, "EIFFEL_MAX_MEMORY");
+    mem_set_limit(limits.max_bytes);
+}
+
+long meter_parse_limit(const char *text) {
+    return parse_limit(text);
+}
+
+void meter_start(void) {
+    atomic_store(&total_steps, 0);
+    atomic_store(&tripped, 0);
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    meter_countdown = 0;
+    meter_granted = 0;
+}
+
+// Informa el primer límite superado y corta la ejecución del hilo
+static void exceed(void) {
+    meter_granted = meter_countdown = METER_UNLIMITED; // El código de recuperación no vuelve a entrar acá
+    runtime_abort();
+}
+
+void meter_refill(void) {
+    atomic_fetch_add_explicit(&total_steps, meter_granted - meter_countdown, memory_order_relaxed);
+    meter_granted = meter_countdown = 0;
+    if (atomic_load_explicit(&tripped, memory_order_relaxed)) exceed(); // Ya lo informó otro hilo
+
+    long done = atomic_load_explicit(&total_steps, memory_order_relaxed);
+    const char *reason = NULL;
+    char detail[128];
+    if (limits.max_steps > 0 && done > limits.max_steps) {
+        reason = "pasos";
+        snprintf(detail, sizeof(detail), "%ld pasos", limits.max_steps);
+    } else if (limits.max_millis > 0 && elapsed_millis() > limits.max_millis) {
+        reason = "tiempo";
+        snprintf(detail, sizeof(detail), "%ld ms", limits.max_millis);
+    } else if (limits.max_bytes > 0 && mem_live_bytes() > limits.max_bytes) {
+        reason = "memoria";
+        snprintf(detail, sizeof(detail), "%ld bytes, en uso %ld", limits.max_bytes, mem_live_bytes());
+    }
+    if (reason) {
+        done = atomic_fetch_sub(&total_steps, 1) - 1; // El paso que pidió el lote no llega a ejecutarse
+        if (!atomic_exchange(&tripped, 1)) {
+            fprintf(stderr, "Error: Se superó el límite de %s (%s) tras %ld pasos.\n", reason, detail, done);
+        }
+        exceed();
+    }
+
+    long grant = has_limits() ? METER_BATCH : METER_UNLIMITED;
+    if (limits.max_steps > 0 && limits.max_steps - done < grant) grant = limits.max_steps - done;
+    meter_granted = meter_countdown = grant;
+}
+
+void meter_interrupt(void) {
+    meter_granted -= meter_countdown; // Lo consumido no cambia
+    meter_countdown = 0;
+}
+
+size_t meter_stack_size(void) {
+    struct rlimit limit;
+    size_t size = 2 * 1024 * 1024;
+    if (getrlimit(RLIMIT_STACK, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) size = (size_t)limit.rlim_cur;
+    return size;
+}
+
+void meter_check_stack(void) {
+    char here;
+    if (!stack_floor) stack_floor = &here - meter_stack_size() / 4 * 3;
+    if (&here < stack_floor) {
+        fprintf(stderr, "Error: Demasiadas llamadas anidadas: se agotó la pila de ejecución.\n");
+        runtime_abort();
+    }
+}
+
+long meter_steps(void) {
+    return atomic_load(&total_steps) + (meter_granted - meter_countdown);
+}
+
+int meter_exceeded(void) {
+    return atomic_load(&tripped);
+}
+
+static void print_limit(FILE *output, const char *name, long value, const char *unit) {
+    if (value > 0) fprintf(output, "  %-12s %ld%s\n", name, value, unit);
+    else fprintf(output, "  %-12s -\n", name);
+}
+
+void meter_print_summary(FILE *output) {
+    if (!output) return;
+    fprintf(output, "--- Metering ---\n");
+    fprintf(output, "  %-12s %ld\n", "steps", meter_steps());
+    fprintf(output, "  %-12s %ld ms\n", "time", elapsed_millis());
+    print_limit(output, "max steps", limits.max_steps, "");
+    print_limit(output, "max time", limits.max_millis, " ms");
+    print_limit(output, "max memory", limits.max_bytes, " bytes");
+    if (meter_exceeded()) fprintf(output, "  ejecución cortada por un límite\n");
+    fprintf(output, "----------------\n");
+}
@@ -0,0 +1,59 @@
+#ifndef METER_H
+#define METER_H
+
+#include <stdio.h>
+
+/* Comentario general:
+   - Medición de la ejecución para correr scripts no confiables: límite de pasos, de tiempo real
+     y de memoria viva (la que cuenta memstats.c).
+   - Un paso es una sentencia ejecutada, una vuelta de loop/across o una llamada a método: todo
+     cómputo sin fin pasa por alguno de ellos.
+   - Camino rápido: METER_STEP() solo decrementa un contador del hilo. Cuando llega a cero,
+     meter_refill() suma el lote al total, revisa los tres límites y entrega el lote siguiente
+     (METER_BATCH pasos, o lo que falte para el límite de pasos). El reloj y la memoria se
+     consultan una vez por lote; además memstats.c adelanta la revisión apenas se supera la memoria.
+   - Al pasarse de un límite se informa el error en stderr (una sola vez, aunque lo detecten varios
+     hilos del across paralelo) y se llama a runtime_abort().
+   - Además, la recursión profunda termina con un error en lugar de desbordar la pila de C.
+   - Sin límites configurados el lote es prácticamente infinito y el costo es el decremento.
+*/
+
+#define METER_BATCH 4096
+
+extern _Thread_local long meter_countdown;
+
+#define METER_STEP() do { if (__builtin_expect(--meter_countdown <= 0, 0)) meter_refill(); } while (0)
+
+// Límites (0 = sin límite): pasos, milisegundos de tiempo real y bytes vivos
+void meter_set_limits(long max_steps, long max_millis, long max_bytes);
+
+// Convierte "N", "NK", "NM" o "NG" (potencias de 1024); -1 si el texto no es válido
+long meter_parse_limit(const char *text);
+
+// Completa los límites que no se fijaron con EIFFEL_MAX_STEPS, EIFFEL_MAX_TIME_MS y EIFFEL_MAX_MEMORY
+void meter_limits_from_env(void);
+
+// Arranca una ejecución: pone en cero los pasos y toma la hora de inicio
+void meter_start(void);
+
+void meter_refill(void);
+
+// Hace que el próximo METER_STEP() del hilo revise los límites (lo usa memstats.c al superar la memoria)
+void meter_interrupt(void);
+
+// Corta con un error limpio si la recursión está por agotar la pila del hilo (antes de cada llamada)
+void meter_check_stack(void);
+
+// Tamaño de pila de un hilo según RLIMIT_STACK (2 MB sin límite); scoop.c crea sus workers con él
+size_t meter_stack_size(void);
+
+// Pasos ejecutados desde meter_start (aproximado mientras otros hilos tienen lotes sin rendir)
+long meter_steps(void);
+
+// Devuelve 1 si la última ejecución se cortó por un límite
+int meter_exceeded(void);
+
+// Escribe los pasos, el tiempo y los límites en output
+void meter_print_summary(FILE *output);
+
+#endif // METER_H
@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include "output.h"
+
+/* Comentario general:
+   - Un único buffer para stdout (más las capturas por hilo de los workers, ver output.h). Se escribe con fwrite para convivir con los printf que quedan
+     (mensajes del REPL, tabla de símbolos a stdout): output_flush siempre deja stdout al día.
+   - output_int usa una tabla de pares de dígitos (dos dígitos por división).
+   - output_real reproduce "%f": escala a millonésimas y redondea; si el valor está cerca de un
+     empate de redondeo o es muy grande, delega en snprintf para obtener exactamente el mismo texto.
+*/
+
+static char buffer[OUTPUT_BUFFER_SIZE];
+static size_t used = 0;
+static int line_mode = 0;
+static int initialized = 0;
+static _Thread_local OutputCapture *active_capture = NULL;
+
+static const char digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+void output_flush(void) {
+    if (active_capture) return; // El hilo escribe en su captura, no en stdout
+    if (used) {
+        fwrite(buffer, 1, used, stdout);
+        used = 0;
+    }
+    fflush(stdout);
+}
+
+void output_init(int line_buffered) {
+    if (!initialized) {
+        atexit(output_flush);
+        initialized = 1;
+    }
+    line_mode = line_buffered < 0 ? isatty(STDOUT_FILENO) : line_buffered;
+}
+
+void output_set_line_buffered(int line_buffered) {
+    line_mode = line_buffered;
+    if (line_mode) output_flush();
+}
+
+static void capture_bytes(OutputCapture *capture, const char *data, size_t len) {
+    if (capture->length + len > capture->capacity) {
+        size_t capacity = capture->capacity ? capture->capacity * 2 : 256;
+        while (capacity < capture->length + len) capacity *= 2;
+        capture->data = realloc(capture->data, capacity);
+        capture->capacity = capacity;
+    }
+    memcpy(capture->data + capture->length, data, len);
+    capture->length += len;
+}
+
+void output_capture_begin(OutputCapture *capture) {
+    capture->data = NULL;
+    capture->length = 0;
+    capture->capacity = 0;
+    capture->previous = active_capture;
+    active_capture = capture;
+}
+
+void output_capture_end(void) {
+    if (active_capture) active_capture = active_capture->previous;
+}
+
+void output_capture_emit(OutputCapture *capture) {
+    if (capture->length) output_bytes(capture->data, capture->length);
+    free(capture->data);
+    capture->data = NULL;
+    capture->length = capture->capacity = 0;
+    if (line_mode) output_flush();
+}
+
+void output_bytes(const char *data, size_t len) {
+    if (active_capture) {
+        capture_bytes(active_capture, data, len);
+        return;
+    }
+    if (!initialized) output_init(-1);
+    if (len > OUTPUT_BUFFER_SIZE - used) {
+        output_flush();
+        if (len >= OUTPUT_BUFFER_SIZE) {
+            fwrite(data, 1, len, stdout);
+            return;
+        }
+    }
+    memcpy(buffer + used, data, len);
+    used += len;
+}
+
+void output_string(const char *text) {
+    output_bytes(text, strlen(text));
+}
+
+void output_char(char c) {
+    if (used == OUTPUT_BUFFER_SIZE || !initialized || active_capture) output_bytes(&c, 1);
+    else buffer[used++] = c;
+}
+
+// Escribe los dígitos decimales de value al final de 'end' (hacia atrás); devuelve el inicio
+static char* format_unsigned(unsigned long long value, char *end) {
+    char *p = end;
+    while (value >= 100) {
+        unsigned idx = (unsigned)(value % 100) * 2;
+        value /= 100;
+        *--p = digit_pairs[idx + 1];
+        *--p = digit_pairs[idx];
+    }
+    if (value >= 10) {
+        unsigned idx = (unsigned)value * 2;
+        *--p = digit_pairs[idx + 1];
+        *--p = digit_pairs[idx];
+    } else {
+        *--p = (char)('0' + value);
+    }
+    return p;
+}
+
+void output_int(int value) {
+    char digits[16];
+    char *end = digits + sizeof(digits);
+    unsigned long long magnitude = value < 0 ? -(long long)value : value;
+    char *start = format_unsigned(magnitude, end);
+    if (value < 0) *--start = '-';
+    output_bytes(start, (size_t)(end - start));
+}
+
+void output_real(double value) {
+    double magnitude = fabs(value);
+    if (isfinite(value) && magnitude < 1e6) {
+        // Con |value| < 1e6 el error de escalar es < 2^-12, muy por debajo del margen de empate
+        double scaled = magnitude * 1e6;
+        double whole = floor(scaled);
+        double fraction = scaled - whole;
+        if (fabs(fraction - 0.5) > 1e-3) {
+            unsigned long long units = (unsigned long long)whole + (fraction > 0.5);
+            char digits[32];
+            char *end = digits + sizeof(digits);
+            char *p = format_unsigned(units % 1000000, end);
+            while (end - p < 6) *--p = '0';
+            *--p = '.';
+            p = format_unsigned(units / 1000000, p);
+            if (signbit(value)) *--p = '-';
+            output_bytes(p, (size_t)(end - p));
+            return;
+        }
+    }
+    char text[512];
+    int len = snprintf(text, sizeof(text), "%f", value);
+    output_bytes(text, (size_t)len < sizeof(text) ? (size_t)len : sizeof(text) - 1);
+}
+
+void output_newline(void) {
+    output_char('\n');
+    if (line_mode) output_flush();
+}
@@ -0,0 +1,45 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stddef.h>
+
+/* Comentario general:
+   - Capa de salida del intérprete: 'print' escribe en un buffer propio en lugar de llamar a printf
+     por cada valor.
+   - Enteros y reales se formatean a mano (mismo texto que "%d" y "%f").
+   - El buffer se vuelca en bloques grandes y al salir (atexit). En modo línea (terminal, REPL o
+     --line-buffered) se vuelca en cada salto de línea.
+   - Captura por hilo: mientras un hilo tiene una OutputCapture activa, lo que imprime se acumula
+     ahí y no en el buffer compartido. Los workers de 'across ... parallel' la usan para que la
+     salida se emita después en el orden de las iteraciones, y los procesadores separate (scoop.c)
+     para que la escriba el hilo principal.
+*/
+
+#define OUTPUT_BUFFER_SIZE (64 * 1024)
+
+// Inicializa la capa (registra el volcado al salir). line_buffered < 0: automático según isatty(stdout)
+void output_init(int line_buffered);
+void output_set_line_buffered(int line_buffered);
+
+void output_bytes(const char *data, size_t len);
+void output_string(const char *text);
+void output_char(char c);
+void output_int(int value);
+void output_real(double value);
+void output_newline(void);
+
+// Vuelca el buffer a stdout (y hace fflush de stdout). No hace nada con una captura activa
+void output_flush(void);
+
+typedef struct OutputCapture {
+    char *data;
+    size_t length;
+    size_t capacity;
+    struct OutputCapture *previous; // Captura que estaba activa antes (las capturas se anidan)
+} OutputCapture;
+
+void output_capture_begin(OutputCapture *capture); // Inicializa capture y la activa en el hilo actual
+void output_capture_end(void);                      // Vuelve a la captura anterior del hilo (o a la salida normal)
+void output_capture_emit(OutputCapture *capture);  // Escribe lo capturado en la salida normal y lo libera
+
+#endif // OUTPUT_H
@@ -0,0 +1,614 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include "parallel.h"
+#include "memstats.h"
+#include "threadpool.h"
+#include "output.h"
+#include "array.h"
+#include "eiffel_io.h"
+
+/* Comentario general:
+   - analyze_body recorre el cuerpo del across una vez por ejecución y clasifica cada variable
+     asignada (reducción, temporal). Es conservador: ante cualquier duda el across corre en secuencia.
+   - Un ARRAY se escribe solo en el índice del cursor; si el cuerpo lo escribe, tampoco puede leer
+     otros elementos (item en otro índice, sum, min, max), que podrían ser de otra iteración.
+   - run_chunk ejecuta un bloque de iteraciones en un scope propio. Un error en tiempo de ejecución
+     dentro de un bloque vuelve (longjmp) a ese mismo bloque; el hilo principal lo informa después
+     de emitir la salida de los bloques anteriores.
+   - La combinación de resultados la hace el hilo principal, en orden de bloque.
+*/
+
+typedef enum {
+    USAGE_READ_ONLY,
+    USAGE_REDUCE_ADD,   // x := x + e / x := x - e
+    USAGE_REDUCE_MUL,   // x := x * e
+    USAGE_LAST_WRITE    // Temporal: queda el valor del último bloque que la asignó
+} UsageKind;
+
+typedef struct {
+    const char *name;
+    int reads;          // Lecturas que podrían ver el valor de otra iteración
+    int adds;
+    int subtracts;
+    int multiplies;
+    int plain;          // Cualquier otra asignación
+    int defined;        // Asignada sin condiciones antes de cualquier lectura de la iteración
+    int nested_cursor;  // Cursor de un across anidado (privado de cada bloque)
+    UsageKind kind;
+} VariableUsage;
+
+typedef struct {
+    const char *name;   // Variable que tiene el ARRAY
+    int puts;           // Siempre en el índice del cursor (otro índice rechaza el cuerpo)
+    int spread_reads;   // sum, min, max o item en un índice que no es el cursor
+} ArrayUsage;
+
+typedef struct {
+    SymbolTable *table;
+    const char *cursor;
+    VariableUsage vars[MAX_SYMBOLS];
+    int count;
+    ArrayUsage arrays[MAX_SYMBOLS];
+    int array_count;
+    int rejected;
+    char reason[256];
+} BodyAnalysis;
+
+typedef struct {
+    SymbolTable *scope;
+    OutputCapture output;
+} AcrossChunk;
+
+typedef struct {
+    AcrossNode *node;
+    SymbolTable *table;
+    BodyAnalysis *analysis;
+    int lower;
+    long long count;
+    int chunk_count;
+    int first_failed;   // Menor bloque que terminó con error (chunk_count si ninguno)
+    AcrossChunk chunks[ACROSS_CHUNKS];
+} AcrossJob;
+
+/* --- Análisis del cuerpo --- */
+
+static void reject(BodyAnalysis *a, const char *format, ...) {
+    if (a->rejected) return;
+    a->rejected = 1;
+    va_list args;
+    va_start(args, format);
+    vsnprintf(a->reason, sizeof(a->reason), format, args);
+    va_end(args);
+}
+
+// Como get_symbol pero sin errores: busca la entrada en el scope y sus padres
+static SymbolTableEntry* lookup_entry(SymbolTable *table, const char *name) {
+    for (; table; table = table->parent) {
+        SymbolTableEntry *entry = find_symbol_entry(table, name);
+        if (entry) return entry;
+    }
+    return NULL;
+}
+
+static VariableUsage* usage_of(BodyAnalysis *a, const char *name) {
+    for (int i = 0; i < a->count; i++) {
+        if (strcmp(a->vars[i].name, name) == 0) return &a->vars[i];
+    }
+    if (a->count == MAX_SYMBOLS) {
+        reject(a, "demasiadas variables en el cuerpo");
+        return &a->vars[MAX_SYMBOLS - 1];
+    }
+    VariableUsage *u = &a->vars[a->count++];
+    memset(u, 0, sizeof(*u));
+    u->name = name;
+    return u;
+}
+
+static int is_cursor(BodyAnalysis *a, const char *name) {
+    if (strcmp(name, a->cursor) == 0) return 1;
+    for (int i = 0; i < a->count; i++) {
+        if (a->vars[i].nested_cursor && strcmp(a->vars[i].name, name) == 0) return 1;
+    }
+    return 0;
+}
+
+static const char* element_type_name(const char *array_type) {
+    if (strcmp(array_type, "ARRAY [INTEGER]") == 0) return "INTEGER";
+    if (strcmp(array_type, "ARRAY [REAL]") == 0) return "REAL";
+    return "STRING";
+}
+
+// Tipo estático de una expresión, o NULL si no se puede saber (ej. objetos de clases del usuario)
+static const char* static_type(BodyAnalysis *a, AstNode *node) {
+    switch (node->type) {
+        case NODE_TYPE_LITERAL: {
+            LiteralNode *n = (LiteralNode*)node;
+            if (n->literal_type == LITERAL_TYPE_INT) return "INTEGER";
+            if (n->literal_type == LITERAL_TYPE_BOOLEAN) return "BOOLEAN";
+            return n->literal_type == LITERAL_TYPE_REAL ? "REAL" : "STRING";
+        }
+        case NODE_TYPE_VARIABLE: {
+            VariableNode *n = (VariableNode*)node;
+            if (is_cursor(a, n->name)) return "INTEGER";
+            SymbolTableEntry *entry = lookup_entry(a->table, n->name);
+            return entry ? entry->type_name : NULL;
+        }
+        case NODE_TYPE_BINARY_EXPR:
+            return static_type(a, ((BinaryExprNode*)node)->left);
+        case NODE_TYPE_COMPARISON_EXPR:
+        case NODE_TYPE_BOOLEAN_EXPR:
+            return "BOOLEAN";
+        case NODE_TYPE_ATTRIBUTE_ACCESS:
+        case NODE_TYPE_METHOD_CALL: {
+            AstNode *object = node->type == NODE_TYPE_METHOD_CALL
+                ? ((MethodCallNode*)node)->object_node : ((AttributeAccessNode*)node)->object_node;
+            const char *feature = node->type == NODE_TYPE_METHOD_CALL
+                ? ((MethodCallNode*)node)->method_name : ((AttributeAccessNode*)node)->attribute_name;
+            const char *object_type = static_type(a, object);
+            if (!object_type) return NULL;
+            if (is_array_type(object_type)) {
+                if (strcmp(feature, "item") == 0 || strcmp(feature, "sum") == 0
+                    || strcmp(feature, "min") == 0 || strcmp(feature, "max") == 0) {
+                    return element_type_name(object_type);
+                }
+                return "INTEGER";
+            }
+            if (strcmp(object_type, "STRING") == 0) {
+                if (strcmp(feature, "substring") == 0) return "STRING";
+                if (strcmp(feature, "split") == 0) return "ARRAY [STRING]";
+                return "INTEGER";
+            }
+            return NULL;
+        }
+        default:
+            return NULL;
+    }
+}
+
+// Features de ARRAY que no cambian su tamaño (note_array_access revisa qué elementos tocan)
+static int is_element_wise_array_feature(const char *feature) {
+    static const char *allowed[] = { "item", "put", "count", "lower", "upper", "valid_index", "sum", "min", "max", NULL };
+    for (int i = 0; allowed[i]; i++) {
+        if (strcmp(feature, allowed[i]) == 0) return 1;
+    }
+    return 0;
+}
+
+// El argumento es exactamente el cursor: cada iteración toca su propio elemento
+static int is_own_index(BodyAnalysis *a, ArgumentListNode *args, int position) {
+    if (!args || args->count <= position) return 0;
+    AstNode *index = args->arguments[position];
+    return index->type == NODE_TYPE_VARIABLE && strcmp(((VariableNode*)index)->name, a->cursor) == 0;
+}
+
+static void note_array_access(BodyAnalysis *a, AstNode *object, const char *feature, ArgumentListNode *args) {
+    int put = strcmp(feature, "put") == 0;
+    int spread = strcmp(feature, "sum") == 0 || strcmp(feature, "min") == 0 || strcmp(feature, "max") == 0
+        || (strcmp(feature, "item") == 0 && !is_own_index(a, args, 0));
+    if (put && !is_own_index(a, args, 1)) {
+        reject(a, "'put' en un índice que no es el cursor '%s'", a->cursor);
+        return;
+    }
+    // Un ARRAY que no está en una variable (ej. el de split) es nuevo en cada iteración
+    if ((!put && !spread) || object->type != NODE_TYPE_VARIABLE) return;
+    const char *name = ((VariableNode*)object)->name;
+    ArrayUsage *u = NULL;
+    for (int i = 0; i < a->array_count && !u; i++) {
+        if (strcmp(a->arrays[i].name, name) == 0) u = &a->arrays[i];
+    }
+    if (!u) {
+        if (a->array_count == MAX_SYMBOLS) {
+            reject(a, "demasiados ARRAY en el cuerpo");
+            return;
+        }
+        u = &a->arrays[a->array_count++];
+        memset(u, 0, sizeof(*u));
+        u->name = name;
+    }
+    if (put) u->puts++;
+    else u->spread_reads++;
+}
+
+static void scan_expression(BodyAnalysis *a, AstNode *node);
+
+static void scan_arguments(BodyAnalysis *a, ArgumentListNode *args) {
+    for (int i = 0; args && i < args->count; i++) scan_expression(a, args->arguments[i]);
+}
+
+static void scan_call(BodyAnalysis *a, AstNode *object, const char *feature, ArgumentListNode *args) {
+    const char *object_type = static_type(a, object);
+    if (!object_type) {
+        reject(a, "llamada a '%s' sobre un objeto de una clase del usuario", feature);
+    } else if (is_array_type(object_type) && !is_element_wise_array_feature(feature)) {
+        reject(a, "'%s' modifica el ARRAY completo", feature);
+    } else if (!is_array_type(object_type) && strcmp(object_type, "STRING") != 0) {
+        reject(a, "'%s' sobre un valor de tipo %s", feature, object_type);
+    } else if (is_array_type(object_type)) {
+        note_array_access(a, object, feature, args);
+    }
+    scan_expression(a, object);
+    scan_arguments(a, args);
+}
+
+static void note_read(BodyAnalysis *a, const char *name) {
+    if (is_cursor(a, name) || strcmp(name, "Current") == 0) return;
+    VariableUsage *u = usage_of(a, name);
+    if (!u->defined) u->reads++;
+}
+
+static void scan_expression(BodyAnalysis *a, AstNode *node) {
+    if (!node || a->rejected) return;
+    switch (node->type) {
+        case NODE_TYPE_LITERAL:
+            break;
+        case NODE_TYPE_VARIABLE: {
+            const char *name = ((VariableNode*)node)->name;
+            if (!is_cursor(a, name) && !lookup_entry(a->table, name)) {
+                // Sin variable: una rutina de Current sin argumentos, o read_line, read_integer...
+                // (leer la entrada depende del orden de las iteraciones)
+                if (find_current_feature(a->table, name)) {
+                    reject(a, "llamada a '%s'", name);
+                    break;
+                }
+                if (io_is_builtin(name)) {
+                    reject(a, "lectura de la entrada ('%s')", name);
+                    break;
+                }
+            }
+            note_read(a, name);
+            break;
+        }
+        case NODE_TYPE_BINARY_EXPR:
+            scan_expression(a, ((BinaryExprNode*)node)->left);
+            scan_expression(a, ((BinaryExprNode*)node)->right);
+            break;
+        case NODE_TYPE_COMPARISON_EXPR:
+            scan_expression(a, ((ComparisonExprNode*)node)->left);
+            scan_expression(a, ((ComparisonExprNode*)node)->right);
+            break;
+        case NODE_TYPE_BOOLEAN_EXPR:
+            scan_expression(a, ((BooleanExprNode*)node)->left);
+            scan_expression(a, ((BooleanExprNode*)node)->right);
+            break;
+        case NODE_TYPE_PROCEDURE_CALL: {
+            ProcedureCallNode *n = (ProcedureCallNode*)node;
+            if (strcmp(n->name, "print") != 0) reject(a, "llamada a '%s'", n->name);
+            scan_arguments(a, n->arguments);
+            break;
+        }
+        case NODE_TYPE_ATTRIBUTE_ACCESS: {
+            AttributeAccessNode *n = (AttributeAccessNode*)node;
+            scan_call(a, n->object_node, n->attribute_name, NULL);
+            break;
+        }
+        case NODE_TYPE_METHOD_CALL: {
+            MethodCallNode *n = (MethodCallNode*)node;
+            scan_call(a, n->object_node, n->method_name, n->arguments);
+            break;
+        }
+        default:
+            reject(a, "construcción no soportada dentro del cuerpo");
+            break;
+    }
+}
+
+static void scan_statements(BodyAnalysis *a, StatementListNode *list, int top_level);
+
+static void scan_assignment(BodyAnalysis *a, AssignNode *n, int top_level) {
+    if (n->target->type != NODE_TYPE_VARIABLE) {
+        reject(a, "asignación a un atributo");
+        return;
+    }
+    const char *name = ((VariableNode*)n->target)->name;
+    if (is_cursor(a, name)) {
+        reject(a, "asignación al cursor '%s'", name);
+        return;
+    }
+
+    BinaryExprNode *binary = n->expression->type == NODE_TYPE_BINARY_EXPR ? (BinaryExprNode*)n->expression : NULL;
+    if (binary && (binary->op == '+' || binary->op == '-' || binary->op == '*')
+        && binary->left->type == NODE_TYPE_VARIABLE && strcmp(((VariableNode*)binary->left)->name, name) == 0) {
+        // x := x op e: candidata a reducción (la lectura de x no cuenta)
+        scan_expression(a, binary->right);
+        VariableUsage *u = usage_of(a, name);
+        if (binary->op == '+') u->adds++;
+        else if (binary->op == '-') u->subtracts++;
+        else u->multiplies++;
+        return;
+    }
+
+    scan_expression(a, n->expression);
+    VariableUsage *u = usage_of(a, name);
+    if (top_level && !u->defined && u->reads == 0 && u->adds == 0 && u->subtracts == 0 && u->multiplies == 0) {
+        u->defined = 1; // Desde acá las lecturas ven el valor de esta misma iteración
+    }
+    u->plain++;
+}
+
+static void scan_statement(BodyAnalysis *a, AstNode *node, int top_level) {
+    if (!node || a->rejected) return;
+    switch (node->type) {
+        case NODE_TYPE_ASSIGN:
+            scan_assignment(a, (AssignNode*)node, top_level);
+            break;
+        case NODE_TYPE_IF: {
+            IfNode *n = (IfNode*)node;
+            scan_expression(a, n->condition);
+            scan_statements(a, n->then_branch, 0);
+            scan_statements(a, n->else_branch, 0);
+            break;
+        }
+        case NODE_TYPE_LOOP: {
+            LoopNode *n = (LoopNode*)node;
+            scan_statements(a, n->initialization, top_level); // La inicialización siempre se ejecuta
+            scan_expression(a, n->condition);
+            scan_statements(a, n->loop_body, 0);
+            break;
+        }
+        case NODE_TYPE_ACROSS: {
+            AcrossNode *n = (AcrossNode*)node;
+            scan_expression(a, n->lower);
+            scan_expression(a, n->upper);
+            if (is_cursor(a, n->cursor_name) || lookup_entry(a->table, n->cursor_name)) {
+                reject(a, "el cursor '%s' de un across anidado oculta otra variable", n->cursor_name);
+                break;
+            }
+            VariableUsage *u = usage_of(a, n->cursor_name);
+            if (u->reads || u->plain || u->adds || u->subtracts || u->multiplies) {
+                reject(a, "'%s' se usa como cursor y como variable", n->cursor_name);
+                break;
+            }
+            u->nested_cursor = 1;
+            scan_statements(a, n->loop_body, 0);
+            break;
+        }
+        case NODE_TYPE_CREATE:
+            reject(a, "create dentro del cuerpo");
+            break;
+        case NODE_TYPE_STATEMENT_LIST:
+            scan_statements(a, (StatementListNode*)node, top_level);
+            break;
+        default:
+            scan_expression(a, node);
+            break;
+    }
+}
+
+static void scan_statements(BodyAnalysis *a, StatementListNode *list, int top_level) {
+    for (int i = 0; list && i < list->count && !a->rejected; i++) scan_statement(a, list->statements[i], top_level);
+}
+
+static void classify(BodyAnalysis *a) {
+    for (int i = 0; i < a->count && !a->rejected; i++) {
+        VariableUsage *u = &a->vars[i];
+        int reductions = u->adds + u->subtracts + u->multiplies;
+        u->kind = USAGE_READ_ONLY;
+        if (u->nested_cursor || (u->plain == 0 && reductions == 0)) continue;
+
+        if (u->defined || (reductions == 0 && u->reads == 0)) {
+            u->kind = USAGE_LAST_WRITE;
+            continue;
+        }
+        if (u->plain || u->reads || (u->multiplies && u->adds + u->subtracts)) {
+            reject(a, "'%s' se lee o se combina de formas distintas entre iteraciones", u->name);
+            continue;
+        }
+
+        // Reducción: el valor inicial debe existir y admitir la operación
+        u->kind = u->multiplies ? USAGE_REDUCE_MUL : USAGE_REDUCE_ADD;
+        SymbolTableEntry *entry = lookup_entry(a->table, u->name);
+        ValueType type = entry ? entry->value.type : VAL_TYPE_NULL;
+        int numeric = type == VAL_TYPE_INT || type == VAL_TYPE_REAL;
+        int concatenation = type == VAL_TYPE_STRING && u->kind == USAGE_REDUCE_ADD && u->subtracts == 0;
+        if (!numeric && !concatenation) {
+            reject(a, "la reducción sobre '%s' necesita un valor inicial INTEGER, REAL o STRING", u->name);
+        }
+    }
+}
+
+static int assigned_in_body(BodyAnalysis *a, const char *name) {
+    for (int i = 0; i < a->count; i++) {
+        VariableUsage *u = &a->vars[i];
+        if (strcmp(u->name, name) == 0) return u->plain || u->adds || u->subtracts || u->multiplies;
+    }
+    return 0;
+}
+
+// Mismo ARRAY: por nombre o porque las dos variables apuntan al mismo objeto
+static int same_array(BodyAnalysis *a, const char *name1, const char *name2) {
+    if (strcmp(name1, name2) == 0) return 1;
+    SymbolTableEntry *e1 = lookup_entry(a->table, name1), *e2 = lookup_entry(a->table, name2);
+    return e1 && e2 && e1->value.type == VAL_TYPE_ARRAY && e2->value.type == VAL_TYPE_ARRAY
+        && e1->value.as.array_val == e2->value.as.array_val;
+}
+
+// Un put en el índice del cursor solo choca con las lecturas de otros elementos del mismo ARRAY
+static void check_arrays(BodyAnalysis *a) {
+    int writes = 0;
+    for (int i = 0; i < a->array_count; i++) writes += a->arrays[i].puts;
+    if (writes == 0) return;
+    for (int i = 0; i < a->array_count && !a->rejected; i++) {
+        ArrayUsage *u = &a->arrays[i];
+        if (assigned_in_body(a, u->name)) {
+            reject(a, "el ARRAY '%s' cambia dentro del cuerpo", u->name);
+            break;
+        }
+        for (int j = 0; j < a->array_count && u->puts; j++) {
+            if (a->arrays[j].spread_reads && same_array(a, u->name, a->arrays[j].name)) {
+                reject(a, "'%s' lee elementos de '%s' que escriben otras iteraciones", a->arrays[j].name, u->name);
+                break;
+            }
+        }
+    }
+}
+
+static void analyze_body(BodyAnalysis *a, AcrossNode *node, SymbolTable *table) {
+    a->table = table;
+    a->cursor = node->cursor_name;
+    a->count = 0;
+    a->array_count = 0;
+    a->rejected = 0;
+    a->reason[0] = '\0';
+    scan_statements(a, node->loop_body, 1);
+    check_arrays(a);
+    classify(a);
+}
+
+/* --- Ejecución por bloques --- */
+
+static RuntimeValue identity_for(VariableUsage *u, ValueType type) {
+    RuntimeValue value;
+    value.type = type;
+    if (type == VAL_TYPE_INT) value.as.int_val = u->kind == USAGE_REDUCE_MUL ? 1 : 0;
+    else if (type == VAL_TYPE_REAL) value.as.real_val = u->kind == USAGE_REDUCE_MUL ? 1.0 : 0.0;
+    else value.as.string_val = mem_strdup(MEM_STRING, "");
+    return value;
+}
+
+static void run_chunk(void *context, int k) {
+    AcrossJob *job = context;
+    AcrossChunk *chunk = &job->chunks[k];
+    BodyAnalysis *a = job->analysis;
+
+    SymbolTable *scope = mem_alloc(MEM_SCOPE, sizeof(SymbolTable));
+    init_symbol_table(scope);
+    scope->parent = job->table;
+    chunk->scope = scope;
+    output_capture_begin(&chunk->output);
+
+    // Tras un error en un bloque anterior no tiene sentido seguir
+    if (__atomic_load_n(&job->first_failed, __ATOMIC_RELAXED) < k) {
+        output_capture_end();
+        return;
+    }
+
+    declare_symbol(scope, a->cursor, "INTEGER");
+    for (int i = 0; i < a->count; i++) {
+        VariableUsage *u = &a->vars[i];
+        if (u->kind == USAGE_REDUCE_ADD || u->kind == USAGE_REDUCE_MUL) {
+            set_symbol(scope, u->name, identity_for(u, lookup_entry(job->table, u->name)->value.type));
+        }
+    }
+
+    long long first = job->count * k / job->chunk_count;
+    long long last = job->count * (k + 1) / job->chunk_count;
+    jmp_buf recover;
+    jmp_buf *previous = runtime_error_handler;
+    runtime_error_handler = &recover;
+    if (setjmp(recover) == 0) {
+        for (long long i = first; i < last; i++) {
+            RuntimeValue cursor = { .type = VAL_TYPE_INT };
+            cursor.as.int_val = (int)(job->lower + i);
+            set_symbol(scope, a->cursor, cursor);
+            eval_ast((AstNode*)job->node->loop_body, scope);
+        }
+    } else {
+        int seen = __atomic_load_n(&job->first_failed, __ATOMIC_RELAXED);
+        while (k < seen && !__atomic_compare_exchange_n(&job->first_failed, &seen, k, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        }
+    }
+    runtime_error_handler = previous;
+    output_capture_end();
+}
+
+static void free_scope(SymbolTable *scope) {
+    if (!scope) return;
+    for (int i = 0; i < scope->count; i++) {
+        mem_free(MEM_IDENTIFIER, scope->entries[i].name);
+        mem_free(MEM_IDENTIFIER, scope->entries[i].type_name);
+        if (scope->entries[i].value.type == VAL_TYPE_STRING) mem_free(MEM_STRING, scope->entries[i].value.as.string_val);
+    }
+    mem_free(MEM_SCOPE, scope);
+}
+
+// Combina el acumulado con el parcial de un bloque (el parcial sigue siendo del bloque)
+static RuntimeValue combine(RuntimeValue total, RuntimeValue part, UsageKind kind) {
+    RuntimeValue result = { .type = VAL_TYPE_VOID };
+    if (total.type == VAL_TYPE_STRING && part.type == VAL_TYPE_STRING) {
+        size_t len1 = strlen(total.as.string_val), len2 = strlen(part.as.string_val);
+        result.type = VAL_TYPE_STRING;
+        result.as.string_val = mem_realloc(MEM_STRING, total.as.string_val, len1 + len2 + 1);
+        memcpy(result.as.string_val + len1, part.as.string_val, len2 + 1);
+        return result;
+    }
+    if (total.type == VAL_TYPE_STRING) mem_free(MEM_STRING, total.as.string_val);
+    if (total.type == VAL_TYPE_INT && part.type == VAL_TYPE_INT) {
+        result.type = VAL_TYPE_INT;
+        result.as.int_val = kind == USAGE_REDUCE_MUL ? total.as.int_val * part.as.int_val : total.as.int_val + part.as.int_val;
+    } else if ((total.type == VAL_TYPE_INT || total.type == VAL_TYPE_REAL) && (part.type == VAL_TYPE_INT || part.type == VAL_TYPE_REAL)) {
+        double l = total.type == VAL_TYPE_REAL ? total.as.real_val : total.as.int_val;
+        double r = part.type == VAL_TYPE_REAL ? part.as.real_val : part.as.int_val;
+        result.type = VAL_TYPE_REAL;
+        result.as.real_val = kind == USAGE_REDUCE_MUL ? l * r : l + r;
+    }
+    return result;
+}
+
+static void merge_results(AcrossJob *job) {
+    BodyAnalysis *a = job->analysis;
+    for (int i = 0; i < a->count; i++) {
+        VariableUsage *u = &a->vars[i];
+        if (u->kind == USAGE_REDUCE_ADD || u->kind == USAGE_REDUCE_MUL) {
+            RuntimeValue total = lookup_entry(job->table, u->name)->value;
+            if (total.type == VAL_TYPE_STRING) total.as.string_val = mem_strdup(MEM_STRING, total.as.string_val);
+            for (int k = 0; k < job->chunk_count; k++) {
+                total = combine(total, find_symbol_entry(job->chunks[k].scope, u->name)->value, u->kind);
+            }
+            set_symbol(job->table, u->name, total);
+        } else if (u->kind == USAGE_LAST_WRITE) {
+            for (int k = job->chunk_count - 1; k >= 0; k--) {
+                SymbolTableEntry *entry = find_symbol_entry(job->chunks[k].scope, u->name);
+                if (!entry) continue;
+                RuntimeValue value = entry->value;
+                entry->value.type = VAL_TYPE_VOID; // El valor (si es STRING) pasa al scope del across
+                set_symbol(job->table, u->name, value);
+                break;
+            }
+        }
+    }
+}
+
+int eval_parallel_across(AcrossNode *node, SymbolTable *table, int lower, int upper) {
+    BodyAnalysis *analysis = malloc(sizeof(BodyAnalysis));
+    analyze_body(analysis, node, table);
+    if (analysis->rejected) {
+        if (!node->fallback_reported) {
+            fprintf(stderr, "Aviso: el across paralelo sobre '%s' se ejecuta en secuencia: %s.\n",
+                    node->cursor_name, analysis->reason);
+            node->fallback_reported = 1;
+        }
+        free(analysis);
+        return 0;
+    }
+    if (upper < lower) {
+        free(analysis);
+        return 1;
+    }
+
+    AcrossJob *job = malloc(sizeof(AcrossJob));
+    job->node = node;
+    job->table = table;
+    job->analysis = analysis;
+    job->lower = lower;
+    job->count = (long long)upper - lower + 1;
+    job->chunk_count = job->count < ACROSS_CHUNKS ? (int)job->count : ACROSS_CHUNKS;
+    job->first_failed = job->chunk_count;
+    pool_run(job->chunk_count, run_chunk, job);
+
+    // La salida se emite en orden de iteraciones; tras un error, solo hasta el bloque que falló
+    for (int k = 0; k < job->chunk_count; k++) {
+        if (k <= job->first_failed) output_capture_emit(&job->chunks[k].output);
+        else free(job->chunks[k].output.data);
+    }
+    int failed = job->first_failed < job->chunk_count;
+    if (!failed) merge_results(job);
+
+    for (int k = 0; k < job->chunk_count; k++) free_scope(job->chunks[k].scope);
+    free(job);
+    free(analysis);
+    if (failed) runtime_abort();
+    return 1;
+}
@@ -0,0 +1,26 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "interpreter.h"
+
+/* Comentario general:
+   - Ejecución de 'across lower |..| upper as i parallel loop ... end' sobre el pool de hilos.
+   - El intervalo se parte en bloques fijos (ACROSS_CHUNKS como máximo): la partición no depende de
+     la cantidad de hilos, solo del intervalo, así que el resultado tampoco.
+   - Cada bloque corre en su propio scope (padre: el scope del across) con el cursor como local.
+   - Antes de ejecutar se analiza el cuerpo. Cada variable asignada debe ser:
+       * una reducción: solo aparece como x := x + e, x := x - e (INTEGER, REAL; '+' también STRING)
+         o x := x * e. Cada bloque arranca del neutro y los parciales se combinan en orden de bloque.
+       * una temporal: nunca se lee antes de asignarla en la iteración. Queda el último valor escrito.
+     No se aceptan create, asignaciones a atributos, llamadas a métodos de clases del usuario ni
+     comandos de ARRAY que cambian el tamaño o todo el contenido. Si el cuerpo no cumple, el across
+     se ejecuta en secuencia (con un aviso en stderr).
+   - La salida de print de cada bloque se captura y se emite en el orden de las iteraciones.
+*/
+
+#define ACROSS_CHUNKS 64
+
+// Ejecuta el across en paralelo. Devuelve 0 (sin ejecutar nada) si el cuerpo no es paralelizable.
+int eval_parallel_across(AcrossNode *node, SymbolTable *table, int lower, int upper);
+
+#endif // PARALLEL_H
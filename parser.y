@@ -1,21 +1,26 @@
+%code requires {
+    /* El scanner reentrante (lexer.l) es el estado del lexer; el mismo typedef que declara Flex */
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void *yyscan_t;
+    #endif
+}
+
 %{
     #include <stdio.h>
     #include <stdlib.h>
     #include <string.h>
     #include "ast.h"
-
-    extern char *yytext;
-    extern int yylineno;
-    int yylex(void);
-    extern FILE *yyin;
-
-    void yyerror(AstNode **root, const char *s);
-    AstNode *root_node;
+    #include "memstats.h"
+    #include "intern.h"
+    #include "frontend.h"
 
     /* Comentario: Este archivo define la gramática (Bison) para el lenguaje.
        - %union define los tipos semánticos usados en las reglas.
        - Muchas producciones devuelven nodos del AST (AstNode* o listas especializadas).
-       - parse-param se usa para recibir un puntero al root desde main.c.
+       - El parser es puro (api.pure): no tiene variables globales. Recibe el scanner (param) y un
+         puntero al root (parse-param); ver frontend.h.
+       - Los identificadores y tipos llegan internados (intern.h): no se liberan.
        - Las reglas más importantes: program, class_list, class_declaration, feature_declaration, statement, expression.
     */
 %}
@@ -28,9 +33,10 @@
     struct ArgumentListNode *arg_list;
     struct StatementListNode *stmt_list;
     struct DeclarationListNode *decl_list;
+    struct LazyBody *lazy_body;
 }
 
-%type <string_val> type
+%type <string_val> type optional_result_type
 
 %token <string_val> TOKEN_IDENTIFIER TOKEN_STRING
 %token <int_val> TOKEN_NUMBER_INT
@@ -41,35 +47,67 @@
 %token TOKEN_ASSIGN TOKEN_LE TOKEN_GE TOKEN_EQ TOKEN_LT TOKEN_GT TOKEN_DOT
 %token TOKEN_PLUS TOKEN_MINUS TOKEN_MULT TOKEN_DIV
 %token TOKEN_LPAREN TOKEN_RPAREN TOKEN_SEMI TOKEN_COLON TOKEN_COMMA
+%token TOKEN_LBRACKET TOKEN_RBRACKET
+%token TOKEN_ACROSS TOKEN_AS TOKEN_PARALLEL TOKEN_INTERVAL
+%token TOKEN_ONCE TOKEN_SEPARATE
+%token TOKEN_NOT TOKEN_AND TOKEN_OR TOKEN_IMPLIES TOKEN_TRUE TOKEN_FALSE
+%token <lazy_body> TOKEN_LAZY_BODY /* Cuerpo salteado por el scanner, hasta su 'end' inclusive (ver frontend.h) */
+%token TOKEN_BODY_START            /* Primer token al parsear un cuerpo diferido */
 
 %nonassoc TOKEN_ASSIGN
+%right TOKEN_IMPLIES
+%left TOKEN_OR
+%left TOKEN_AND
 %nonassoc TOKEN_LT TOKEN_GT TOKEN_LE TOKEN_GE TOKEN_EQ
 %left TOKEN_PLUS TOKEN_MINUS
 %left TOKEN_MULT TOKEN_DIV
+%right TOKEN_NOT
 %left TOKEN_DOT
+%nonassoc NO_CREATION_ARGS NO_ONCE_KEY /* Menores que TOKEN_LPAREN: "create a.make (" y "once (" siempre abren los paréntesis */
+%nonassoc TOKEN_LPAREN
 
 %type <node> program class_declaration expression statement
-%type <node> if_statement loop_statement create_statement
+%type <node> if_statement loop_statement create_statement across_statement
+%type <int_val> optional_parallel
 %type <node> primary_expression
 %type <stmt_list> statement_list optional_statements feature_list class_list
-%type <arg_list> argument_list optional_argument_list
-%type <decl_list> local_clause declarations declaration_list identifier_list
-%type <node> feature_declaration
+%type <arg_list> argument_list optional_argument_list optional_creation_args
+%type <decl_list> local_clause declarations declaration_list identifier_list formal_arg_list
+%type <node> feature_declaration routine_body
+%type <int_val> routine_mark
 
+%define api.pure full
+%param { yyscan_t scanner }
 %parse-param { AstNode **root }
 
+%code {
+    int yylex(YYSTYPE *yylval, yyscan_t scanner);
+    void yyerror(yyscan_t scanner, AstNode **root, const char *s);
+    int yyget_lineno(yyscan_t scanner);
+    char *yyget_text(yyscan_t scanner);
+    struct ParseContext *yyget_extra(yyscan_t scanner);
+}
+
 %%
 
 /* Programa principal: puede ser una lista de clases o sentencias sueltas (tests antiguos) */
 program:
     class_list { *root = (AstNode*)$1; }
     | optional_statements { *root = (AstNode*)$1; } /* Para tests sin clases */
+    | TOKEN_LOCAL declarations optional_statements {
+        /* Declaraciones sueltas (usado por el REPL): se evalúan como un cuerpo de feature sin nombre */
+        *root = create_feature_body_node($2, $3);
+    }
+    | TOKEN_BODY_START statement_list {
+        /* Cuerpo diferido de una rutina (parse_feature_body): las sentencias, sin el 'end' */
+        *root = (AstNode*)$2;
+    }
     ;
 
 class_list:
     class_declaration {
         /* Crea una lista de clases con un solo elemento (caso base recursivo) */
-        $$ = create_statement_list_node($1, NULL);
+        $$ = create_statement_list_node($1);
     }
     | class_list class_declaration {
         /* Agrega una nueva clase al final de la lista de clases (caso recursivo) */
@@ -84,32 +122,85 @@ class_declaration:
     ;
 
 feature_list:
-    feature_declaration { $$ = create_statement_list_node($1, NULL); }
+    feature_declaration { $$ = create_statement_list_node($1); }
     | feature_list feature_declaration { $$ = append_to_statement_list($1, $2); }
     ;
 
+/* Rutinas: "f do ... end", "f (a: T; b: U): R do ... end" y "f: R do ... end" (función sin
+   argumentos). Esta última comparte el prefijo con un atributo: se distinguen por el "do"/"once". */
 feature_declaration:
-    TOKEN_IDENTIFIER formal_args local_clause TOKEN_DO statement_list TOKEN_END {
-        $$ = create_feature_body_node($3, $5);
+    TOKEN_IDENTIFIER routine_body {
+        $$ = $2;
         ((FeatureBodyNode*)$$)->feature_name = $1;
     }
+    | TOKEN_IDENTIFIER TOKEN_LPAREN formal_arg_list TOKEN_RPAREN optional_result_type routine_body {
+        $$ = $6;
+        ((FeatureBodyNode*)$$)->feature_name = $1;
+        ((FeatureBodyNode*)$$)->parameters = $3;
+        ((FeatureBodyNode*)$$)->result_type = $5;
+    }
+    | identifier_list TOKEN_COLON type routine_body {
+        if ($1->count != 1) {
+            yyerror(scanner, root, "una función se declara con un solo nombre");
+            YYERROR;
+        }
+        $$ = $4;
+        ((FeatureBodyNode*)$$)->feature_name = $1->items[0].variable_name;
+        ((FeatureBodyNode*)$$)->result_type = $3;
+        mem_free(MEM_AST, $1); // El nombre pasó a la rutina
+    }
     | identifier_list TOKEN_COLON type {
         // Asigna el tipo a cada identificador en la lista
         set_declaration_type($1, $3);
         $$ = (AstNode*)$1;
-        free($3);
     }
     ;
 
-formal_args:
-    /* empty */
-    | TOKEN_LPAREN formal_arg_list TOKEN_RPAREN
+routine_body:
+    local_clause routine_mark statement_list TOKEN_END {
+        $$ = create_feature_body_node($1, $3);
+        ((FeatureBodyNode*)$$)->routine_kind = (RoutineKind)$2;
+    }
+    | local_clause routine_mark TOKEN_LAZY_BODY {
+        /* Con lazy_bodies el scanner saltea el cuerpo: se parsea al primer uso (parse_feature_body) */
+        $$ = create_feature_body_node($1, NULL);
+        ((FeatureBodyNode*)$$)->routine_kind = (RoutineKind)$2;
+        atomic_init(&((FeatureBodyNode*)$$)->lazy_body, $3);
+    }
+    ;
+
+routine_mark:
+    TOKEN_DO { $$ = ROUTINE_DO; }
+    | TOKEN_ONCE %prec NO_ONCE_KEY { $$ = ROUTINE_ONCE; }
+    | TOKEN_ONCE TOKEN_LPAREN TOKEN_STRING TOKEN_RPAREN {
+        /* Clave del once: "OBJECT" guarda un resultado por objeto; "PROCESS" y "THREAD", uno por clase.
+           "once (" siempre se lee como clave (el cuerpo no puede empezar con una expresión entre
+           paréntesis): el %prec de la alternativa sin clave resuelve el conflicto con el "(". */
+        if (strcmp($3, "OBJECT") == 0) {
+            $$ = ROUTINE_ONCE_OBJECT;
+        } else if (strcmp($3, "PROCESS") == 0 || strcmp($3, "THREAD") == 0) {
+            $$ = ROUTINE_ONCE;
+        } else {
+            mem_free(MEM_STRING, $3);
+            yyerror(scanner, root, "clave de once desconocida (se espera \"OBJECT\", \"PROCESS\" o \"THREAD\")");
+            YYERROR;
+        }
+        mem_free(MEM_STRING, $3);
+    }
+    ;
+
+optional_result_type:
+    /* empty */ { $$ = NULL; }
+    | TOKEN_COLON type { $$ = $2; }
     ;
 
 formal_arg_list:
-    /* empty */
-    | identifier_list TOKEN_COLON type
-    | formal_arg_list TOKEN_SEMI identifier_list TOKEN_COLON type
+    /* empty */ { $$ = NULL; }
+    | identifier_list TOKEN_COLON type { $$ = $1; set_declaration_type($$, $3); }
+    | formal_arg_list TOKEN_SEMI identifier_list TOKEN_COLON type {
+        set_declaration_type($3, $5);
+        $$ = append_to_declaration_list($1, $3);
+    }
     ;
 
 local_clause:
@@ -122,21 +213,41 @@ declarations:
     ;
 
 declaration_list:
-    identifier_list TOKEN_COLON type { $$ = $1; set_declaration_type($$, $3); free($3); }
-    | declaration_list TOKEN_SEMI identifier_list TOKEN_COLON type { $$ = append_to_declaration_list($1, $3); set_declaration_type($$, $5); free($5); }
+    identifier_list TOKEN_COLON type { $$ = $1; set_declaration_type($$, $3); }
+    | declaration_list TOKEN_SEMI identifier_list TOKEN_COLON type {
+        /* El tipo se aplica solo al grupo nuevo, no a las declaraciones anteriores */
+        set_declaration_type($3, $5);
+        $$ = append_to_declaration_list($1, $3);
+    }
     ;
 
 identifier_list:
-    TOKEN_IDENTIFIER { $$ = create_declaration_list_node($1, NULL); }
-    | identifier_list TOKEN_COMMA TOKEN_IDENTIFIER { $$ = create_declaration_list_node($3, $1); }
+    TOKEN_IDENTIFIER { $$ = create_declaration_list_node($1); }
+    | identifier_list TOKEN_COMMA TOKEN_IDENTIFIER { $$ = append_declaration($1, $3); }
     ;
 
 type:
     TOKEN_IDENTIFIER { $$ = $1; }
+    | TOKEN_IDENTIFIER TOKEN_LBRACKET type TOKEN_RBRACKET {
+        /* Tipo genérico (ej. ARRAY [INTEGER]): se guarda como texto "NOMBRE [PARAMETRO]" */
+        size_t length = strlen($1) + strlen($3) + 3;
+        char *text = malloc(length + 1);
+        sprintf(text, "%s [%s]", $1, $3);
+        $$ = intern(text, length);
+        free(text);
+    }
+    | TOKEN_SEPARATE TOKEN_IDENTIFIER {
+        /* Objeto con su propio procesador (ver scoop.h): se guarda como texto "separate NOMBRE" */
+        size_t length = strlen($2) + 9;
+        char *text = malloc(length + 1);
+        sprintf(text, "separate %s", $2);
+        $$ = intern(text, length);
+        free(text);
+    }
     ;
 
 statement_list:
-    statement { $$ = create_statement_list_node($1, NULL); }
+    statement { $$ = create_statement_list_node($1); }
     | statement_list statement { $$ = append_to_statement_list($1, $2); }
     ;
 
@@ -150,11 +261,23 @@ statement:
     | primary_expression { $$ = $1; }
     | if_statement { $$ = $1; }
     | loop_statement { $$ = $1; }
+    | across_statement { $$ = $1; }
     | create_statement { $$ = $1; }
     ;
 
 create_statement:
-    TOKEN_CREATE TOKEN_IDENTIFIER { $$ = create_create_node($2); }
+    TOKEN_CREATE TOKEN_IDENTIFIER { $$ = create_create_node($2, NULL, NULL); }
+    | TOKEN_CREATE TOKEN_IDENTIFIER TOKEN_DOT TOKEN_IDENTIFIER optional_creation_args {
+        /* Creación con procedimiento de creación (ej. create a.make (1, 10)) */
+        $$ = create_create_node($2, $4, $5);
+    }
+    ;
+
+/* Como con "once (", un "(" tras el procedimiento de creación se lee como sus argumentos aunque pueda
+   empezar la sentencia siguiente; el %prec resuelve ese conflicto en vez de dejarlo en el recuento de bison. */
+optional_creation_args:
+    /* empty */ %prec NO_CREATION_ARGS { $$ = NULL; }
+    | TOKEN_LPAREN optional_argument_list TOKEN_RPAREN { $$ = $2; }
     ;
 
 if_statement:
@@ -169,6 +292,18 @@ loop_statement:
     }
     ;
 
+/* across a |..| b as i [parallel] loop ... end: recorre el intervalo con i como INTEGER */
+across_statement:
+    TOKEN_ACROSS expression TOKEN_INTERVAL expression TOKEN_AS TOKEN_IDENTIFIER optional_parallel TOKEN_LOOP optional_statements TOKEN_END {
+        $$ = create_across_node($2, $4, $6, $7, $9);
+    }
+    ;
+
+optional_parallel:
+    /* empty */ { $$ = 0; }
+    | TOKEN_PARALLEL { $$ = 1; }
+    ;
+
 expression:
     primary_expression { $$ = $1; }
     | expression TOKEN_PLUS expression { $$ = create_binary_expr_node('+', $1, $3); }
@@ -180,12 +315,20 @@ expression:
     | expression TOKEN_LE expression { $$ = create_comparison_expr_node(TOKEN_LE, $1, $3); }
     | expression TOKEN_GE expression { $$ = create_comparison_expr_node(TOKEN_GE, $1, $3); }
     | expression TOKEN_EQ expression { $$ = create_comparison_expr_node(TOKEN_EQ, $1, $3); }
+    | TOKEN_NOT expression { $$ = create_boolean_expr_node(BOOL_NOT, $2, NULL); }
+    | expression TOKEN_AND expression { $$ = create_boolean_expr_node(BOOL_AND, $1, $3); }
+    | expression TOKEN_AND TOKEN_THEN expression %prec TOKEN_AND { $$ = create_boolean_expr_node(BOOL_AND_THEN, $1, $4); }
+    | expression TOKEN_OR expression { $$ = create_boolean_expr_node(BOOL_OR, $1, $3); }
+    | expression TOKEN_OR TOKEN_ELSE expression %prec TOKEN_OR { $$ = create_boolean_expr_node(BOOL_OR_ELSE, $1, $4); }
+    | expression TOKEN_IMPLIES expression { $$ = create_boolean_expr_node(BOOL_IMPLIES, $1, $3); }
     ;
 
 primary_expression:
     TOKEN_NUMBER_INT { $$ = create_int_literal_node($1); }
     | TOKEN_NUMBER_REAL { $$ = create_real_literal_node($1); }
     | TOKEN_STRING { $$ = create_string_literal_node($1); }
+    | TOKEN_TRUE { $$ = create_boolean_literal_node(1); }
+    | TOKEN_FALSE { $$ = create_boolean_literal_node(0); }
     | TOKEN_IDENTIFIER { $$ = create_variable_node($1); }
     | TOKEN_LPAREN expression TOKEN_RPAREN { $$ = $2; }
     | TOKEN_IDENTIFIER TOKEN_LPAREN optional_argument_list TOKEN_RPAREN { $$ = create_procedure_call_node($1, $3); }
@@ -195,16 +338,16 @@ primary_expression:
 
 optional_argument_list:
     /* empty */ { $$ = NULL; }
-    | argument_list { $$ = reverse_argument_list($1); }
+    | argument_list { $$ = $1; }
     ;
 
 argument_list:
-    expression { $$ = create_argument_list_node($1, NULL); }
-    | argument_list TOKEN_COMMA expression { $$ = create_argument_list_node($3, $1); }
+    expression { $$ = create_argument_list_node($1); }
+    | argument_list TOKEN_COMMA expression { $$ = append_to_argument_list($1, $3); }
     ;
 
 %%
-void yyerror(AstNode **root, const char *s) {
-    fprintf(stderr, "Error de sintaxis en línea %d cerca de '%s': %s\n",
-            yylineno, yytext, s);
+void yyerror(yyscan_t scanner, AstNode **root, const char *s) {
+    fprintf(yyget_extra(scanner)->diagnostics, "Error de sintaxis en línea %d cerca de '%s': %s\n",
+            yyget_lineno(scanner), yyget_text(scanner), s);
 }
@@ -0,0 +1,404 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include "ast.h"
+#include "interpreter.h"
+#include "frontend.h"
+#include "intern.h"
+#include "output.h"
+#include "repl.h"
+#include "memstats.h"
+#include "meter.h"
+#include "heapdump.h"
+#include "scoop.h"
+
+/* Comentario general:
+   - Este archivo implementa el modo REPL: lee entradas, las parsea por separado (parse_text)
+     y las evalúa sobre un scope global que vive toda la sesión.
+   - Una entrada termina cuando se cierran todos sus bloques (class/do/once/if/from ... end).
+   - Los bloques 'class' se registran o redefinen en class_table; los objetos vivos alcanzables
+     desde el scope global reciben los atributos nuevos con su valor por defecto.
+   - ':load archivo' solo re-parsea las clases cuyo texto cambió desde la última carga.
+*/
+
+// Texto ya cargado de cada clase (para detectar cuáles cambiaron en ':load')
+typedef struct {
+    char *class_name;
+    unsigned long source_hash;
+} LoadedClass;
+
+static LoadedClass *loaded_classes = NULL;
+static int loaded_class_count = 0;
+static int loaded_class_capacity = 0;
+
+// ASTs de clases registradas: deben vivir mientras class_table apunte a sus features
+static AstNode **class_roots = NULL;
+static int class_root_count = 0;
+static int class_root_capacity = 0;
+
+static SymbolTable global_scope;
+static int interactive = 0;
+
+/* --- Escaneo de bloques ---
+   block_depth: calcula la profundidad de bloques abiertos en el texto, ignorando strings y comentarios.
+   - Abren bloque: class, do, once, if, from, across. Lo cierra: end.
+   - Si top_level_end no es NULL, se detiene en el 'end' que cierra el primer bloque de nivel superior
+     y guarda la posición siguiente.
+*/
+static int is_block_opener(const char *word, size_t len) {
+    return (len == 5 && strncmp(word, "class", 5) == 0)
+        || (len == 2 && strncmp(word, "do", 2) == 0)
+        || (len == 4 && strncmp(word, "once", 4) == 0)
+        || (len == 2 && strncmp(word, "if", 2) == 0)
+        || (len == 4 && strncmp(word, "from", 4) == 0)
+        || (len == 6 && strncmp(word, "across", 6) == 0);
+}
+
+static int block_depth(const char *text, const char **top_level_end) {
+    int depth = 0;
+    const char *p = text;
+    while (*p) {
+        if (p[0] == '-' && p[1] == '-') {
+            while (*p && *p != '\n') p++;
+        } else if (*p == '"') {
+            p++;
+            while (*p && *p != '"' && *p != '\n') p++;
+            if (*p == '"') p++;
+        } else if (isalpha((unsigned char)*p) || *p == '_') {
+            const char *word = p;
+            while (isalnum((unsigned char)*p) || *p == '_') p++;
+            size_t len = (size_t)(p - word);
+            if (is_block_opener(word, len)) {
+                depth++;
+            } else if (len == 3 && strncmp(word, "end", 3) == 0) {
+                depth--;
+                if (depth == 0 && top_level_end) {
+                    *top_level_end = p;
+                    return 0;
+                }
+            }
+        } else {
+            p++;
+        }
+    }
+    if (top_level_end) *top_level_end = NULL;
+    return depth;
+}
+
+static int is_blank(const char *text) {
+    while (*text) {
+        if (text[0] == '-' && text[1] == '-') {
+            while (*text && *text != '\n') text++;
+            continue;
+        }
+        if (!isspace((unsigned char)*text)) return 0;
+        text++;
+    }
+    return 1;
+}
+
+// Nombre de la clase declarada en un bloque 'class NOMBRE ...' (o 0 si el bloque no es una clase)
+static int chunk_class_name(const char *chunk, char *out, size_t out_size) {
+    while (isspace((unsigned char)*chunk) || (chunk[0] == '-' && chunk[1] == '-')) {
+        if (chunk[0] == '-') {
+            while (*chunk && *chunk != '\n') chunk++;
+        } else {
+            chunk++;
+        }
+    }
+    if (strncmp(chunk, "class", 5) != 0 || !isspace((unsigned char)chunk[5])) return 0;
+    chunk += 5;
+    while (isspace((unsigned char)*chunk)) chunk++;
+    size_t len = 0;
+    while ((isalnum((unsigned char)chunk[len]) || chunk[len] == '_') && len + 1 < out_size) len++;
+    if (len == 0) return 0;
+    memcpy(out, chunk, len);
+    out[len] = '\0';
+    return 1;
+}
+
+static unsigned long hash_text(const char *text, size_t len) {
+    unsigned long h = 5381;
+    for (size_t i = 0; i < len; i++) h = h * 33 + (unsigned char)text[i];
+    return h;
+}
+
+/* --- Parseo y evaluación de entradas --- */
+
+static AstNode* parse_chunk(const char *text, int first_line, int *ok) {
+    // Sin archivo .info: no se registran tokens ni AST
+    ParseContext context = { NULL, stderr };
+    AstNode *root = NULL;
+    *ok = (parse_text(text, strlen(text), first_line, &context, &root) == 0);
+    return *ok ? root : NULL;
+}
+
+static void eval_with_recovery(AstNode *node) {
+    jmp_buf recover;
+    runtime_error_handler = &recover;
+    meter_start(); // Los límites de ejecución valen por entrada
+    if (setjmp(recover) == 0) {
+        eval_ast(node, &global_scope);
+        // Cada entrada termina con los procesadores separate vacíos (su salida sale antes del prompt)
+        if (scoop_started && scoop_wait_all()) runtime_abort();
+    } else if (scoop_started) {
+        scoop_after_abort();
+    }
+    runtime_error_handler = NULL;
+    output_flush();
+}
+
+// Recorre los objetos alcanzables desde una tabla y completa los atributos de la clase redefinida
+static void refresh_live_objects(SymbolTable *table, ClassDefinition *class_def,
+                                 SymbolTable ***visited, int *visited_count, int *visited_capacity) {
+    for (int i = 0; i < table->count; i++) {
+        RuntimeValue value = table->entries[i].value;
+        if (value.type != VAL_TYPE_OBJECT || !value.as.object_val) continue;
+        SymbolTable *object = value.as.object_val;
+
+        int seen = 0;
+        for (int v = 0; v < *visited_count; v++) {
+            if ((*visited)[v] == object) { seen = 1; break; }
+        }
+        if (seen) continue;
+        if (*visited_count == *visited_capacity) {
+            *visited_capacity = *visited_capacity ? *visited_capacity * 2 : 16;
+            *visited = realloc(*visited, sizeof(SymbolTable*) * (*visited_capacity));
+        }
+        (*visited)[(*visited_count)++] = object;
+
+        if (object->owner_class_name && strcmp(object->owner_class_name, class_def->name) == 0) {
+            init_object_attributes(object, class_def);
+        }
+        refresh_live_objects(object, class_def, visited, visited_count, visited_capacity);
+    }
+}
+
+static void install_classes(AstNode *root) {
+    StatementListNode *list = (StatementListNode*)root;
+    for (int i = 0; i < list->count; i++) {
+        ClassNode *class_node = (ClassNode*)list->statements[i];
+        int existed = find_class(class_node->name) != NULL;
+        redefine_class(class_node->name, class_node->features);
+
+        if (existed) {
+            SymbolTable **visited = NULL;
+            int visited_count = 0, visited_capacity = 0;
+            refresh_live_objects(&global_scope, find_class(class_node->name), &visited, &visited_count, &visited_capacity);
+            free(visited);
+        }
+        if (interactive) {
+            printf("-- clase %s %s\n", class_node->name, existed ? "redefinida" : "registrada");
+        }
+    }
+
+    if (class_root_count == class_root_capacity) {
+        class_root_capacity = class_root_capacity ? class_root_capacity * 2 : 8;
+        class_roots = realloc(class_roots, sizeof(AstNode*) * class_root_capacity);
+    }
+    class_roots[class_root_count++] = root;
+}
+
+static int is_class_chunk(AstNode *root) {
+    return root && root->type == NODE_TYPE_STATEMENT_LIST
+        && ((StatementListNode*)root)->statements[0]
+        && ((StatementListNode*)root)->statements[0]->type == NODE_TYPE_CLASS_DECL;
+}
+
+// Evalúa una entrada completa: registra clases o ejecuta sentencias sobre el scope global
+static void handle_chunk(const char *text, int first_line) {
+    int ok;
+    AstNode *root = parse_chunk(text, first_line, &ok);
+    if (!ok || !root) return;
+
+    if (is_class_chunk(root)) {
+        install_classes(root);
+    } else {
+        eval_with_recovery(root);
+        free_ast(root);
+    }
+}
+
+// Registra el texto de una clase como cargado; devuelve 0 si ya estaba cargado sin cambios
+static int remember_class_source(const char *class_name, unsigned long hash) {
+    for (int i = 0; i < loaded_class_count; i++) {
+        if (strcmp(loaded_classes[i].class_name, class_name) == 0) {
+            if (loaded_classes[i].source_hash == hash) return 0;
+            loaded_classes[i].source_hash = hash;
+            return 1;
+        }
+    }
+    if (loaded_class_count == loaded_class_capacity) {
+        loaded_class_capacity = loaded_class_capacity ? loaded_class_capacity * 2 : 16;
+        loaded_classes = realloc(loaded_classes, loaded_class_capacity * sizeof(LoadedClass));
+    }
+    loaded_classes[loaded_class_count].class_name = strdup(class_name);
+    loaded_classes[loaded_class_count].source_hash = hash;
+    loaded_class_count++;
+    return 1;
+}
+
+/* load_file: divide el archivo en bloques de nivel superior y solo parsea las clases
+   cuyo texto cambió respecto de la última carga. El resto del texto se evalúa como sentencias.
+*/
+static void load_file(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *source = malloc(size + 1);
+    size_t read = fread(source, 1, size, file);
+    source[read] = '\0';
+    fclose(file);
+
+    int recompiled = 0, unchanged = 0;
+    const char *cursor = source;
+    int line = 1;
+    while (*cursor) {
+        const char *chunk_end = NULL;
+        block_depth(cursor, &chunk_end);
+        size_t len = chunk_end ? (size_t)(chunk_end - cursor) : strlen(cursor);
+        char *chunk = strndup(cursor, len);
+
+        if (!is_blank(chunk)) {
+            char class_name[256];
+            if (chunk_class_name(chunk, class_name, sizeof(class_name))) {
+                if (remember_class_source(class_name, hash_text(chunk, len))) {
+                    handle_chunk(chunk, line);
+                    recompiled++;
+                } else {
+                    unchanged++;
+                }
+            } else {
+                handle_chunk(chunk, line);
+            }
+        }
+
+        for (size_t i = 0; i < len; i++) {
+            if (cursor[i] == '\n') line++;
+        }
+        free(chunk);
+        cursor += len;
+    }
+    free(source);
+
+    if (interactive) {
+        printf("-- %s: %d clase(s) recompilada(s), %d sin cambios\n", path, recompiled, unchanged);
+    }
+}
+
+static void run_main_make(void) {
+    ClassDefinition *main_class = find_class("MAIN");
+    FeatureBodyNode *make_method = main_class ? find_feature(main_class->feature_list, "make") : NULL;
+    if (!make_method) {
+        fprintf(stderr, "No hay MAIN.make definido.\n");
+        return;
+    }
+    eval_with_recovery((AstNode*)make_method);
+}
+
+static void print_help(void) {
+    printf("Comandos:\n");
+    printf("  :load <archivo>  carga clases (solo re-parsea las que cambiaron)\n");
+    printf("  :run             ejecuta MAIN.make sobre el scope global\n");
+    printf("  :symbols         muestra la tabla de símbolos global\n");
+    printf("  :classes         lista las clases registradas\n");
+    printf("  :memory          muestra la memoria usada por categoría y las instancias por clase\n");
+    printf("  :dump <archivo>  escribe un snapshot del heap (JSON-lines, ver heap_report)\n");
+    printf("  :quit            sale del REPL\n");
+    printf("Cualquier otra entrada se evalúa como sentencias, 'local ...' o bloques 'class ... end'.\n");
+}
+
+// Devuelve 0 si el comando pide salir
+static int handle_command(char *line) {
+    line[strcspn(line, "\r\n")] = '\0';
+    output_flush();
+    if (strcmp(line, ":quit") == 0 || strcmp(line, ":q") == 0) {
+        return 0;
+    } else if (strncmp(line, ":load ", 6) == 0) {
+        char *path = line + 6;
+        while (isspace((unsigned char)*path)) path++;
+        load_file(path);
+    } else if (strcmp(line, ":run") == 0) {
+        run_main_make();
+    } else if (strcmp(line, ":symbols") == 0) {
+        print_symbol_table(&global_scope, stdout);
+    } else if (strcmp(line, ":memory") == 0) {
+        mem_print_summary(stdout);
+    } else if (strncmp(line, ":dump ", 6) == 0) {
+        char *path = line + 6;
+        while (isspace((unsigned char)*path)) path++;
+        FILE *file = fopen(path, "w");
+        if (!file) {
+            perror(path);
+        } else {
+            unsigned cells = heap_dump_write(&global_scope, file);
+            fclose(file);
+            printf("%u celdas escritas en %s\n", cells, path);
+        }
+    } else if (strcmp(line, ":classes") == 0) {
+        for (int i = 0; i < class_count; i++) printf("%s\n", class_table[i]->name);
+    } else if (strcmp(line, ":help") == 0) {
+        print_help();
+    } else {
+        fprintf(stderr, "Comando desconocido: %s (ver :help)\n", line);
+    }
+    fflush(stdout);
+    return 1;
+}
+
+int run_repl(const char *initial_file) {
+    output_set_line_buffered(1); // La salida de cada entrada se ve antes del siguiente prompt
+    init_symbol_table(&global_scope);
+    interactive = isatty(STDIN_FILENO);
+
+    if (initial_file) load_file(initial_file);
+
+    char *line = NULL;
+    size_t line_capacity = 0;
+    char *pending = NULL;      // Entrada acumulada hasta cerrar todos sus bloques
+    size_t pending_len = 0;
+    int line_number = 0, pending_first_line = 1;
+
+    while (1) {
+        if (interactive) {
+            printf(pending_len ? "....> " : "eiffel> ");
+            fflush(stdout);
+        }
+        ssize_t read = getline(&line, &line_capacity, stdin);
+        if (read < 0) break;
+        line_number++;
+
+        if (pending_len == 0 && line[0] == ':') {
+            if (!handle_command(line)) break;
+            continue;
+        }
+
+        if (pending_len == 0) pending_first_line = line_number;
+        pending = realloc(pending, pending_len + read + 1);
+        memcpy(pending + pending_len, line, read + 1);
+        pending_len += read;
+
+        if (block_depth(pending, NULL) > 0) continue;
+
+        if (!is_blank(pending)) handle_chunk(pending, pending_first_line);
+        pending_len = 0;
+        pending[0] = '\0';
+    }
+    if (interactive) printf("\n");
+
+    free(line);
+    free(pending);
+    for (int i = 0; i < class_root_count; i++) free_ast(class_roots[i]);
+    free(class_roots);
+    for (int i = 0; i < loaded_class_count; i++) free(loaded_classes[i].class_name);
+    free(loaded_classes);
+    intern_free();
+    return 0;
+}
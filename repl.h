@@ -0,0 +1,13 @@
+#ifndef REPL_H
+#define REPL_H
+
+/* Comentario general:
+   - Modo interactivo del intérprete (./interpreter --repl [archivo.e]).
+   - Mantiene class_table, objetos y variables globales vivos entre entradas.
+   - Acepta sentencias, declaraciones 'local' y bloques 'class ... end' nuevos o redefinidos.
+*/
+
+// Ejecuta el bucle leer-evaluar-imprimir. Si initial_file no es NULL lo carga antes (como ':load').
+int run_repl(const char *initial_file);
+
+#endif // REPL_H
@@ -0,0 +1,578 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "interpreter.h"
+#include "scoop.h"
+#include "threadpool.h"
+#include "output.h"
+#include "memstats.h"
+#include "meter.h"
+
+/* Comentario general:
+   - Un solo mutex (scoop.lock) protege las colas de pedidos, el estado de cada procesador, los
+     futuros y la salida juntada; cada cola de procesadores listos tiene además su propio mutex,
+     como las colas de threadpool.c: el dueño saca por el final y los ladrones por el principio.
+   - Un procesador está en a lo sumo una cola de listos y lo ejecuta un solo hilo por vez
+     (IDLE -> READY al recibir un pedido, READY -> RUNNING al tomarlo). Ejecuta hasta
+     SCOOP_BATCH pedidos seguidos y, si le quedan, vuelve a la cola: un procesador con mucho
+     trabajo no acapara un hilo mientras otros esperan.
+   - El resultado de una consulta va en un Future. Lo libera el que lo espera, salvo que la
+     variable que lo esperaba se haya pisado (abandoned): entonces lo libera el procesador.
+   - Las variables pendientes son del hilo que hizo la llamada (lista por hilo): solo ese hilo
+     puede leerlas, porque son locales de sus scopes.
+   - Solo un hilo que no está ejecutando un procesador ayuda mientras espera. Un procesador que
+     espera una consulta bloquea su hilo: si ejecutara otro procesador encima de su pila y ese lo
+     consultara, el pedido nuevo esperaría a que termine el actual, que espera al de arriba. Para
+     que los pedidos sigan corriendo, siempre queda al menos un worker sin bloquear (se crea uno
+     de repuesto si hace falta).
+   - Estructuras internas con malloc directo, como las colas de threadpool.c.
+*/
+
+#define SCOOP_BATCH 64
+
+typedef struct {
+    int ready;
+    int failed;
+    int abandoned;
+    RuntimeValue value;
+} Future;
+
+typedef enum {
+    REQUEST_CALL,
+    REQUEST_READ
+} RequestKind;
+
+typedef struct SeparateRequest {
+    RequestKind kind;
+    ClassDefinition *class_def;
+    FeatureBodyNode *method;
+    const char *attribute;
+    RuntimeValue *args;
+    int arg_count;
+    Future *future;         // NULL: comando
+    struct SeparateRequest *next;
+} SeparateRequest;
+
+typedef enum {
+    PROCESSOR_IDLE,
+    PROCESSOR_READY,
+    PROCESSOR_RUNNING
+} ProcessorState;
+
+struct Processor {
+    SymbolTable *object;
+    SeparateRequest *head;
+    SeparateRequest *tail;
+    ProcessorState state;
+    int failed;
+};
+
+typedef struct Processor Processor;
+
+typedef struct {
+    pthread_mutex_t lock;
+    Processor **items;      // Anillo: [head, tail) módulo capacity
+    unsigned head;
+    unsigned tail;
+    unsigned capacity;
+} ReadyQueue;
+
+typedef struct OutputChunk {
+    OutputCapture capture;
+    struct OutputChunk *next;
+} OutputChunk;
+
+typedef struct {
+    SymbolTableEntry *entry;
+    Future *future;
+} PendingRead;
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;  // Hay procesadores listos o terminó un pedido
+    int queue_count;         // Workers pedidos (al menos 1 cola aunque no haya workers)
+    ReadyQueue queues[POOL_MAX_THREADS];
+    int workers;             // Workers creados, incluidos los de repuesto
+    int blocked_workers;     // Workers bloqueados esperando una consulta desde un procesador
+    atomic_int ready;        // Procesadores en alguna cola de listos
+    int outstanding;         // Pedidos encolados o ejecutándose
+    int failures;            // Pedidos que terminaron con error desde el último scoop_wait_all
+    unsigned next_queue;     // Reparto de los procesadores que encola un hilo que no es worker
+    OutputChunk *output_head;
+    OutputChunk *output_tail;
+} scoop = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .changed = PTHREAD_COND_INITIALIZER
+};
+
+int scoop_started = 0;
+_Thread_local Processor *scoop_current_processor = NULL;
+_Thread_local int scoop_pending_count = 0;
+
+static pthread_once_t scoop_once = PTHREAD_ONCE_INIT;
+static _Thread_local int worker_slot = -1; // Cola propia de un worker; -1 en los demás hilos
+static _Thread_local PendingRead *pending = NULL;
+static _Thread_local int pending_capacity = 0;
+
+static pthread_mutex_t once_lock;
+static _Thread_local int once_depth = 0;
+
+/* --- Tipos separate --- */
+
+int is_separate_type(const char *type_name) {
+    return type_name && strncmp(type_name, "separate ", 9) == 0;
+}
+
+const char *separate_base_type(const char *type_name) {
+    return is_separate_type(type_name) ? type_name + 9 : type_name;
+}
+
+/* --- Colas de procesadores listos --- */
+
+static void queue_push(ReadyQueue *q, Processor *p) {
+    pthread_mutex_lock(&q->lock);
+    if (q->tail - q->head == q->capacity) {
+        unsigned capacity = q->capacity ? q->capacity * 2 : 16;
+        Processor **items = malloc(capacity * sizeof(Processor*));
+        for (unsigned i = 0; i < q->tail - q->head; i++) items[i] = q->items[(q->head + i) % q->capacity];
+        free(q->items);
+        q->items = items;
+        q->tail -= q->head;
+        q->head = 0;
+        q->capacity = capacity;
+    }
+    q->items[q->tail++ % q->capacity] = p;
+    pthread_mutex_unlock(&q->lock);
+}
+
+static Processor *queue_take(ReadyQueue *q, int from_tail) {
+    Processor *p = NULL;
+    pthread_mutex_lock(&q->lock);
+    if (q->head != q->tail) p = from_tail ? q->items[--q->tail % q->capacity] : q->items[q->head++ % q->capacity];
+    pthread_mutex_unlock(&q->lock);
+    return p;
+}
+
+// Pone a p en una cola de listos (con scoop.lock tomado)
+static void make_ready(Processor *p) {
+    p->state = PROCESSOR_READY;
+    int slot = worker_slot >= 0 ? worker_slot : (int)(scoop.next_queue++ % (unsigned)scoop.queue_count);
+    queue_push(&scoop.queues[slot], p);
+    atomic_fetch_add(&scoop.ready, 1);
+    pthread_cond_broadcast(&scoop.changed);
+}
+
+// Un procesador listo: primero de la cola propia (el último que llegó), si no robado de otra
+static Processor *take_ready(void) {
+    Processor *p = NULL;
+    if (worker_slot >= 0) p = queue_take(&scoop.queues[worker_slot], 1);
+    for (int k = 0; !p && k < scoop.queue_count; k++) {
+        int slot = worker_slot >= 0 ? (worker_slot + 1 + k) % scoop.queue_count : k;
+        p = queue_take(&scoop.queues[slot], 0);
+    }
+    if (p) atomic_fetch_sub(&scoop.ready, 1);
+    return p;
+}
+
+/* --- Ejecución de pedidos --- */
+
+static void free_future(Future *future) {
+    if (future->value.type == VAL_TYPE_STRING) mem_free(MEM_STRING, future->value.as.string_val);
+    free(future);
+}
+
+static void release_values(RuntimeValue *values, int count) {
+    for (int i = 0; i < count; i++) {
+        if (values[i].type == VAL_TYPE_STRING) mem_free(MEM_STRING, values[i].as.string_val);
+    }
+}
+
+// 1 si value puede pasar de un procesador a otro (copia de un básico o referencia separate)
+static int transferable(RuntimeValue value) {
+    switch (value.type) {
+        case VAL_TYPE_OBJECT: return value.as.object_val == NULL || value.as.object_val->processor != NULL;
+        case VAL_TYPE_ARRAY:
+        case VAL_TYPE_FILE: return 0;
+        default: return 1;
+    }
+}
+
+static RuntimeValue run_request(Processor *p, SeparateRequest *r) {
+    RuntimeValue value;
+    if (r->kind == REQUEST_CALL) {
+        value = invoke_method(r->class_def, r->method, p->object, r->args, r->arg_count);
+    } else {
+        value = get_symbol(p->object, r->attribute);
+        if (value.type == VAL_TYPE_STRING) value.as.string_val = mem_strdup(MEM_STRING, value.as.string_val);
+    }
+    if (r->future && !transferable(value)) {
+        fprintf(stderr, "Error: '%s' de un objeto separate devolvió una referencia que no es separate.\n",
+                r->kind == REQUEST_CALL ? r->method->feature_name : r->attribute);
+        runtime_abort();
+    }
+    return value;
+}
+
+static void execute(Processor *p, SeparateRequest *r) {
+    Processor *previous = scoop_current_processor;
+    jmp_buf *previous_handler = runtime_error_handler;
+    int previous_once_depth = once_depth;
+    int previous_pending = scoop_pending_count;
+    jmp_buf recover;
+    OutputCapture capture;
+    RuntimeValue value = { .type = VAL_TYPE_VOID };
+
+    scoop_current_processor = p;
+    runtime_error_handler = &recover;
+    output_capture_begin(&capture);
+    int failed = p->failed;
+    if (!failed) {
+        if (setjmp(recover) == 0) {
+            value = run_request(p, r);
+        } else {
+            failed = 1;
+            // Un error dentro de una rutina once no puede dejar tomado el lock de los once, ni
+            // quedar pendientes variables de scopes que ya no existen
+            while (once_depth > previous_once_depth) scoop_once_leave();
+            while (scoop_pending_count > previous_pending) scoop_forget_entry(pending[scoop_pending_count - 1].entry);
+        }
+    }
+    output_capture_end();
+    runtime_error_handler = previous_handler;
+    scoop_current_processor = previous;
+    release_values(r->args, r->arg_count);
+    free(r->args);
+
+    OutputChunk *chunk = NULL;
+    if (capture.length) {
+        chunk = malloc(sizeof(OutputChunk));
+        chunk->capture = capture;
+        chunk->next = NULL;
+    } else {
+        free(capture.data);
+    }
+
+    pthread_mutex_lock(&scoop.lock);
+    if (failed && !p->failed) {
+        p->failed = 1;
+        scoop.failures++;
+    }
+    if (chunk) {
+        if (scoop.output_tail) scoop.output_tail->next = chunk;
+        else scoop.output_head = chunk;
+        scoop.output_tail = chunk;
+    }
+    Future *future = r->future;
+    if (future && future->abandoned) {
+        if (value.type == VAL_TYPE_STRING) mem_free(MEM_STRING, value.as.string_val);
+        free(future);
+    } else if (future) {
+        future->value = failed ? (RuntimeValue){ .type = VAL_TYPE_VOID } : value;
+        future->failed = failed;
+        future->ready = 1;
+    } else if (value.type == VAL_TYPE_STRING) {
+        mem_free(MEM_STRING, value.as.string_val);
+    }
+    scoop.outstanding--;
+    pthread_cond_broadcast(&scoop.changed);
+    pthread_mutex_unlock(&scoop.lock);
+    free(r);
+}
+
+// Ejecuta hasta SCOOP_BATCH pedidos de p (tomado de una cola de listos)
+static void run_processor(Processor *p) {
+    pthread_mutex_lock(&scoop.lock);
+    p->state = PROCESSOR_RUNNING;
+    for (int done = 0; ; done++) {
+        SeparateRequest *r = p->head;
+        if (!r || done == SCOOP_BATCH) {
+            if (r) make_ready(p);
+            else p->state = PROCESSOR_IDLE;
+            break;
+        }
+        p->head = r->next;
+        if (!p->head) p->tail = NULL;
+        pthread_mutex_unlock(&scoop.lock);
+        execute(p, r);
+        pthread_mutex_lock(&scoop.lock);
+    }
+    pthread_mutex_unlock(&scoop.lock);
+}
+
+// Espera (con scoop.lock tomado) a que done(arg) sea verdadero, ejecutando pedidos mientras tanto
+static void help_until(int (*done)(void*), void *arg) {
+    while (!done(arg)) {
+        if (atomic_load(&scoop.ready) > 0) {
+            pthread_mutex_unlock(&scoop.lock);
+            Processor *p = take_ready();
+            if (p) run_processor(p);
+            pthread_mutex_lock(&scoop.lock);
+        } else {
+            pthread_cond_wait(&scoop.changed, &scoop.lock);
+        }
+    }
+}
+
+static void* worker_main(void *arg) {
+    worker_slot = (int)(intptr_t)arg;
+    pthread_mutex_lock(&scoop.lock);
+    for (;;) {
+        while (atomic_load(&scoop.ready) == 0) pthread_cond_wait(&scoop.changed, &scoop.lock);
+        pthread_mutex_unlock(&scoop.lock);
+        Processor *p = take_ready();
+        if (p) run_processor(p);
+        pthread_mutex_lock(&scoop.lock);
+    }
+    return NULL;
+}
+
+// Crea un worker más (con scoop.lock tomado); los de repuesto comparten las colas
+static int start_worker(void) {
+    pthread_attr_t thread_attr;
+    pthread_attr_init(&thread_attr);
+    pthread_attr_setstacksize(&thread_attr, meter_stack_size()); // Las rutinas recursivas usan la pila del worker
+    pthread_t thread;
+    int slot = scoop.workers % scoop.queue_count;
+    int created = pthread_create(&thread, &thread_attr, worker_main, (void*)(intptr_t)slot) == 0;
+    pthread_attr_destroy(&thread_attr);
+    if (!created) return 0;
+    pthread_detach(thread);
+    scoop.workers++;
+    return 1;
+}
+
+// Como help_until, pero sin ejecutar pedidos: lo usa un procesador, al que otro podría consultar
+static void block_until(int (*done)(void*), void *arg) {
+    if (done(arg)) return;
+    int worker = worker_slot >= 0;
+    scoop.blocked_workers += worker;
+    // Sin un worker libre nadie ejecutaría el pedido que esperamos
+    if (scoop.workers == scoop.blocked_workers && !start_worker()) {
+        // No se pudo crear el hilo: ayudar como antes es la única forma de avanzar
+        scoop.blocked_workers -= worker;
+        help_until(done, arg);
+        return;
+    }
+    while (!done(arg)) pthread_cond_wait(&scoop.changed, &scoop.lock);
+    scoop.blocked_workers -= worker;
+}
+
+static void start_scheduler(void) {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&once_lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    int workers = pool_configured_size() - 1; // El hilo principal ejecuta pedidos cuando espera
+    scoop.queue_count = workers > 0 ? workers : 1;
+    for (int i = 0; i < scoop.queue_count; i++) pthread_mutex_init(&scoop.queues[i].lock, NULL);
+
+    pthread_mutex_lock(&scoop.lock);
+    for (int i = 0; i < workers && start_worker(); i++) {
+        // Siguen los que se pudieron crear
+    }
+    pthread_mutex_unlock(&scoop.lock);
+    scoop_started = 1;
+}
+
+void scoop_attach(SymbolTable *object) {
+    pthread_once(&scoop_once, start_scheduler);
+    Processor *p = calloc(1, sizeof(Processor));
+    p->object = object;
+    p->state = PROCESSOR_IDLE;
+    object->processor = p;
+}
+
+/* --- Llamadas desde el cliente --- */
+
+static int future_ready(void *arg) {
+    return ((Future*)arg)->ready;
+}
+
+static void enqueue(Processor *p, SeparateRequest *r) {
+    pthread_mutex_lock(&scoop.lock);
+    if (p->tail) p->tail->next = r;
+    else p->head = r;
+    p->tail = r;
+    scoop.outstanding++;
+    if (p->state == PROCESSOR_IDLE) make_ready(p);
+    pthread_mutex_unlock(&scoop.lock);
+}
+
+// Espera future y devuelve su valor (lo libera); si el pedido falló, el error corta también acá
+static RuntimeValue take_future(Future *future) {
+    pthread_mutex_lock(&scoop.lock);
+    if (scoop_current_processor) block_until(future_ready, future);
+    else help_until(future_ready, future);
+    pthread_mutex_unlock(&scoop.lock);
+    scoop_emit_output();
+    RuntimeValue value = future->value;
+    int failed = future->failed;
+    free(future);
+    if (failed) runtime_abort(); // El procesador ya informó el error
+    return value;
+}
+
+static void add_pending(SymbolTableEntry *entry, Future *future) {
+    scoop_forget_entry(entry);
+    if (entry->value.type == VAL_TYPE_STRING) mem_free(MEM_STRING, entry->value.as.string_val);
+    entry->value.type = VAL_TYPE_NULL;
+    if (scoop_pending_count == pending_capacity) {
+        pending_capacity = pending_capacity ? pending_capacity * 2 : 8;
+        pending = realloc(pending, (size_t)pending_capacity * sizeof(PendingRead));
+    }
+    pending[scoop_pending_count].entry = entry;
+    pending[scoop_pending_count].future = future;
+    scoop_pending_count++;
+}
+
+// Encola r; una consulta se espera ahora o queda pendiente en defer_into
+static RuntimeValue submit(Processor *p, SeparateRequest *r, SymbolTableEntry *defer_into, int *deferred) {
+    RuntimeValue none = { .type = VAL_TYPE_VOID };
+    Future *future = r->future;
+    enqueue(p, r);
+    if (!future) return none;
+    if (defer_into) {
+        add_pending(defer_into, future);
+        *deferred = 1;
+        return none;
+    }
+    return take_future(future);
+}
+
+RuntimeValue scoop_call(ClassDefinition *class_def, FeatureBodyNode *method, SymbolTable *object,
+                        RuntimeValue *args, int arg_count, SymbolTableEntry *defer_into, int *deferred) {
+    for (int i = 0; i < arg_count; i++) {
+        if (!transferable(args[i])) {
+            fprintf(stderr, "Error: '%s' sobre un objeto separate: el argumento %d no es INTEGER, REAL, STRING ni un objeto separate.\n",
+                    method->feature_name, i + 1);
+            runtime_abort();
+        }
+    }
+    SeparateRequest *r = calloc(1, sizeof(SeparateRequest));
+    r->kind = REQUEST_CALL;
+    r->class_def = class_def;
+    r->method = method;
+    r->arg_count = arg_count;
+    size_t slots = arg_count > 0 ? (size_t)arg_count : 1; // Nunca malloc(0) ni un tamaño negativo
+    r->args = malloc(slots * sizeof(RuntimeValue));
+    for (int i = 0; i < arg_count; i++) {
+        r->args[i] = args[i];
+        if (args[i].type == VAL_TYPE_STRING) r->args[i].as.string_val = mem_strdup(MEM_STRING, args[i].as.string_val);
+    }
+    if (method->result_type) r->future = calloc(1, sizeof(Future));
+    return submit(object->processor, r, defer_into, deferred);
+}
+
+RuntimeValue scoop_read_attribute(SymbolTable *object, const char *name, SymbolTableEntry *defer_into, int *deferred) {
+    SeparateRequest *r = calloc(1, sizeof(SeparateRequest));
+    r->kind = REQUEST_READ;
+    r->attribute = name;
+    r->future = calloc(1, sizeof(Future));
+    return submit(object->processor, r, defer_into, deferred);
+}
+
+/* --- Variables pendientes --- */
+
+static void remove_pending(int i) {
+    pending[i] = pending[--scoop_pending_count];
+}
+
+static void resolve_at(int i) {
+    SymbolTableEntry *entry = pending[i].entry;
+    Future *future = pending[i].future;
+    remove_pending(i);
+    entry->value = take_future(future);
+}
+
+void scoop_resolve_entry(SymbolTableEntry *entry) {
+    for (int i = 0; i < scoop_pending_count; i++) {
+        if (pending[i].entry == entry) {
+            resolve_at(i);
+            return;
+        }
+    }
+}
+
+void scoop_forget_entry(SymbolTableEntry *entry) {
+    for (int i = 0; i < scoop_pending_count; i++) {
+        if (pending[i].entry != entry) continue;
+        Future *future = pending[i].future;
+        remove_pending(i);
+        pthread_mutex_lock(&scoop.lock);
+        if (future->ready) free_future(future);
+        else future->abandoned = 1;
+        pthread_mutex_unlock(&scoop.lock);
+        return;
+    }
+}
+
+void scoop_resolve_scope(SymbolTable *scope) {
+    for (int i = scoop_pending_count - 1; i >= 0; i--) {
+        if (i < scoop_pending_count && pending[i].entry >= scope->entries && pending[i].entry < scope->entries + MAX_SYMBOLS) {
+            resolve_at(i);
+        }
+    }
+}
+
+void scoop_resolve_all(void) {
+    while (scoop_pending_count > 0) resolve_at(scoop_pending_count - 1);
+}
+
+/* --- Salida y fin de la ejecución --- */
+
+void scoop_emit_output(void) {
+    if (scoop_current_processor || pool_in_task()) return;
+    pthread_mutex_lock(&scoop.lock);
+    OutputChunk *chunk = scoop.output_head;
+    scoop.output_head = scoop.output_tail = NULL;
+    pthread_mutex_unlock(&scoop.lock);
+    while (chunk) {
+        OutputChunk *next = chunk->next;
+        output_capture_emit(&chunk->capture);
+        free(chunk);
+        chunk = next;
+    }
+}
+
+static int all_idle(void *arg) {
+    (void)arg;
+    return scoop.outstanding == 0;
+}
+
+int scoop_wait_all(void) {
+    pthread_mutex_lock(&scoop.lock);
+    help_until(all_idle, NULL);
+    int failures = scoop.failures;
+    scoop.failures = 0;
+    pthread_mutex_unlock(&scoop.lock);
+    scoop_emit_output();
+    if (failures) return 1;
+    scoop_resolve_all();
+    return 0;
+}
+
+void scoop_after_abort(void) {
+    while (once_depth > 0) scoop_once_leave();
+    while (scoop_pending_count > 0) scoop_forget_entry(pending[scoop_pending_count - 1].entry);
+    pthread_mutex_lock(&scoop.lock);
+    help_until(all_idle, NULL);
+    scoop.failures = 0;
+    pthread_mutex_unlock(&scoop.lock);
+    scoop_emit_output();
+}
+
+void scoop_once_enter(void) {
+    pthread_mutex_lock(&once_lock);
+    once_depth++;
+}
+
+void scoop_once_leave(void) {
+    once_depth--;
+    pthread_mutex_unlock(&once_lock);
+}
@@ -0,0 +1,87 @@
+#ifndef SCOOP_H
+#define SCOOP_H
+
+#include "interpreter.h"
+
+/* Comentario general:
+   - Objetos 'separate' al estilo SCOOP: una variable o atributo declarado 'x: separate WORKER'
+     recibe en 'create x' un objeto con su propio procesador. Todo lo que se ejecuta sobre ese
+     objeto (su procedimiento de creación, sus rutinas, la lectura de sus atributos) pasa por la
+     cola de pedidos del procesador y lo ejecuta un único hilo a la vez, en el orden en que llegó.
+   - Un comando (rutina sin resultado) se encola y el que llama sigue sin esperar.
+   - Una consulta (función o atributo) también se encola. Si su valor va directo a una variable
+     local ('r := w.total'), la variable queda pendiente y recién se espera cuando se la lee
+     (espera por necesidad); en cualquier otra expresión se espera en el momento.
+   - Los procesadores listos se reparten en colas por hilo con robo de trabajo (como threadpool.c,
+     EIFFEL_THREADS hilos contando al principal). Un hilo que espera un resultado ejecuta mientras
+     tanto pedidos de otros procesadores; con EIFFEL_THREADS=1 no hay workers y todo lo ejecuta el
+     hilo principal cuando espera.
+   - Entre procesadores solo viajan copias de INTEGER, REAL y STRING y referencias a objetos
+     separate: pasar o devolver un objeto común, un ARRAY o un PLAIN_TEXT_FILE es un error.
+     Tampoco se puede asignar un atributo de un objeto separate desde afuera.
+   - Lo que imprime un pedido se junta y lo escribe el hilo principal (antes de su próximo print
+     o al final), así las líneas de distintos procesadores no se mezclan.
+   - Un error dentro de un pedido deja al procesador fallado (sus pedidos siguientes no se
+     ejecutan); el programa termina con ese error cuando se lee un resultado suyo o al final.
+   - El programa termina cuando todos los procesadores vaciaron sus colas (run_in_scope espera).
+   - Las rutinas once de clase se ejecutan de a una por vez entre todos los procesadores.
+*/
+
+struct Processor;
+
+// 1 desde que se creó el primer objeto separate (lo leen los caminos rápidos del intérprete)
+extern int scoop_started;
+
+// Procesador del hilo actual mientras ejecuta un pedido (NULL: el procesador principal)
+extern _Thread_local struct Processor *scoop_current_processor;
+
+// Variables del hilo que esperan el resultado de una consulta (ver scoop_resolve_entry)
+extern _Thread_local int scoop_pending_count;
+
+// 1 si una llamada sobre object tiene que ir a la cola de otro procesador
+#define SCOOP_IS_SEPARATE(object) ((object)->processor && (object)->processor != scoop_current_processor)
+
+// 1 si type_name es 'separate X'; separate_base_type devuelve X (o type_name si no es separate)
+int is_separate_type(const char *type_name);
+const char *separate_base_type(const char *type_name);
+
+// Le da a un objeto recién creado su propio procesador (arranca los workers la primera vez)
+void scoop_attach(SymbolTable *object);
+
+/* scoop_call: encola method (con copias de args) en el procesador de object.
+   - Un comando devuelve VOID enseguida.
+   - Una consulta con defer_into (la entrada de la variable que recibe el valor) deja la variable
+     pendiente, pone *deferred en 1 y devuelve VOID; sin defer_into espera el resultado. */
+RuntimeValue scoop_call(ClassDefinition *class_def, FeatureBodyNode *method, SymbolTable *object,
+                        RuntimeValue *args, int arg_count, SymbolTableEntry *defer_into, int *deferred);
+
+// Lectura de un atributo de un objeto separate: una consulta más (mismas reglas que scoop_call)
+RuntimeValue scoop_read_attribute(SymbolTable *object, const char *name, SymbolTableEntry *defer_into, int *deferred);
+
+// Espera el resultado pendiente de entry (si lo tiene) y lo guarda en la variable
+void scoop_resolve_entry(SymbolTableEntry *entry);
+
+// La variable recibe otro valor: el resultado pendiente ya no le importa a nadie
+void scoop_forget_entry(SymbolTableEntry *entry);
+
+// Resuelve las variables pendientes de scope (antes de leer Result y liberar el scope)
+void scoop_resolve_scope(SymbolTable *scope);
+
+// Resuelve todas las variables pendientes del hilo
+void scoop_resolve_all(void);
+
+// Escribe la salida que dejaron los pedidos terminados (solo en el hilo principal)
+void scoop_emit_output(void);
+
+/* scoop_wait_all: espera que todos los procesadores vacíen sus colas, resuelve las variables
+   pendientes y escribe su salida. Devuelve 1 si algún pedido terminó con un error. */
+int scoop_wait_all(void);
+
+// Después de un error en el hilo principal: suelta las variables pendientes y espera a los procesadores
+void scoop_after_abort(void);
+
+// Rutinas once de clase: exclusión mutua entre procesadores (reentrante en el mismo hilo)
+void scoop_once_enter(void);
+void scoop_once_leave(void);
+
+#endif // SCOOP_H
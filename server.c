@@ -0,0 +1,382 @@
+#define _GNU_SOURCE // struct ucred (SO_PEERCRED)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include "ast.h"
+#include "interpreter.h"
+#include "frontend.h"
+#include "server.h"
+
+/* Comentario general:
+   - El proceso servidor parsea cada programa una sola vez y guarda el AST junto con el texto del .info
+     (tokens + AST) y los diagnósticos que el parseo escribió en stderr.
+   - Cada pedido se ejecuta en un proceso hijo (fork): hereda el AST ya parseado sin copiarlo,
+     registra las clases y corre el programa con los descriptores del cliente. Así un error en
+     tiempo de ejecución (exit) no afecta al servidor.
+   - Un proceso intermedio espera al hijo y devuelve su código de salida al cliente, de modo que
+     el servidor vuelve a aceptar conexiones sin bloquearse.
+*/
+
+#ifdef __APPLE__
+#define STAT_MTIME(st) ((st).st_mtimespec)
+#else
+#define STAT_MTIME(st) ((st).st_mtim)
+#endif
+
+
+typedef struct {
+    char *path;
+    struct timespec mtime;
+    off_t size;
+    unsigned long last_used;
+    int parse_status;       // Resultado de yyparse (0 = ok)
+    AstNode *root;
+    char *info_text;        // Contenido del .info hasta el AST inclusive
+    size_t info_len;
+    char *diagnostics;      // Lo que el parseo escribió en stderr
+    size_t diagnostics_len;
+} CachedProgram;
+
+static CachedProgram cache[MAX_CACHED_PROGRAMS];
+static int cache_count = 0;
+static unsigned long use_clock = 0;
+
+static void release_entry(CachedProgram *entry) {
+    free(entry->path);
+    if (entry->root) free_ast(entry->root);
+    free(entry->info_text);
+    free(entry->diagnostics);
+    memset(entry, 0, sizeof(*entry));
+}
+
+static char* read_stream(FILE *stream, size_t *len) {
+    fflush(stream);
+    fseek(stream, 0, SEEK_END);
+    long size = ftell(stream);
+    fseek(stream, 0, SEEK_SET);
+    char *data = malloc(size > 0 ? size : 1);
+    *len = size > 0 ? fread(data, 1, size, stream) : 0;
+    return data;
+}
+
+/* parse_into_entry: parsea el archivo como lo haría main.c, pero escribiendo el .info y los errores
+   de parseo en archivos temporales, para poder reproducir ambos en cada ejecución.
+*/
+static int parse_into_entry(const char *path, const struct stat *st, CachedProgram *entry) {
+    FILE *source = fopen(path, "r");
+    if (!source) return -1;
+
+    FILE *info = tmpfile();
+    FILE *diagnostics = tmpfile();
+    if (!info || !diagnostics) {
+        fclose(source);
+        if (info) fclose(info);
+        if (diagnostics) fclose(diagnostics);
+        return -1;
+    }
+
+    fprintf(info, "--- TOKENS ---\n");
+    ParseContext context = { info, diagnostics };
+    AstNode *root = NULL;
+    int status = parse_stream(source, &context, &root);
+    if (status != 0) {
+        fprintf(info, "Error de parseo.\n");
+        root = NULL;
+    } else {
+        fprintf(info, "\n--- AST Tree ---\n");
+        print_ast(root, info);
+        fprintf(info, "----------------\n\n");
+    }
+    fclose(source);
+
+    entry->path = strdup(path);
+    entry->mtime = STAT_MTIME(*st);
+    entry->size = st->st_size;
+    entry->parse_status = status;
+    entry->root = root;
+    entry->info_text = read_stream(info, &entry->info_len);
+    entry->diagnostics = read_stream(diagnostics, &entry->diagnostics_len);
+    fclose(info);
+    fclose(diagnostics);
+    return 0;
+}
+
+/* lookup_program: devuelve el programa cacheado si la ruta y el mtime coinciden; si no, lo (re)parsea.
+   - Si la caché está llena se descarta la entrada usada hace más tiempo.
+*/
+static CachedProgram* lookup_program(const char *path) {
+    struct stat st;
+    if (stat(path, &st) != 0) return NULL;
+
+    CachedProgram *slot = NULL;
+    for (int i = 0; i < cache_count; i++) {
+        if (strcmp(cache[i].path, path) == 0) {
+            struct timespec mtime = STAT_MTIME(st);
+            if (cache[i].mtime.tv_sec == mtime.tv_sec && cache[i].mtime.tv_nsec == mtime.tv_nsec
+                && cache[i].size == st.st_size) {
+                cache[i].last_used = ++use_clock;
+                return &cache[i];
+            }
+            slot = &cache[i]; // Archivo modificado: re-parsear en la misma entrada
+            release_entry(slot);
+            break;
+        }
+    }
+    if (!slot) {
+        if (cache_count < MAX_CACHED_PROGRAMS) {
+            slot = &cache[cache_count++];
+        } else {
+            slot = &cache[0];
+            for (int i = 1; i < cache_count; i++) {
+                if (cache[i].last_used < slot->last_used) slot = &cache[i];
+            }
+            release_entry(slot);
+        }
+    }
+
+    if (parse_into_entry(path, &st, slot) != 0) {
+        // No se pudo abrir: la entrada queda libre (se compacta moviendo la última)
+        *slot = cache[--cache_count];
+        memset(&cache[cache_count], 0, sizeof(CachedProgram));
+        return NULL;
+    }
+    slot->last_used = ++use_clock;
+    return slot;
+}
+
+/* execute_request: corre dentro del proceso hijo con los descriptores del cliente ya instalados.
+   - Reproduce exactamente lo que haría './interpreter archivo.e': mensajes, .info y código de salida.
+*/
+static int execute_request(const char *path, const char *display_path) {
+    CachedProgram *program = lookup_program(path);
+    if (!program) {
+        errno = ENOENT;
+        perror(display_path);
+        return 1;
+    }
+    if (program->diagnostics_len) {
+        fwrite(program->diagnostics, 1, program->diagnostics_len, stderr);
+        fflush(stderr);
+    }
+
+    char info_filename[256];
+    snprintf(info_filename, sizeof(info_filename), "%s.info", path);
+    FILE *info = fopen(info_filename, "w");
+    if (!info) {
+        fprintf(stderr, "No se pudo crear el archivo de información %s.\n", info_filename);
+        info = stderr;
+    }
+    fwrite(program->info_text, 1, program->info_len, info);
+
+    int status = 0;
+    if (program->parse_status != 0) {
+        status = 1;
+    } else if (program->root) {
+        status = run_program(program->root, info);
+    }
+    if (info != stderr) fclose(info);
+    return status;
+}
+
+static int receive_request(int conn, char *buffer, size_t size, int fds[3]) {
+    struct iovec iov = { .iov_base = buffer, .iov_len = size - 1 };
+    union {
+        struct cmsghdr header;
+        char space[CMSG_SPACE(sizeof(int) * 3)];
+    } control;
+    struct msghdr msg = { 0 };
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.space;
+    msg.msg_controllen = sizeof(control.space);
+
+    ssize_t received = recvmsg(conn, &msg, 0);
+    if (received <= 0) return -1;
+    buffer[received] = '\0';
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS
+        || cmsg->cmsg_len != CMSG_LEN(sizeof(int) * 3)) {
+        return -1;
+    }
+    memcpy(fds, CMSG_DATA(cmsg), sizeof(int) * 3);
+    return (int)received;
+}
+
+/* handle_connection: corre en un proceso intermedio. Lanza el hijo que ejecuta el programa,
+   espera su finalización y le devuelve al cliente el código de salida.
+*/
+static void handle_connection(int conn, const char *path, const char *display_path, int fds[3]) {
+    signal(SIGCHLD, SIG_DFL);
+    fflush(NULL);
+    pid_t runner = fork();
+    if (runner == 0) {
+        dup2(fds[0], STDIN_FILENO);
+        dup2(fds[1], STDOUT_FILENO);
+        dup2(fds[2], STDERR_FILENO);
+        for (int i = 0; i < 3; i++) close(fds[i]);
+        close(conn);
+        exit(execute_request(path, display_path));
+    }
+
+    int status = 1;
+    if (runner > 0) {
+        int wait_status;
+        if (waitpid(runner, &wait_status, 0) == runner) {
+            if (WIFEXITED(wait_status)) status = WEXITSTATUS(wait_status);
+            else if (WIFSIGNALED(wait_status)) status = 128 + WTERMSIG(wait_status);
+        }
+    }
+    if (write(conn, &status, sizeof(status)) != sizeof(status)) {
+        // El cliente se desconectó: no hay a quién avisar
+    }
+}
+
+/* private_socket_dir: crea (si hace falta) el directorio del socket por defecto y verifica que
+   sea nuestro y que nadie más pueda entrar. Devuelve 0 si se puede usar. */
+static int private_socket_dir(const char *dir) {
+    if (mkdir(dir, 0700) != 0 && errno != EEXIST) {
+        perror(dir);
+        return -1;
+    }
+    struct stat st;
+    if (lstat(dir, &st) != 0) {
+        perror(dir);
+        return -1;
+    }
+    if (!S_ISDIR(st.st_mode) || st.st_uid != getuid() || (st.st_mode & 077) != 0) {
+        fprintf(stderr, "El directorio %s no es privado del usuario: no se usa para el socket.\n", dir);
+        return -1;
+    }
+    return 0;
+}
+
+/* remove_stale_socket: borra un socket viejo en path, solo si es un socket nuestro. Devuelve 0
+   si path quedó libre. */
+static int remove_stale_socket(const char *path) {
+    struct stat st;
+    if (lstat(path, &st) != 0) {
+        if (errno == ENOENT) return 0;
+        perror(path);
+        return -1;
+    }
+    if (!S_ISSOCK(st.st_mode) || st.st_uid != getuid()) {
+        fprintf(stderr, "%s existe y no es un socket del usuario: no se reemplaza.\n", path);
+        return -1;
+    }
+    if (unlink(path) != 0) {
+        perror(path);
+        return -1;
+    }
+    return 0;
+}
+
+// 1 si el proceso del otro lado de conn es del mismo usuario que el servidor
+static int same_user_peer(int conn) {
+#ifdef __APPLE__
+    uid_t uid;
+    gid_t gid;
+    if (getpeereid(conn, &uid, &gid) != 0) return 0;
+    return uid == getuid();
+#else
+    struct ucred credentials;
+    socklen_t length = sizeof(credentials);
+    if (getsockopt(conn, SOL_SOCKET, SO_PEERCRED, &credentials, &length) != 0) return 0;
+    return credentials.uid == getuid();
+#endif
+}
+
+int run_server(const char *socket_path) {
+    char default_path[sizeof(((struct sockaddr_un*)0)->sun_path)];
+    if (!socket_path) socket_path = getenv(SOCKET_PATH_ENV);
+    if (!socket_path) {
+        char dir[sizeof(default_path) - sizeof(DEFAULT_SOCKET_NAME)];
+        if (default_socket_dir(dir, sizeof(dir)) != 0) {
+            fprintf(stderr, "Ruta de socket demasiado larga: %s/%s\n", dir, DEFAULT_SOCKET_NAME);
+            return 1;
+        }
+        const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
+        if (!(runtime_dir && *runtime_dir) && private_socket_dir(dir) != 0) return 1;
+        snprintf(default_path, sizeof(default_path), "%s/%s", dir, DEFAULT_SOCKET_NAME);
+        socket_path = default_path;
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        perror("socket");
+        return 1;
+    }
+    struct sockaddr_un address = { .sun_family = AF_UNIX };
+    if (strlen(socket_path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Ruta de socket demasiado larga: %s\n", socket_path);
+        return 1;
+    }
+    strcpy(address.sun_path, socket_path);
+    if (remove_stale_socket(socket_path) != 0) {
+        close(listener);
+        return 1;
+    }
+    // El socket nace con permisos 0600: otro usuario no puede conectarse
+    mode_t previous_umask = umask(077);
+    int bound = bind(listener, (struct sockaddr*)&address, sizeof(address));
+    umask(previous_umask);
+    if (bound != 0 || chmod(socket_path, 0600) != 0 || listen(listener, 64) != 0) {
+        perror(socket_path);
+        close(listener);
+        return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGCHLD, SIG_IGN); // Los procesos intermedios se recolectan solos
+    fprintf(stderr, "Servidor escuchando en %s\n", socket_path);
+
+    while (1) {
+        int conn = accept(listener, NULL, NULL);
+        if (conn < 0) {
+            if (errno == EINTR) continue;
+            perror("accept");
+            break;
+        }
+        if (!same_user_peer(conn)) { // Defensa extra si el socket se creó en un directorio compartido
+            fprintf(stderr, "Pedido rechazado: el cliente no es del mismo usuario.\n");
+            close(conn);
+            continue;
+        }
+
+        char request[MAX_REQUEST_SIZE];
+        int fds[3];
+        int len = receive_request(conn, request, sizeof(request), fds);
+        if (len < 0) {
+            close(conn);
+            continue;
+        }
+        const char *path = request;
+        size_t path_len = strnlen(request, len);
+        const char *display_path = (path_len + 1 < (size_t)len) ? request + path_len + 1 : path;
+
+        // Parsear en el proceso servidor para que el AST quede en caché para los próximos pedidos
+        lookup_program(path);
+
+        fflush(NULL);
+        pid_t handler = fork();
+        if (handler == 0) {
+            close(listener);
+            handle_connection(conn, path, display_path, fds);
+            exit(0);
+        }
+        for (int i = 0; i < 3; i++) close(fds[i]);
+        close(conn);
+    }
+
+    close(listener);
+    unlink(socket_path);
+    return 1;
+}
@@ -0,0 +1,43 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* Comentario general:
+   - Modo servidor (./interpreter --serve [socket]): un proceso de larga vida que mantiene los programas
+     ya parseados en memoria (clave: ruta + mtime) y los ejecuta a pedido por un socket Unix.
+   - El cliente (interpreter_client) envía la ruta del programa junto con sus descriptores
+     stdin/stdout/stderr (SCM_RIGHTS); el programa escribe directo en ellos y al final el servidor
+     responde con el código de salida.
+   - Solo el usuario que arrancó el servidor puede usarlo: el programa corre con sus permisos.
+*/
+
+/* Socket por defecto: en un directorio del usuario, nunca en un lugar que otro usuario pueda crear
+   o abrir ($XDG_RUNTIME_DIR, o /tmp/eiffel-<uid> con permisos 0700 que crea el servidor). */
+#define DEFAULT_SOCKET_NAME "eiffel_interpreter.sock"
+#define FALLBACK_SOCKET_DIR_FORMAT "/tmp/eiffel-%u"
+#define SOCKET_PATH_ENV "EIFFEL_INTERPRETER_SOCKET"
+
+// Directorio del socket por defecto (lo usan el servidor y el cliente); -1 si no entra en buffer
+static inline int default_socket_dir(char *buffer, size_t size) {
+    const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
+    int length = runtime_dir && *runtime_dir ? snprintf(buffer, size, "%s", runtime_dir)
+                                             : snprintf(buffer, size, FALLBACK_SOCKET_DIR_FORMAT, (unsigned)getuid());
+    return length >= 0 && (size_t)length < size ? 0 : -1;
+}
+#define MAX_CACHED_PROGRAMS 64
+
+/* Protocolo de un pedido:
+   - Cliente -> servidor: "<ruta absoluta>\0<ruta tal como se escribió (para mensajes)>\0" + 3 descriptores (0, 1, 2).
+   - Servidor -> cliente: un int con el código de salida del programa.
+*/
+#define MAX_REQUEST_SIZE 8192
+
+/* Bucle principal del servidor (socket_path NULL: variable de entorno o DEFAULT_SOCKET_NAME en
+   default_socket_dir). El socket queda con permisos 0600 y solo se atienden pedidos de procesos
+   del mismo usuario. Solo retorna ante un error de inicialización. */
+int run_server(const char *socket_path);
+
+#endif // SERVER_H
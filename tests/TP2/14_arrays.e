@@ -0,0 +1,34 @@
+class MAIN
+feature
+   make
+      local
+         a, b: ARRAY [INTEGER];
+         r: ARRAY [REAL];
+         i: INTEGER
+      do
+         create a.make (1, 10)
+         from
+            i := 1
+         until
+            i > 10
+         loop
+            a.put (i * i, i)
+            i := i + 1
+         end
+         print(a.count)
+         print(a.item (3))
+         print(a.sum)
+         print(a.min, " ", a.max)
+         create b.make_filled (2, 1, 10)
+         a.multiply (b)
+         print(a.item (10))
+         b.fill (5)
+         a.subtract (b)
+         print(a.sum)
+         create r.make (0, 4)
+         r.put (1.5, 0)
+         r.put (2.25, 4)
+         print(r.sum)
+         print(r.lower, " ", r.upper)
+      end
+end
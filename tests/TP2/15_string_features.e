@@ -0,0 +1,39 @@
+class MAIN
+feature
+   make
+      local
+         s, t: STRING;
+         parts: ARRAY [STRING];
+         i, total: INTEGER
+      do
+         s := "the quick brown fox jumps over the lazy dog"
+         print(s.count)
+         print(s.index_of ("fox"), " ", s.index_of ("the", 2), " ", s.index_of ("cat"))
+         print(s.has ("lazy"), " ", s.has ("LAZY"))
+         print(s.substring (5, 9), "|", s.substring (3, 2), "|")
+         -- inicio = fin + 1 es el STRING vacío, también en los extremos
+         i := s.count
+         print(s.substring (i + 1, i), "|", s.substring (1, 0), "|", s.substring (i + 1, i).count)
+         t := "the quick brown fox"
+         print(s.substring (1, 19).is_equal (t), " ", s.is_equal (t))
+         print("abc" < "abd", " ", "b" > "abc", " ", "abc" < "ab", " ", t = "the quick brown fox")
+         print(s.hash_code = t.hash_code, " ", t.hash_code = s.substring (1, 19).hash_code)
+         parts := "10,20,,30" .split (",")
+         print(parts.count)
+         from
+            i := 1
+            total := 0
+         until
+            i > parts.count
+         loop
+            if parts.item (i).is_integer then
+               total := total + parts.item (i).to_integer
+            else
+               print("no es entero: [", parts.item (i), "]")
+            end
+            i := i + 1
+         end
+         print(total)
+         print("-42".to_integer + 2, " ", 1.5 < 2)
+      end
+end
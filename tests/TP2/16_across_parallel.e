@@ -0,0 +1,51 @@
+class MAIN
+feature
+   make
+      local
+         squares, chain, zeros: ARRAY [INTEGER];
+         total, product, n, last, square, misses, seen: INTEGER;
+         text: STRING
+      do
+         n := 1000
+         create squares.make (1, n)
+         total := 5
+         product := 1
+         text := ">"
+         misses := 0
+         -- Reducciones (+, -, *, concatenación) y temporales en un across paralelo
+         across 1 |..| n as i parallel loop
+            square := i * i
+            squares.put (square, i)
+            total := total + square
+            if i < 11 then
+               product := product * i
+               text := text + "x"
+            else
+               misses := misses - 1
+            end
+            last := i
+         end
+         print(total, " ", squares.sum, " ", product, " ", text, " ", misses, " ", last)
+         -- La salida de print respeta el orden de las iteraciones
+         across 1 |..| 5 as j parallel loop
+            print("iteración ", j)
+         end
+         across 1 |..| 3 as k loop
+            total := total + k
+         end
+         print(total)
+         -- Leer otro elemento o todo el ARRAY que el cuerpo escribe: corre en secuencia
+         create chain.make (0, n)
+         chain.put (1, 0)
+         across 1 |..| n as m parallel loop
+            chain.put (chain.item (m - 1) + 1, m)
+         end
+         create zeros.make_filled (7, 1, n)
+         seen := 0
+         across 1 |..| n as p parallel loop
+            zeros.put (0, p)
+            seen := seen + zeros.sum
+         end
+         print(chain.item (n), " ", seen)
+      end
+end
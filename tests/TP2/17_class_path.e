@@ -0,0 +1,17 @@
+-- POINT y LABEL están en tests/TP2/classes (EIFFEL_CLASSPATH) y se cargan al usarlas
+class MAIN
+feature
+   make
+      local
+         p, q: POINT
+      do
+         create p
+         p.x := 3
+         p.y := 4
+         p.show
+         create q
+         q.x := p.x + p.y
+         print(q.x)
+         p.describe
+      end
+end
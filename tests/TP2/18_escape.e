@@ -0,0 +1,81 @@
+-- Objetos locales que no escapan (viven en el frame) y que sí escapan (heap)
+class BOX
+feature
+   v: INTEGER
+
+   bump
+      do
+         Current.v := Current.v + 5
+      end
+end
+
+class NODE
+feature
+   v: INTEGER
+   owner: WORKER
+
+   register
+      do
+         Current.owner.last := Current
+      end
+end
+
+class WORKER
+feature
+   kept: BOX
+   last: NODE
+
+   run
+      local
+         b: BOX
+      do
+         create b
+         b.v := 10
+         b.bump
+         b.bump
+         print(b.v)
+      end
+
+   keep
+      local
+         b: BOX
+      do
+         create b
+         b.v := 42
+         Current.kept := b
+      end
+
+   chain
+      local
+         n: NODE
+      do
+         create n
+         n.v := 7
+         n.owner := Current
+         n.register
+      end
+end
+
+class MAIN
+feature
+   make
+      local
+         w: WORKER;
+         i: INTEGER
+      do
+         create w
+         from
+            i := 0
+         until
+            i = 3
+         loop
+            w.run
+            i := i + 1
+         end
+         w.keep
+         w.chain
+         w.run
+         print(w.kept.v)
+         print(w.last.v)
+      end
+end
@@ -0,0 +1,89 @@
+-- Imagen del heap: make arma el estado, resume lo usa después de restaurar la imagen
+class NODE
+feature
+   value: INTEGER
+   next: NODE
+end
+
+class REGISTRY
+feature
+   name: STRING
+   first: NODE
+   ratio: REAL
+   squares: ARRAY [INTEGER]
+   labels: ARRAY [STRING]
+
+   report_total
+      local
+         n: NODE;
+         t: INTEGER
+      do
+         t := 0
+         n := Current.first
+         from
+         until
+            n.value = 3
+         loop
+            t := t + n.value
+            n := n.next
+         end
+         print(t + n.value)
+      end
+end
+
+class MAIN
+feature
+   make
+      local
+         r: REGISTRY;
+         a, b, c: NODE;
+         sq: ARRAY [INTEGER];
+         lb: ARRAY [STRING];
+         i: INTEGER;
+         greeting: STRING
+      do
+         create r
+         create a
+         create b
+         create c
+         a.value := 1
+         b.value := 2
+         c.value := 3
+         a.next := b
+         b.next := c
+         c.next := a
+         r.first := a
+         r.name := "registro"
+         r.ratio := 2.5
+         create sq.make (1, 5)
+         from
+            i := 1
+         until
+            i > 5
+         loop
+            sq.put (i * i, i)
+            i := i + 1
+         end
+         r.squares := sq
+         create lb.make (0, 1)
+         lb.put ("cero", 0)
+         lb.put ("uno", 1)
+         r.labels := lb
+         greeting := "hola"
+         print("estado listo")
+      end
+
+   resume
+      do
+         print(greeting)
+         print(r.name)
+         print(r.ratio)
+         print(r.squares.item (4))
+         print(r.labels.item (1))
+         r.report_total
+         sq.put (100, 5)
+         print(r.squares.item (5))
+         print(r.first.next.next.next.value)
+         print(i)
+      end
+end
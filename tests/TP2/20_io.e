@@ -0,0 +1,73 @@
+-- Entrada/salida: PLAIN_TEXT_FILE escribe un archivo y después se lee por líneas y por enteros
+class MAIN
+feature
+   make
+      local
+         f: PLAIN_TEXT_FILE;
+         g: PLAIN_TEXT_FILE;
+         line: STRING;
+         total: INTEGER;
+         lines: INTEGER;
+         i: INTEGER
+      do
+         create f.make_open_write("tests/TP2/20_io.e.data")
+         f.put_string("numeros")
+         f.put_new_line
+         from
+            i := 1
+         until
+            i > 5
+         loop
+            f.put_integer(i * 10)
+            f.put_string(" ")
+            i := i + 1
+         end
+         f.put_new_line
+         f.put_string("fin")
+         f.put_new_line
+         f.close
+
+         create g.make_open_read("tests/TP2/20_io.e.data")
+         print(g.is_open_read)
+         line := g.read_line
+         print(line)
+         total := 0
+         from
+            i := 1
+         until
+            i > 5
+         loop
+            total := total + g.read_integer
+            i := i + 1
+         end
+         print(total)
+         print(g.last_integer)
+         g.read_line
+         lines := 0
+         from
+         until
+            g.end_of_file = 1
+         loop
+            g.read_line
+            print(g.last_string)
+            lines := lines + 1
+         end
+         print(lines)
+         g.close
+         print(g.is_open_read)
+
+         f.make_open_append("tests/TP2/20_io.e.data")
+         f.put_real(2.5)
+         f.put_new_line
+         f.close
+         g.make_open_read(f.name)
+         from
+         until
+            g.end_of_file = 1
+         loop
+            line := g.read_line
+         end
+         print(line)
+         g.close
+      end
+end
@@ -0,0 +1,100 @@
+-- Rutinas once: la primera llamada ejecuta el cuerpo y las siguientes devuelven el mismo resultado
+class CONFIG
+feature
+   name: STRING
+   level: INTEGER
+end
+
+class SERVICE
+feature
+   calls: INTEGER
+   id: INTEGER
+
+   set_id (n: INTEGER)
+      do
+         Current.id := n
+      end
+
+   shared: CONFIG
+      once
+         print("creando CONFIG")
+         create Result
+         Result.name := "global"
+         Result.level := 3
+      end
+
+   squares: ARRAY [INTEGER]
+      once
+         print("armando tabla")
+         create Result.make(1, 5)
+         across 1 |..| 5 as i loop
+            Result.put(i * i, i)
+         end
+      end
+
+   label: STRING
+      once ("OBJECT")
+         Current.calls := Current.calls + 1
+         Result := "servicio " + describe(id)
+      end
+
+   describe (n: INTEGER): STRING
+      do
+         if n < 10 then
+            Result := "chico"
+         else
+            Result := "grande"
+         end
+         Result := Result + " (" + Current.name_of(n) + ")"
+      end
+
+   name_of (n: INTEGER): STRING
+      do
+         if n = 7 then
+            Result := "siete"
+         else
+            Result := "doce"
+         end
+      end
+
+   setup
+      once
+         print("setup")
+      end
+end
+
+class MAIN
+feature
+   banner: STRING
+      once
+         print("calculando banner")
+         Result := "== once =="
+      end
+
+   make
+      local
+         a: SERVICE;
+         b: SERVICE;
+         c: CONFIG;
+         t: ARRAY [INTEGER]
+      do
+         print(banner)
+         print(banner)
+         create a.set_id(7)
+         create b.set_id(12)
+         a.setup
+         b.setup
+         c := a.shared
+         print(c.name)
+         c.level := c.level + 1
+         print(b.shared.level)
+         t := a.squares
+         print(b.squares.item(4))
+         print(t.sum)
+         print(a.label)
+         print(a.label)
+         print(b.label)
+         print(a.calls)
+         print(b.calls)
+      end
+end
@@ -0,0 +1,57 @@
+-- Aritmética completa INTEGER/REAL: los nodos se especializan y se desoptimizan si cambian los tipos
+class MAIN
+feature
+   average (a: REAL; b: REAL): REAL
+      do
+         Result := (a + b) / 2
+      end
+
+   make
+      local
+         total: INTEGER;
+         v: INTEGER;
+         k: INTEGER;
+         r: REAL;
+         s: STRING
+      do
+         r := 1.5 + 2.25
+         print(r)
+         print(r * 2)
+         print(3 - r)
+         print(7 / 2)
+         print(7.0 / 2)
+         print(average(3, 4))
+         print(2.5 < 3)
+         print(2 = 2.0)
+
+         total := 0
+         v := 1
+         from
+            k := 1
+         until
+            k > 8
+         loop
+            total := total + v
+            if k = 4 then
+               v := 0.5
+            else
+               v := v
+            end
+            k := k + 1
+         end
+         print(total)
+
+         s := ""
+         from
+            k := 1
+         until
+            k > 3
+         loop
+            s := s + "ab"
+            k := k + 1
+         end
+         print(s)
+         print(s < "abac")
+         print(0 - 2147483647 - 2)
+      end
+end
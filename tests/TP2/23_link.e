@@ -0,0 +1,88 @@
+-- Enlace: solo quedan las clases y rutinas alcanzables desde MAIN.make; las llamadas con clase
+-- conocida se enlazan antes de ejecutar (el .info muestra el resumen)
+class POINT
+feature
+   x: INTEGER
+   y: INTEGER
+
+   set (a: INTEGER; b: INTEGER)
+      do
+         Current.x := a
+         Current.y := b
+      end
+
+   sum: INTEGER
+      do
+         Result := x + y
+      end
+
+   scaled (k: INTEGER): POINT
+      do
+         create Result
+         Result.set(x * k, y * k)
+      end
+
+   unused_distance: INTEGER
+      do
+         Result := x * x + y * y
+      end
+end
+
+class SEGMENT
+feature
+   from_point: POINT
+   to_point: POINT
+
+   make (a: POINT; b: POINT)
+      do
+         Current.from_point := a
+         Current.to_point := b
+      end
+
+   width: INTEGER
+      do
+         Result := to_point.x - from_point.x
+      end
+end
+
+class NEVER_CREATED
+feature
+   value: INTEGER
+
+   sum: INTEGER
+      do
+         Result := value
+      end
+end
+
+class MAIN
+feature
+   make
+      local
+         p, q: POINT;
+         s: SEGMENT;
+         other: POINT
+      do
+         create p
+         p.set(2, 3)
+         print(p.sum)
+         q := p.scaled(10)
+         print(q.sum)
+         print(p.scaled(2).scaled(3).sum)
+         create s.make(p, q)
+         print(s.width)
+         other := q
+         print(other.sum)
+         print(twice(21))
+      end
+
+   twice (n: INTEGER): INTEGER
+      do
+         Result := n + n
+      end
+
+   never_called
+      do
+         print("no")
+      end
+end
@@ -0,0 +1,31 @@
+-- Programa de varios archivos: tests/TP2/multi/*.e se parsean en paralelo con este
+-- (ver 24_multi_file.e.files) y sus clases se registran después de las del programa
+class GREETING
+feature
+   text: STRING
+      do
+         Result := "hola desde el programa"
+      end
+end
+
+class MAIN
+feature
+   make
+      local
+         r: RECTANGLE;
+         s: SQUARE;
+         rep: REPORT;
+         g: GREETING
+      do
+         create r.make(3, 4)
+         create s
+         s.side := 5
+         create rep
+         rep.add(r.area)
+         rep.add(s.area)
+         print(rep.title)
+         print(rep.total)
+         create g
+         print(g.text)
+      end
+end
@@ -0,0 +1,137 @@
+-- Inlining: las rutinas chicas sin llamadas (get, set_step, inc, scaled, sign, label_of...) se
+-- empalman en la llamada, con los mismos resultados que una llamada normal
+class ACCOUNT
+feature
+   balance: INTEGER
+   rate: REAL
+   step: INTEGER
+   name: STRING
+
+   set_step (s: INTEGER)
+      do
+         Current.step := s
+      end
+
+   set_rate (r: REAL)
+      do
+         Current.rate := r
+      end
+
+   inc
+      do
+         Current.balance := balance + step
+      end
+
+   local_only
+      do
+         -- Sin Current: balance es una variable del scope de la llamada, el atributo no cambia
+         balance := balance + 1000
+      end
+
+   doubled_next: INTEGER
+      do
+         -- La primera balance es el atributo; después de asignarla, la variable de la llamada
+         balance := balance + 1
+         Result := balance * 2
+      end
+
+   pick (flag: BOOLEAN): INTEGER
+      do
+         if flag then
+            t := 10
+         else
+            t := 20
+         end
+         Result := t + step
+      end
+
+   maybe_local (flag: BOOLEAN): INTEGER
+      do
+         -- balance es variable solo si flag: se resuelve al ejecutar, no va en línea
+         if flag then
+            balance := 7
+         else
+            Result := 1
+         end
+         Result := Result + balance
+      end
+
+   get: INTEGER
+      do
+         Result := balance
+      end
+
+   scaled (k: INTEGER): REAL
+      do
+         Result := rate * k
+      end
+
+   sign (v: INTEGER): INTEGER
+      do
+         if v < 0 then
+            Result := 0 - 1
+         else
+            if v = 0 then
+               Result := 0
+            else
+               Result := 1
+            end
+         end
+      end
+
+   label_of (prefix: STRING): STRING
+      do
+         Result := prefix + name
+      end
+
+   rename (n: STRING)
+      do
+         Current.name := n
+      end
+
+   countdown (n: INTEGER): INTEGER
+      do
+         -- Recursiva: se llama a sí misma, no va en línea
+         if n = 0 then
+            Result := 0
+         else
+            Result := 1 + countdown(n - 1)
+         end
+      end
+end
+
+class MAIN
+feature
+   make
+      local
+         a: ACCOUNT;
+         i: INTEGER;
+         total: INTEGER
+      do
+         create a
+         a.set_step(3)
+         a.set_rate(2)
+         a.rename("ahorro")
+         total := 0
+         from i := 1 until i > 10 loop
+            a.inc
+            total := total + a.get
+            i := i + 1
+         end
+         print(total)
+         a.local_only
+         print(a.get)
+         print(a.scaled(4))
+         print(a.sign(0 - 5))
+         print(a.sign(0))
+         print(a.sign(7))
+         print(a.label_of("cuenta "))
+         print(a.countdown(5))
+         print(a.doubled_next)
+         print(a.get)
+         print(a.pick(True))
+         print(a.pick(False))
+         print(a.maybe_local(True))
+         print(a.maybe_local(False))
+      end
+end
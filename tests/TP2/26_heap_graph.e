@@ -0,0 +1,58 @@
+-- Objetos compartidos y ciclos: el .info y --heap-dump escriben cada objeto una sola vez
+class NODE
+feature
+   value: INTEGER
+   left: NODE
+   right: NODE
+   next: NODE
+end
+
+class MAIN
+feature
+   new_node (v: INTEGER): NODE
+      do
+         create Result
+         Result.value := v
+      end
+
+   make
+      local
+         first: NODE;
+         last: NODE;
+         n: NODE;
+         ladder: NODE;
+         i: INTEGER;
+         total: INTEGER
+      do
+         -- Anillo de 5 nodos: el último apunta al primero
+         first := new_node(1)
+         last := first
+         from i := 2 until i > 5 loop
+            n := new_node(i)
+            last.next := n
+            last := n
+            i := i + 1
+         end
+         last.next := first
+
+         -- Escalera de 40 niveles: left y right apuntan al mismo nodo (muchos caminos, pocos objetos)
+         ladder := new_node(0)
+         from i := 1 until i > 40 loop
+            n := new_node(i)
+            n.left := ladder
+            n.right := ladder
+            ladder := n
+            i := i + 1
+         end
+
+         total := 0
+         n := first
+         from i := 1 until i > 12 loop
+            total := total + n.value
+            n := n.next
+            i := i + 1
+         end
+         print(total)
+         print(ladder.value + ladder.left.value + ladder.right.left.value)
+      end
+end
@@ -0,0 +1,68 @@
+-- Objetos separate: cada SUMMER suma su intervalo en su propio procesador
+class SUMMER
+feature
+   label: STRING
+   total: INTEGER
+
+   make (name: STRING; low: INTEGER; high: INTEGER)
+      local
+         i: INTEGER
+      do
+         Current.label := name
+         from i := low until i > high loop
+            Current.total := total + i
+            i := i + 1
+         end
+      end
+
+   add (k: INTEGER)
+      do
+         Current.total := total + k
+      end
+
+   absorb (other: separate SUMMER)
+      do
+         Current.total := total + other.total
+      end
+
+   report
+      do
+         print(label, ": ", total)
+      end
+
+   doubled: INTEGER
+      do
+         Result := total * 2
+      end
+end
+
+class MAIN
+feature
+   make
+      local
+         a: separate SUMMER;
+         b: separate SUMMER;
+         c: separate SUMMER;
+         ra: INTEGER;
+         rb: INTEGER;
+         rc: INTEGER
+      do
+         create a.make("a", 1, 10000)
+         create b.make("b", 10001, 20000)
+         create c.make("c", 20001, 30000)
+         -- Las tres consultas quedan pendientes: se esperan recién al leer ra, rb y rc
+         ra := a.total
+         rb := b.total
+         rc := c.total
+         print(ra + rb + rc)
+
+         -- Los comandos se encolan en orden: report ve el add y doubled espera a los dos
+         b.add(5)
+         b.report
+         print(b.doubled)
+
+         -- a espera a c desde su propio procesador
+         a.absorb(c)
+         print(a.total)
+      end
+end
@@ -0,0 +1,72 @@
+-- BOOLEAN: not, and, or, implies y las formas de cortocircuito 'and then' / 'or else'
+class PROBE
+feature
+   done: BOOLEAN
+   calls: INTEGER
+
+   positive (n: INTEGER): BOOLEAN
+      do
+         Current.calls := calls + 1
+         Result := n > 0
+      end
+end
+
+class MAIN
+feature
+   make
+      local
+         p: PROBE;
+         d: INTEGER;
+         b: BOOLEAN;
+         i: INTEGER;
+         found: INTEGER;
+         s: STRING;
+         a: ARRAY [INTEGER]
+      do
+         create p
+         print(p.done, " ", True, " ", not False)
+         b := 3 < 4 and not (2 = 3)
+         print(b)
+         print(True implies False, " ", False implies (1 / 0 = 1))
+
+         d := 0
+         if not (d = 0) and then 10 / d > 1 then
+            print("no")
+         else
+            print("and then no evalua la division")
+         end
+         if d = 0 or else 10 / d > 1 then
+            print("or else no evalua la division")
+         else
+         end
+
+         b := p.positive(0 - 1) and then p.positive(1)
+         print(b, " ", p.calls)
+         b := p.positive(0 - 1) and p.positive(1)
+         print(b, " ", p.calls)
+         b := p.positive(1) or else p.positive(2)
+         print(b, " ", p.calls)
+         b := p.positive(1) or p.positive(2)
+         print(b, " ", p.calls)
+
+         from
+            i := 1
+            found := 0
+         until
+            i > 10 or else found > 0
+         loop
+            if i * i > 20 then
+               found := i
+            else
+            end
+            i := i + 1
+         end
+         print(found)
+
+         -- Las consultas predefinidas también devuelven BOOLEAN
+         s := "boolean"
+         create a.make (1, 3)
+         b := s.has ("lean") and not s.is_integer
+         print(b, " ", s.is_equal ("boolean"), " ", a.valid_index (4))
+      end
+end
@@ -0,0 +1,58 @@
+-- Cuerpos diferidos (--lazy-bodies, ver 29_lazy_bodies.e.flags): cada cuerpo se parsea al primer uso
+class REPORT
+feature
+   total: INTEGER
+
+   -- Nunca se llama: con cuerpos diferidos su error de sintaxis no se ve
+   unused
+      do
+         print("nunca" +)
+      end
+
+   add (n: INTEGER)
+      do
+         -- Un 'end' en un comentario o en un "end" no cierra el cuerpo
+         if n > 0 then
+            Current.total := total + n
+         else
+            print("end")
+         end
+      end
+
+   sum_to (n: INTEGER): INTEGER
+      local
+         i: INTEGER
+      do
+         from
+            i := 1
+         until
+            i > n
+         loop
+            across 1 |..| i as k loop
+               Result := Result + 1
+            end
+            i := i + 1
+         end
+      end
+
+   label: STRING
+      once ("OBJECT")
+         print("armando label")
+         Result := "total: "
+      end
+end
+
+class MAIN
+feature
+   make
+      local
+         r: REPORT
+      do
+         create r
+         r.add(5)
+         r.add(0)
+         r.add(37)
+         print(r.label, r.total)
+         print(r.label, r.sum_to(10))
+      end
+end
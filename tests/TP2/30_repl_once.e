@@ -0,0 +1,30 @@
+-- Rutinas once en el REPL: ':load' de este archivo y una clase con once escrita en la sesión
+-- (ver 30_repl_once.e.repl); también se ejecuta como programa
+class SETTINGS
+feature
+   calls: INTEGER
+
+   greeting: STRING
+      once
+         print("armando saludo")
+         Result := "hola"
+      end
+
+   counter: INTEGER
+      once ("OBJECT")
+         Current.calls := calls + 1
+         Result := 10 * calls
+      end
+end
+
+class MAIN
+feature
+   make
+      local
+         s: SETTINGS
+      do
+         create s
+         print(s.greeting, " ", s.greeting)
+         print(s.counter, " ", s.counter)
+      end
+end
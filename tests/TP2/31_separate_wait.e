@@ -0,0 +1,51 @@
+-- Un procesador que espera una consulta no ejecuta otros encima de su pila: otro puede consultarlo
+class WORKER
+feature
+   total: INTEGER
+
+   slow: INTEGER
+      local
+         i: INTEGER
+      do
+         from i := 1 until i > 200000 loop
+            Result := Result + 1
+            i := i + 1
+         end
+      end
+
+   work (other: separate WORKER)
+      local
+         r: INTEGER
+      do
+         r := other.slow
+         Current.total := total + 1
+      end
+
+   poke (other: separate WORKER)
+      local
+         r: INTEGER
+      do
+         r := other.total
+         Current.total := total + r
+      end
+end
+
+class MAIN
+feature
+   make
+      local
+         a: separate WORKER;
+         b: separate WORKER;
+         c: separate WORKER;
+         r: INTEGER
+      do
+         create a
+         create b
+         create c
+         -- b consulta a mientras a espera a c
+         a.work (c)
+         b.poke (a)
+         r := b.total
+         print (r)
+      end
+end
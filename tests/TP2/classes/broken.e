@@ -0,0 +1,8 @@
+-- Nunca se carga: ningún programa de tests/TP2 usa la clase BROKEN
+class BROKEN
+feature
+   oops
+      do
+         x := := 1
+      end
+end
@@ -0,0 +1,4 @@
+class LABEL
+feature
+   text: STRING
+end
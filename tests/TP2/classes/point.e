@@ -0,0 +1,20 @@
+class POINT
+feature
+   x: INTEGER
+   y: INTEGER
+
+   show
+      do
+         print(x)
+         print(y)
+      end
+
+   describe
+      local
+         l: LABEL
+      do
+         create l
+         l.text := "punto"
+         print(l.text)
+      end
+end
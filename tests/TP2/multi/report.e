@@ -0,0 +1,23 @@
+-- Clases para 24_multi_file.e. GREETING también está en el programa: gana la del programa
+class REPORT
+feature
+   total: INTEGER
+
+   add (n: INTEGER)
+      do
+         Current.total := Current.total + n
+      end
+
+   title: STRING
+      do
+         Result := "total"
+      end
+end
+
+class GREETING
+feature
+   text: STRING
+      do
+         Result := "hola desde report.e"
+      end
+end
@@ -0,0 +1,27 @@
+-- Clases para 24_multi_file.e (se pasa como archivo extra en la línea de comandos)
+class RECTANGLE
+feature
+   width: INTEGER
+   height: INTEGER
+
+   make (w: INTEGER; h: INTEGER)
+      do
+         Current.width := w
+         Current.height := h
+      end
+
+   area: INTEGER
+      do
+         Result := width * height
+      end
+end
+
+class SQUARE
+feature
+   side: INTEGER
+
+   area: INTEGER
+      do
+         Result := side * side
+      end
+end
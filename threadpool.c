@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "threadpool.h"
+
+/* Comentario general:
+   - Cada hilo tiene una cola de índices de tarea [head, tail) protegida por su propio mutex:
+     las tareas son bloques de iteraciones, así que el costo del lock es despreciable.
+   - El dueño saca de tail (lo último que recibió) y los ladrones sacan de head.
+   - Un trabajo se publica incrementando 'generation'. El que llama espera a que no queden tareas
+     pendientes ni workers dentro del trabajo; así ningún worker ve colas de un trabajo siguiente
+     con la función del anterior.
+*/
+
+typedef struct {
+    pthread_mutex_t lock;
+    int head;
+    int tail;
+} TaskQueue;
+
+static struct {
+    int size;                 // Hilos totales (el hilo 0 es el que llama a pool_run)
+    TaskQueue queues[POOL_MAX_THREADS];
+    pthread_mutex_t job_lock;
+    pthread_cond_t job_ready;
+    pthread_cond_t job_done;
+    unsigned generation;
+    PoolTask task;
+    void *context;
+    int pending;              // Tareas sin terminar del trabajo actual
+    int active;               // Workers dentro del trabajo actual
+    pthread_mutex_t run_lock; // Un solo trabajo a la vez
+} pool = {
+    .size = 0,
+    .job_lock = PTHREAD_MUTEX_INITIALIZER,
+    .job_ready = PTHREAD_COND_INITIALIZER,
+    .job_done = PTHREAD_COND_INITIALIZER,
+    .run_lock = PTHREAD_MUTEX_INITIALIZER
+};
+
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+static _Thread_local int current_slot = -1; // Cola del hilo mientras ejecuta tareas; -1 fuera del pool
+
+static int take_own(int slot) {
+    TaskQueue *q = &pool.queues[slot];
+    int index = -1;
+    pthread_mutex_lock(&q->lock);
+    if (q->head < q->tail) index = --q->tail;
+    pthread_mutex_unlock(&q->lock);
+    return index;
+}
+
+static int steal(int slot) {
+    for (int k = 1; k < pool.size; k++) {
+        TaskQueue *q = &pool.queues[(slot + k) % pool.size];
+        int index = -1;
+        pthread_mutex_lock(&q->lock);
+        if (q->head < q->tail) index = q->head++;
+        pthread_mutex_unlock(&q->lock);
+        if (index >= 0) return index;
+    }
+    return -1;
+}
+
+// Ejecuta tareas propias y robadas hasta que no quede ninguna; devuelve cuántas ejecutó
+static int drain(int slot, PoolTask task, void *context) {
+    int done = 0;
+    int index;
+    current_slot = slot;
+    while ((index = take_own(slot)) >= 0 || (index = steal(slot)) >= 0) {
+        task(context, index);
+        done++;
+    }
+    current_slot = -1;
+    return done;
+}
+
+static void* worker_main(void *arg) {
+    int slot = (int)(intptr_t)arg;
+    unsigned seen = 0;
+    for (;;) {
+        pthread_mutex_lock(&pool.job_lock);
+        while (pool.generation == seen) pthread_cond_wait(&pool.job_ready, &pool.job_lock);
+        seen = pool.generation;
+        if (pool.pending == 0) { // Llegó tarde: el trabajo ya terminó
+            pthread_mutex_unlock(&pool.job_lock);
+            continue;
+        }
+        PoolTask task = pool.task;
+        void *context = pool.context;
+        pool.active++;
+        pthread_mutex_unlock(&pool.job_lock);
+
+        int done = drain(slot, task, context);
+
+        pthread_mutex_lock(&pool.job_lock);
+        pool.active--;
+        pool.pending -= done;
+        if (pool.pending == 0 && pool.active == 0) pthread_cond_broadcast(&pool.job_done);
+        pthread_mutex_unlock(&pool.job_lock);
+    }
+    return NULL;
+}
+
+int pool_configured_size(void) {
+    const char *env = getenv("EIFFEL_THREADS");
+    long size = env ? strtol(env, NULL, 10) : sysconf(_SC_NPROCESSORS_ONLN);
+    if (size < 1) size = 1;
+    if (size > POOL_MAX_THREADS) size = POOL_MAX_THREADS;
+    return (int)size;
+}
+
+static void start_pool(void) {
+    pool.size = pool_configured_size();
+
+    for (int i = 0; i < pool.size; i++) {
+        pthread_mutex_init(&pool.queues[i].lock, NULL);
+        pool.queues[i].head = pool.queues[i].tail = 0;
+    }
+    for (int i = 1; i < pool.size; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, worker_main, (void*)(intptr_t)i) != 0) {
+            pool.size = i; // Seguimos con los hilos que se pudieron crear
+            break;
+        }
+        pthread_detach(thread);
+    }
+}
+
+int pool_size(void) {
+    pthread_once(&pool_once, start_pool);
+    return pool.size;
+}
+
+int pool_in_task(void) {
+    return current_slot >= 0;
+}
+
+void pool_run(int task_count, PoolTask task, void *context) {
+    if (task_count <= 0) return;
+    if (pool_in_task() || pool_size() == 1 || task_count == 1) {
+        int previous = current_slot;
+        current_slot = previous >= 0 ? previous : 0;
+        for (int i = 0; i < task_count; i++) task(context, i);
+        current_slot = previous;
+        return;
+    }
+
+    pthread_mutex_lock(&pool.run_lock);
+    for (int i = 0; i < pool.size; i++) {
+        TaskQueue *q = &pool.queues[i];
+        pthread_mutex_lock(&q->lock);
+        q->head = (int)((long)task_count * i / pool.size);
+        q->tail = (int)((long)task_count * (i + 1) / pool.size);
+        pthread_mutex_unlock(&q->lock);
+    }
+
+    pthread_mutex_lock(&pool.job_lock);
+    pool.task = task;
+    pool.context = context;
+    pool.pending = task_count;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.job_ready);
+    pthread_mutex_unlock(&pool.job_lock);
+
+    int done = drain(0, task, context);
+
+    pthread_mutex_lock(&pool.job_lock);
+    pool.pending -= done;
+    while (pool.pending > 0 || pool.active > 0) pthread_cond_wait(&pool.job_done, &pool.job_lock);
+    pthread_mutex_unlock(&pool.job_lock);
+    pthread_mutex_unlock(&pool.run_lock);
+}
@@ -0,0 +1,29 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+/* Comentario general:
+   - Pool de hilos con robo de trabajo (work stealing), creado la primera vez que se usa.
+   - pool_run reparte las tareas 0..n-1 en colas por hilo (bloques contiguos); cada hilo toma de
+     su propia cola por el final y, cuando se queda sin trabajo, roba del principio de las otras.
+   - El hilo que llama a pool_run también ejecuta tareas (es el hilo 0 del pool).
+   - Tamaño: variable de entorno EIFFEL_THREADS o la cantidad de CPUs en línea.
+*/
+
+#define POOL_MAX_THREADS 64
+
+typedef void (*PoolTask)(void *context, int task_index);
+
+// Ejecuta task(context, i) para cada i en [0, task_count) y vuelve cuando terminaron todas.
+// Llamado desde dentro de una tarea (anidado) ejecuta todo en el hilo actual, en orden.
+void pool_run(int task_count, PoolTask task, void *context);
+
+// Cantidad de hilos del pool, incluido el que llama a pool_run
+int pool_size(void);
+
+// Tamaño que tendría el pool según EIFFEL_THREADS o las CPUs (sin crearlo; lo usa scoop.c)
+int pool_configured_size(void);
+
+// 1 si el hilo actual está ejecutando una tarea del pool
+int pool_in_task(void);
+
+#endif // THREADPOOL_H
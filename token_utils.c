@@ -15,6 +15,19 @@ const char* get_token_name(int token) {
         case TOKEN_LOOP: return "TOKEN_LOOP";
         case TOKEN_LOCAL: return "TOKEN_LOCAL";
         case TOKEN_CREATE: return "TOKEN_CREATE";
+        case TOKEN_ACROSS: return "TOKEN_ACROSS";
+        case TOKEN_AS: return "TOKEN_AS";
+        case TOKEN_PARALLEL: return "TOKEN_PARALLEL";
+        case TOKEN_ONCE: return "TOKEN_ONCE";
+        case TOKEN_SEPARATE: return "TOKEN_SEPARATE";
+        case TOKEN_NOT: return "TOKEN_NOT";
+        case TOKEN_AND: return "TOKEN_AND";
+        case TOKEN_OR: return "TOKEN_OR";
+        case TOKEN_IMPLIES: return "TOKEN_IMPLIES";
+        case TOKEN_TRUE: return "TOKEN_TRUE";
+        case TOKEN_FALSE: return "TOKEN_FALSE";
+        case TOKEN_LAZY_BODY: return "TOKEN_LAZY_BODY";
+        case TOKEN_INTERVAL: return "TOKEN_INTERVAL";
         case TOKEN_IDENTIFIER: return "TOKEN_IDENTIFIER";
         case TOKEN_STRING: return "TOKEN_STRING";
         case TOKEN_NUMBER_INT: return "TOKEN_NUMBER_INT";
@@ -32,6 +45,8 @@ const char* get_token_name(int token) {
         case TOKEN_DIV: return "TOKEN_DIV";
         case TOKEN_LPAREN: return "TOKEN_LPAREN";
         case TOKEN_RPAREN: return "TOKEN_RPAREN";
+        case TOKEN_LBRACKET: return "TOKEN_LBRACKET";
+        case TOKEN_RBRACKET: return "TOKEN_RBRACKET";
         case TOKEN_SEMI: return "TOKEN_SEMI";
         case TOKEN_COLON: return "TOKEN_COLON";
         case TOKEN_COMMA: return "TOKEN_COMMA";
@@ -39,56 +54,71 @@ const char* get_token_name(int token) {
     }
 }
 
-void print_token(int token, YYSTYPE yylval, int yylineno) {
-    if (!info_file_ptr) return;
+void print_token(FILE *output, int token, YYSTYPE yylval, int yylineno) {
+    if (!output) return;
 
     const char* token_name = get_token_name(token);
-    fprintf(info_file_ptr, "[Line %d] %s: ", yylineno, token_name);
+    fprintf(output, "[Line %d] %s: ", yylineno, token_name);
 
     switch (token) {
-        case TOKEN_CLASS: fprintf(info_file_ptr, "\"class\"\n"); break;
-        case TOKEN_FEATURE: fprintf(info_file_ptr, "\"feature\"\n"); break;
-        case TOKEN_DO: fprintf(info_file_ptr, "\"do\"\n"); break;
-        case TOKEN_END: fprintf(info_file_ptr, "\"end\"\n"); break;
-        case TOKEN_IF: fprintf(info_file_ptr, "\"if\"\n"); break;
-        case TOKEN_THEN: fprintf(info_file_ptr, "\"then\"\n"); break;
-        case TOKEN_ELSE: fprintf(info_file_ptr, "\"else\"\n"); break;
-        case TOKEN_FROM: fprintf(info_file_ptr, "\"from\"\n"); break;
-        case TOKEN_UNTIL: fprintf(info_file_ptr, "\"until\"\n"); break;
-        case TOKEN_LOOP: fprintf(info_file_ptr, "\"loop\"\n"); break;
-        case TOKEN_LOCAL: fprintf(info_file_ptr, "\"local\"\n"); break;
-        case TOKEN_CREATE: fprintf(info_file_ptr, "\"create\"\n"); break;
-        case TOKEN_ASSIGN: fprintf(info_file_ptr, "\":=\"\n"); break;
-        case TOKEN_LE: fprintf(info_file_ptr, "\"<=\"\n"); break;
-        case TOKEN_GE: fprintf(info_file_ptr, "\">=\"\n"); break;
-        case TOKEN_EQ: fprintf(info_file_ptr, "\"=\"\n"); break;
-        case TOKEN_LT: fprintf(info_file_ptr, "\"<\"\n"); break;
-        case TOKEN_GT: fprintf(info_file_ptr, "\">\"\n"); break;
-        case TOKEN_DOT: fprintf(info_file_ptr, "\".\"\n"); break;
-        case TOKEN_PLUS: fprintf(info_file_ptr, "\"+\"\n"); break;
-        case TOKEN_MINUS: fprintf(info_file_ptr, "\"-\"\n"); break;
-        case TOKEN_MULT: fprintf(info_file_ptr, "\"*\"\n"); break;
-        case TOKEN_DIV: fprintf(info_file_ptr, "\"/\"\n"); break;
-        case TOKEN_LPAREN: fprintf(info_file_ptr, "\"(\"\n"); break;
-        case TOKEN_RPAREN: fprintf(info_file_ptr, "\")\"\n"); break;
-        case TOKEN_SEMI: fprintf(info_file_ptr, "\";\"\n"); break;
-        case TOKEN_COLON: fprintf(info_file_ptr, "\":\"\n"); break;
-        case TOKEN_COMMA: fprintf(info_file_ptr, "\",\"\n"); break;
+        case TOKEN_CLASS: fprintf(output, "\"class\"\n"); break;
+        case TOKEN_FEATURE: fprintf(output, "\"feature\"\n"); break;
+        case TOKEN_DO: fprintf(output, "\"do\"\n"); break;
+        case TOKEN_END: fprintf(output, "\"end\"\n"); break;
+        case TOKEN_IF: fprintf(output, "\"if\"\n"); break;
+        case TOKEN_THEN: fprintf(output, "\"then\"\n"); break;
+        case TOKEN_ELSE: fprintf(output, "\"else\"\n"); break;
+        case TOKEN_FROM: fprintf(output, "\"from\"\n"); break;
+        case TOKEN_UNTIL: fprintf(output, "\"until\"\n"); break;
+        case TOKEN_LOOP: fprintf(output, "\"loop\"\n"); break;
+        case TOKEN_LOCAL: fprintf(output, "\"local\"\n"); break;
+        case TOKEN_CREATE: fprintf(output, "\"create\"\n"); break;
+        case TOKEN_ACROSS: fprintf(output, "\"across\"\n"); break;
+        case TOKEN_AS: fprintf(output, "\"as\"\n"); break;
+        case TOKEN_PARALLEL: fprintf(output, "\"parallel\"\n"); break;
+        case TOKEN_ONCE: fprintf(output, "\"once\"\n"); break;
+        case TOKEN_SEPARATE: fprintf(output, "\"separate\"\n"); break;
+        case TOKEN_NOT: fprintf(output, "\"not\"\n"); break;
+        case TOKEN_AND: fprintf(output, "\"and\"\n"); break;
+        case TOKEN_OR: fprintf(output, "\"or\"\n"); break;
+        case TOKEN_IMPLIES: fprintf(output, "\"implies\"\n"); break;
+        case TOKEN_TRUE: fprintf(output, "\"True\"\n"); break;
+        case TOKEN_FALSE: fprintf(output, "\"False\"\n"); break;
+        case TOKEN_LAZY_BODY: fprintf(output, "cuerpo sin parsear (%zu bytes)\n", yylval.lazy_body->length); break;
+        case TOKEN_INTERVAL: fprintf(output, "\"|..|\"\n"); break;
+        case TOKEN_ASSIGN: fprintf(output, "\":=\"\n"); break;
+        case TOKEN_LE: fprintf(output, "\"<=\"\n"); break;
+        case TOKEN_GE: fprintf(output, "\">=\"\n"); break;
+        case TOKEN_EQ: fprintf(output, "\"=\"\n"); break;
+        case TOKEN_LT: fprintf(output, "\"<\"\n"); break;
+        case TOKEN_GT: fprintf(output, "\">\"\n"); break;
+        case TOKEN_DOT: fprintf(output, "\".\"\n"); break;
+        case TOKEN_PLUS: fprintf(output, "\"+\"\n"); break;
+        case TOKEN_MINUS: fprintf(output, "\"-\"\n"); break;
+        case TOKEN_MULT: fprintf(output, "\"*\"\n"); break;
+        case TOKEN_DIV: fprintf(output, "\"/\"\n"); break;
+        case TOKEN_LPAREN: fprintf(output, "\"(\"\n"); break;
+        case TOKEN_RPAREN: fprintf(output, "\")\"\n"); break;
+        case TOKEN_LBRACKET: fprintf(output, "\"[\"\n"); break;
+        case TOKEN_RBRACKET: fprintf(output, "\"]\"\n"); break;
+        case TOKEN_SEMI: fprintf(output, "\";\"\n"); break;
+        case TOKEN_COLON: fprintf(output, "\":\"\n"); break;
+        case TOKEN_COMMA: fprintf(output, "\",\"\n"); break;
 
         case TOKEN_NUMBER_INT:
-            fprintf(info_file_ptr, "%d\n", yylval.int_val);
+            fprintf(output, "%d\n", yylval.int_val);
             break;
         case TOKEN_NUMBER_REAL:
-            fprintf(info_file_ptr, "%f\n", yylval.real_val);
+            fprintf(output, "%f\n", yylval.real_val);
             break;
         case TOKEN_STRING:
-            fprintf(info_file_ptr, "\"%s\"\n", yylval.string_val);
+            fprintf(output, "\"%s\"\n", yylval.string_val);
             break;
         case TOKEN_IDENTIFIER:
-            fprintf(info_file_ptr, "\"%s\"\n", yylval.string_val);
+            fprintf(output, "\"%s\"\n", yylval.string_val);
             break;
         default:
-            fprintf(info_file_ptr, "\n");
+            fprintf(output, "\n");
             break;
     }
 }
@@ -11,7 +11,7 @@ extern FILE *info_file_ptr;
 // Prototipo de la función para obtener el nombre de un token
 const char* get_token_name(int token);
 
-// Prototipo de la función para imprimir un token
-void print_token(int token, YYSTYPE yylval, int yylineno);
+// Prototipo de la función para imprimir un token en output (el .info; NULL: no se imprime)
+void print_token(FILE *output, int token, YYSTYPE yylval, int yylineno);
 
 #endif // TOKEN_UTILS_H